@@ -0,0 +1,466 @@
+//
+// Host micro benchmarks of the driver hot paths, the real drivers talk to the device models of test/support.
+// Usage: bench [output.json], without a file the JSON goes to stdout.
+//
+
+#include <stdio.h>
+#include <string.h>
+
+#include "saph_bench.h"
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "saphBme280_burst.h"
+#include "saphBme280_filter.h"
+#include "saphBme280_stats.h"
+#include "saphBme280_derived.h"
+#include "saphBme280_sampler.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "saph_ssd1306_sparkline.h"
+#include "saph_ssd1306_framebuffer.h"
+#include "i2c_arbiter.h"
+#include "i2c_handler.h"
+#include "i2c_trace.h"
+
+#include "sim_hal.h"
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+#include "sim_ssd1306.h"
+
+#define BENCH_SENSOR_ADDRESS 0x76
+#define BENCH_DISPLAY_ADDRESS 0x3C
+// Raw readings of about 22 degC, 1000 hPa and 45 %RH with the reference trimming values
+#define BENCH_RAW_PRESSURE 283413
+#define BENCH_RAW_TEMPERATURE 523407
+#define BENCH_RAW_HUMIDITY 27999
+// x1 on all three converts in about 8 ms
+#define BENCH_MEASUREMENT_TIME_US 7600
+#define BENCH_STANDBY_TIME_US 62500
+// Samples per operation of the bulk decode
+#define BENCH_BURST_BATCH 64
+
+static sim_bme280_t simSensor;
+static sim_ssd1306_t simDisplay;
+static saphBmeDevice_t sensor;
+static saph_ssd1306_device_t display;
+
+static saphBme280_filter_t filter;
+static saphBme280_stats_t stats;
+static saphBme280_sampler_t sampler;
+static saph_ssd1306_sparkline_t sparkline;
+static saph_ssd1306_framebuffer_t framebuffer;
+static i2c_arbiter_t arbiter;
+static uint8_t frames[2][SAPH_SSD1306_FRAMEBUFFER_SIZE];
+// Control byte and a whole frame
+static uint8_t dataWrite[SAPH_SSD1306_FRAMEBUFFER_SIZE + 1];
+static uint32_t nowUs;
+static uint8_t traceBuffer[1024];
+static i2c_trace_t trace;
+static i2c_trace_replay_t replay;
+static saphBme280_burst_ring_t burstRing;
+static uint8_t burstBuffer[(BENCH_BURST_BATCH + 1) * SAPHBME280_BURST_SIZE];
+static int32_t burstTemperatures[BENCH_BURST_BATCH];
+static uint32_t burstPressures[BENCH_BURST_BATCH];
+static uint32_t burstHumidities[BENCH_BURST_BATCH];
+static const saphBme280_burst_columns_t burstColumns = {burstTemperatures, burstPressures, burstHumidities};
+
+// ###############################################
+// Setups
+// ###############################################
+
+static void setupBus(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, SAPHBME280_CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, BENCH_RAW_PRESSURE, BENCH_RAW_TEMPERATURE, BENCH_RAW_HUMIDITY);
+    sim_bme280_attach(&simSensor, BENCH_SENSOR_ADDRESS);
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, BENCH_DISPLAY_ADDRESS);
+    sim_hal_setDelayHandler(0, 0);
+    saphBme280_init(BENCH_SENSOR_ADDRESS, &sensor);
+    saph_ssd1306_init(BENCH_DISPLAY_ADDRESS, &display);
+    sim_i2c_bus_clearStats();
+}
+
+static void setupFilterIir(void) {
+    setupBus();
+    saphBme280_filter_initIir(&filter, SAPHBME280_IIR_FILTER_COEFFICIENT_16);
+}
+
+static void setupFilterCic(void) {
+    setupBus();
+    saphBme280_filter_initCic(&filter, 16, 3);
+}
+
+static void setupFilterMovingAverage(void) {
+    setupBus();
+    saphBme280_filter_initMovingAverage(&filter, 16);
+}
+
+// Minute, hour and day of one second samples
+static void setupStats(void) {
+    setupBus();
+    saphBme280_stats_init(&stats);
+    saphBme280_stats_addWindow(&stats, 60);
+    saphBme280_stats_addWindow(&stats, 3600);
+    saphBme280_stats_addWindow(&stats, 86400);
+}
+
+static void setupSampler(void) {
+    setupBus();
+    sim_bme280_setTiming(&simSensor, BENCH_MEASUREMENT_TIME_US, BENCH_STANDBY_TIME_US);
+    saphBme280_prepareConfigReg(&sensor, SAPHBME280_STANDBY_TIME_MS_62_5, SAPHBME280_IIR_FILTER_COEFFICIENT_OFF);
+    saphBme280_prepareMeasureCtrlReg(&sensor, OVERSAMPLING_x1, OVERSAMPLING_x1, SAPHBME280_SENSOR_MODE_NORMAL);
+    saphBme280_prepareCtrlHumidityReg(&sensor, OVERSAMPLING_x1);
+    saphBme280_commitAllRegs(&sensor);
+    nowUs = 0;
+    saphBme280_sampler_init(&sampler, &sensor, nowUs);
+    sim_i2c_bus_clearStats();
+}
+
+static void advanceSensor(void* context, uint32_t delayUs) {
+    sim_bme280_advanceTime((sim_bme280_t*) context, delayUs);
+}
+
+// Forced mode waited for through saph_hal.h, whose simulated backend lets the sensor convert during the delay
+static void setupForcedCycle(void) {
+    setupBus();
+    sim_bme280_setTiming(&simSensor, BENCH_MEASUREMENT_TIME_US, 0);
+    saphBme280_prepareProfile(&sensor, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_commitAllRegs(&sensor);
+    sim_hal_setDelayHandler(advanceSensor, &simSensor);
+    sim_i2c_bus_clearStats();
+}
+
+// Raw mode stores into a ring that never fills, the samples are compensated by nobody
+static void setupSamplerRaw(void) {
+    setupSampler();
+    saphBme280_burst_initRing(&burstRing, &sensor, burstBuffer, sizeof(burstBuffer));
+}
+
+static void setupBurstRing(void) {
+    setupBus();
+    saphBme280_burst_initRing(&burstRing, &sensor, burstBuffer, sizeof(burstBuffer));
+}
+
+// A full ring of slightly different bursts, taken out again by every operation
+static void setupBurstBatch(void) {
+    setupBurstRing();
+    for (uint32_t i = 0; i < BENCH_BURST_BATCH; ++i) {
+        sim_bme280_setRawMeasurement(&simSensor, BENCH_RAW_PRESSURE + (int32_t) i, BENCH_RAW_TEMPERATURE + (int32_t) i,
+                                     BENCH_RAW_HUMIDITY + (int32_t) i);
+        saphBme280_burst_read(&burstRing);
+    }
+    sim_i2c_bus_clearStats();
+}
+
+// Full width temperature sparkline over the top half of the panel
+static void setupSparkline(void) {
+    setupBus();
+    saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE, 0,
+                                SAPH_SSD1306_WIDTH, 0, SAPH_SSD1306_PAGES / 2 - 1, 1);
+    sim_i2c_bus_clearStats();
+}
+
+// The sparkline above with its whole history in the ring
+static void setupSparklineFull(void) {
+    setupSparkline();
+    for (uint32_t i = 0; i < SAPH_SSD1306_WIDTH; ++i) {
+        saph_ssd1306_sparkline_push(&sparkline, 2150 + (int32_t) (i % 40) * 5);
+    }
+    sim_i2c_bus_clearStats();
+}
+
+static void setupFramebuffer(void) {
+    setupBus();
+    saph_ssd1306_framebuffer_init(&framebuffer, &display, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    sim_i2c_bus_clearStats();
+}
+
+static void recordTransaction(void* context, uint32_t timeUs, uint8_t address, bool isRead, const uint8_t* buffer,
+                              uint32_t amount, int32_t result) {
+    i2c_trace_record((i2c_trace_t*) context, timeUs, address, isRead, buffer, amount, result);
+}
+
+static int32_t replayWrite(void* context, const uint8_t* buffer, uint32_t amount) {
+    return i2c_trace_replayWrite((i2c_trace_replay_t*) context, sim_i2c_bus_getCurrentAddress(), buffer, amount);
+}
+
+static int32_t replayRead(void* context, uint8_t* buffer, uint32_t amount) {
+    return i2c_trace_replayRead((i2c_trace_replay_t*) context, sim_i2c_bus_getCurrentAddress(), buffer, amount);
+}
+
+// Every transaction recorded into a ring small enough to evict all the time
+static void setupTraceRecord(void) {
+    setupBus();
+    i2c_trace_init(&trace, traceBuffer, sizeof(traceBuffer));
+    sim_i2c_bus_setObserver(recordTransaction, &trace);
+}
+
+// One measurement read recorded, then played back with no device on the bus
+static void setupTraceReplay(void) {
+    setupTraceRecord();
+    saphBmeMeasurements_t result;
+    saphBme280_getMeasurements(&sensor, &result);
+    sim_i2c_bus_reset();
+    sim_i2c_bus_attach(SIM_I2C_BUS_ANY_ADDRESS, &replay, replayWrite, replayRead);
+    i2c_trace_replayInit(&replay, &trace);
+}
+
+// Two frames differing in one small block
+static void setupFrames(void) {
+    setupBus();
+    memset(frames, 0x55, sizeof(frames));
+    frames[1][3 * SAPH_SSD1306_WIDTH + 40] = 0xFF;
+    frames[1][3 * SAPH_SSD1306_WIDTH + 47] = 0xFF;
+}
+
+static void setupArbiter(void) {
+    setupBus();
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    memset(dataWrite, 0x55, sizeof(dataWrite));
+    dataWrite[0] = 0x40;
+}
+
+// ###############################################
+// Operations
+// ###############################################
+
+// Raw values move a little so the compensation does not see the same input every time
+static saphBmeRawMeasurements_t rawSample(uint32_t iteration) {
+    saphBmeRawMeasurements_t raw = {BENCH_RAW_PRESSURE + (int32_t) (iteration & 0xFF),
+                                    BENCH_RAW_TEMPERATURE + (int32_t) (iteration & 0x3FF),
+                                    BENCH_RAW_HUMIDITY + (int32_t) (iteration & 0x7F)};
+    return raw;
+}
+
+static saphBmeMeasurements_t measurementSample(uint32_t iteration) {
+    saphBmeMeasurements_t measurements = {25600000 + (iteration & 0xFFF), 2150 + (int32_t) (iteration & 0x3F),
+                                          46080 + (iteration & 0x3FF)};
+    return measurements;
+}
+
+static void opCompensate(uint32_t iteration) {
+    saphBmeRawMeasurements_t raw = rawSample(iteration);
+    saphBmeMeasurements_t result = saphBme280_internal_compensateMeasurements(&sensor, &raw);
+    saph_bench_sink += result.pressure + result.temperature + result.humidity;
+}
+
+static void opDecodeBurst(uint32_t iteration) {
+    (void) iteration;
+    saphBmeRawMeasurements_t raw;
+    saphBme280_internal_getRawMeasurement(&sensor, &raw);
+    saph_bench_sink += raw.pressure + raw.temperature + raw.humidity;
+}
+
+static void opParseTrimming(uint32_t iteration) {
+    (void) iteration;
+    saph_bench_sink += saphBme280_internal_readTrimmingValues(&sensor) + sensor.trimmingValues.dig_H6;
+}
+
+static void opGetMeasurements(uint32_t iteration) {
+    (void) iteration;
+    saphBmeMeasurements_t result;
+    saphBme280_getMeasurements(&sensor, &result);
+    saph_bench_sink += result.temperature;
+}
+
+// Trigger, wait and read, what a gateway does once per sample
+static void opForcedCycle(uint32_t iteration) {
+    (void) iteration;
+    saphBmeMeasurements_t result;
+    saphBme280_triggerForcedMeasurement(&sensor);
+    saph_hal_delayUs(saphBme280_getMeasurementTimeUs(&sensor));
+    saphBme280_getMeasurements(&sensor, &result);
+    saph_bench_sink += result.temperature;
+}
+
+// One sample the way get_measurements delivers it, read into the ring and decoded a batch at a time
+static void opBurstReadDecode(uint32_t iteration) {
+    saph_bench_sink += saphBme280_burst_read(&burstRing);
+    if ((iteration + 1) % BENCH_BURST_BATCH == 0) {
+        saph_bench_sink += saphBme280_burst_decode(&burstRing, &burstColumns, BENCH_BURST_BATCH);
+        saph_bench_sink += burstTemperatures[BENCH_BURST_BATCH - 1];
+    }
+}
+
+// The stored bursts are handed back to the ring after each decode, there is no bus traffic
+static void opBurstDecodeBatch(uint32_t iteration) {
+    (void) iteration;
+    saph_bench_sink += saphBme280_burst_decode(&burstRing, &burstColumns, BENCH_BURST_BATCH);
+    saph_bench_sink += burstPressures[BENCH_BURST_BATCH - 1];
+    burstRing.oldest = 0;
+    burstRing.amount = BENCH_BURST_BATCH;
+}
+
+static void opFilterPush(uint32_t iteration) {
+    saphBmeRawMeasurements_t raw = rawSample(iteration);
+    saphBmeRawMeasurements_t output;
+    saph_bench_sink += saphBme280_filter_push(&filter, &raw, &output) + output.temperature;
+}
+
+static void opStatsPush(uint32_t iteration) {
+    saphBmeMeasurements_t measurements = measurementSample(iteration);
+    saph_bench_sink += saphBme280_stats_push(&stats, &measurements);
+}
+
+static void opDewPoint(uint32_t iteration) {
+    saphBmeMeasurements_t measurements = measurementSample(iteration);
+    int32_t dewPoint = 0;
+    saphBme280_derived_dewPoint(&measurements, &dewPoint);
+    saph_bench_sink += dewPoint;
+}
+
+static void opAltitude(uint32_t iteration) {
+    saphBmeMeasurements_t measurements = measurementSample(iteration);
+    int32_t altitude = 0;
+    saphBme280_derived_altitude(&measurements, 101325u * 256u, &altitude);
+    saph_bench_sink += altitude;
+}
+
+// One poll every 10 ms of simulated time, most of them find nothing new
+static void opSamplerPoll(uint32_t iteration) {
+    (void) iteration;
+    sim_bme280_advanceTime(&simSensor, 10000);
+    nowUs += 10000;
+    saphBmeMeasurements_t result;
+    saph_bench_sink += saphBme280_sampler_poll(&sampler, nowUs, &result);
+}
+
+static void opSamplerPollRaw(uint32_t iteration) {
+    (void) iteration;
+    sim_bme280_advanceTime(&simSensor, 10000);
+    nowUs += 10000;
+    saph_bench_sink += saphBme280_sampler_pollRaw(&sampler, nowUs, &burstRing);
+    burstRing.amount = 0;
+}
+
+// Compensates one stored sample on demand, the consumer looking at a value
+static void opBurstPeek(uint32_t iteration) {
+    saphBmeMeasurements_t result;
+    saph_bench_sink += saphBme280_burst_peek(&burstRing, iteration % BENCH_BURST_BATCH, &result) + result.pressure;
+}
+
+static void opCommandFraming(uint32_t iteration) {
+    uint8_t column = (uint8_t) (iteration % SAPH_SSD1306_WIDTH);
+    saph_bench_sink += saph_ssd1306_setAddressWindow(&display, column, column, 0, SAPH_SSD1306_PAGES - 1);
+}
+
+static void opDataFraming(uint32_t iteration) {
+    saph_bench_sink += saph_ssd1306_writeData(&display, &frames[0][iteration & 0xFF], 32);
+}
+
+static void opHandlerWrite(uint32_t iteration) {
+    uint8_t buffer[2] = {0x00, (uint8_t) iteration};
+    saph_bench_sink += i2c_handler_write(BENCH_DISPLAY_ADDRESS, buffer, 2);
+}
+
+static void opSparklinePush(uint32_t iteration) {
+    saph_bench_sink += saph_ssd1306_sparkline_push(&sparkline, 2150 + (int32_t) (iteration % 40) * 5);
+}
+
+// What every sample would cost without the sweep
+static void opSparklineRedraw(uint32_t iteration) {
+    (void) iteration;
+    saph_bench_sink += saph_ssd1306_sparkline_redraw(&sparkline);
+}
+
+static void opFramebufferDiff(uint32_t iteration) {
+    saph_ssd1306_region_t region;
+    saph_bench_sink += saph_ssd1306_framebuffer_diff(frames[iteration & 1], frames[(iteration + 1) & 1], &region);
+}
+
+// A changing value of a few pixels, swapped and flushed completely
+static void opFramebufferSmallChange(uint32_t iteration) {
+    for (uint8_t x = 0; x < 8; ++x) {
+        saph_ssd1306_framebuffer_setPixel(&framebuffer, 40 + x, 10, ((iteration >> x) & 1) != 0);
+    }
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    while (saph_ssd1306_framebuffer_flushStep(&framebuffer) == SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING) {
+    }
+}
+
+// Every byte changes, the whole frame goes out in chunks with a sensor read between two of them
+static void opFramebufferShared(uint32_t iteration) {
+    memset(saph_ssd1306_framebuffer_getBack(&framebuffer), (iteration & 1) != 0 ? 0xA5 : 0x5A,
+           SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    saphBmeMeasurements_t result;
+    while (saph_ssd1306_framebuffer_flushStep(&framebuffer) == SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING) {
+        saph_bench_sink += saphBme280_getMeasurements(&sensor, &result);
+    }
+}
+
+static void opTraceReplay(uint32_t iteration) {
+    (void) iteration;
+    if (i2c_trace_replayIsDone(&replay)) {
+        i2c_trace_replayInit(&replay, &trace);
+    }
+    saphBmeMeasurements_t result;
+    saph_bench_sink += saphBme280_getMeasurements(&sensor, &result);
+}
+
+// A whole frame of data queued at low priority and sent in chunks
+static void opArbiterFrame(uint32_t iteration) {
+    (void) iteration;
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWrite(&request, BENCH_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, dataWrite, sizeof(dataWrite), 1);
+    i2c_arbiter_submit(&arbiter, &request);
+    while (i2c_arbiter_step(&arbiter) == I2C_ARBITER_TRANSFERRED) {
+    }
+    saph_bench_sink += request.state;
+}
+
+static const saph_bench_case_t benchCases[] = {
+        {"bme280.compensate",            setupBus,                 opCompensate},
+        {"bme280.decode_burst",          setupBus,                 opDecodeBurst},
+        {"bme280.parse_trimming",        setupBus,                 opParseTrimming},
+        {"bme280.get_measurements",      setupBus,                 opGetMeasurements},
+        {"bme280.forced_cycle_hal",      setupForcedCycle,         opForcedCycle},
+        {"bme280.burst_read_decode",     setupBurstRing,           opBurstReadDecode},
+        {"bme280.burst_decode_64",       setupBurstBatch,          opBurstDecodeBatch},
+        {"bme280.filter_iir_push",       setupFilterIir,           opFilterPush},
+        {"bme280.filter_cic_push",       setupFilterCic,           opFilterPush},
+        {"bme280.filter_average_push",   setupFilterMovingAverage, opFilterPush},
+        {"bme280.stats_push",            setupStats,               opStatsPush},
+        {"bme280.derived_dew_point",     setupBus,                 opDewPoint},
+        {"bme280.derived_altitude",      setupBus,                 opAltitude},
+        {"bme280.sampler_poll",          setupSampler,             opSamplerPoll},
+        {"bme280.sampler_poll_raw",      setupSamplerRaw,          opSamplerPollRaw},
+        {"bme280.burst_peek",            setupBurstBatch,          opBurstPeek},
+        {"ssd1306.command_framing",      setupBus,                 opCommandFraming},
+        {"ssd1306.data_framing_32",      setupFrames,              opDataFraming},
+        {"ssd1306.sparkline_push",       setupSparkline,           opSparklinePush},
+        {"ssd1306.sparkline_redraw",     setupSparklineFull,       opSparklineRedraw},
+        {"ssd1306.framebuffer_diff",     setupFrames,              opFramebufferDiff},
+        {"ssd1306.framebuffer_small",    setupFramebuffer,         opFramebufferSmallChange},
+        {"ssd1306.framebuffer_shared",   setupFramebuffer,         opFramebufferShared},
+        {"i2c.handler_write",            setupBus,                 opHandlerWrite},
+        {"i2c.arbiter_chunked_frame",    setupArbiter,             opArbiterFrame},
+        {"i2c.trace_record_measurement", setupTraceRecord,         opGetMeasurements},
+        {"i2c.trace_replay_measurement", setupTraceReplay,         opTraceReplay},
+};
+
+#define AMOUNT_BENCH_CASES (sizeof(benchCases) / sizeof(benchCases[0]))
+
+int main(int argc, char** argv) {
+    saph_bench_result_t results[AMOUNT_BENCH_CASES];
+    for (uint32_t i = 0; i < AMOUNT_BENCH_CASES; ++i) {
+        results[i] = saph_bench_run(&benchCases[i]);
+        fprintf(stderr, "%-32s %10.1f ns/op %8.1f bus bytes/op\n", results[i].name, results[i].nsPerOp,
+                results[i].busBytesPerOp);
+    }
+    FILE* output = stdout;
+    if (argc > 1) {
+        output = fopen(argv[1], "w");
+        if (output == 0) {
+            fprintf(stderr, "Cannot write %s\n", argv[1]);
+            return 1;
+        }
+    }
+    saph_bench_writeJson(output, results, AMOUNT_BENCH_CASES);
+    if (output != stdout) {
+        fclose(output);
+    }
+    return 0;
+}
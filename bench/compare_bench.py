@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+"""Compares two JSON files written by the bench target.
+
+Times may move by the tolerance before they count as a regression, the bus and allocation counters
+do not depend on the machine and have to match exactly. Exits with 1 on any regression.
+
+    python3 bench/compare_bench.py baseline.json current.json [--tolerance 0.10]
+"""
+
+import argparse
+import json
+import sys
+
+EXACT_FIELDS = ("bus_transfers_per_op", "bus_bytes_per_op", "allocations_per_op")
+
+
+def load(path):
+    with open(path) as source:
+        return {entry["name"]: entry for entry in json.load(source)["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--tolerance", type=float, default=0.10, help="allowed relative slow down of ns_per_op")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+    for name in sorted(set(baseline) | set(current)):
+        if name not in current:
+            print(f"{name:32} removed")
+            continue
+        if name not in baseline:
+            print(f"{name:32} new {current[name]['ns_per_op']:10.1f} ns/op")
+            continue
+        old, new = baseline[name], current[name]
+        change = new["ns_per_op"] / old["ns_per_op"] - 1.0 if old["ns_per_op"] > 0 else 0.0
+        notes = []
+        if change > args.tolerance:
+            notes.append("SLOWER")
+        for field in EXACT_FIELDS:
+            if old.get(field) != new.get(field):
+                notes.append(f"{field} {old.get(field)} -> {new.get(field)}")
+        regressions += 1 if notes else 0
+        print(f"{name:32} {old['ns_per_op']:10.1f} -> {new['ns_per_op']:10.1f} ns/op {change:+7.1%} {' '.join(notes)}")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
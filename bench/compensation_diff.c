@@ -0,0 +1,426 @@
+//
+// Differential harness for the BME280 compensation: saphBme280_internal_compensateMeasurements is the reference,
+// every candidate in the table below runs on the same inputs and has to stay within its tolerances.
+// Sweeps the whole 20 bit temperature and pressure and 16 bit humidity raw domains for a number of trimming sets,
+// spread over all cores. Prints the largest deviation per field and the first input outside the tolerance.
+//
+// Usage: compensation_diff [--trims N] [--temperatures N] [--threads N] [--seed N] [--quick]
+//
+
+#include <inttypes.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "sim_bme280.h"
+
+#define MAX_THREADS 64
+#define RAW_20BIT_VALUES (1u << 20)
+#define RAW_16BIT_VALUES (1u << 16)
+// Raw values the other channels keep while one is swept, about 22 degC, 1000 hPa and 45 %RH
+#define FIXED_RAW_PRESSURE 283413
+#define FIXED_RAW_TEMPERATURE 523407
+#define FIXED_RAW_HUMIDITY 27999
+// Operating range of the BME280 in the units of saphBmeMeasurements_t
+#define OPERATING_TEMPERATURE_MIN -4000
+#define OPERATING_TEMPERATURE_MAX 8500
+#define OPERATING_PRESSURE_MIN (30000u * 256u)
+#define OPERATING_PRESSURE_MAX (110000u * 256u)
+
+#define SWEEP_TEMPERATURE 0
+#define SWEEP_PRESSURE 1
+#define SWEEP_HUMIDITY 2
+
+typedef saphBmeMeasurements_t (* compensate_t)(saphBmeDevice_t* device, saphBmeRawMeasurements_t* raw);
+
+/* *
+ * Tolerances in the units of saphBmeMeasurements_t, all 0 for a candidate that has to match bit for bit.
+ * Approximations only get compared where the reference lies in the operating range of the sensor.
+ * */
+typedef struct candidate_t {
+    const char* name;
+    compensate_t compensate;
+    uint32_t temperatureTolerance;
+    uint32_t pressureTolerance;
+    uint32_t humidityTolerance;
+    bool operatingRangeOnly;
+} candidate_t;
+
+typedef struct deviation_t {
+    uint64_t compared;
+    uint64_t failures;
+    int64_t maxTemperature;
+    int64_t maxPressure;
+    int64_t maxHumidity;
+    // Sweep order of the first failure, lowest work item first
+    bool hasFailure;
+    uint32_t failureItem;
+    uint32_t failureOffset;
+    uint32_t failureTrimSet;
+    saphBmeRawMeasurements_t failureInput;
+    saphBmeMeasurements_t failureExpected;
+    saphBmeMeasurements_t failureActual;
+} deviation_t;
+
+typedef struct sweepConfig_t {
+    uint32_t trimSets;
+    uint32_t temperatures;
+    uint32_t threads;
+    uint64_t seed;
+    // Step through the raw domains, 1 for the full sweep
+    uint32_t stride;
+} sweepConfig_t;
+
+static saphBmeMeasurements_t compensateDatasheetDouble(saphBmeDevice_t* device, saphBmeRawMeasurements_t* raw);
+
+// The table every future compensation implementation gets added to
+static const candidate_t candidates[] = {
+        // Floating point formulas of the datasheet, chapter 8.1. 0.01 degC, 1 Pa and 0.01 %RH apart at most
+        {"datasheet_double", compensateDatasheetDouble, 1, 256, 11, true},
+};
+
+#define AMOUNT_CANDIDATES (sizeof(candidates) / sizeof(candidates[0]))
+
+static sweepConfig_t config = {16, 32, 0, 1, 1};
+static saphBmeDevice_t* trimDevices;
+static uint32_t nextItem = 0;
+static pthread_mutex_t itemLock = PTHREAD_MUTEX_INITIALIZER;
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static uint64_t nextRandom(uint64_t* state);
+
+static int16_t spread(uint64_t* state, int32_t reference, int32_t minimumSpread);
+
+static void makeTrimSets(saphBmeDevice_t* devices, uint32_t amount, uint64_t seed);
+
+static uint32_t amountItems(void);
+
+static void describeItem(uint32_t item, uint32_t* trimSet, uint32_t* sweep, int32_t* fixedTemperature);
+
+static bool isInOperatingRange(const saphBmeMeasurements_t* measurements);
+
+static int64_t distance(int64_t a, int64_t b);
+
+static void compare(const candidate_t* candidate, deviation_t* deviation, uint32_t item, uint32_t offset,
+                    uint32_t trimSet, saphBmeDevice_t* device, saphBmeRawMeasurements_t* raw,
+                    const saphBmeMeasurements_t* expected);
+
+static void* sweepWorker(void* argument);
+
+static void mergeDeviation(deviation_t* into, const deviation_t* from);
+
+static bool parseArguments(int argc, char** argv);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int main(int argc, char** argv) {
+    if (!parseArguments(argc, argv)) {
+        fprintf(stderr, "Usage: %s [--trims N] [--temperatures N] [--threads N] [--seed N] [--quick]\n", argv[0]);
+        return 2;
+    }
+    if (config.threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        config.threads = cores > 0 ? (uint32_t) cores : 1;
+    }
+    if (config.threads > MAX_THREADS) {
+        config.threads = MAX_THREADS;
+    }
+    trimDevices = calloc(config.trimSets, sizeof(saphBmeDevice_t));
+    if (trimDevices == 0) {
+        return 2;
+    }
+    makeTrimSets(trimDevices, config.trimSets, config.seed);
+    printf("%u trimming sets, %u temperatures per pressure and humidity sweep, stride %u, %u threads\n",
+           config.trimSets, config.temperatures, config.stride, config.threads);
+
+    pthread_t threads[MAX_THREADS];
+    deviation_t results[MAX_THREADS][AMOUNT_CANDIDATES];
+    memset(results, 0, sizeof(results));
+    for (uint32_t i = 0; i < config.threads; ++i) {
+        pthread_create(&threads[i], 0, sweepWorker, results[i]);
+    }
+    for (uint32_t i = 0; i < config.threads; ++i) {
+        pthread_join(threads[i], 0);
+    }
+
+    bool allPassed = true;
+    for (uint32_t c = 0; c < AMOUNT_CANDIDATES; ++c) {
+        deviation_t total;
+        memset(&total, 0, sizeof(total));
+        for (uint32_t i = 0; i < config.threads; ++i) {
+            mergeDeviation(&total, &results[i][c]);
+        }
+        printf("%s: %" PRIu64 " compared, %" PRIu64 " outside tolerance, max deviation %" PRId64 " (0.01 degC) %"
+               PRId64 " (1/256 Pa) %" PRId64 " (1/1024 %%RH)\n", candidates[c].name, total.compared, total.failures,
+               total.maxTemperature, total.maxPressure, total.maxHumidity);
+        if (total.hasFailure) {
+            allPassed = false;
+            printf("  first failure: trim set %u, raw P %" PRId32 " T %" PRId32 " H %" PRId32
+                   ", expected %" PRIu32 " %" PRId32 " %" PRIu32 ", got %" PRIu32 " %" PRId32 " %" PRIu32 "\n",
+                   total.failureTrimSet, total.failureInput.pressure, total.failureInput.temperature,
+                   total.failureInput.humidity, total.failureExpected.pressure, total.failureExpected.temperature,
+                   total.failureExpected.humidity, total.failureActual.pressure, total.failureActual.temperature,
+                   total.failureActual.humidity);
+        }
+    }
+    free(trimDevices);
+    return allPassed ? 0 : 1;
+}
+
+// ###############################################
+// Candidates
+// ###############################################
+
+static saphBmeMeasurements_t compensateDatasheetDouble(saphBmeDevice_t* device, saphBmeRawMeasurements_t* raw) {
+    saphBmeTrimmingValues_t* trims = &(device->trimmingValues);
+    saphBmeMeasurements_t result = {0, 0, 0};
+
+    double var1 = (raw->temperature / 16384.0 - trims->dig_T1 / 1024.0) * trims->dig_T2;
+    double var2 = (raw->temperature / 131072.0 - trims->dig_T1 / 8192.0) *
+                  (raw->temperature / 131072.0 - trims->dig_T1 / 8192.0) * trims->dig_T3;
+    double fineTemperature = var1 + var2;
+    result.temperature = (int32_t) lround(fineTemperature / 5120.0 * 100.0);
+
+    var1 = fineTemperature / 2.0 - 64000.0;
+    var2 = var1 * var1 * trims->dig_P6 / 32768.0;
+    var2 = var2 + var1 * trims->dig_P5 * 2.0;
+    var2 = var2 / 4.0 + trims->dig_P4 * 65536.0;
+    var1 = (trims->dig_P3 * var1 * var1 / 524288.0 + trims->dig_P2 * var1) / 524288.0;
+    var1 = (1.0 + var1 / 32768.0) * trims->dig_P1;
+    if (var1 != 0.0) {
+        double pressure = 1048576.0 - raw->pressure;
+        pressure = (pressure - var2 / 4096.0) * 6250.0 / var1;
+        var1 = trims->dig_P9 * pressure * pressure / 2147483648.0;
+        var2 = pressure * trims->dig_P8 / 32768.0;
+        pressure = pressure + (var1 + var2 + trims->dig_P7) / 16.0;
+        result.pressure = pressure > 0 ? (uint32_t) llround(pressure * 256.0) : 0;
+    }
+
+    if (saphBme280_hasHumidity(device)) {
+        double humidity = fineTemperature - 76800.0;
+        humidity = (raw->humidity - (trims->dig_H4 * 64.0 + trims->dig_H5 / 16384.0 * humidity)) *
+                   (trims->dig_H2 / 65536.0 * (1.0 + trims->dig_H6 / 67108864.0 * humidity *
+                                                     (1.0 + trims->dig_H3 / 67108864.0 * humidity)));
+        humidity = humidity * (1.0 - trims->dig_H1 * humidity / 524288.0);
+        humidity = humidity > 100.0 ? 100.0 : (humidity < 0.0 ? 0.0 : humidity);
+        result.humidity = (uint32_t) lround(humidity * 1024.0);
+    }
+    return result;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+// xorshift64*, the same seed gives the same trimming sets on every machine
+static uint64_t nextRandom(uint64_t* state) {
+    *state ^= *state >> 12;
+    *state ^= *state << 25;
+    *state ^= *state >> 27;
+    return *state * 0x2545F4914F6CDD1Dull;
+}
+
+// Up to a sixteenth of the reference or minimumSpread either way, parts differ by about that much
+static int16_t spread(uint64_t* state, int32_t reference, int32_t minimumSpread) {
+    int32_t width = abs(reference) / 16;
+    width = width < minimumSpread ? minimumSpread : width;
+    int32_t value = reference + (int32_t) (nextRandom(state) % (uint64_t) (2 * width + 1)) - width;
+    return (int16_t) value;
+}
+
+// The first set is the reference set of the unit tests, the others are spread around it
+static void makeTrimSets(saphBmeDevice_t* devices, uint32_t amount, uint64_t seed) {
+    uint64_t state = seed == 0 ? 1 : seed;
+    for (uint32_t i = 0; i < amount; ++i) {
+        saphBmeDevice_t* device = &devices[i];
+        device->chipId = SAPHBME280_CHIP_ID_BME280;
+        saphBmeTrimmingValues_t trims = sim_bme280_referenceTrimmingValues;
+        trims.dig_H6 = 30;
+        if (i > 0) {
+            trims.dig_T1 = (uint16_t) (trims.dig_T1 + spread(&state, 0, 1000));
+            trims.dig_T2 = spread(&state, trims.dig_T2, 16);
+            trims.dig_T3 = spread(&state, trims.dig_T3, 1000);
+            trims.dig_P1 = (uint16_t) (trims.dig_P1 + spread(&state, 0, 2000));
+            trims.dig_P2 = spread(&state, trims.dig_P2, 16);
+            trims.dig_P3 = spread(&state, trims.dig_P3, 16);
+            trims.dig_P4 = spread(&state, trims.dig_P4, 16);
+            trims.dig_P5 = spread(&state, trims.dig_P5, 16);
+            trims.dig_P6 = spread(&state, trims.dig_P6, 16);
+            trims.dig_P7 = spread(&state, trims.dig_P7, 16);
+            trims.dig_P8 = spread(&state, trims.dig_P8, 16);
+            trims.dig_P9 = spread(&state, trims.dig_P9, 16);
+            trims.dig_H1 = (uint8_t) (trims.dig_H1 + spread(&state, 0, 10));
+            trims.dig_H2 = spread(&state, trims.dig_H2, 16);
+            trims.dig_H3 = (uint8_t) (nextRandom(&state) % 8);
+            trims.dig_H4 = spread(&state, trims.dig_H4, 16);
+            trims.dig_H5 = spread(&state, trims.dig_H5, 16);
+            trims.dig_H6 = (int8_t) spread(&state, 30, 4);
+        }
+        device->trimmingValues = trims;
+    }
+}
+
+// Per trimming set one temperature sweep, then one pressure and one humidity sweep per fixed temperature
+static uint32_t amountItems(void) {
+    return config.trimSets * (1 + 2 * config.temperatures);
+}
+
+static void describeItem(uint32_t item, uint32_t* trimSet, uint32_t* sweep, int32_t* fixedTemperature) {
+    uint32_t perSet = 1 + 2 * config.temperatures;
+    *trimSet = item / perSet;
+    uint32_t inSet = item % perSet;
+    if (inSet == 0) {
+        *sweep = SWEEP_TEMPERATURE;
+        *fixedTemperature = FIXED_RAW_TEMPERATURE;
+        return;
+    }
+    inSet--;
+    *sweep = inSet < config.temperatures ? SWEEP_PRESSURE : SWEEP_HUMIDITY;
+    // Spread evenly over the raw values that come out between about -45 and 90 degC
+    uint32_t index = inSet % config.temperatures;
+    int32_t coldest = 380000;
+    int32_t hottest = 680000;
+    *fixedTemperature = config.temperatures == 1 ? FIXED_RAW_TEMPERATURE :
+                        coldest + (int32_t) (((int64_t) (hottest - coldest) * index) / (config.temperatures - 1));
+}
+
+static bool isInOperatingRange(const saphBmeMeasurements_t* measurements) {
+    return measurements->temperature >= OPERATING_TEMPERATURE_MIN &&
+           measurements->temperature <= OPERATING_TEMPERATURE_MAX &&
+           measurements->pressure >= OPERATING_PRESSURE_MIN && measurements->pressure <= OPERATING_PRESSURE_MAX;
+}
+
+static int64_t distance(int64_t a, int64_t b) {
+    return a > b ? a - b : b - a;
+}
+
+static void compare(const candidate_t* candidate, deviation_t* deviation, uint32_t item, uint32_t offset,
+                    uint32_t trimSet, saphBmeDevice_t* device, saphBmeRawMeasurements_t* raw,
+                    const saphBmeMeasurements_t* expected) {
+    if (candidate->operatingRangeOnly && !isInOperatingRange(expected)) {
+        return;
+    }
+    saphBmeRawMeasurements_t input = *raw;
+    saphBmeMeasurements_t actual = candidate->compensate(device, &input);
+    int64_t temperature = distance(actual.temperature, expected->temperature);
+    int64_t pressure = distance(actual.pressure, expected->pressure);
+    int64_t humidity = distance(actual.humidity, expected->humidity);
+    deviation->compared++;
+    deviation->maxTemperature = temperature > deviation->maxTemperature ? temperature : deviation->maxTemperature;
+    deviation->maxPressure = pressure > deviation->maxPressure ? pressure : deviation->maxPressure;
+    deviation->maxHumidity = humidity > deviation->maxHumidity ? humidity : deviation->maxHumidity;
+    if (temperature <= candidate->temperatureTolerance && pressure <= candidate->pressureTolerance &&
+        humidity <= candidate->humidityTolerance) {
+        return;
+    }
+    deviation->failures++;
+    if (deviation->hasFailure && (deviation->failureItem < item ||
+                                  (deviation->failureItem == item && deviation->failureOffset < offset))) {
+        return;
+    }
+    deviation->hasFailure = true;
+    deviation->failureItem = item;
+    deviation->failureOffset = offset;
+    deviation->failureTrimSet = trimSet;
+    deviation->failureInput = *raw;
+    deviation->failureExpected = *expected;
+    deviation->failureActual = actual;
+}
+
+// Takes work items until none are left, each sweeps one raw domain completely
+static void* sweepWorker(void* argument) {
+    deviation_t* deviations = (deviation_t*) argument;
+    while (1) {
+        pthread_mutex_lock(&itemLock);
+        uint32_t item = nextItem++;
+        pthread_mutex_unlock(&itemLock);
+        if (item >= amountItems()) {
+            return 0;
+        }
+        uint32_t trimSet, sweep;
+        int32_t fixedTemperature;
+        describeItem(item, &trimSet, &sweep, &fixedTemperature);
+        saphBmeDevice_t device = trimDevices[trimSet];
+        uint32_t domain = sweep == SWEEP_HUMIDITY ? RAW_16BIT_VALUES : RAW_20BIT_VALUES;
+        for (uint32_t offset = 0; offset < domain; offset += config.stride) {
+            saphBmeRawMeasurements_t raw = {FIXED_RAW_PRESSURE, fixedTemperature, FIXED_RAW_HUMIDITY};
+            if (sweep == SWEEP_TEMPERATURE) {
+                raw.temperature = (int32_t) offset;
+            } else if (sweep == SWEEP_PRESSURE) {
+                raw.pressure = (int32_t) offset;
+            } else {
+                raw.humidity = (int32_t) offset;
+            }
+            saphBmeRawMeasurements_t input = raw;
+            saphBmeMeasurements_t expected = saphBme280_internal_compensateMeasurements(&device, &input);
+            for (uint32_t c = 0; c < AMOUNT_CANDIDATES; ++c) {
+                compare(&candidates[c], &deviations[c], item, offset, trimSet, &device, &raw, &expected);
+            }
+        }
+    }
+}
+
+static void mergeDeviation(deviation_t* into, const deviation_t* from) {
+    into->compared += from->compared;
+    into->failures += from->failures;
+    into->maxTemperature = from->maxTemperature > into->maxTemperature ? from->maxTemperature : into->maxTemperature;
+    into->maxPressure = from->maxPressure > into->maxPressure ? from->maxPressure : into->maxPressure;
+    into->maxHumidity = from->maxHumidity > into->maxHumidity ? from->maxHumidity : into->maxHumidity;
+    if (!from->hasFailure) {
+        return;
+    }
+    if (!into->hasFailure || from->failureItem < into->failureItem ||
+        (from->failureItem == into->failureItem && from->failureOffset < into->failureOffset)) {
+        uint64_t compared = into->compared;
+        uint64_t failures = into->failures;
+        int64_t maxTemperature = into->maxTemperature;
+        int64_t maxPressure = into->maxPressure;
+        int64_t maxHumidity = into->maxHumidity;
+        *into = *from;
+        into->compared = compared;
+        into->failures = failures;
+        into->maxTemperature = maxTemperature;
+        into->maxPressure = maxPressure;
+        into->maxHumidity = maxHumidity;
+    }
+}
+
+// --quick takes every 61st raw value of 4 trimming sets, a few seconds for CTest
+static bool parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            config.trimSets = 4;
+            config.temperatures = 8;
+            config.stride = 61;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        unsigned long long value = strtoull(argv[i + 1], 0, 0);
+        if (strcmp(argv[i], "--trims") == 0 && value > 0) {
+            config.trimSets = (uint32_t) value;
+        } else if (strcmp(argv[i], "--temperatures") == 0 && value > 0) {
+            config.temperatures = (uint32_t) value;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            config.threads = (uint32_t) value;
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            config.seed = value;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
@@ -0,0 +1,345 @@
+//
+// Full frame updates of the SSD1306 framebuffer sharing the bus with periodic BME280 reads, once per configuration:
+// flush steps sent directly in several chunk sizes, or queued through the i2c_arbiter next to the sensor reads.
+// Reports how many whole frames a second get to the panel and how long a due sensor read waited for the bus.
+// Times are simulated: the bus time of sim_i2c_bus, so results do not depend on the host.
+//
+// Usage: display_sharing [--seconds N] [--quick]
+//
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "saphBme280.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_framebuffer.h"
+#include "i2c_arbiter.h"
+#include "i2c_handler.h"
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+#include "sim_ssd1306.h"
+
+#define SHARING_SENSOR_ADDRESS 0x76
+#define SHARING_DISPLAY_ADDRESS 0x3C
+#define SHARING_RAW_PRESSURE 283413
+#define SHARING_RAW_TEMPERATURE 523407
+#define SHARING_RAW_HUMIDITY 27999
+// The data registers from press_msb to hum_lsb, what a measurement read fetches
+#define SENSOR_DATA_REGISTER 0xF7
+#define SENSOR_DATA_BYTES 8
+// Not a multiple of any frame time, so the reads land on every phase of a flush
+#define SENSOR_PERIOD_US 10007u
+// Chunk size 0 stands for the whole frame in one write, the way it goes without the framebuffer
+#define UNCHUNKED 0
+
+typedef struct sharingConfig_t {
+    const char* name;
+    uint16_t chunkSize;
+    // 0 flushes directly, otherwise the arbiter cuts the queued chunks into pieces of this size
+    uint16_t arbiterChunkSize;
+    bool queued;
+} sharingConfig_t;
+
+typedef struct sharingResult_t {
+    uint32_t frames;
+    uint32_t reads;
+    // Reads that came due again before the previous one could run, a chunk longer than the sensor period does that
+    uint32_t missedReads;
+    uint32_t simulatedUs;
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxLatencyUs;
+} sharingResult_t;
+
+static const sharingConfig_t configs[] = {
+        {"whole",       UNCHUNKED,                              0,                                      false},
+        {"direct 16",   16,                                     0,                                      false},
+        {"direct 32",   SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK, 0,                                      false},
+        {"direct 64",   64,                                     0,                                      false},
+        {"direct 128",  SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK,     0,                                      false},
+        {"arbiter 32",  SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK,     SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK, true},
+        {"arbiter 64",  SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK,     I2C_ARBITER_MAX_CHUNK,                  true},
+};
+
+#define AMOUNT_CONFIGS (sizeof(configs) / sizeof(configs[0]))
+
+static uint32_t simulationUs = 10000000;
+static sim_bme280_t simSensor;
+static sim_ssd1306_t simDisplay;
+static saphBmeDevice_t sensor;
+static saph_ssd1306_device_t display;
+static saph_ssd1306_framebuffer_t framebuffer;
+static i2c_arbiter_t arbiter;
+// Control byte and the whole frame, writeData would split it into short transactions
+static uint8_t wholeFrameWrite[1 + SAPH_SSD1306_FRAMEBUFFER_SIZE];
+static uint32_t* latencies;
+static uint32_t latencyCapacity;
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static void attachDevices(void);
+
+static void drawFrame(uint32_t frame);
+
+static int32_t flushUnchunked(void);
+
+static uint32_t readSensor(void);
+
+static void addLatency(sharingResult_t* result, uint32_t latencyUs);
+
+static uint32_t countMissed(uint32_t* nextSensorUs, uint32_t nowUs);
+
+static bool runDirect(const sharingConfig_t* config, sharingResult_t* result);
+
+static bool runQueued(const sharingConfig_t* config, sharingResult_t* result);
+
+static void finishResult(sharingResult_t* result);
+
+static void printResult(const sharingConfig_t* config, const sharingResult_t* result, uint32_t boundUs);
+
+static bool parseArguments(int argc, char** argv);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int main(int argc, char** argv) {
+    if (!parseArguments(argc, argv)) {
+        fprintf(stderr, "Usage: %s [--seconds N] [--quick]\n", argv[0]);
+        return 2;
+    }
+    latencyCapacity = simulationUs / SENSOR_PERIOD_US + 2;
+    latencies = malloc(latencyCapacity * sizeof(uint32_t));
+    if (latencies == 0) {
+        return 1;
+    }
+    attachDevices();
+    uint32_t readUs = readSensor();
+    printf("%" PRIu32 " simulated seconds per configuration, a sensor read every %u us takes %" PRIu32 " us\n",
+           simulationUs / 1000000, SENSOR_PERIOD_US, readUs);
+    printf("%-12s %10s %8s %8s %10s %10s %10s %10s\n", "flush", "frames/s", "reads", "missed", "p50 us", "p99 us",
+           "max us", "bound us");
+
+    bool allPassed = true;
+    for (uint32_t i = 0; i < AMOUNT_CONFIGS; ++i) {
+        const sharingConfig_t* config = &configs[i];
+        sharingResult_t result;
+        if (!(config->queued ? runQueued(config, &result) : runDirect(config, &result))) {
+            printf("  %s: flush failed\n", config->name);
+            allPassed = false;
+            continue;
+        }
+        // A due read waits for the transfer in flight at most: a chunk with its control and address byte
+        uint16_t transferSize = config->queued ? config->arbiterChunkSize : config->chunkSize;
+        uint32_t boundUs = (transferSize + 2u) * SIM_I2C_BUS_BYTE_TIME_US + readUs;
+        printResult(config, &result, config->chunkSize == UNCHUNKED ? 0 : boundUs);
+        if (config->chunkSize != UNCHUNKED && result.maxLatencyUs > boundUs) {
+            printf("  %s: a sensor read waited longer than one chunk\n", config->name);
+            allPassed = false;
+        }
+    }
+    free(latencies);
+    return allPassed ? 0 : 1;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static void attachDevices(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, SAPHBME280_CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, SHARING_RAW_PRESSURE, SHARING_RAW_TEMPERATURE, SHARING_RAW_HUMIDITY);
+    sim_bme280_attach(&simSensor, SHARING_SENSOR_ADDRESS);
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SHARING_DISPLAY_ADDRESS);
+    saphBme280_init(SHARING_SENSOR_ADDRESS, &sensor);
+    saph_ssd1306_init(SHARING_DISPLAY_ADDRESS, &display);
+}
+
+// Every byte changes from one frame to the next, so each swap flushes the whole panel
+static void drawFrame(uint32_t frame) {
+    memset(saph_ssd1306_framebuffer_getBack(&framebuffer), (frame & 1) != 0 ? 0xA5 : 0x5A,
+           SAPH_SSD1306_FRAMEBUFFER_SIZE);
+}
+
+static int32_t flushUnchunked(void) {
+    int32_t errorCode = saph_ssd1306_setAddressWindow(&display, 0, SAPH_SSD1306_WIDTH - 1, 0,
+                                                      SAPH_SSD1306_PAGES - 1);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    wholeFrameWrite[0] = 0x40;
+    memcpy(wholeFrameWrite + 1, saph_ssd1306_framebuffer_getBack(&framebuffer), SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    int32_t commResult = i2c_handler_write(display.address, wholeFrameWrite, sizeof(wholeFrameWrite));
+    return commResult < 0 ? commResult : SAPH_SSD1306_NO_ERROR;
+}
+
+// Returns the bus time of the read
+static uint32_t readSensor(void) {
+    uint32_t startUs = sim_i2c_bus_getTimeUs();
+    saphBmeMeasurements_t measurements;
+    saphBme280_getMeasurements(&sensor, &measurements);
+    return sim_i2c_bus_getTimeUs() - startUs;
+}
+
+static void addLatency(sharingResult_t* result, uint32_t latencyUs) {
+    if (result->reads < latencyCapacity) {
+        latencies[result->reads] = latencyUs;
+    }
+    result->reads++;
+}
+
+// Moves the next read behind nowUs, returns how many due reads that skipped
+static uint32_t countMissed(uint32_t* nextSensorUs, uint32_t nowUs) {
+    uint32_t missed = 0;
+    for (*nextSensorUs += SENSOR_PERIOD_US; *nextSensorUs <= nowUs; *nextSensorUs += SENSOR_PERIOD_US) {
+        missed++;
+    }
+    return missed;
+}
+
+/* *
+ * The main loop of the firmware: a due sensor read goes first, otherwise one flush step, otherwise the next frame.
+ * The display always has a frame to send, so the bus never idles and the frame rate is the most it can do.
+ * */
+static bool runDirect(const sharingConfig_t* config, sharingResult_t* result) {
+    memset(result, 0, sizeof(sharingResult_t));
+    attachDevices();
+    saph_ssd1306_framebuffer_init(&framebuffer, &display, config->chunkSize == UNCHUNKED ?
+                                                          SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK : config->chunkSize);
+    uint32_t startUs = sim_i2c_bus_getTimeUs();
+    uint32_t nextSensorUs = startUs;
+    uint32_t nowUs = startUs;
+    while (nowUs - startUs < simulationUs) {
+        if (nowUs >= nextSensorUs) {
+            readSensor();
+            nowUs = sim_i2c_bus_getTimeUs();
+            addLatency(result, nowUs - nextSensorUs);
+            result->missedReads += countMissed(&nextSensorUs, nowUs);
+            continue;
+        }
+        int32_t outcome;
+        if (config->chunkSize == UNCHUNKED) {
+            drawFrame(result->frames);
+            outcome = flushUnchunked();
+        } else if (saph_ssd1306_framebuffer_isFlushing(&framebuffer)) {
+            outcome = saph_ssd1306_framebuffer_flushStep(&framebuffer);
+        } else {
+            drawFrame(result->frames);
+            outcome = saph_ssd1306_framebuffer_swap(&framebuffer);
+        }
+        if (outcome < 0) {
+            return false;
+        }
+        if (outcome == SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE) {
+            result->frames++;
+        }
+        nowUs = sim_i2c_bus_getTimeUs();
+    }
+    result->simulatedUs = nowUs - startUs;
+    finishResult(result);
+    return true;
+}
+
+/* *
+ * Both clients queue into the arbiter: a due sensor read at high priority, the framebuffer its flush at low priority
+ * in chunks of a whole row, which the arbiter cuts into its own chunk size. One arbiter step per loop.
+ * */
+static bool runQueued(const sharingConfig_t* config, sharingResult_t* result) {
+    memset(result, 0, sizeof(sharingResult_t));
+    attachDevices();
+    saph_ssd1306_framebuffer_init(&framebuffer, &display, config->chunkSize);
+    i2c_arbiter_init(&arbiter, config->arbiterChunkSize);
+    saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter);
+    static const uint8_t sensorRegister[1] = {SENSOR_DATA_REGISTER};
+    uint8_t sensorData[SENSOR_DATA_BYTES];
+    i2c_arbiter_request_t sensorRequest;
+    memset(&sensorRequest, 0, sizeof(sensorRequest));
+    uint32_t startUs = sim_i2c_bus_getTimeUs();
+    uint32_t nextSensorUs = startUs;
+    uint32_t sensorDueUs = startUs;
+    uint32_t nowUs = startUs;
+    while (nowUs - startUs < simulationUs) {
+        if (nowUs >= nextSensorUs && sensorRequest.state != I2C_ARBITER_STATE_QUEUED) {
+            i2c_arbiter_prepareWriteRead(&sensorRequest, SHARING_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH,
+                                         sensorRegister, 1, sensorData, SENSOR_DATA_BYTES);
+            if (i2c_arbiter_submit(&arbiter, &sensorRequest) != I2C_ARBITER_NO_ERROR) {
+                return false;
+            }
+            sensorDueUs = nextSensorUs;
+            result->missedReads += countMissed(&nextSensorUs, nowUs);
+        }
+        if (!saph_ssd1306_framebuffer_isFlushing(&framebuffer)) {
+            drawFrame(result->frames);
+            saph_ssd1306_framebuffer_swap(&framebuffer);
+        }
+        int32_t outcome = saph_ssd1306_framebuffer_flushStep(&framebuffer);
+        if (outcome < 0) {
+            return false;
+        }
+        if (outcome == SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE) {
+            result->frames++;
+        }
+        if (i2c_arbiter_step(&arbiter) < 0 || sensorRequest.state == I2C_ARBITER_STATE_FAILED) {
+            return false;
+        }
+        nowUs = sim_i2c_bus_getTimeUs();
+        if (sensorRequest.state == I2C_ARBITER_STATE_DONE) {
+            sensorRequest.state = I2C_ARBITER_STATE_IDLE;
+            addLatency(result, nowUs - sensorDueUs);
+        }
+    }
+    result->simulatedUs = nowUs - startUs;
+    finishResult(result);
+    return true;
+}
+
+static int compareUint32(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*) a;
+    uint32_t right = *(const uint32_t*) b;
+    return (left > right) - (left < right);
+}
+
+static void finishResult(sharingResult_t* result) {
+    uint32_t amount = result->reads < latencyCapacity ? result->reads : latencyCapacity;
+    if (amount == 0) {
+        return;
+    }
+    qsort(latencies, amount, sizeof(uint32_t), compareUint32);
+    result->p50Us = latencies[(amount - 1) / 2];
+    result->p99Us = latencies[(uint32_t) ((amount - 1) * 0.99)];
+    result->maxLatencyUs = latencies[amount - 1];
+}
+
+static void printResult(const sharingConfig_t* config, const sharingResult_t* result, uint32_t boundUs) {
+    double framesPerSecond = (double) result->frames * 1e6 / (double) result->simulatedUs;
+    printf("%-12s %10.2f %8" PRIu32 " %8" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 " %10" PRIu32 "\n",
+           config->name, framesPerSecond, result->reads, result->missedReads, result->p50Us, result->p99Us,
+           result->maxLatencyUs, boundUs);
+}
+
+// --quick simulates one second per configuration for CTest
+static bool parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            simulationUs = 1000000;
+            continue;
+        }
+        if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            long seconds = strtol(argv[++i], 0, 10);
+            if (seconds <= 0 || seconds > 3600) {
+                return false;
+            }
+            simulationUs = (uint32_t) seconds * 1000000;
+            continue;
+        }
+        return false;
+    }
+    return true;
+}
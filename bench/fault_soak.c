@@ -0,0 +1,274 @@
+//
+// Soak of the BME280 driver against the simulated sensor with random faults injected into its transactions.
+// Runs forced mode acquisition cycles for every fault profile in the table below and reports the throughput,
+// how long the driver takes to deliver again after a fault, and every sample that came out wrong.
+// Times are simulated: the bus time of sim_i2c_bus plus the conversion waits, so results do not depend on the host.
+//
+// Usage: fault_soak [--cycles N] [--seed N] [--quick]
+//
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+#define SOAK_SENSOR_ADDRESS 0x76
+#define SOAK_RAW_PRESSURE 283413
+#define SOAK_RAW_TEMPERATURE 523407
+#define SOAK_RAW_HUMIDITY 27999
+#define SOAK_MEASUREMENT_TIME_US 7600
+// More failed attempts in a row than this count as a driver that does not recover
+#define MAX_ATTEMPTS_PER_SAMPLE 16
+
+typedef struct faultProfile_t {
+    const char* name;
+    sim_bme280_faultRates_t rates;
+} faultProfile_t;
+
+typedef struct soakResult_t {
+    uint64_t attempts;
+    uint64_t samples;
+    uint64_t wrongSamples;
+    uint64_t simulatedUs;
+    uint32_t longestOutage;
+    uint32_t faults[SIM_BME280_AMOUNT_FAULT_KINDS];
+    uint32_t resetsBeforeRead;
+    double hostNsPerAttempt;
+    // Simulated time from the start of the first failed attempt to the end of the next good one, one per outage
+    uint32_t* recoveryUs;
+    uint32_t amountRecoveries;
+    uint32_t recoveryCapacity;
+} soakResult_t;
+
+// The first profile is the baseline the others are compared with
+static const faultProfile_t profiles[] = {
+        {"fault_free",      {0,     0,     0}},
+        {"nack_0.1%",       {1000,  0,     0}},
+        {"short_read_0.1%", {0,     1000,  0}},
+        {"reset_0.01%",     {0,     0,     100}},
+        {"field_mix",       {2000,  1000,  200}},
+        {"harsh_mix",       {20000, 10000, 2000}},
+};
+
+#define AMOUNT_PROFILES (sizeof(profiles) / sizeof(profiles[0]))
+
+static uint64_t cycles = 2000000;
+static uint32_t seed = 1;
+static sim_bme280_t simSensor;
+static saphBmeDevice_t device;
+static saphBmeMeasurements_t expected;
+static bool needsConfig;
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static void attachSensor(void);
+
+static int32_t acquire(saphBmeMeasurements_t* result, uint32_t* waitedUs);
+
+static bool runProfile(const faultProfile_t* profile, soakResult_t* soak);
+
+static void addRecovery(soakResult_t* soak, uint32_t recoveryUs);
+
+static int compareUint32(const void* a, const void* b);
+
+static double samplesPerSecond(const soakResult_t* soak);
+
+static void printResult(const faultProfile_t* profile, soakResult_t* soak, const soakResult_t* baseline);
+
+static bool parseArguments(int argc, char** argv);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int main(int argc, char** argv) {
+    if (!parseArguments(argc, argv)) {
+        fprintf(stderr, "Usage: %s [--cycles N] [--seed N] [--quick]\n", argv[0]);
+        return 2;
+    }
+    printf("%" PRIu64 " acquisition cycles per profile, seed %" PRIu32 "\n", cycles, seed);
+    printf("%-16s %8s %8s %8s %8s %10s %8s %10s %10s %10s %8s %9s\n", "profile", "nack", "short", "reset",
+           "silent", "samples/s", "degrade", "rec mean", "rec p99", "rec max", "outage", "ns/try");
+
+    bool allPassed = true;
+    soakResult_t results[AMOUNT_PROFILES];
+    memset(results, 0, sizeof(results));
+    for (uint32_t i = 0; i < AMOUNT_PROFILES; ++i) {
+        if (!runProfile(&profiles[i], &results[i])) {
+            allPassed = false;
+        }
+        printResult(&profiles[i], &results[i], &results[0]);
+        if (results[i].wrongSamples > results[i].resetsBeforeRead) {
+            printf("  %" PRIu64 " wrong samples, more than the %" PRIu32
+                   " resets between a pointer write and its read\n", results[i].wrongSamples,
+                   results[i].resetsBeforeRead);
+            allPassed = false;
+        }
+    }
+    for (uint32_t i = 0; i < AMOUNT_PROFILES; ++i) {
+        free(results[i].recoveryUs);
+    }
+    return allPassed ? 0 : 1;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static void attachSensor(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, SAPHBME280_CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, SOAK_RAW_PRESSURE, SOAK_RAW_TEMPERATURE, SOAK_RAW_HUMIDITY);
+    sim_bme280_setTiming(&simSensor, SOAK_MEASUREMENT_TIME_US, 0);
+    sim_bme280_attach(&simSensor, SOAK_SENSOR_ADDRESS);
+    saphBme280_init(SOAK_SENSOR_ADDRESS, &device);
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_setVerifyCommits(&device, true);
+    needsConfig = true;
+}
+
+/* *
+ * The recovery policy under test: every commit is verified, a verify mismatch or data registers at their reset
+ * value mean the sensor lost its configuration and everything gets rewritten. Anything else is retried as is.
+ * */
+static int32_t acquire(saphBmeMeasurements_t* result, uint32_t* waitedUs) {
+    *waitedUs = 0;
+    int32_t errorCode = needsConfig ? saphBme280_commitAllRegs(&device)
+                                    : saphBme280_triggerForcedMeasurement(&device);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        needsConfig = needsConfig || errorCode == SAPH_BME280_VERIFY_ERROR;
+        return errorCode;
+    }
+    needsConfig = false;
+    *waitedUs = saphBme280_getMeasurementTimeUs(&device);
+    sim_bme280_advanceTime(&simSensor, *waitedUs);
+    errorCode = saphBme280_getMeasurements(&device, result);
+    needsConfig = errorCode == SAPH_BME280_NO_MEASUREMENT_ERROR;
+    return errorCode;
+}
+
+static bool runProfile(const faultProfile_t* profile, soakResult_t* soak) {
+    attachSensor();
+    uint32_t waitedUs = 0;
+    if (acquire(&expected, &waitedUs) != SAPH_BME280_NO_ERROR) {
+        return false;
+    }
+    sim_bme280_setFaultRates(&simSensor, &profile->rates, seed);
+
+    uint32_t outage = 0;
+    uint64_t outageStartUs = 0;
+    struct timespec start;
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    while (soak->samples < cycles) {
+        uint64_t attemptStartUs = soak->simulatedUs;
+        uint32_t busStartUs = sim_i2c_bus_getTimeUs();
+        saphBmeMeasurements_t result;
+        int32_t errorCode = acquire(&result, &waitedUs);
+        soak->simulatedUs += (uint32_t) (sim_i2c_bus_getTimeUs() - busStartUs) + waitedUs;
+        soak->attempts++;
+        if (errorCode != SAPH_BME280_NO_ERROR) {
+            outageStartUs = outage == 0 ? attemptStartUs : outageStartUs;
+            if (++outage >= MAX_ATTEMPTS_PER_SAMPLE) {
+                printf("  %s: no sample after %u attempts, last error %" PRId32 "\n", profile->name, outage, errorCode);
+                return false;
+            }
+            continue;
+        }
+        if (outage > 0) {
+            addRecovery(soak, (uint32_t) (soak->simulatedUs - outageStartUs));
+            soak->longestOutage = outage > soak->longestOutage ? outage : soak->longestOutage;
+            outage = 0;
+        }
+        soak->samples++;
+        if (result.temperature != expected.temperature || result.pressure != expected.pressure ||
+            result.humidity != expected.humidity) {
+            soak->wrongSamples++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsedNs = (double) (end.tv_sec - start.tv_sec) * 1e9 + (double) (end.tv_nsec - start.tv_nsec);
+    soak->hostNsPerAttempt = elapsedNs / (double) soak->attempts;
+    memcpy(soak->faults, simSensor.injectedFaults, sizeof(soak->faults));
+    soak->resetsBeforeRead = simSensor.resetsBeforeRead;
+    return true;
+}
+
+static void addRecovery(soakResult_t* soak, uint32_t recoveryUs) {
+    if (soak->amountRecoveries == soak->recoveryCapacity) {
+        uint32_t capacity = soak->recoveryCapacity == 0 ? 1024 : 2 * soak->recoveryCapacity;
+        uint32_t* grown = realloc(soak->recoveryUs, capacity * sizeof(uint32_t));
+        if (grown == 0) {
+            return;
+        }
+        soak->recoveryUs = grown;
+        soak->recoveryCapacity = capacity;
+    }
+    soak->recoveryUs[soak->amountRecoveries++] = recoveryUs;
+}
+
+static int compareUint32(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*) a;
+    uint32_t right = *(const uint32_t*) b;
+    return (left > right) - (left < right);
+}
+
+static double samplesPerSecond(const soakResult_t* soak) {
+    return soak->simulatedUs == 0 ? 0.0 : (double) soak->samples * 1e6 / (double) soak->simulatedUs;
+}
+
+// Recovery times in us, the degradation is the loss of samples per simulated second against the baseline
+static void printResult(const faultProfile_t* profile, soakResult_t* soak, const soakResult_t* baseline) {
+    double rate = samplesPerSecond(soak);
+    double baselineRate = samplesPerSecond(baseline);
+    double degradation = baselineRate == 0.0 ? 0.0 : 100.0 * (1.0 - rate / baselineRate);
+    double meanUs = 0.0;
+    uint32_t p99Us = 0;
+    uint32_t maxUs = 0;
+    if (soak->amountRecoveries > 0) {
+        qsort(soak->recoveryUs, soak->amountRecoveries, sizeof(uint32_t), compareUint32);
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < soak->amountRecoveries; ++i) {
+            sum += soak->recoveryUs[i];
+        }
+        meanUs = (double) sum / soak->amountRecoveries;
+        p99Us = soak->recoveryUs[(uint32_t) ((soak->amountRecoveries - 1) * 0.99)];
+        maxUs = soak->recoveryUs[soak->amountRecoveries - 1];
+    }
+    printf("%-16s %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %8" PRIu64 " %10.2f %7.2f%% %10.0f %10" PRIu32 " %10" PRIu32
+           " %8" PRIu32 " %9.1f\n", profile->name, soak->faults[SIM_BME280_FAULT_NACK],
+           soak->faults[SIM_BME280_FAULT_SHORT_READ], soak->faults[SIM_BME280_FAULT_RESET], soak->wrongSamples, rate,
+           degradation, meanUs, p99Us, maxUs, soak->longestOutage, soak->hostNsPerAttempt);
+}
+
+// --quick runs 20000 cycles per profile for CTest
+static bool parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            cycles = 20000;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            return false;
+        }
+        unsigned long long value = strtoull(argv[i + 1], 0, 0);
+        if (strcmp(argv[i], "--cycles") == 0 && value > 0) {
+            cycles = value;
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed = (uint32_t) value;
+        } else {
+            return false;
+        }
+        i++;
+    }
+    return true;
+}
@@ -0,0 +1,123 @@
+//
+// Host benchmark runner, see saph_bench.h
+//
+
+#include "saph_bench.h"
+
+#include <stddef.h>
+#include <time.h>
+
+#include "sim_i2c_bus.h"
+
+volatile int64_t saph_bench_sink = 0;
+
+#ifdef SAPH_BENCH_COUNT_ALLOCATIONS
+// Linked with -Wl,--wrap, every allocation of the code under test passes through here
+static uint64_t allocations = 0;
+
+void* __real_malloc(size_t size);
+
+void* __real_calloc(size_t amount, size_t size);
+
+void* __real_realloc(void* pointer, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocations++;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t amount, size_t size) {
+    allocations++;
+    return __real_calloc(amount, size);
+}
+
+void* __wrap_realloc(void* pointer, size_t size) {
+    allocations++;
+    return __real_realloc(pointer, size);
+}
+#endif
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static uint64_t nowNs(void);
+
+static uint64_t timeOps(const saph_bench_case_t* benchCase, uint64_t amountOps);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+saph_bench_result_t saph_bench_run(const saph_bench_case_t* benchCase) {
+    saph_bench_result_t result = {benchCase->name, 0.0, 0, 0.0, 0.0, -1.0};
+
+    benchCase->setup();
+    sim_i2c_bus_clearStats();
+#ifdef SAPH_BENCH_COUNT_ALLOCATIONS
+    uint64_t allocationsBefore = allocations;
+#endif
+    for (uint32_t i = 0; i < SAPH_BENCH_COUNTED_OPS; ++i) {
+        benchCase->op(i);
+    }
+#ifdef SAPH_BENCH_COUNT_ALLOCATIONS
+    result.allocationsPerOp = (double) (allocations - allocationsBefore) / SAPH_BENCH_COUNTED_OPS;
+#endif
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    result.busTransfersPerOp = (double) (stats.writeTransactions + stats.readTransactions) / SAPH_BENCH_COUNTED_OPS;
+    result.busBytesPerOp = (double) (stats.bytesWritten + stats.bytesRead) / SAPH_BENCH_COUNTED_OPS;
+
+    // Doubles the batch until one repetition is long enough to time reliably
+    uint64_t amountOps = 1;
+    benchCase->setup();
+    while (timeOps(benchCase, amountOps) < SAPH_BENCH_MIN_REPETITION_NS) {
+        amountOps *= 2;
+    }
+    uint64_t fastestNs = UINT64_MAX;
+    for (uint8_t repetition = 0; repetition < SAPH_BENCH_REPETITIONS; ++repetition) {
+        benchCase->setup();
+        uint64_t elapsedNs = timeOps(benchCase, amountOps);
+        if (elapsedNs < fastestNs) {
+            fastestNs = elapsedNs;
+        }
+    }
+    result.timedOps = amountOps;
+    result.nsPerOp = (double) fastestNs / (double) amountOps;
+    return result;
+}
+
+void saph_bench_writeJson(FILE* output, const saph_bench_result_t* results, uint32_t amountResults) {
+    fprintf(output, "{\n  \"unit\": \"ns/op\",\n  \"benchmarks\": [\n");
+    for (uint32_t i = 0; i < amountResults; ++i) {
+        const saph_bench_result_t* result = &results[i];
+        fprintf(output, "    {\"name\": \"%s\", \"ns_per_op\": %.1f, \"timed_ops\": %llu, "
+                        "\"bus_transfers_per_op\": %.3f, \"bus_bytes_per_op\": %.3f, ",
+                result->name, result->nsPerOp, (unsigned long long) result->timedOps, result->busTransfersPerOp,
+                result->busBytesPerOp);
+        if (result->allocationsPerOp < 0) {
+            fprintf(output, "\"allocations_per_op\": null}");
+        } else {
+            fprintf(output, "\"allocations_per_op\": %.3f}", result->allocationsPerOp);
+        }
+        fprintf(output, i + 1 < amountResults ? ",\n" : "\n");
+    }
+    fprintf(output, "  ]\n}\n");
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static uint64_t nowNs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+static uint64_t timeOps(const saph_bench_case_t* benchCase, uint64_t amountOps) {
+    uint64_t startNs = nowNs();
+    for (uint64_t i = 0; i < amountOps; ++i) {
+        benchCase->op((uint32_t) i);
+    }
+    return nowNs() - startNs;
+}
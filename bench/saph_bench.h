@@ -0,0 +1,46 @@
+//
+// Minimal host benchmark runner: times each case, counts what it puts on the simulated bus and what it allocates,
+// and writes everything as JSON so two runs can be compared with compare_bench.py.
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_SAPH_BENCH_H
+#define SAPH_PICO_TEMPERATURE_SAPH_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Operations of the untimed pass the per operation counters are taken from
+#define SAPH_BENCH_COUNTED_OPS 1000
+// A repetition runs at least this long, the fastest repetition is reported
+#define SAPH_BENCH_MIN_REPETITION_NS 20000000ull
+#define SAPH_BENCH_REPETITIONS 5
+
+typedef void (* saph_bench_setup_t)(void);
+
+typedef void (* saph_bench_op_t)(uint32_t iteration);
+
+typedef struct saph_bench_case_t {
+    const char* name;
+    saph_bench_setup_t setup;
+    saph_bench_op_t op;
+} saph_bench_case_t;
+
+typedef struct saph_bench_result_t {
+    const char* name;
+    double nsPerOp;
+    uint64_t timedOps;
+    // Per operation over SAPH_BENCH_COUNTED_OPS, these do not depend on the machine
+    double busTransfersPerOp;
+    double busBytesPerOp;
+    // -1 when the build cannot count allocations
+    double allocationsPerOp;
+} saph_bench_result_t;
+
+// Keeps results alive so the compiler cannot drop the work of an operation
+extern volatile int64_t saph_bench_sink;
+
+saph_bench_result_t saph_bench_run(const saph_bench_case_t* benchCase);
+
+void saph_bench_writeJson(FILE* output, const saph_bench_result_t* results, uint32_t amountResults);
+
+#endif //SAPH_PICO_TEMPERATURE_SAPH_BENCH_H
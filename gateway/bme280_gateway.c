@@ -0,0 +1,152 @@
+//
+// Reads a BME280/BMP280 from a Linux gateway with the same drivers as the Pico, in forced mode once per interval.
+// Built against i2c_handler_linux.c and saph_hal_posix.c, or with SAPH_GATEWAY_SIMULATED against a simulated sensor.
+//
+// Usage: bme280_gateway [--bus N] [--address N] [--interval-ms N] [--samples N]
+//
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "i2c_handler.h"
+#include "saphBme280.h"
+#include "saph_hal.h"
+
+#ifdef SAPH_GATEWAY_SIMULATED
+#include "sim_hal.h"
+#include "sim_bme280.h"
+#endif
+
+// Only reported back on Linux, the kernel sets the clock
+#define GATEWAY_BAUDRATE 100000u
+
+static uint8_t bus = 1;
+static uint8_t address = 0x76;
+static uint32_t intervalMs = 1000;
+// 0 reads until the process is stopped
+static uint32_t samples = 0;
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static bool parseArguments(int argc, char** argv);
+
+static void printMeasurements(saphBmeDevice_t* device, const saphBmeMeasurements_t* measurements);
+
+#ifdef SAPH_GATEWAY_SIMULATED
+static void attachSimulatedSensor(void);
+#endif
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int main(int argc, char** argv) {
+    if (!parseArguments(argc, argv)) {
+        fprintf(stderr, "Usage: %s [--bus N] [--address N] [--interval-ms N] [--samples N]\n", argv[0]);
+        return 2;
+    }
+#ifdef SAPH_GATEWAY_SIMULATED
+    attachSimulatedSensor();
+#endif
+    i2c_handler_selectHwInstance(bus);
+    if (i2c_handler_initialise(GATEWAY_BAUDRATE) == 0) {
+        fprintf(stderr, "Cannot open /dev/i2c-%u\n", bus);
+        return 1;
+    }
+    saphBmeDevice_t device;
+    int32_t errorCode = saphBme280_init(address, &device);
+    if (errorCode == SAPH_BME280_NO_ERROR) {
+        saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_WEATHER_MONITORING);
+        errorCode = saphBme280_commitAllRegs(&device);
+    }
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        fprintf(stderr, "No BME280/BMP280 at 0x%02X on bus %u, error %" PRId32 "\n", address, bus, errorCode);
+        i2c_handler_disable();
+        return 1;
+    }
+
+    for (uint32_t i = 0; samples == 0 || i < samples; ++i) {
+        if (i > 0) {
+            saph_hal_delayUs(intervalMs * 1000u);
+        }
+        saphBmeMeasurements_t measurements;
+        errorCode = saphBme280_triggerForcedMeasurement(&device);
+        if (errorCode == SAPH_BME280_NO_ERROR) {
+            saph_hal_delayUs(saphBme280_getMeasurementTimeUs(&device));
+            errorCode = saphBme280_getMeasurements(&device, &measurements);
+        }
+        if (errorCode != SAPH_BME280_NO_ERROR) {
+            fprintf(stderr, "Sample %" PRIu32 " failed with error %" PRId32 "\n", i, errorCode);
+            continue;
+        }
+        printMeasurements(&device, &measurements);
+    }
+    i2c_handler_disable();
+    return 0;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static bool parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; i += 2) {
+        if (i + 1 >= argc) {
+            return false;
+        }
+        char* end = 0;
+        unsigned long value = strtoul(argv[i + 1], &end, 0);
+        if (*end != '\0') {
+            return false;
+        }
+        if (strcmp(argv[i], "--bus") == 0 && value <= UINT8_MAX) {
+            bus = (uint8_t) value;
+        } else if (strcmp(argv[i], "--address") == 0 && value <= 0x7F) {
+            address = (uint8_t) value;
+        } else if (strcmp(argv[i], "--interval-ms") == 0 && value <= UINT32_MAX / 1000u) {
+            intervalMs = (uint32_t) value;
+        } else if (strcmp(argv[i], "--samples") == 0 && value <= UINT32_MAX) {
+            samples = (uint32_t) value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Seconds of saph_hal_getTimeUs, centi degC, Q24.8 Pa and Q22.10 %RH as plain decimals
+static void printMeasurements(saphBmeDevice_t* device, const saphBmeMeasurements_t* measurements) {
+    int32_t temperature = measurements->temperature;
+    uint32_t pascal = measurements->pressure / 256u;
+    printf("%.3f %s%" PRId32 ".%02" PRId32 " degC %" PRIu32 ".%02" PRIu32 " hPa",
+           saph_hal_getTimeUs() / 1e6, temperature < 0 ? "-" : "", abs(temperature) / 100, abs(temperature) % 100,
+           pascal / 100u, pascal % 100u);
+    if (saphBme280_hasHumidity(device)) {
+        uint32_t milliPercent = (uint32_t) (((uint64_t) measurements->humidity * 1000u) / 1024u);
+        printf(" %" PRIu32 ".%03" PRIu32 " %%RH", milliPercent / 1000u, milliPercent % 1000u);
+    }
+    printf("\n");
+    fflush(stdout);
+}
+
+#ifdef SAPH_GATEWAY_SIMULATED
+static sim_bme280_t simSensor;
+
+static void advanceSensor(void* context, uint32_t delayUs) {
+    sim_bme280_advanceTime((sim_bme280_t*) context, delayUs);
+}
+
+// About 22 degC, 1022 hPa and 39 %RH with the reference trimming values, converting in 7.6 ms
+static void attachSimulatedSensor(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, SAPHBME280_CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_setTiming(&simSensor, 7600, 0);
+    sim_bme280_attach(&simSensor, address);
+    sim_hal_setDelayHandler(advanceSensor, &simSensor);
+}
+#endif
@@ -0,0 +1,190 @@
+#include "i2c_arbiter.h"
+
+#include "i2c_handler.h"
+#include <string.h>
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static i2c_arbiter_request_t* pickRequest(i2c_arbiter_t* arbiter);
+
+static void finishRequest(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request, int32_t result);
+
+static bool isChunked(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request);
+
+static int32_t writeChunk(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t i2c_arbiter_init(i2c_arbiter_t* arbiter, uint16_t chunkSize) {
+    if (arbiter == 0) {
+        return I2C_ARBITER_NULL_POINTER_ERROR;
+    }
+    if (chunkSize > I2C_ARBITER_MAX_CHUNK) {
+        return I2C_ARBITER_INVALID_CONFIG_ERROR;
+    }
+    memset(arbiter, 0, sizeof(i2c_arbiter_t));
+    arbiter->chunkSize = chunkSize;
+    return I2C_ARBITER_NO_ERROR;
+}
+
+void i2c_arbiter_prepareWrite(i2c_arbiter_request_t* request, uint8_t address, uint8_t priority,
+                              const uint8_t* buffer, uint32_t amount, uint8_t prefixLength) {
+    i2c_arbiter_prepareWriteRead(request, address, priority, buffer, amount, 0, 0);
+    if (request != 0) {
+        request->prefixLength = prefixLength;
+    }
+}
+
+// E.g. the register address of a BME280 followed by the burst read starting there
+void i2c_arbiter_prepareWriteRead(i2c_arbiter_request_t* request, uint8_t address, uint8_t priority,
+                                  const uint8_t* writeBuffer, uint32_t writeAmount,
+                                  uint8_t* readBuffer, uint32_t readAmount) {
+    if (request == 0) {
+        return;
+    }
+    memset(request, 0, sizeof(i2c_arbiter_request_t));
+    request->address = address;
+    request->priority = priority;
+    request->writeBuffer = writeBuffer;
+    request->writeAmount = writeAmount;
+    request->readBuffer = readBuffer;
+    request->readAmount = readAmount;
+}
+
+int32_t i2c_arbiter_submit(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request) {
+    if (arbiter == 0 || request == 0) {
+        return I2C_ARBITER_NULL_POINTER_ERROR;
+    }
+    if (request->state == I2C_ARBITER_STATE_QUEUED) {
+        return I2C_ARBITER_BUSY_ERROR;
+    }
+    if (request->priority >= I2C_ARBITER_AMOUNT_PRIORITIES || request->prefixLength > I2C_ARBITER_MAX_PREFIX ||
+        request->prefixLength > request->writeAmount ||
+        (request->writeAmount > 0 && request->writeBuffer == 0) ||
+        (request->readAmount > 0 && request->readBuffer == 0)) {
+        return I2C_ARBITER_INVALID_CONFIG_ERROR;
+    }
+    request->state = I2C_ARBITER_STATE_QUEUED;
+    request->result = I2C_ARBITER_NO_ERROR;
+    request->written = 0;
+    request->next = 0;
+    uint8_t priority = request->priority;
+    if (arbiter->tails[priority] == 0) {
+        arbiter->heads[priority] = request;
+    } else {
+        arbiter->tails[priority]->next = request;
+    }
+    arbiter->tails[priority] = request;
+    return I2C_ARBITER_NO_ERROR;
+}
+
+/* *
+ * Runs one transfer: a chunk of a long low priority write, or a whole request otherwise. A write and the read
+ * after it count as one transfer, nothing else gets between them. Returns I2C_ARBITER_TRANSFERRED,
+ * I2C_ARBITER_IDLE if nothing was queued, or the error of a failed transfer, which also fails its request.
+ * */
+int32_t i2c_arbiter_step(i2c_arbiter_t* arbiter) {
+    if (arbiter == 0) {
+        return I2C_ARBITER_NULL_POINTER_ERROR;
+    }
+    i2c_arbiter_request_t* request = pickRequest(arbiter);
+    if (request == 0) {
+        return I2C_ARBITER_IDLE;
+    }
+    arbiter->transfers++;
+    if (isChunked(arbiter, request)) {
+        int32_t commResult = writeChunk(arbiter, request);
+        if (commResult < 0) {
+            finishRequest(arbiter, request, commResult);
+            return commResult;
+        }
+        if (request->written == request->writeAmount) {
+            finishRequest(arbiter, request, I2C_ARBITER_NO_ERROR);
+        }
+        return I2C_ARBITER_TRANSFERRED;
+    }
+    int32_t commResult = 0;
+    i2c_handler_lock();
+    if (request->writeAmount > 0) {
+        commResult = i2c_handler_write(request->address, (uint8_t*) request->writeBuffer, request->writeAmount);
+        if (commResult >= 0 && (uint32_t) commResult != request->writeAmount) {
+            commResult = I2C_ARBITER_COMM_ERROR_WRITE_AMOUNT;
+        }
+    }
+    if (commResult >= 0 && request->readAmount > 0) {
+        commResult = i2c_handler_read(request->address, request->readBuffer, request->readAmount);
+        if (commResult >= 0 && (uint32_t) commResult != request->readAmount) {
+            commResult = I2C_ARBITER_COMM_ERROR_READ_AMOUNT;
+        }
+    }
+    i2c_handler_unlock();
+    finishRequest(arbiter, request, commResult < 0 ? commResult : I2C_ARBITER_NO_ERROR);
+    return commResult < 0 ? commResult : I2C_ARBITER_TRANSFERRED;
+}
+
+bool i2c_arbiter_isIdle(i2c_arbiter_t* arbiter) {
+    if (arbiter == 0) {
+        return true;
+    }
+    for (uint8_t priority = 0; priority < I2C_ARBITER_AMOUNT_PRIORITIES; ++priority) {
+        if (arbiter->heads[priority] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static i2c_arbiter_request_t* pickRequest(i2c_arbiter_t* arbiter) {
+    for (uint8_t priority = 0; priority < I2C_ARBITER_AMOUNT_PRIORITIES; ++priority) {
+        if (arbiter->heads[priority] != 0) {
+            return arbiter->heads[priority];
+        }
+    }
+    return 0;
+}
+
+// Only ever the head of its queue
+static void finishRequest(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request, int32_t result) {
+    uint8_t priority = request->priority;
+    arbiter->heads[priority] = request->next;
+    if (arbiter->heads[priority] == 0) {
+        arbiter->tails[priority] = 0;
+    }
+    request->next = 0;
+    request->result = result;
+    request->state = result < 0 ? I2C_ARBITER_STATE_FAILED : I2C_ARBITER_STATE_DONE;
+}
+
+// A write that started in chunks goes on in chunks
+static bool isChunked(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request) {
+    return request->priority != I2C_ARBITER_PRIORITY_HIGH && arbiter->chunkSize > 0 && request->readAmount == 0 &&
+           (request->written > 0 || request->writeAmount - request->prefixLength > arbiter->chunkSize);
+}
+
+// The prefix and up to chunkSize of the bytes after it, a chunk that didn't go out whole fails the request
+static int32_t writeChunk(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request) {
+    uint8_t prefixLength = request->prefixLength;
+    if (request->written == 0) {
+        request->written = prefixLength;
+    }
+    uint32_t left = request->writeAmount - request->written;
+    uint32_t payload = left < arbiter->chunkSize ? left : arbiter->chunkSize;
+    memcpy(arbiter->chunkBuffer, request->writeBuffer, prefixLength);
+    memcpy(arbiter->chunkBuffer + prefixLength, request->writeBuffer + request->written, payload);
+    int32_t commResult = i2c_handler_write(request->address, arbiter->chunkBuffer, prefixLength + payload);
+    if (commResult < 0) {
+        return commResult;
+    } else if ((uint32_t) commResult != prefixLength + payload) {
+        return I2C_ARBITER_COMM_ERROR_WRITE_AMOUNT;
+    }
+    request->written += payload;
+    return commResult;
+}
@@ -0,0 +1,78 @@
+#ifndef SAPH_PICO_TEMPERATURE_I2C_ARBITER_H
+#define SAPH_PICO_TEMPERATURE_I2C_ARBITER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_ARBITER_NO_ERROR 0
+#define I2C_ARBITER_COMM_ERROR_WRITE_AMOUNT -11
+#define I2C_ARBITER_COMM_ERROR_READ_AMOUNT -12
+#define I2C_ARBITER_NULL_POINTER_ERROR -20
+#define I2C_ARBITER_INVALID_CONFIG_ERROR -43
+#define I2C_ARBITER_BUSY_ERROR -47
+
+// Positive results of i2c_arbiter_step
+#define I2C_ARBITER_IDLE 0
+#define I2C_ARBITER_TRANSFERRED 1
+
+#define I2C_ARBITER_PRIORITY_HIGH 0
+#define I2C_ARBITER_PRIORITY_LOW 1
+#define I2C_ARBITER_AMOUNT_PRIORITIES 2
+
+#define I2C_ARBITER_STATE_IDLE 0
+#define I2C_ARBITER_STATE_QUEUED 1
+#define I2C_ARBITER_STATE_DONE 2
+#define I2C_ARBITER_STATE_FAILED 3
+
+#define I2C_ARBITER_MAX_CHUNK 64
+#define I2C_ARBITER_MAX_PREFIX 4
+
+/* *
+ * One transaction of a client: an optional write followed by an optional read of the same device.
+ * The request and its buffers belong to the client and have to stay valid until the state is DONE or FAILED.
+ * */
+typedef struct i2c_arbiter_request_t {
+    uint8_t address;
+    uint8_t priority;
+    const uint8_t* writeBuffer;
+    uint32_t writeAmount;
+    uint8_t* readBuffer;
+    uint32_t readAmount;
+    // Bytes sent again at the start of every chunk, e.g. the SSD1306 control byte of a data write
+    uint8_t prefixLength;
+    uint8_t state;
+    // Error code of the failed transfer, a transfer cut short fails with I2C_ARBITER_COMM_ERROR_*_AMOUNT
+    int32_t result;
+    uint32_t written;
+    struct i2c_arbiter_request_t* next;
+} i2c_arbiter_request_t;
+
+/* *
+ * Queues transactions per priority and runs one bus transfer per step, always from the highest priority queue
+ * that has work. Low priority writes longer than chunkSize go out in chunks, so a high priority request waits
+ * for at most one chunk besides the other high priority requests. A chunk size of 0 sends everything whole.
+ * */
+typedef struct i2c_arbiter_t {
+    i2c_arbiter_request_t* heads[I2C_ARBITER_AMOUNT_PRIORITIES];
+    i2c_arbiter_request_t* tails[I2C_ARBITER_AMOUNT_PRIORITIES];
+    uint16_t chunkSize;
+    uint8_t chunkBuffer[I2C_ARBITER_MAX_PREFIX + I2C_ARBITER_MAX_CHUNK];
+    uint32_t transfers;
+} i2c_arbiter_t;
+
+int32_t i2c_arbiter_init(i2c_arbiter_t* arbiter, uint16_t chunkSize);
+
+void i2c_arbiter_prepareWrite(i2c_arbiter_request_t* request, uint8_t address, uint8_t priority,
+                              const uint8_t* buffer, uint32_t amount, uint8_t prefixLength);
+
+void i2c_arbiter_prepareWriteRead(i2c_arbiter_request_t* request, uint8_t address, uint8_t priority,
+                                  const uint8_t* writeBuffer, uint32_t writeAmount,
+                                  uint8_t* readBuffer, uint32_t readAmount);
+
+int32_t i2c_arbiter_submit(i2c_arbiter_t* arbiter, i2c_arbiter_request_t* request);
+
+int32_t i2c_arbiter_step(i2c_arbiter_t* arbiter);
+
+bool i2c_arbiter_isIdle(i2c_arbiter_t* arbiter);
+
+#endif //SAPH_PICO_TEMPERATURE_I2C_ARBITER_H
@@ -6,13 +6,35 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "pico/mutex.h"
 
 #include "i2c_handler.h"
+#ifndef SAPH_NO_PRINTF
 #include <stdio.h>
+#endif
+#include <string.h>
+
+#define AMOUNT_HW_INSTANCES 2
+
+// One lock per hardware instance, only the core holding it touches the depth, the start time and the stats
+typedef struct busLock_t {
+    recursive_mutex_t* mutex;
+    uint32_t depth;
+    uint32_t lockedAtUs;
+    i2c_handler_lockStats_t stats;
+} busLock_t;
+
+auto_init_recursive_mutex(busMutex0);
+auto_init_recursive_mutex(busMutex1);
 
 static i2c_inst_t* selectedI2CInstance = i2c0;
+static uint8_t selectedIndex = 0;
+static busLock_t busLocks[AMOUNT_HW_INSTANCES] = {{.mutex = &busMutex0}, {.mutex = &busMutex1}};
+static i2c_trace_t* recordingTrace = 0;
 
+#ifndef SAPH_NO_PRINTF
 static bool isAddressReserved(uint8_t addr);
+#endif
 
 uint32_t i2c_handler_initialise(uint32_t baudrate) {
     gpio_set_function(4, GPIO_FUNC_I2C);
@@ -33,9 +55,11 @@ int32_t i2c_handler_selectHwInstance(uint8_t device_num) {
     switch (device_num) {
         case 0:
             selectedI2CInstance = i2c0;
+            selectedIndex = 0;
             break;
         case 1:
             selectedI2CInstance = i2c1;
+            selectedIndex = 1;
             break;
         default:
             result = -1;
@@ -49,15 +73,76 @@ uint32_t i2c_handler_set_baudrate(uint32_t baudrate) {
 }
 
 int32_t i2c_handler_write(uint8_t addr, uint8_t* buffer, uint32_t amount) {
-    return i2c_write_blocking(selectedI2CInstance, addr, buffer, amount, false);
+    i2c_handler_lock();
+    int32_t result = i2c_write_blocking(selectedI2CInstance, addr, buffer, amount, false);
+    if (recordingTrace != 0) {
+        i2c_trace_record(recordingTrace, time_us_32(), addr, false, buffer, amount, result);
+    }
+    i2c_handler_unlock();
+    return result;
 }
 
 int32_t i2c_handler_read(uint8_t addr, uint8_t* buffer, uint32_t amount) {
+    i2c_handler_lock();
     int32_t result = i2c_read_blocking(selectedI2CInstance, addr, buffer, amount, false);
+    if (recordingTrace != 0) {
+        i2c_trace_record(recordingTrace, time_us_32(), addr, true, buffer, amount, result);
+    }
+    i2c_handler_unlock();
     return result;
 }
 
+/* *
+ * Takes the selected bus for the calling core, e.g. around a register pointer write and its read.
+ * Nests, only the outermost unlock frees the bus. Select the hardware instance before both cores start.
+ * */
+void i2c_handler_lock(void) {
+    busLock_t* lock = &busLocks[selectedIndex];
+    uint32_t owner;
+    if (!recursive_mutex_try_enter(lock->mutex, &owner)) {
+        recursive_mutex_enter_blocking(lock->mutex);
+        lock->stats.contended++;
+    }
+    if (lock->depth++ == 0) {
+        lock->stats.acquisitions++;
+        lock->lockedAtUs = time_us_32();
+    }
+}
+
+void i2c_handler_unlock(void) {
+    busLock_t* lock = &busLocks[selectedIndex];
+    if (--lock->depth == 0) {
+        uint32_t heldUs = time_us_32() - lock->lockedAtUs;
+        lock->stats.totalHoldUs += heldUs;
+        lock->stats.maxHoldUs = heldUs > lock->stats.maxHoldUs ? heldUs : lock->stats.maxHoldUs;
+    }
+    recursive_mutex_exit(lock->mutex);
+}
+
+// Of the selected bus, taken under its lock so the counters belong together
+i2c_handler_lockStats_t i2c_handler_getLockStats(void) {
+    i2c_handler_lock();
+    i2c_handler_lockStats_t stats = busLocks[selectedIndex].stats;
+    i2c_handler_unlock();
+    return stats;
+}
+
+void i2c_handler_clearLockStats(void) {
+    i2c_handler_lock();
+    busLock_t* lock = &busLocks[selectedIndex];
+    memset(&lock->stats, 0, sizeof(i2c_handler_lockStats_t));
+    // Only the rest of this very hold gets booked, without counting it as an acquisition
+    lock->lockedAtUs = time_us_32();
+    i2c_handler_unlock();
+}
+
+void i2c_handler_setTrace(i2c_trace_t* trace) {
+    recordingTrace = trace;
+}
+
+// Prints the scan to stdout, a build with SAPH_NO_PRINTF keeps the function but drops the scan
 void i2c_handler_scanForDevices(void) {
+#ifndef SAPH_NO_PRINTF
     printf("\nI2C Bus Scan\n");
     printf("   0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F\n");
     int8_t isCurrentDeviceThere = 0;
@@ -74,8 +159,11 @@ void i2c_handler_scanForDevices(void) {
         printf(isCurrentDeviceThere < 0 ? "." : "@");
         printf(i % 16 == 15 ? "\n" : "  ");
     }
+#endif
 }
 
+#ifndef SAPH_NO_PRINTF
 static bool isAddressReserved(uint8_t addr) {
     return (addr & 0x78) == 0 || (addr & 0x78) == 0x78;
 }
+#endif
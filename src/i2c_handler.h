@@ -6,6 +6,16 @@
 #define SAPH_PICO_TEMPERATURE_I2C_HANDLER_H
 
 #include <stdint.h>
+#include "i2c_trace.h"
+
+// Use of a bus lock since the last clear, times in us
+typedef struct i2c_handler_lockStats_t {
+    uint32_t acquisitions;
+    // Acquisitions that had to wait for the other core
+    uint32_t contended;
+    uint32_t maxHoldUs;
+    uint64_t totalHoldUs;
+} i2c_handler_lockStats_t;
 
 uint32_t i2c_handler_initialise(uint32_t baudrate);
 
@@ -24,4 +34,16 @@ int32_t i2c_handler_read(uint8_t addr, uint8_t* buffer, uint32_t amount);
 
 void i2c_handler_scanForDevices(void);
 
+// Every transaction takes the bus lock by itself, sequences that must not be split take it around themselves
+void i2c_handler_lock(void);
+
+void i2c_handler_unlock(void);
+
+i2c_handler_lockStats_t i2c_handler_getLockStats(void);
+
+void i2c_handler_clearLockStats(void);
+
+// Records every transaction into the trace from then on, 0 stops recording
+void i2c_handler_setTrace(i2c_trace_t* trace);
+
 #endif //SAPH_PICO_TEMPERATURE_I2C_HANDLER_H
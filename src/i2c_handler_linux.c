@@ -0,0 +1,186 @@
+//
+// i2c_handler.h on Linux through i2c-dev, so the drivers run on a gateway with the sensor on e.g. /dev/i2c-1.
+// Needs the i2c-dev module and read/write access to the device node. Times come from saph_hal_posix.c.
+//
+
+// Recursive mutexes also with -std=c11
+#define _XOPEN_SOURCE 700
+
+#include "i2c_handler.h"
+#include "saph_hal.h"
+
+#include <fcntl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// PICO_ERROR_GENERIC, what the drivers get from the Pico SDK when nobody acknowledges the address
+#define LINUX_I2C_ERROR -1
+// The bus on the header of a Raspberry Pi
+#define DEFAULT_BUS 1
+
+static uint8_t selectedBus = DEFAULT_BUS;
+static int busFd = -1;
+static i2c_trace_t* recordingTrace = 0;
+// One bus open at a time, only the thread holding the lock touches the depth and the stats
+static pthread_once_t lockOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t busLock;
+static uint32_t lockDepth = 0;
+static uint32_t lockedAtUs = 0;
+static i2c_handler_lockStats_t lockStats;
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static int32_t transfer(uint8_t addr, uint8_t* buffer, uint32_t amount, bool isRead);
+
+static void initLock(void);
+
+#ifndef SAPH_NO_PRINTF
+static bool isAddressReserved(uint8_t addr);
+#endif
+
+// ###############################################
+// Implementations
+// ###############################################
+
+// Opens /dev/i2c-<selected bus> and returns the baudrate, or 0 if the node cannot be opened
+uint32_t i2c_handler_initialise(uint32_t baudrate) {
+    char path[sizeof("/dev/i2c-255")];
+    snprintf(path, sizeof(path), "/dev/i2c-%u", selectedBus);
+    i2c_handler_disable();
+    busFd = open(path, O_RDWR);
+    return busFd < 0 ? 0 : baudrate;
+}
+
+void i2c_handler_disable(void) {
+    if (busFd >= 0) {
+        close(busFd);
+        busFd = -1;
+    }
+}
+
+// Any bus number the kernel knows, it is opened by the next i2c_handler_initialise
+int32_t i2c_handler_selectHwInstance(uint8_t device_num) {
+    selectedBus = device_num;
+    return 0;
+}
+
+// The clock is fixed by the kernel, e.g. dtparam=i2c_arm_baudrate on a Raspberry Pi, so nothing is set
+uint32_t i2c_handler_set_baudrate(uint32_t baudrate) {
+    (void) baudrate;
+    return 0;
+}
+
+int32_t i2c_handler_write(uint8_t addr, uint8_t* buffer, uint32_t amount) {
+    i2c_handler_lock();
+    int32_t result = transfer(addr, buffer, amount, false);
+    if (recordingTrace != 0) {
+        i2c_trace_record(recordingTrace, saph_hal_getTimeUs(), addr, false, buffer, amount, result);
+    }
+    i2c_handler_unlock();
+    return result;
+}
+
+int32_t i2c_handler_read(uint8_t addr, uint8_t* buffer, uint32_t amount) {
+    i2c_handler_lock();
+    int32_t result = transfer(addr, buffer, amount, true);
+    if (recordingTrace != 0) {
+        i2c_trace_record(recordingTrace, saph_hal_getTimeUs(), addr, true, buffer, amount, result);
+    }
+    i2c_handler_unlock();
+    return result;
+}
+
+void i2c_handler_lock(void) {
+    pthread_once(&lockOnce, initLock);
+    if (pthread_mutex_trylock(&busLock) != 0) {
+        pthread_mutex_lock(&busLock);
+        lockStats.contended++;
+    }
+    if (lockDepth++ == 0) {
+        lockStats.acquisitions++;
+        lockedAtUs = saph_hal_getTimeUs();
+    }
+}
+
+void i2c_handler_unlock(void) {
+    if (--lockDepth == 0) {
+        uint32_t heldUs = saph_hal_getTimeUs() - lockedAtUs;
+        lockStats.totalHoldUs += heldUs;
+        lockStats.maxHoldUs = heldUs > lockStats.maxHoldUs ? heldUs : lockStats.maxHoldUs;
+    }
+    pthread_mutex_unlock(&busLock);
+}
+
+i2c_handler_lockStats_t i2c_handler_getLockStats(void) {
+    i2c_handler_lock();
+    i2c_handler_lockStats_t result = lockStats;
+    i2c_handler_unlock();
+    return result;
+}
+
+void i2c_handler_clearLockStats(void) {
+    i2c_handler_lock();
+    memset(&lockStats, 0, sizeof(lockStats));
+    lockedAtUs = saph_hal_getTimeUs();
+    i2c_handler_unlock();
+}
+
+void i2c_handler_setTrace(i2c_trace_t* trace) {
+    recordingTrace = trace;
+}
+
+// Same table as on the Pico, a build with SAPH_NO_PRINTF keeps the function but drops the scan
+void i2c_handler_scanForDevices(void) {
+#ifndef SAPH_NO_PRINTF
+    printf("\nI2C Bus Scan\n");
+    printf("   0  1  2  3  4  5  6  7  8  9  A  B  C  D  E  F\n");
+    uint8_t buffer;
+    for (uint8_t i = 0; i < 128; ++i) {
+        if (i % 16 == 0) {
+            printf("%02x ", i);
+        }
+        bool isThere = !isAddressReserved(i) && i2c_handler_read(i, &buffer, 1) >= 0;
+        printf(isThere ? "@" : ".");
+        printf(i % 16 == 15 ? "\n" : "  ");
+    }
+#endif
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+// One message per transaction with a stop at its end, like the blocking calls of the Pico SDK
+static int32_t transfer(uint8_t addr, uint8_t* buffer, uint32_t amount, bool isRead) {
+    if (busFd < 0 || amount > UINT16_MAX) {
+        return LINUX_I2C_ERROR;
+    }
+    struct i2c_msg message = {.addr = addr, .flags = isRead ? I2C_M_RD : 0, .len = (uint16_t) amount, .buf = buffer};
+    struct i2c_rdwr_ioctl_data transaction = {.msgs = &message, .nmsgs = 1};
+    if (ioctl(busFd, I2C_RDWR, &transaction) < 0) {
+        return LINUX_I2C_ERROR;
+    }
+    return (int32_t) amount;
+}
+
+static void initLock(void) {
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&busLock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
+
+#ifndef SAPH_NO_PRINTF
+static bool isAddressReserved(uint8_t addr) {
+    return (addr & 0x78) == 0 || (addr & 0x78) == 0x78;
+}
+#endif
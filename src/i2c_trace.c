@@ -0,0 +1,400 @@
+#include "i2c_trace.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define READ_BIT 0x80
+#define ADDRESS_MASK 0x7F
+// Time, address, direction and a result of -2147483648, each followed by a space
+#define MAX_HEADER_LENGTH 30
+
+static const char hexDigits[] = "0123456789ABCDEF";
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static void putByte(i2c_trace_t* trace, uint32_t* position, uint8_t value);
+
+static uint8_t getByte(i2c_trace_t* trace, uint32_t* position);
+
+static void putVarint(i2c_trace_t* trace, uint32_t* position, uint32_t value);
+
+static uint32_t getVarint(i2c_trace_t* trace, uint32_t* position);
+
+static uint32_t varintSize(uint32_t value);
+
+static uint32_t zigzag(int32_t value);
+
+static int32_t unzigzag(uint32_t value);
+
+static void evictOldest(i2c_trace_t* trace);
+
+static char* putDecimal(char* next, uint32_t value);
+
+static int32_t hexValue(char digit);
+
+static bool takeRecord(i2c_trace_replay_t* replay, uint8_t address, bool isRead);
+
+static void countMismatch(i2c_trace_replay_t* replay);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t i2c_trace_init(i2c_trace_t* trace, uint8_t* buffer, uint32_t size) {
+    if (trace == 0 || buffer == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    if (size < I2C_TRACE_MAX_RECORD_SIZE) {
+        return I2C_TRACE_INVALID_CONFIG_ERROR;
+    }
+    memset(trace, 0, sizeof(i2c_trace_t));
+    trace->buffer = buffer;
+    trace->size = size;
+    return I2C_TRACE_NO_ERROR;
+}
+
+void i2c_trace_clear(i2c_trace_t* trace) {
+    if (trace == 0) {
+        return;
+    }
+    trace->tail = 0;
+    trace->used = 0;
+    trace->amountRecords = 0;
+    trace->recorded = 0;
+    trace->evicted = 0;
+}
+
+/* *
+ * Keeps what went over the bus: the bytes of a write, the bytes read back by a successful read.
+ * Evicts the oldest records until the new one fits. Times are microseconds of a free running 32 bit clock.
+ * */
+int32_t i2c_trace_record(i2c_trace_t* trace, uint32_t timeUs, uint8_t address, bool isRead, const uint8_t* data,
+                         uint32_t amount, int32_t result) {
+    if (trace == 0 || (data == 0 && amount > 0)) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    uint32_t length = amount;
+    if (isRead) {
+        length = result <= 0 ? 0 : ((uint32_t) result < amount ? (uint32_t) result : amount);
+    }
+    length = length > I2C_TRACE_MAX_DATA ? I2C_TRACE_MAX_DATA : length;
+    uint32_t deltaUs = trace->amountRecords == 0 ? 0 : timeUs - trace->newestTimeUs;
+    uint32_t recordSize = 1 + varintSize(deltaUs) + varintSize(zigzag(result)) + varintSize(length) + length;
+    while (trace->size - trace->used < recordSize) {
+        evictOldest(trace);
+    }
+    if (trace->amountRecords == 0) {
+        trace->oldestTimeUs = timeUs;
+    }
+    uint32_t position = (trace->tail + trace->used) % trace->size;
+    putByte(trace, &position, (uint8_t) ((address & ADDRESS_MASK) | (isRead ? READ_BIT : 0)));
+    putVarint(trace, &position, deltaUs);
+    putVarint(trace, &position, zigzag(result));
+    putVarint(trace, &position, length);
+    for (uint32_t i = 0; i < length; ++i) {
+        putByte(trace, &position, data[i]);
+    }
+    trace->used += recordSize;
+    trace->amountRecords++;
+    trace->newestTimeUs = timeUs;
+    trace->recorded++;
+    return I2C_TRACE_NO_ERROR;
+}
+
+int32_t i2c_trace_first(i2c_trace_t* trace, i2c_trace_cursor_t* cursor) {
+    if (trace == 0 || cursor == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    cursor->position = trace->tail;
+    cursor->remaining = trace->amountRecords;
+    cursor->timeUs = trace->oldestTimeUs;
+    cursor->started = false;
+    return I2C_TRACE_NO_ERROR;
+}
+
+// Returns I2C_TRACE_RECORD with record filled in, I2C_TRACE_END after the newest record or a negative error code
+int32_t i2c_trace_next(i2c_trace_t* trace, i2c_trace_cursor_t* cursor, i2c_trace_record_t* record) {
+    if (trace == 0 || cursor == 0 || record == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    if (cursor->remaining == 0) {
+        return I2C_TRACE_END;
+    }
+    uint8_t header = getByte(trace, &cursor->position);
+    uint32_t deltaUs = getVarint(trace, &cursor->position);
+    // The oldest record stores the delta to a record that may be evicted already
+    if (cursor->started) {
+        cursor->timeUs += deltaUs;
+    }
+    cursor->started = true;
+    record->timeUs = cursor->timeUs;
+    record->address = header & ADDRESS_MASK;
+    record->isRead = (header & READ_BIT) != 0;
+    record->result = unzigzag(getVarint(trace, &cursor->position));
+    record->length = (uint16_t) getVarint(trace, &cursor->position);
+    for (uint16_t i = 0; i < record->length; ++i) {
+        record->data[i] = getByte(trace, &cursor->position);
+    }
+    cursor->remaining--;
+    return I2C_TRACE_RECORD;
+}
+
+/* *
+ * One line per record: time in us, address in hex, R or W, result and the data as hex, "-" for none.
+ * E.g. "1200 76 W 1 F7" and "1290 76 R 8 5183A07FB0006D5F". Returns the length of the line or a negative error code.
+ * */
+int32_t i2c_trace_formatRecord(const i2c_trace_record_t* record, char* line, uint32_t lineSize) {
+    if (record == 0 || line == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    // Formatted by hand so dumping a trace on the board does not pull in printf
+    char header[MAX_HEADER_LENGTH];
+    char* next = putDecimal(header, record->timeUs);
+    *next++ = ' ';
+    *next++ = hexDigits[(record->address >> 4) & 0x0F];
+    *next++ = hexDigits[record->address & 0x0F];
+    *next++ = ' ';
+    *next++ = record->isRead ? 'R' : 'W';
+    *next++ = ' ';
+    if (record->result < 0) {
+        *next++ = '-';
+        next = putDecimal(next, 0u - (uint32_t) record->result);
+    } else {
+        next = putDecimal(next, (uint32_t) record->result);
+    }
+    *next++ = ' ';
+    uint32_t written = (uint32_t) (next - header);
+    if (written + 2 * record->length + 2 > lineSize) {
+        return I2C_TRACE_BUFFER_TOO_SMALL_ERROR;
+    }
+    memcpy(line, header, written);
+    next = line + written;
+    for (uint16_t i = 0; i < record->length; ++i) {
+        *next++ = hexDigits[record->data[i] >> 4];
+        *next++ = hexDigits[record->data[i] & 0x0F];
+    }
+    if (record->length == 0) {
+        *next++ = '-';
+    }
+    *next = '\0';
+    return (int32_t) (next - line);
+}
+
+// Meant for the host, on the board it links in sscanf
+int32_t i2c_trace_parseLine(const char* line, i2c_trace_record_t* record) {
+    if (line == 0 || record == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    unsigned long timeUs;
+    unsigned int address;
+    char direction;
+    long result;
+    int consumed = 0;
+    if (sscanf(line, "%lu %x %c %ld %n", &timeUs, &address, &direction, &result, &consumed) != 4 ||
+        address > ADDRESS_MASK || (direction != 'R' && direction != 'W')) {
+        return I2C_TRACE_PARSE_ERROR;
+    }
+    record->timeUs = (uint32_t) timeUs;
+    record->address = (uint8_t) address;
+    record->isRead = direction == 'R';
+    record->result = (int32_t) result;
+    record->length = 0;
+    const char* next = line + consumed;
+    if (*next == '-') {
+        return I2C_TRACE_NO_ERROR;
+    }
+    while (hexValue(next[0]) >= 0) {
+        if (hexValue(next[1]) < 0 || record->length >= I2C_TRACE_MAX_DATA) {
+            return I2C_TRACE_PARSE_ERROR;
+        }
+        record->data[record->length++] = (uint8_t) ((hexValue(next[0]) << 4) | hexValue(next[1]));
+        next += 2;
+    }
+    return I2C_TRACE_NO_ERROR;
+}
+
+// Oldest record first, e.g. with puts as the line emitter to get the trace off the board over USB
+int32_t i2c_trace_dump(i2c_trace_t* trace, i2c_trace_emitLine_t emitLine, void* context) {
+    if (trace == 0 || emitLine == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    i2c_trace_cursor_t cursor;
+    i2c_trace_record_t record;
+    char line[I2C_TRACE_MAX_LINE];
+    i2c_trace_first(trace, &cursor);
+    while (i2c_trace_next(trace, &cursor, &record) == I2C_TRACE_RECORD) {
+        i2c_trace_formatRecord(&record, line, sizeof(line));
+        emitLine(context, line);
+    }
+    return I2C_TRACE_NO_ERROR;
+}
+
+int32_t i2c_trace_replayInit(i2c_trace_replay_t* replay, i2c_trace_t* trace) {
+    if (replay == 0 || trace == 0) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    memset(replay, 0, sizeof(i2c_trace_replay_t));
+    replay->trace = trace;
+    return i2c_trace_first(trace, &replay->cursor);
+}
+
+// Written bytes are compared with the recorded ones, as far as the record kept them
+int32_t i2c_trace_replayWrite(i2c_trace_replay_t* replay, uint8_t address, const uint8_t* buffer, uint32_t amount) {
+    if (replay == 0 || (buffer == 0 && amount > 0)) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    if (!takeRecord(replay, address, false)) {
+        return I2C_TRACE_REPLAY_NACK;
+    }
+    i2c_trace_record_t* record = &replay->record;
+    bool clipped = record->length == I2C_TRACE_MAX_DATA;
+    uint32_t compared = amount < record->length ? amount : record->length;
+    if ((clipped ? amount < record->length : amount != record->length) ||
+        memcmp(buffer, record->data, compared) != 0) {
+        countMismatch(replay);
+    }
+    return record->result;
+}
+
+int32_t i2c_trace_replayRead(i2c_trace_replay_t* replay, uint8_t address, uint8_t* buffer, uint32_t amount) {
+    if (replay == 0 || (buffer == 0 && amount > 0)) {
+        return I2C_TRACE_NULL_POINTER_ERROR;
+    }
+    if (!takeRecord(replay, address, true)) {
+        return I2C_TRACE_REPLAY_NACK;
+    }
+    i2c_trace_record_t* record = &replay->record;
+    if (record->result > 0 && (uint32_t) record->result != amount) {
+        countMismatch(replay);
+    }
+    memcpy(buffer, record->data, amount < record->length ? amount : record->length);
+    return record->result;
+}
+
+bool i2c_trace_replayIsDone(i2c_trace_replay_t* replay) {
+    return replay == 0 || replay->cursor.remaining == 0;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static void putByte(i2c_trace_t* trace, uint32_t* position, uint8_t value) {
+    trace->buffer[*position] = value;
+    *position = *position + 1 == trace->size ? 0 : *position + 1;
+}
+
+static uint8_t getByte(i2c_trace_t* trace, uint32_t* position) {
+    uint8_t value = trace->buffer[*position];
+    *position = *position + 1 == trace->size ? 0 : *position + 1;
+    return value;
+}
+
+// Seven bits per byte, lowest first, bit 7 set while more follow
+static void putVarint(i2c_trace_t* trace, uint32_t* position, uint32_t value) {
+    while (value >= 0x80) {
+        putByte(trace, position, (uint8_t) (value | 0x80));
+        value >>= 7;
+    }
+    putByte(trace, position, (uint8_t) value);
+}
+
+static uint32_t getVarint(i2c_trace_t* trace, uint32_t* position) {
+    uint32_t value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        uint8_t byte = getByte(trace, position);
+        value |= (uint32_t) (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+static uint32_t varintSize(uint32_t value) {
+    uint32_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+// Small negative error codes stay one byte
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t) (value >> 1) ^ -(int32_t) (value & 1);
+}
+
+// The record after the evicted one becomes the oldest and its delta moves the oldest time on
+static void evictOldest(i2c_trace_t* trace) {
+    uint32_t position = trace->tail;
+    getByte(trace, &position);
+    getVarint(trace, &position);
+    getVarint(trace, &position);
+    uint32_t length = getVarint(trace, &position);
+    position = (position + length) % trace->size;
+    uint32_t recordSize = (position + trace->size - trace->tail) % trace->size;
+    recordSize = recordSize == 0 ? trace->size : recordSize;
+    trace->tail = position;
+    trace->used -= recordSize;
+    trace->amountRecords--;
+    trace->evicted++;
+    if (trace->amountRecords > 0) {
+        uint32_t next = trace->tail;
+        getByte(trace, &next);
+        trace->oldestTimeUs += getVarint(trace, &next);
+    }
+}
+
+static char* putDecimal(char* next, uint32_t value) {
+    char reversed[10];
+    uint32_t amount = 0;
+    do {
+        reversed[amount++] = (char) ('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (amount > 0) {
+        *next++ = reversed[--amount];
+    }
+    return next;
+}
+
+static int32_t hexValue(char digit) {
+    if (digit >= '0' && digit <= '9') {
+        return digit - '0';
+    }
+    if (digit >= 'A' && digit <= 'F') {
+        return digit - 'A' + 10;
+    }
+    if (digit >= 'a' && digit <= 'f') {
+        return digit - 'a' + 10;
+    }
+    return -1;
+}
+
+// False if the trace is used up or the record is a different transaction, both count as a mismatch
+static bool takeRecord(i2c_trace_replay_t* replay, uint8_t address, bool isRead) {
+    replay->replayed++;
+    if (i2c_trace_next(replay->trace, &replay->cursor, &replay->record) != I2C_TRACE_RECORD) {
+        countMismatch(replay);
+        return false;
+    }
+    if (replay->record.address != address || replay->record.isRead != isRead) {
+        countMismatch(replay);
+        return false;
+    }
+    return true;
+}
+
+static void countMismatch(i2c_trace_replay_t* replay) {
+    if (replay->mismatches == 0) {
+        replay->firstMismatch = replay->replayed - 1;
+    }
+    replay->mismatches++;
+}
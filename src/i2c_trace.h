@@ -0,0 +1,105 @@
+#ifndef SAPH_PICO_TEMPERATURE_I2C_TRACE_H
+#define SAPH_PICO_TEMPERATURE_I2C_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define I2C_TRACE_NO_ERROR 0
+#define I2C_TRACE_NULL_POINTER_ERROR -20
+#define I2C_TRACE_INVALID_CONFIG_ERROR -43
+#define I2C_TRACE_BUFFER_TOO_SMALL_ERROR -48
+#define I2C_TRACE_PARSE_ERROR -49
+
+// Positive results of i2c_trace_next
+#define I2C_TRACE_END 0
+#define I2C_TRACE_RECORD 1
+
+// What a replay returns for a transaction it has no matching record for, PICO_ERROR_GENERIC like a missing device
+#define I2C_TRACE_REPLAY_NACK -1
+
+// Longer transfers keep their first bytes only, a BME280 burst or an SSD1306 chunk always fits
+#define I2C_TRACE_MAX_DATA 255
+// Address byte, three varints of up to five bytes and the data
+#define I2C_TRACE_MAX_RECORD_SIZE (1 + 3 * 5 + I2C_TRACE_MAX_DATA)
+// Time, address, direction, result and two hex digits per byte
+#define I2C_TRACE_MAX_LINE (32 + 2 * I2C_TRACE_MAX_DATA)
+
+typedef struct i2c_trace_record_t {
+    uint32_t timeUs;
+    uint8_t address;
+    bool isRead;
+    // What i2c_handler returned, the amount transferred or a negative error code
+    int32_t result;
+    // Bytes written or read back, none for a failed read
+    uint16_t length;
+    uint8_t data[I2C_TRACE_MAX_DATA];
+} i2c_trace_record_t;
+
+/* *
+ * Ring of variable length records in a buffer of the caller, the oldest records make room for new ones.
+ * A record is the address with the direction in bit 7, then varints of the time since the record before,
+ * the zigzagged result and the length, then the data. A BME280 measurement read takes 19 bytes this way.
+ * */
+typedef struct i2c_trace_t {
+    uint8_t* buffer;
+    uint32_t size;
+    uint32_t tail;
+    uint32_t used;
+    uint32_t amountRecords;
+    uint32_t oldestTimeUs;
+    uint32_t newestTimeUs;
+    uint32_t recorded;
+    uint32_t evicted;
+} i2c_trace_t;
+
+typedef struct i2c_trace_cursor_t {
+    uint32_t position;
+    uint32_t remaining;
+    uint32_t timeUs;
+    bool started;
+} i2c_trace_cursor_t;
+
+typedef void (* i2c_trace_emitLine_t)(void* context, const char* line);
+
+/* *
+ * Plays a trace back in place of the bus: every transaction takes the next record, reads get the recorded bytes
+ * and every transaction gets the recorded result, at whatever speed the caller goes.
+ * A transaction that does not match its record counts as a mismatch, its record is used up all the same.
+ * */
+typedef struct i2c_trace_replay_t {
+    i2c_trace_t* trace;
+    i2c_trace_cursor_t cursor;
+    i2c_trace_record_t record;
+    // Transactions so far, including those past the end of the trace
+    uint32_t replayed;
+    uint32_t mismatches;
+    // Index of the first transaction that did not match, valid while mismatches is not 0
+    uint32_t firstMismatch;
+} i2c_trace_replay_t;
+
+int32_t i2c_trace_init(i2c_trace_t* trace, uint8_t* buffer, uint32_t size);
+
+void i2c_trace_clear(i2c_trace_t* trace);
+
+int32_t i2c_trace_record(i2c_trace_t* trace, uint32_t timeUs, uint8_t address, bool isRead, const uint8_t* data,
+                         uint32_t amount, int32_t result);
+
+int32_t i2c_trace_first(i2c_trace_t* trace, i2c_trace_cursor_t* cursor);
+
+int32_t i2c_trace_next(i2c_trace_t* trace, i2c_trace_cursor_t* cursor, i2c_trace_record_t* record);
+
+int32_t i2c_trace_formatRecord(const i2c_trace_record_t* record, char* line, uint32_t lineSize);
+
+int32_t i2c_trace_parseLine(const char* line, i2c_trace_record_t* record);
+
+int32_t i2c_trace_dump(i2c_trace_t* trace, i2c_trace_emitLine_t emitLine, void* context);
+
+int32_t i2c_trace_replayInit(i2c_trace_replay_t* replay, i2c_trace_t* trace);
+
+int32_t i2c_trace_replayWrite(i2c_trace_replay_t* replay, uint8_t address, const uint8_t* buffer, uint32_t amount);
+
+int32_t i2c_trace_replayRead(i2c_trace_replay_t* replay, uint8_t address, uint8_t* buffer, uint32_t amount);
+
+bool i2c_trace_replayIsDone(i2c_trace_replay_t* replay);
+
+#endif //SAPH_PICO_TEMPERATURE_I2C_TRACE_H
@@ -0,0 +1,248 @@
+//
+// On target benchmarks of the driver hot paths, timed with SysTick in processor cycles.
+// Prints one JSON line per benchmark between "bench begin" and "bench end" markers, then starts over.
+//
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+
+#include "../i2c_handler.h"
+#include "../saphBme280.h"
+#include "../saphBme280_internal.h"
+#include "../saphBme280_burst.h"
+#include "../saphBme280_filter.h"
+#include "../saphBme280_stats.h"
+#include "../saphBme280_derived.h"
+#include "../saph_ssd1306.h"
+#include "../saph_ssd1306_internal.h"
+#include "../saph_ssd1306_framebuffer.h"
+#include "../saph_cycleBench.h"
+
+#ifndef I2C_BAUDRATE
+#define I2C_BAUDRATE 400000UL
+#endif
+
+#define BME_DEFAULT_ADDRESS 0x76
+#define SSD1306_DEFAULT_ADDRESS 0x3C
+
+// Pure computations run often, everything waiting on the bus only a few times
+#define COMPUTE_ITERATIONS 1000
+#define BUS_ITERATIONS 50
+#define CALIBRATION_ITERATIONS 100
+// Samples per bulk decode, the cycles of one decode divided by this are the cost of a sample
+#define BURST_BATCH 32
+// Enable, processor clock as source, no interrupt
+#define SYSTICK_CSR_ENABLE_PROCESSOR_CLOCK 0x5
+
+typedef struct benchContext_t {
+    saphBmeDevice_t sensor;
+    saph_ssd1306_device_t display;
+    bool hasSensor;
+    bool hasDisplay;
+    saphBme280_filter_t filter;
+    saphBme280_stats_t stats;
+    saphBme280_burst_ring_t burstRing;
+    uint8_t burstBuffer[(BURST_BATCH + 1) * SAPHBME280_BURST_SIZE];
+    int32_t burstTemperatures[BURST_BATCH];
+    uint32_t burstPressures[BURST_BATCH];
+    uint32_t burstHumidities[BURST_BATCH];
+    uint8_t frames[2][SAPH_SSD1306_FRAMEBUFFER_SIZE];
+    volatile int32_t sink;
+} benchContext_t;
+
+static benchContext_t benchContext;
+
+// ######################################
+// helper functions
+// ######################################
+static uint32_t readSysTick(void);
+
+static void initSysTick(void);
+
+static void runAllBenchmarks(saph_cycleBench_t* bench, benchContext_t* context);
+
+static void runAndPrint(saph_cycleBench_t* bench, const char* name, saph_cycleBench_op_t op, benchContext_t* context,
+                        uint32_t iterations);
+
+static saphBmeRawMeasurements_t rawSample(uint32_t iteration);
+
+static void bench_compensate(void* context, uint32_t iteration);
+
+static void bench_burstDecode(void* context, uint32_t iteration);
+
+static void bench_filterIirPush(void* context, uint32_t iteration);
+
+static void bench_statsPush(void* context, uint32_t iteration);
+
+static void bench_dewPoint(void* context, uint32_t iteration);
+
+static void bench_altitude(void* context, uint32_t iteration);
+
+static void bench_framebufferDiff(void* context, uint32_t iteration);
+
+static void bench_decodeBurst(void* context, uint32_t iteration);
+
+static void bench_readTrimmingValues(void* context, uint32_t iteration);
+
+static void bench_sendCtrlCommand(void* context, uint32_t iteration);
+
+int main() {
+    stdio_init_all();
+    i2c_handler_initialise(I2C_BAUDRATE);
+    initSysTick();
+
+    saph_cycleBench_t bench;
+    saph_cycleBench_init(&bench, readSysTick, SAPH_CYCLEBENCH_SYSTICK_MASK, true);
+    while (1) {
+        sleep_ms(5000);
+        runAllBenchmarks(&bench, &benchContext);
+    }
+}
+
+static uint32_t readSysTick(void) {
+    return systick_hw->cvr;
+}
+
+static void initSysTick(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = SAPH_CYCLEBENCH_SYSTICK_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = SYSTICK_CSR_ENABLE_PROCESSOR_CLOCK;
+}
+
+static void runAllBenchmarks(saph_cycleBench_t* bench, benchContext_t* context) {
+    memset(context, 0, sizeof(benchContext_t));
+    context->hasSensor = saphBme280_init(BME_DEFAULT_ADDRESS, &context->sensor) == SAPH_BME280_NO_ERROR;
+    saph_ssd1306_init(SSD1306_DEFAULT_ADDRESS, &context->display);
+    uint8_t status;
+    context->hasDisplay = saph_ssd1306_status(&context->display, &status) == SAPH_SSD1306_NO_ERROR;
+    saphBme280_filter_initIir(&context->filter, SAPHBME280_IIR_FILTER_COEFFICIENT_16);
+    saphBme280_stats_init(&context->stats);
+    saphBme280_stats_addWindow(&context->stats, 60);
+    saphBme280_stats_addWindow(&context->stats, 3600);
+    saphBme280_burst_initRing(&context->burstRing, &context->sensor, context->burstBuffer,
+                              sizeof(context->burstBuffer));
+    for (uint32_t i = 0; i < sizeof(context->burstBuffer); ++i) {
+        context->burstBuffer[i] = (uint8_t) (0x5A + i * 13);
+    }
+    memset(context->frames, 0x55, sizeof(context->frames));
+    context->frames[1][3 * SAPH_SSD1306_WIDTH + 40] = 0xFF;
+
+    saph_cycleBench_calibrate(bench, CALIBRATION_ITERATIONS);
+    printf("bench begin {\"clock_hz\":%lu,\"sensor\":%d,\"display\":%d}\n", (unsigned long) clock_get_hz(clk_sys),
+           context->hasSensor, context->hasDisplay);
+    // Without a sensor the compensation runs on zeroed trimming values, the cycles still tell the story of the math
+    runAndPrint(bench, "bme280.compensate", bench_compensate, context, COMPUTE_ITERATIONS);
+    runAndPrint(bench, "bme280.burst_decode_32", bench_burstDecode, context, COMPUTE_ITERATIONS);
+    runAndPrint(bench, "bme280.filter_iir_push", bench_filterIirPush, context, COMPUTE_ITERATIONS);
+    runAndPrint(bench, "bme280.stats_push", bench_statsPush, context, COMPUTE_ITERATIONS);
+    runAndPrint(bench, "bme280.derived_dew_point", bench_dewPoint, context, COMPUTE_ITERATIONS);
+    runAndPrint(bench, "bme280.derived_altitude", bench_altitude, context, COMPUTE_ITERATIONS);
+    runAndPrint(bench, "ssd1306.framebuffer_diff", bench_framebufferDiff, context, COMPUTE_ITERATIONS);
+    if (context->hasSensor) {
+        runAndPrint(bench, "bme280.decode_burst", bench_decodeBurst, context, BUS_ITERATIONS);
+        runAndPrint(bench, "bme280.parse_trimming", bench_readTrimmingValues, context, BUS_ITERATIONS);
+    }
+    if (context->hasDisplay) {
+        runAndPrint(bench, "ssd1306.send_ctrl_command", bench_sendCtrlCommand, context, BUS_ITERATIONS);
+    }
+    printf("bench end\n");
+}
+
+static void runAndPrint(saph_cycleBench_t* bench, const char* name, saph_cycleBench_op_t op, benchContext_t* context,
+                        uint32_t iterations) {
+    saph_cycleBench_result_t result;
+    char line[160];
+    if (saph_cycleBench_run(bench, name, op, context, iterations, &result) != SAPH_CYCLEBENCH_NO_ERROR ||
+        saph_cycleBench_formatResult(&result, bench->overheadCycles, line, sizeof(line)) < 0) {
+        printf("{\"name\":\"%s\",\"error\":true}\n", name);
+        return;
+    }
+    printf("%s\n", line);
+}
+
+// Raw values move a little so the compensation does not see the same input every time
+static saphBmeRawMeasurements_t rawSample(uint32_t iteration) {
+    saphBmeRawMeasurements_t raw = {283413 + (int32_t) (iteration & 0xFF), 523407 + (int32_t) (iteration & 0x3FF),
+                                    27999 + (int32_t) (iteration & 0x7F)};
+    return raw;
+}
+
+static void bench_compensate(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    saphBmeRawMeasurements_t raw = rawSample(iteration);
+    saphBmeMeasurements_t result = saphBme280_internal_compensateMeasurements(&benchData->sensor, &raw);
+    benchData->sink += (int32_t) result.pressure;
+}
+
+// Compensates whatever the buffer holds, the ring is refilled by hand so no bus traffic is timed
+static void bench_burstDecode(void* context, uint32_t iteration) {
+    (void) iteration;
+    benchContext_t* benchData = (benchContext_t*) context;
+    benchData->burstRing.oldest = 0;
+    benchData->burstRing.amount = BURST_BATCH;
+    saphBme280_burst_columns_t columns = {benchData->burstTemperatures, benchData->burstPressures,
+                                          benchData->burstHumidities};
+    benchData->sink += saphBme280_burst_decode(&benchData->burstRing, &columns, BURST_BATCH);
+}
+
+static void bench_filterIirPush(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    saphBmeRawMeasurements_t raw = rawSample(iteration);
+    saphBmeRawMeasurements_t output;
+    benchData->sink += saphBme280_filter_push(&benchData->filter, &raw, &output);
+}
+
+static void bench_statsPush(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    saphBmeMeasurements_t measurements = {25600000 + (iteration & 0xFFF), 2150 + (int32_t) (iteration & 0x3F),
+                                          46080 + (iteration & 0x3FF)};
+    benchData->sink += saphBme280_stats_push(&benchData->stats, &measurements);
+}
+
+static void bench_dewPoint(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    saphBmeMeasurements_t measurements = {25600000, 2150 + (int32_t) (iteration & 0x3F), 46080 + (iteration & 0x3FF)};
+    int32_t dewPoint = 0;
+    saphBme280_derived_dewPoint(&measurements, &dewPoint);
+    benchData->sink += dewPoint;
+}
+
+static void bench_altitude(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    saphBmeMeasurements_t measurements = {25600000 + (iteration & 0xFFF), 2150, 46080};
+    int32_t altitude = 0;
+    saphBme280_derived_altitude(&measurements, 101325u * 256u, &altitude);
+    benchData->sink += altitude;
+}
+
+static void bench_framebufferDiff(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    saph_ssd1306_region_t region;
+    benchData->sink += saph_ssd1306_framebuffer_diff(benchData->frames[iteration & 1],
+                                                     benchData->frames[(iteration + 1) & 1], &region);
+}
+
+// Includes the 8 byte burst on the bus, at 400 kHz that is the bigger part
+static void bench_decodeBurst(void* context, uint32_t iteration) {
+    (void) iteration;
+    benchContext_t* benchData = (benchContext_t*) context;
+    saphBmeRawMeasurements_t raw;
+    benchData->sink += saphBme280_internal_getRawMeasurement(&benchData->sensor, &raw);
+}
+
+static void bench_readTrimmingValues(void* context, uint32_t iteration) {
+    (void) iteration;
+    benchContext_t* benchData = (benchContext_t*) context;
+    benchData->sink += saphBme280_internal_readTrimmingValues(&benchData->sensor);
+}
+
+// Column address command, framed with the control byte like every command
+static void bench_sendCtrlCommand(void* context, uint32_t iteration) {
+    benchContext_t* benchData = (benchContext_t*) context;
+    uint8_t command[3] = {0x21, (uint8_t) (iteration % SAPH_SSD1306_WIDTH), SAPH_SSD1306_WIDTH - 1};
+    benchData->sink += saph_ssd1306_internal_sendCtrlCommand(&benchData->display, command, sizeof(command));
+}
@@ -87,7 +87,8 @@ static void integration_initDevice(saphBmeDevice_t* device) {
     printf("integration_initDevice: ");
     int32_t errorCode = saphBme280_init(BME_DEFAULT_ADDRESS, device);
     if (errorCode == SAPH_BME280_NO_ERROR) {
-        printf("successful\n\nDevice address is %u\n\"Trimming values are: ", device->address);
+        printf("successful\n\nDevice address is %u, chip id 0x%02X\n\"Trimming values are: ", device->address,
+               device->chipId);
         saphBmeTrimmingValues_t trimmingVals = device->trimmingValues;
         printf("%u, ", trimmingVals.dig_T1);
         printf("%d, ", trimmingVals.dig_T2);
@@ -210,8 +211,11 @@ static void integration_getMeasurements(saphBmeDevice_t* device) {
             printf("Temperature: %3.3f °C\n", temperature);
             float pressure = results.pressure / 25600.0f;
             printf("Pressure: %f hPa\n", pressure);
-            float humidity = results.humidity / 1024.0f;
-            printf("Humidity: %f %%\n\n", humidity);
+            if (saphBme280_hasHumidity(device)) {
+                float humidity = results.humidity / 1024.0f;
+                printf("Humidity: %f %%\n", humidity);
+            }
+            printf("\n");
         } else {
             printf("failed\n");
             printf("Error code: %ld\n\n", errorCode);
@@ -245,30 +249,12 @@ static void init_debug_leds(void) {
 }
 
 static int32_t configIntoKnownSensorState(saphBmeDevice_t* device) {
-    saphBme280_prepareMeasureCtrlReg(device, OVERSAMPLING_x1, OVERSAMPLING_x1, SAPHBME280_SENSOR_MODE_SLEEP);
-    int32_t errorCode = saphBme280_commitMeasureCtrlReg(device);
-    if (errorCode != SAPH_BME280_NO_ERROR) {
-        printError(errorCode, "committing MeasureControlReg settings");
-        return errorCode;
-    }
-
     saphBme280_prepareCtrlHumidityReg(device, OVERSAMPLING_x1);
-    errorCode = saphBme280_commitCtrlHumidity(device);
-    if (errorCode != SAPH_BME280_NO_ERROR) {
-        printError(errorCode, "committing ctrlHumidity settings");
-        return errorCode;
-    }
-
     saphBme280_prepareConfigReg(device, SAPHBME280_STANDBY_TIME_MS_0_5, SAPHBME280_IIR_FILTER_COEFFICIENT_2);
-    errorCode = saphBme280_commitConfigReg(device);
-    if (errorCode != SAPH_BME280_NO_ERROR) {
-        printError(errorCode, "committing ConfigurationReg settings");
-        return errorCode;
-    }
     saphBme280_prepareMeasureCtrlReg(device, OVERSAMPLING_x1, OVERSAMPLING_x1, SAPHBME280_SENSOR_MODE_NORMAL);
-    errorCode = saphBme280_commitMeasureCtrlReg(device);
+    int32_t errorCode = saphBme280_commitAllRegs(device);
     if (errorCode != SAPH_BME280_NO_ERROR) {
-        printError(errorCode, "committing MeasureControlReg settings");
+        printError(errorCode, "committing all register settings");
         return errorCode;
     }
     sleep_ms(10);
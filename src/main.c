@@ -3,17 +3,42 @@
 
 
 #include "i2c_handler.h"
+#include "saph_discovery.h"
+#include "saph_dutyCycle.h"
+#include "saph_hal.h"
 
 #ifndef I2C_BAUDRATE
 #define I2C_BAUDRATE 100000UL
 #endif
 
+#ifndef SAMPLE_INTERVAL_US
+#define SAMPLE_INTERVAL_US 60000000UL
+#endif
+
+#ifndef DISPLAY_ON_US
+#define DISPLAY_ON_US 5000000UL
+#endif
+
+// The minimal footprint build has no stdio to print to, the LEDs are all that is left
+#ifdef SAPH_NO_PRINTF
+#define printf(...) ((void) 0)
+#endif
+
 const uint LED_YELLOW_0 = 16;
 const uint LED_YELLOW_1 = 17;
 const uint LED_YELLOW_2 = 18;
 
 void init_debug_leds(void);
 
+void print_discovered_devices(saph_discovery_registry_t* registry);
+
+bool start_duty_cycle(saph_discovery_registry_t* registry);
+
+void run_duty_cycle(void);
+
+static saph_discovery_registry_t deviceRegistry;
+static saph_dutyCycle_t dutyCycle;
+
 int main() {
     stdio_init_all();
     init_debug_leds();
@@ -25,8 +50,18 @@ int main() {
     gpio_init(LED_PIN);
     gpio_set_dir(LED_PIN, GPIO_OUT);
     bool current_val = 0;
+    saph_discovery_init(&deviceRegistry);
     while (1) {
-        i2c_handler_scanForDevices();
+        // One candidate address per round, so the rest of the loop never waits on discovery
+        if (!saph_discovery_isDone(&deviceRegistry)) {
+            saph_discovery_step(&deviceRegistry);
+            if (saph_discovery_isDone(&deviceRegistry)) {
+                print_discovered_devices(&deviceRegistry);
+                if (start_duty_cycle(&deviceRegistry)) {
+                    run_duty_cycle();
+                }
+            }
+        }
         gpio_put(LED_YELLOW_2, 1);
         gpio_put(LED_PIN, current_val);
         current_val = !current_val;
@@ -46,4 +81,53 @@ void init_debug_leds(void) {
     gpio_put(LED_YELLOW_0, 0);
     gpio_put(LED_YELLOW_1, 0);
     gpio_put(LED_YELLOW_2, 0);
-}
\ No newline at end of file
+}
+
+void print_discovered_devices(saph_discovery_registry_t* registry) {
+    printf("Discovered %u BME280/BMP280 and %u SSD1306\n", registry->amountBme280, registry->amountSsd1306);
+    for (uint8_t i = 0; i < registry->amountBme280; ++i) {
+        printf("  %s at 0x%02X\n", registry->bme280[i].kind == SAPH_DISCOVERY_KIND_BMP280 ? "BMP280" : "BME280",
+               registry->bme280[i].device.address);
+    }
+    for (uint8_t i = 0; i < registry->amountSsd1306; ++i) {
+        printf("  SSD1306 at 0x%02X\n", registry->ssd1306[i].address);
+    }
+}
+
+// Forced measurements with the weather monitoring profile on the first sensor, the display only lights up after a sample
+bool start_duty_cycle(saph_discovery_registry_t* registry) {
+    saphBmeDevice_t* sensor = saph_discovery_getBme280(registry, 0);
+    if (sensor == 0 || saphBme280_prepareProfile(sensor, SAPHBME280_PROFILE_WEATHER_MONITORING) != SAPH_BME280_NO_ERROR ||
+        saphBme280_commitAllRegs(sensor) != SAPH_BME280_NO_ERROR) {
+        return false;
+    }
+    saph_ssd1306_device_t* display = saph_discovery_getSsd1306(registry, 0);
+    if (display != 0 && saph_ssd1306_configurePanel(display) != SAPH_SSD1306_NO_ERROR) {
+        return false;
+    }
+    saph_dutyCycle_config_t config = {
+            .intervalUs = SAMPLE_INTERVAL_US,
+            .displayOnUs = DISPLAY_ON_US,
+            .mcuSleepMode = SAPH_DUTYCYCLE_MCU_SLEEP,
+    };
+    return saph_dutyCycle_init(&dutyCycle, sensor, display, &config, saph_hal_getTimeUs()) ==
+           SAPH_DUTYCYCLE_NO_ERROR;
+}
+
+// Between wakeups the core waits in saph_hal_sleepUs with its clocks gated
+void run_duty_cycle(void) {
+    gpio_put(LED_YELLOW_0, 0);
+    gpio_put(LED_YELLOW_1, 0);
+    gpio_put(LED_YELLOW_2, 0);
+    while (1) {
+        saphBmeMeasurements_t measurements;
+        if (saph_dutyCycle_step(&dutyCycle, saph_hal_getTimeUs(), &measurements) == SAPH_DUTYCYCLE_SAMPLE_READY) {
+            printf("%ld centi C, %lu uA*s per sample\n", (long) measurements.temperature,
+                   (unsigned long) (saph_dutyCycle_getChargePerSample(&dutyCycle) / 1000));
+        }
+        uint32_t waitUs = dutyCycle.nextWakeUs - saph_hal_getTimeUs();
+        if ((int32_t) waitUs > 0) {
+            saph_hal_sleepUs(waitUs);
+        }
+    }
+}
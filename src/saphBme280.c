@@ -25,10 +25,84 @@
 #define TEMP_OVERSAMPLING_POS 5
 #define PRESSURE_OVERSAMPLING_POS 2
 
+// Flags in committedValid, a cleared flag means the sensor content is unknown and gets written unconditionally
+#define COMMITTED_CTRL_HUMIDITY 0x01
+#define COMMITTED_MEASURE_CTRL 0x02
+#define COMMITTED_CONFIG 0x04
+#define COMMITTED_ALL (COMMITTED_CTRL_HUMIDITY | COMMITTED_MEASURE_CTRL | COMMITTED_CONFIG)
+
+// Readback of ctrl_hum through config in one burst, status sits in between
+#define VERIFY_READ_AMOUNT 4
+#define VERIFY_CTRL_HUMIDITY_POS 0
+#define VERIFY_MEASURE_CTRL_POS 2
+#define VERIFY_CONFIG_POS 3
+// spi3w_en and the reserved bit of config are never set by this driver
+#define BITMASK_CONFIG_WRITABLE 0xFC
+
+#define OVERSAMPLING_MAX_SAMPLES 16
+
+typedef struct measurementTime_t {
+    uint32_t baseUs;
+    uint32_t perSampleUs;
+    uint32_t pressureHumiditySetupUs;
+} measurementTime_t;
+
+// Measurement time, datasheet chapter 9.1, in microseconds
+static const measurementTime_t measurementTimeTypical = {1000, 2000, 500};
+static const measurementTime_t measurementTimeMax = {1250, 2300, 575};
+
+// Supply current during each phase of a conversion, datasheet table 1, in nA
+#define CURRENT_TEMPERATURE_NA 350000
+#define CURRENT_PRESSURE_NA 714000
+#define CURRENT_HUMIDITY_NA 340000
+
+typedef struct measurementPhases_t {
+    uint32_t temperatureUs;
+    uint32_t pressureUs;
+    uint32_t humidityUs;
+} measurementPhases_t;
+
+// Indexed by SAPHBME280_STANDBY_TIME_*, the BMP280 uses the last two codes for 2s and 4s
+static const uint32_t standbyTimesUs[] = {500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000};
+static const uint32_t standbyTimesUsBmp280[] = {500, 62500, 125000, 250000, 500000, 1000000, 2000000, 4000000};
+
+typedef struct profile_t {
+    uint8_t tempOversampling;
+    uint8_t pressureOversampling;
+    uint8_t humidityOversampling;
+    uint8_t sensorMode;
+    uint8_t standbyTime;
+    uint8_t iirFilterCoefficient;
+} profile_t;
+
+// Indexed by SAPHBME280_PROFILE_*, forced mode profiles leave the sensor asleep until triggered
+static const profile_t profiles[] = {
+        {OVERSAMPLING_x1, OVERSAMPLING_x1, OVERSAMPLING_x1, SAPHBME280_SENSOR_MODE_SLEEP,
+                SAPHBME280_STANDBY_TIME_MS_0_5, SAPHBME280_IIR_FILTER_COEFFICIENT_OFF},
+        {OVERSAMPLING_x1, OVERSAMPLING_SKIP, OVERSAMPLING_x1, SAPHBME280_SENSOR_MODE_SLEEP,
+                SAPHBME280_STANDBY_TIME_MS_0_5, SAPHBME280_IIR_FILTER_COEFFICIENT_OFF},
+        {OVERSAMPLING_x2, OVERSAMPLING_x16, OVERSAMPLING_x1, SAPHBME280_SENSOR_MODE_NORMAL,
+                SAPHBME280_STANDBY_TIME_MS_0_5, SAPHBME280_IIR_FILTER_COEFFICIENT_16},
+        {OVERSAMPLING_x1, OVERSAMPLING_x4, OVERSAMPLING_SKIP, SAPHBME280_SENSOR_MODE_NORMAL,
+                SAPHBME280_STANDBY_TIME_MS_0_5, SAPHBME280_IIR_FILTER_COEFFICIENT_16},
+};
+
+#define AMOUNT_PROFILES (sizeof(profiles) / sizeof(profiles[0]))
+
 // ###############################################
 // Helper Function definitions
 // ###############################################
 
+static int32_t finishCommit(saphBmeDevice_t* device, int32_t errorCode, uint8_t committedRegisters);
+
+static bool isCommitted(saphBmeDevice_t* device, uint8_t committedRegister, uint8_t committedValue, uint8_t value);
+
+static measurementPhases_t getMeasurementPhases(saphBmeDevice_t* device, const measurementTime_t* timing);
+
+static uint32_t getMeasurementTime(saphBmeDevice_t* device, const measurementTime_t* timing);
+
+static uint32_t getSamplesFromOversampling(uint8_t oversampling);
+
 // ###############################################
 //
 // ###############################################
@@ -41,6 +115,19 @@ int32_t saphBme280_init(uint8_t address, saphBmeDevice_t* device) {
         return SAPH_BME280_RESERVED_ADDR_ERROR;
     }
     device->address = address;
+    device->committedCtrlHumidity = 0;
+    device->committedMeasureCtrl = 0;
+    device->committedConfig = 0;
+    device->committedValid = 0;
+    device->verifyCommits = false;
+    int32_t chipId = saphBme280_getId(device);
+    if (chipId < 0) {
+        return chipId;
+    }
+    if (chipId != SAPHBME280_CHIP_ID_BME280 && chipId != SAPHBME280_CHIP_ID_BMP280) {
+        return SAPH_BME280_UNKNOWN_CHIP_ERROR;
+    }
+    device->chipId = (uint8_t) chipId;
     int32_t errorCode = saphBme280_internal_readTrimmingValues(device);
     if(errorCode != SAPH_BME280_NO_ERROR){
         return errorCode;
@@ -59,9 +146,24 @@ int32_t saphBme280_getId(saphBmeDevice_t* device) {
     }
 }
 
+// Devices that never went through init are treated as a BME280
+bool saphBme280_hasHumidity(saphBmeDevice_t* device) {
+    return device->chipId != SAPHBME280_CHIP_ID_BMP280;
+}
+
 int32_t saphBme280_resetDevice(saphBmeDevice_t* device) {
     uint8_t buffer[2] = {REG_RESET_ADDR, REG_RESET_VALUE};
-    return saphBme280_internal_writeToRegister(device, buffer, 2);
+    int32_t errorCode = saphBme280_internal_writeToRegister(device, buffer, 2);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        device->committedValid = 0;
+        return errorCode;
+    }
+    // All control registers come back as 0x00 after a soft reset
+    device->committedCtrlHumidity = 0;
+    device->committedMeasureCtrl = 0;
+    device->committedConfig = 0;
+    device->committedValid = COMMITTED_ALL;
+    return SAPH_BME280_NO_ERROR;
 }
 
 void
@@ -75,7 +177,8 @@ saphBme280_prepareMeasureCtrlReg(saphBmeDevice_t* device, uint8_t tempOversampli
 
 int32_t saphBme280_commitMeasureCtrlReg(saphBmeDevice_t* device) {
     uint8_t buffer[2] = {REG_MEASURE_CONTROL_ADDR, device->registerMeasureCtrl};
-    return saphBme280_internal_writeToRegister(device, buffer, 2);
+    int32_t errorCode = saphBme280_internal_writeToRegister(device, buffer, 2);
+    return finishCommit(device, errorCode, COMMITTED_MEASURE_CTRL);
 }
 
 void saphBme280_prepareConfigReg(saphBmeDevice_t* device, uint8_t standbyTime, uint8_t iirFilterCoefficient) {
@@ -86,7 +189,8 @@ void saphBme280_prepareConfigReg(saphBmeDevice_t* device, uint8_t standbyTime, u
 
 int32_t saphBme280_commitConfigReg(saphBmeDevice_t* device) {
     uint8_t buffer[] = {REG_CONFIG_ADDR, device->registerConfig};
-    return saphBme280_internal_writeToRegister(device, buffer, 2);
+    int32_t errorCode = saphBme280_internal_writeToRegister(device, buffer, 2);
+    return finishCommit(device, errorCode, COMMITTED_CONFIG);
 }
 
 void saphBme280_prepareCtrlHumidityReg(saphBmeDevice_t* device, uint8_t humidityOversampling) {
@@ -94,24 +198,189 @@ void saphBme280_prepareCtrlHumidityReg(saphBmeDevice_t* device, uint8_t humidity
 }
 
 int32_t saphBme280_commitCtrlHumidity(saphBmeDevice_t* device) {
+    if (!saphBme280_hasHumidity(device)) {
+        return SAPH_BME280_NO_ERROR;
+    }
     uint8_t buffer[] = {REG_HUMIDITY_CTRL_ADDR, device->registerCtrlHumidity};
-    return saphBme280_internal_writeToRegister(device, buffer, 2);
+    int32_t errorCode = saphBme280_internal_writeToRegister(device, buffer, 2);
+    return finishCommit(device, errorCode, COMMITTED_CTRL_HUMIDITY);
+}
+
+int32_t saphBme280_prepareProfile(saphBmeDevice_t* device, uint8_t profile) {
+    if (device == 0) {
+        return SAPH_BME280_NULL_POINTER_ERROR;
+    }
+    if (profile >= AMOUNT_PROFILES) {
+        return SAPH_BME280_UNKNOWN_PROFILE_ERROR;
+    }
+    const profile_t* settings = &profiles[profile];
+    saphBme280_prepareCtrlHumidityReg(device, settings->humidityOversampling);
+    saphBme280_prepareConfigReg(device, settings->standbyTime, settings->iirFilterCoefficient);
+    saphBme280_prepareMeasureCtrlReg(device, settings->tempOversampling, settings->pressureOversampling,
+                                     settings->sensorMode);
+    return SAPH_BME280_NO_ERROR;
+}
+
+/* *
+ * Writes all three prepared registers as register/value pairs in a single transaction.
+ * The sensor is put to sleep first since config writes may be ignored in normal mode, ctrl_hum only takes effect
+ * with the following ctrl_meas write, and ctrl_meas goes last so the new mode starts with everything else in place.
+ * */
+int32_t saphBme280_commitAllRegs(saphBmeDevice_t* device) {
+    uint8_t buffer[8];
+    uint32_t bufferSize = 0;
+    buffer[bufferSize++] = REG_MEASURE_CONTROL_ADDR;
+    buffer[bufferSize++] = device->registerMeasureCtrl & ~BITMASK_LOWEST_TWO;
+    if (saphBme280_hasHumidity(device)) {
+        buffer[bufferSize++] = REG_HUMIDITY_CTRL_ADDR;
+        buffer[bufferSize++] = device->registerCtrlHumidity;
+    }
+    buffer[bufferSize++] = REG_CONFIG_ADDR;
+    buffer[bufferSize++] = device->registerConfig;
+    buffer[bufferSize++] = REG_MEASURE_CONTROL_ADDR;
+    buffer[bufferSize++] = device->registerMeasureCtrl;
+    int32_t errorCode = saphBme280_internal_writeToRegister(device, buffer, bufferSize);
+    return finishCommit(device, errorCode, COMMITTED_ALL);
+}
+
+/* *
+ * Like commitAllRegs, but only writes registers whose prepared value differs from what the sensor is known to hold.
+ * A changed ctrl_hum still needs the ctrl_meas write to latch, and a changed config is only preceded by the sleep
+ * write if the sensor may be running in normal mode. A prepared forced mode always gets its ctrl_meas write, as
+ * every write of it starts a conversion. Returns without any bus traffic if nothing changed.
+ * */
+int32_t saphBme280_commitChangedRegs(saphBmeDevice_t* device) {
+    if (device == 0) {
+        return SAPH_BME280_NULL_POINTER_ERROR;
+    }
+    bool humidityChanged = saphBme280_hasHumidity(device) &&
+                           !isCommitted(device, COMMITTED_CTRL_HUMIDITY, device->committedCtrlHumidity,
+                                        device->registerCtrlHumidity);
+    bool configChanged = !isCommitted(device, COMMITTED_CONFIG, device->committedConfig, device->registerConfig);
+    bool measureCtrlChanged = !isCommitted(device, COMMITTED_MEASURE_CTRL, device->committedMeasureCtrl,
+                                           device->registerMeasureCtrl) ||
+                              (device->registerMeasureCtrl & BITMASK_LOWEST_TWO) == SAPHBME280_SENSOR_MODE_FORCED;
+    if (!humidityChanged && !configChanged && !measureCtrlChanged) {
+        return SAPH_BME280_NO_ERROR;
+    }
+    bool mayBeRunning = !(device->committedValid & COMMITTED_MEASURE_CTRL) ||
+                        (device->committedMeasureCtrl & BITMASK_LOWEST_TWO) == SAPHBME280_SENSOR_MODE_NORMAL;
+    uint8_t buffer[8];
+    uint32_t bufferSize = 0;
+    if (configChanged && mayBeRunning) {
+        buffer[bufferSize++] = REG_MEASURE_CONTROL_ADDR;
+        buffer[bufferSize++] = device->registerMeasureCtrl & ~BITMASK_LOWEST_TWO;
+    }
+    if (humidityChanged) {
+        buffer[bufferSize++] = REG_HUMIDITY_CTRL_ADDR;
+        buffer[bufferSize++] = device->registerCtrlHumidity;
+    }
+    if (configChanged) {
+        buffer[bufferSize++] = REG_CONFIG_ADDR;
+        buffer[bufferSize++] = device->registerConfig;
+    }
+    if (bufferSize > 0 || measureCtrlChanged) {
+        buffer[bufferSize++] = REG_MEASURE_CONTROL_ADDR;
+        buffer[bufferSize++] = device->registerMeasureCtrl;
+    }
+    int32_t errorCode = saphBme280_internal_writeToRegister(device, buffer, bufferSize);
+    return finishCommit(device, errorCode, COMMITTED_ALL);
+}
+
+/* *
+ * Starts a single conversion with the prepared oversampling settings, the sensor goes back to sleep on its own
+ * once it is done, after about saphBme280_getMeasurementTimeUs. The write happens even if ctrl_meas is unchanged,
+ * every forced measurement needs its own mode write.
+ * */
+int32_t saphBme280_triggerForcedMeasurement(saphBmeDevice_t* device) {
+    if (device == 0) {
+        return SAPH_BME280_NULL_POINTER_ERROR;
+    }
+    device->registerMeasureCtrl = (device->registerMeasureCtrl & ~BITMASK_LOWEST_TWO) | SAPHBME280_SENSOR_MODE_FORCED;
+    return saphBme280_commitMeasureCtrlReg(device);
+}
+
+void saphBme280_setVerifyCommits(saphBmeDevice_t* device, bool verifyCommits) {
+    device->verifyCommits = verifyCommits;
+}
+
+/* *
+ * Reads the control registers back and compares them with the committed values.
+ * The mode bits are skipped for forced mode since the sensor drops back to sleep after the measurement.
+ * On a mismatch everything is marked unknown, so the next commit rewrites all registers.
+ * */
+int32_t saphBme280_verifyCommittedRegs(saphBmeDevice_t* device) {
+    if (device == 0) {
+        return SAPH_BME280_NULL_POINTER_ERROR;
+    }
+    uint8_t readback[VERIFY_READ_AMOUNT] = {0};
+    int32_t errorCode = saphBme280_internal_readFromRegister(device, REG_HUMIDITY_CTRL_ADDR, readback,
+                                                             VERIFY_READ_AMOUNT);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    bool matches = true;
+    if ((device->committedValid & COMMITTED_CTRL_HUMIDITY) && saphBme280_hasHumidity(device)) {
+        matches &= (readback[VERIFY_CTRL_HUMIDITY_POS] & BITMASK_LOWEST_THREE) == device->committedCtrlHumidity;
+    }
+    if (device->committedValid & COMMITTED_MEASURE_CTRL) {
+        uint8_t mask = 0xFF;
+        if ((device->committedMeasureCtrl & BITMASK_LOWEST_TWO) != SAPHBME280_SENSOR_MODE_NORMAL) {
+            mask = ~BITMASK_LOWEST_TWO;
+        }
+        matches &= (readback[VERIFY_MEASURE_CTRL_POS] & mask) == (device->committedMeasureCtrl & mask);
+    }
+    if (device->committedValid & COMMITTED_CONFIG) {
+        matches &= (readback[VERIFY_CONFIG_POS] & BITMASK_CONFIG_WRITABLE) ==
+                   (device->committedConfig & BITMASK_CONFIG_WRITABLE);
+    }
+    if (!matches) {
+        device->committedValid = 0;
+        return SAPH_BME280_VERIFY_ERROR;
+    }
+    return SAPH_BME280_NO_ERROR;
 }
 
 int32_t saphBme280_status(saphBmeDevice_t* device, uint8_t* buffer) {
     return saphBme280_internal_readFromRegister(device, REG_STATUS_ADDR, buffer, 1);
 }
 
+// Worst case duration of one conversion with the prepared oversampling settings, e.g. to wait on forced mode
+uint32_t saphBme280_getMeasurementTimeUs(saphBmeDevice_t* device) {
+    return getMeasurementTime(device, &measurementTimeMax);
+}
+
+// Duration of an average conversion, together with the standby time this is the expected normal mode period
+uint32_t saphBme280_getTypicalMeasurementTimeUs(saphBmeDevice_t* device) {
+    return getMeasurementTime(device, &measurementTimeTypical);
+}
+
+/* *
+ * Charge one conversion with the prepared oversampling settings draws, in nA*us, from the typical conversion times.
+ * With SAPHBME280_SLEEP_CURRENT_NA for the time in between this gives the average currents of datasheet chapter 3.5.
+ * */
+uint64_t saphBme280_getMeasurementCharge(saphBmeDevice_t* device) {
+    measurementPhases_t phases = getMeasurementPhases(device, &measurementTimeTypical);
+    return (uint64_t) phases.temperatureUs * CURRENT_TEMPERATURE_NA +
+           (uint64_t) phases.pressureUs * CURRENT_PRESSURE_NA +
+           (uint64_t) phases.humidityUs * CURRENT_HUMIDITY_NA;
+}
+
+uint32_t saphBme280_getStandbyTimeUs(saphBmeDevice_t* device) {
+    uint8_t standbyTime = device->registerConfig >> STANDBY_TIME_POS;
+    if (device->chipId == SAPHBME280_CHIP_ID_BMP280) {
+        return standbyTimesUsBmp280[standbyTime];
+    }
+    return standbyTimesUs[standbyTime];
+}
+
 int32_t saphBme280_getMeasurements(saphBmeDevice_t* device, saphBmeMeasurements_t* result) {
     saphBmeRawMeasurements_t rawValues = {0, 0, 0};
     int32_t errorCode = saphBme280_internal_getRawMeasurement(device, &rawValues);
     if (errorCode != SAPH_BME280_NO_ERROR) {
         return errorCode;
     }
-    saphBmeMeasurements_t compensatedValues = saphBme280_internal_compensateMeasurements(device, &rawValues);
-    result->pressure = compensatedValues.pressure;
-    result->temperature = compensatedValues.temperature;
-    result->humidity = compensatedValues.humidity;
+    *result = saphBme280_internal_compensateMeasurements(device, &rawValues);
     return errorCode;
 }
 
@@ -130,6 +399,61 @@ int32_t saphBme280_getMeasurements(saphBmeDevice_t* device, saphBmeMeasurements_
 // Helper Functions
 // ###############################################
 
+// Updates the committed values after a write, a failed write leaves the sensor content unknown
+static int32_t finishCommit(saphBmeDevice_t* device, int32_t errorCode, uint8_t committedRegisters) {
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        device->committedValid &= ~committedRegisters;
+        return errorCode;
+    }
+    if (committedRegisters & COMMITTED_CTRL_HUMIDITY) {
+        device->committedCtrlHumidity = device->registerCtrlHumidity;
+    }
+    if (committedRegisters & COMMITTED_MEASURE_CTRL) {
+        device->committedMeasureCtrl = device->registerMeasureCtrl;
+    }
+    if (committedRegisters & COMMITTED_CONFIG) {
+        device->committedConfig = device->registerConfig;
+    }
+    device->committedValid |= committedRegisters;
+    if (device->verifyCommits) {
+        return saphBme280_verifyCommittedRegs(device);
+    }
+    return SAPH_BME280_NO_ERROR;
+}
+
+static bool isCommitted(saphBmeDevice_t* device, uint8_t committedRegister, uint8_t committedValue, uint8_t value) {
+    return (device->committedValid & committedRegister) && committedValue == value;
+}
 
+// The temperature phase carries the fixed part of the conversion, skipped measurements have no phase at all
+static measurementPhases_t getMeasurementPhases(saphBmeDevice_t* device, const measurementTime_t* timing) {
+    uint32_t temperatureSamples = getSamplesFromOversampling(device->registerMeasureCtrl >> TEMP_OVERSAMPLING_POS);
+    uint32_t pressureSamples = getSamplesFromOversampling(
+            (device->registerMeasureCtrl >> PRESSURE_OVERSAMPLING_POS) & BITMASK_LOWEST_THREE);
+    uint32_t humiditySamples = 0;
+    if (saphBme280_hasHumidity(device)) {
+        humiditySamples = getSamplesFromOversampling(device->registerCtrlHumidity);
+    }
+    measurementPhases_t phases = {timing->baseUs + temperatureSamples * timing->perSampleUs, 0, 0};
+    if (pressureSamples > 0) {
+        phases.pressureUs = pressureSamples * timing->perSampleUs + timing->pressureHumiditySetupUs;
+    }
+    if (humiditySamples > 0) {
+        phases.humidityUs = humiditySamples * timing->perSampleUs + timing->pressureHumiditySetupUs;
+    }
+    return phases;
+}
 
+static uint32_t getMeasurementTime(saphBmeDevice_t* device, const measurementTime_t* timing) {
+    measurementPhases_t phases = getMeasurementPhases(device, timing);
+    return phases.temperatureUs + phases.pressureUs + phases.humidityUs;
+}
 
+// Oversampling codes above x16 are treated as x16 by the sensor
+static uint32_t getSamplesFromOversampling(uint8_t oversampling) {
+    if (oversampling == OVERSAMPLING_SKIP) {
+        return 0;
+    }
+    uint32_t samples = 1u << (oversampling - 1);
+    return samples > OVERSAMPLING_MAX_SAMPLES ? OVERSAMPLING_MAX_SAMPLES : samples;
+}
@@ -2,6 +2,7 @@
 #define SAPHBME280_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef struct saphBmeTrimmingValues_t {
     uint16_t dig_T1;
@@ -26,9 +27,16 @@ typedef struct saphBmeTrimmingValues_t {
 
 typedef struct saphBmeDevice_t {
     uint8_t address;
+    uint8_t chipId;
     uint8_t registerCtrlHumidity;
     uint8_t registerMeasureCtrl;
     uint8_t registerConfig;
+    // Values the sensor is known to hold, only meaningful for the registers flagged in committedValid
+    uint8_t committedCtrlHumidity;
+    uint8_t committedMeasureCtrl;
+    uint8_t committedConfig;
+    uint8_t committedValid;
+    bool verifyCommits;
     saphBmeTrimmingValues_t trimmingValues;
 } saphBmeDevice_t;
 
@@ -43,6 +51,15 @@ typedef struct saphBmeMeasurements_t {
 #define SAPH_BME280_COMM_ERROR_READ_AMOUNT -12
 #define SAPH_BME280_NULL_POINTER_ERROR -20
 #define SAPH_BME280_RESERVED_ADDR_ERROR -30
+#define SAPH_BME280_UNKNOWN_CHIP_ERROR -40
+#define SAPH_BME280_UNKNOWN_PROFILE_ERROR -41
+#define SAPH_BME280_VERIFY_ERROR -42
+// The data registers still hold their reset value, no conversion finished since power up or a reset of the sensor
+#define SAPH_BME280_NO_MEASUREMENT_ERROR -44
+
+// Contents of the id register, the BMP280 shares the register map minus humidity
+#define SAPHBME280_CHIP_ID_BME280 0x60
+#define SAPHBME280_CHIP_ID_BMP280 0x58
 
 #define OVERSAMPLING_SKIP 0x00
 #define OVERSAMPLING_x1 0x01
@@ -64,16 +81,31 @@ typedef struct saphBmeMeasurements_t {
 #define SAPHBME280_STANDBY_TIME_MS_10_0 0x06
 #define SAPHBME280_STANDBY_TIME_MS_20_0 0x07
 
+// Supply current in sleep mode, datasheet table 1
+#define SAPHBME280_SLEEP_CURRENT_NA 100
+
+// Bits of the status register
+#define SAPHBME280_STATUS_MEASURING 0x08
+#define SAPHBME280_STATUS_IM_UPDATE 0x01
+
 #define SAPHBME280_IIR_FILTER_COEFFICIENT_OFF 0x00
 #define SAPHBME280_IIR_FILTER_COEFFICIENT_2 0x01
 #define SAPHBME280_IIR_FILTER_COEFFICIENT_4 0x02
 #define SAPHBME280_IIR_FILTER_COEFFICIENT_8 0x03
 #define SAPHBME280_IIR_FILTER_COEFFICIENT_16 0x04
 
+// Recommended modes of operation, datasheet chapter 3.5
+#define SAPHBME280_PROFILE_WEATHER_MONITORING 0
+#define SAPHBME280_PROFILE_HUMIDITY_SENSING 1
+#define SAPHBME280_PROFILE_INDOOR_NAVIGATION 2
+#define SAPHBME280_PROFILE_GAMING 3
+
 int32_t saphBme280_init(uint8_t address, saphBmeDevice_t* device);
 
 int32_t saphBme280_getId(saphBmeDevice_t* device);
 
+bool saphBme280_hasHumidity(saphBmeDevice_t* device);
+
 int32_t saphBme280_resetDevice(saphBmeDevice_t* device);
 
 void saphBme280_prepareMeasureCtrlReg(saphBmeDevice_t* device, uint8_t tempOversampling, uint8_t pressureOversampling,
@@ -89,8 +121,28 @@ void saphBme280_prepareCtrlHumidityReg(saphBmeDevice_t* device, uint8_t humidity
 
 int32_t saphBme280_commitCtrlHumidity(saphBmeDevice_t* device);
 
+int32_t saphBme280_prepareProfile(saphBmeDevice_t* device, uint8_t profile);
+
+int32_t saphBme280_commitAllRegs(saphBmeDevice_t* device);
+
+int32_t saphBme280_commitChangedRegs(saphBmeDevice_t* device);
+
+int32_t saphBme280_triggerForcedMeasurement(saphBmeDevice_t* device);
+
+void saphBme280_setVerifyCommits(saphBmeDevice_t* device, bool verifyCommits);
+
+int32_t saphBme280_verifyCommittedRegs(saphBmeDevice_t* device);
+
 int32_t saphBme280_status(saphBmeDevice_t* device, uint8_t* buffer);
 
+uint32_t saphBme280_getMeasurementTimeUs(saphBmeDevice_t* device);
+
+uint32_t saphBme280_getTypicalMeasurementTimeUs(saphBmeDevice_t* device);
+
+uint64_t saphBme280_getMeasurementCharge(saphBmeDevice_t* device);
+
+uint32_t saphBme280_getStandbyTimeUs(saphBmeDevice_t* device);
+
 int32_t saphBme280_getMeasurements(saphBmeDevice_t* device, saphBmeMeasurements_t* result);
 
 int32_t saphBme280_getPressure(saphBmeDevice_t* device, uint32_t* resultBuffer);
@@ -0,0 +1,123 @@
+#include "saphBme280_burst.h"
+#include "saphBme280_internal.h"
+
+#include <string.h>
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static uint32_t advanceSlot(const saphBme280_burst_ring_t* ring, uint32_t slot, uint32_t steps);
+
+static void decodeSpan(saphBme280_burst_ring_t* ring, uint32_t firstSlot, uint32_t amount,
+                       const saphBme280_burst_columns_t* columns, uint32_t columnOffset);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+/* *
+ * The burst size follows the chip, 8 bytes for a BME280 and 6 for a BMP280, so the device has to be initialised.
+ * The ring keeps the device to compensate with, its trimming values have to stay put while samples are stored.
+ * */
+int32_t saphBme280_burst_initRing(saphBme280_burst_ring_t* ring, saphBmeDevice_t* device, uint8_t* buffer,
+                                  uint32_t bufferSize) {
+    if (ring == 0 || device == 0 || buffer == 0) {
+        return SAPHBME280_BURST_NULL_POINTER_ERROR;
+    }
+    uint32_t burstSize = saphBme280_internal_getBurstSize(device);
+    if (bufferSize < 2 * burstSize) {
+        return SAPHBME280_BURST_BUFFER_TOO_SMALL_ERROR;
+    }
+    memset(ring, 0, sizeof(saphBme280_burst_ring_t));
+    ring->device = device;
+    ring->bytes = buffer;
+    ring->burstSize = burstSize;
+    ring->slots = bufferSize / burstSize;
+    return SAPHBME280_BURST_NO_ERROR;
+}
+
+// Bursts the ring holds before it starts giving up the oldest
+uint32_t saphBme280_burst_getCapacity(const saphBme280_burst_ring_t* ring) {
+    return ring->slots - 1;
+}
+
+/* *
+ * One burst read of the data registers into the free slot, stored only if it holds a measurement.
+ * Returns the error code of the read, SAPH_BME280_NO_MEASUREMENT_ERROR after a reset of the sensor.
+ * */
+int32_t saphBme280_burst_read(saphBme280_burst_ring_t* ring) {
+    if (ring == 0) {
+        return SAPHBME280_BURST_NULL_POINTER_ERROR;
+    }
+    uint32_t freeSlot = advanceSlot(ring, ring->oldest, ring->amount);
+    int32_t errorCode = saphBme280_internal_readRawBurst(ring->device, ring->bytes + freeSlot * ring->burstSize);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    if (ring->amount == saphBme280_burst_getCapacity(ring)) {
+        ring->oldest = advanceSlot(ring, ring->oldest, 1);
+        ring->overwritten++;
+    } else {
+        ring->amount++;
+    }
+    return SAPHBME280_BURST_NO_ERROR;
+}
+
+/* *
+ * Takes up to maxSamples of the oldest bursts out of the ring and compensates them into columns, oldest first.
+ * Returns the amount of samples decoded, each array of columns needs room for that many.
+ * */
+int32_t saphBme280_burst_decode(saphBme280_burst_ring_t* ring, const saphBme280_burst_columns_t* columns,
+                                uint32_t maxSamples) {
+    if (ring == 0 || columns == 0) {
+        return SAPHBME280_BURST_NULL_POINTER_ERROR;
+    }
+    uint32_t amount = ring->amount < maxSamples ? ring->amount : maxSamples;
+    uint32_t untilWrap = ring->slots - ring->oldest;
+    uint32_t firstSpan = amount < untilWrap ? amount : untilWrap;
+    decodeSpan(ring, ring->oldest, firstSpan, columns, 0);
+    decodeSpan(ring, 0, amount - firstSpan, columns, firstSpan);
+    ring->oldest = advanceSlot(ring, ring->oldest, amount);
+    ring->amount -= amount;
+    return (int32_t) amount;
+}
+
+/* *
+ * Compensates the stored sample index, 0 being the oldest, on demand and leaves it in the ring.
+ * Looking at a sample twice does the math twice, decode what is needed more than once.
+ * */
+int32_t saphBme280_burst_peek(const saphBme280_burst_ring_t* ring, uint32_t index, saphBmeMeasurements_t* result) {
+    if (ring == 0 || result == 0) {
+        return SAPHBME280_BURST_NULL_POINTER_ERROR;
+    }
+    if (index >= ring->amount) {
+        return SAPHBME280_BURST_OUT_OF_RANGE_ERROR;
+    }
+    const uint8_t* burst = ring->bytes + advanceSlot(ring, ring->oldest, index) * ring->burstSize;
+    saphBme280_internal_compensateBursts(ring->device, burst, 1, &result->temperature, &result->pressure,
+                                         &result->humidity);
+    return SAPHBME280_BURST_NO_ERROR;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+// Steps never exceed the amount of slots, the M0+ has no divide instruction to spend on a modulo
+static uint32_t advanceSlot(const saphBme280_burst_ring_t* ring, uint32_t slot, uint32_t steps) {
+    slot += steps;
+    return slot >= ring->slots ? slot - ring->slots : slot;
+}
+
+// Bursts of one span lie back to back in the buffer, they are compensated where they are
+static void decodeSpan(saphBme280_burst_ring_t* ring, uint32_t firstSlot, uint32_t amount,
+                       const saphBme280_burst_columns_t* columns, uint32_t columnOffset) {
+    if (amount == 0) {
+        return;
+    }
+    saphBme280_internal_compensateBursts(ring->device, ring->bytes + firstSlot * ring->burstSize, amount,
+                                         columns->temperature == 0 ? 0 : columns->temperature + columnOffset,
+                                         columns->pressure == 0 ? 0 : columns->pressure + columnOffset,
+                                         columns->humidity == 0 ? 0 : columns->humidity + columnOffset);
+}
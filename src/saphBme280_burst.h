@@ -0,0 +1,50 @@
+#ifndef SAPHBME280_BURST_H
+#define SAPHBME280_BURST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+
+#define SAPHBME280_BURST_NO_ERROR 0
+#define SAPHBME280_BURST_NULL_POINTER_ERROR -20
+#define SAPHBME280_BURST_OUT_OF_RANGE_ERROR -45
+#define SAPHBME280_BURST_BUFFER_TOO_SMALL_ERROR -48
+
+/* *
+ * Raw bursts of the data registers in a byte buffer of the caller, read off the bus straight into their slot and
+ * decoded only when taken out, in bulk. The buffer is cut into slots of one burst each, one slot stays free for
+ * the read in progress, so a failed read never costs a stored burst. A full ring gives up its oldest burst.
+ * Samples that are dropped or aggregated as raw values are never compensated at all. On the host, a device with
+ * the chip id and trimming values of the board compensates bursts uploaded from it the same way.
+ * */
+typedef struct saphBme280_burst_ring_t {
+    saphBmeDevice_t* device;
+    uint8_t* bytes;
+    uint32_t burstSize;
+    uint32_t slots;
+    uint32_t oldest;
+    uint32_t amount;
+    uint32_t overwritten;
+} saphBme280_burst_ring_t;
+
+// One array per quantity, sample i of a decode lands at index i of each. A null array skips that quantity
+typedef struct saphBme280_burst_columns_t {
+    int32_t* temperature;
+    uint32_t* pressure;
+    uint32_t* humidity;
+} saphBme280_burst_columns_t;
+
+int32_t saphBme280_burst_initRing(saphBme280_burst_ring_t* ring, saphBmeDevice_t* device, uint8_t* buffer,
+                                  uint32_t bufferSize);
+
+uint32_t saphBme280_burst_getCapacity(const saphBme280_burst_ring_t* ring);
+
+int32_t saphBme280_burst_read(saphBme280_burst_ring_t* ring);
+
+int32_t saphBme280_burst_decode(saphBme280_burst_ring_t* ring, const saphBme280_burst_columns_t* columns,
+                                uint32_t maxSamples);
+
+int32_t saphBme280_burst_peek(const saphBme280_burst_ring_t* ring, uint32_t index, saphBmeMeasurements_t* result);
+
+#endif // SAPHBME280_BURST_H
@@ -0,0 +1,213 @@
+#include "saphBme280_derived.h"
+
+// Magnus coefficients, b as 0.01 and c in 0.01 degC
+#define MAGNUS_B 1762
+#define MAGNUS_C 24312
+// 44330 m in cm and the exponent 1/5.255 of the international barometric formula
+#define BAROMETRIC_HEIGHT_CM 4433000
+#define BAROMETRIC_EXPONENT_Q24 88164270
+#define INVERSE_BAROMETRIC_EXPONENT_Q30 204327654
+// 13.2471 = 6.112 hPa * 2.1674 g K / J, scaled by 10^5 to give 0.01 g/m^3 with the temperature in 0.01 K
+#define ABSOLUTE_HUMIDITY_FACTOR 1324715
+#define ZERO_CELSIUS_IN_CENTI_KELVIN 27315
+
+#define LN2_Q30 744261118
+#define LN2_Q31 1488522236
+#define LOG2_E_Q30 1549082005
+#define LOG2_100_Q24 111465410
+
+#define TABLE_BITS 6
+
+// log2(1 + i / 64) in Q31
+static const uint32_t log2Table[] = {
+        0, 48034513, 95335645, 141925456, 187825021, 233054496,
+        277633165, 321579490, 364911162, 407645136, 449797678, 491384396,
+        532420281, 572919734, 612896598, 652364189, 691335320, 729822324,
+        767837083, 805391046, 842495250, 879160341, 915396590, 951213914,
+        986621888, 1021629764, 1056246482, 1090480686, 1124340739, 1157834731,
+        1190970490, 1223755601, 1256197405, 1288303019, 1320079339, 1351533050,
+        1382670639, 1413498396, 1444022426, 1474248656, 1504182841, 1533830570,
+        1563197273, 1592288229, 1621108567, 1649663276, 1677957208, 1705995083,
+        1733781493, 1761320910, 1788617686, 1815676059, 1842500157, 1869094003,
+        1895461516, 1921606515, 1947532725, 1973243777, 1998743213, 2024034488,
+        2049120974, 2074005959, 2098692655, 2123184198,
+};
+
+// 1 / (1 + i / 64) in Q31
+static const uint32_t reciprocalTable[] = {
+        2147483648, 2114445438, 2082408386, 2051327664, 2021161080, 1991868891,
+        1963413621, 1935759908, 1908874354, 1882725390, 1857283155, 1832519380,
+        1808407283, 1784921474, 1762037865, 1739733588, 1717986918, 1696777203,
+        1676084798, 1655891006, 1636178018, 1616928864, 1598127366, 1579758086,
+        1561806289, 1544257904, 1527099483, 1510318170, 1493901668, 1477838209,
+        1462116526, 1446725826, 1431655765, 1416896428, 1402438301, 1388272257,
+        1374389535, 1360781718, 1347440720, 1334358772, 1321528399, 1308942414,
+        1296593901, 1284476201, 1272582903, 1260907830, 1249445032, 1238188770,
+        1227133513, 1216273925, 1205604855, 1195121335, 1184818564, 1174691910,
+        1164736894, 1154949189, 1145324612, 1135859120, 1126548799, 1117389866,
+        1108378657, 1099511628, 1090785345, 1082196484,
+};
+
+// 2^(i / 64) in Q31
+static const uint32_t exp2Table[] = {
+        2147483648, 2170868212, 2194507417, 2218404036, 2242560872, 2266980759,
+        2291666561, 2316621173, 2341847524, 2367348571, 2393127307, 2419186755,
+        2445529972, 2472160047, 2499080105, 2526293303, 2553802834, 2581611923,
+        2609723834, 2638141863, 2666869345, 2695909648, 2725266179, 2754942382,
+        2784941738, 2815267765, 2845924021, 2876914102, 2908241642, 2939910317,
+        2971923842, 3004285971, 3037000500, 3070071267, 3103502151, 3137297074,
+        3171459999, 3205994934, 3240905930, 3276197082, 3311872529, 3347936457,
+        3384393094, 3421246719, 3458501653, 3496162267, 3534232978, 3572718252,
+        3611622603, 3650950594, 3690706840, 3730896002, 3771522796, 3812591987,
+        3854108391, 3896076880, 3938502376, 3981389855, 4024744348, 4068570940,
+        4112874773, 4157661043, 4202935003, 4248701965,
+};
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static int32_t log2Q24(uint64_t value);
+
+static uint64_t exp2Q30(int32_t exponent);
+
+static int64_t getMagnusTermQ24(int32_t temperature);
+
+static int64_t divideRounded(int64_t dividend, int64_t divisor);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t saphBme280_derived_dewPoint(const saphBmeMeasurements_t* measurements, int32_t* dewPoint) {
+    if (measurements == 0 || dewPoint == 0) {
+        return SAPHBME280_DERIVED_NULL_POINTER_ERROR;
+    }
+    if (measurements->humidity == 0) {
+        return SAPHBME280_DERIVED_OUT_OF_RANGE_ERROR;
+    }
+    // Humidity is in Q22.10 %RH, ln(RH / 100 %) = ln 2 * (log2(humidity) - 10 - log2(100))
+    int64_t log2Humidity = log2Q24(measurements->humidity) - (10 << 24) - LOG2_100_Q24;
+    int64_t gamma = ((log2Humidity * LN2_Q30) >> 30) + getMagnusTermQ24(measurements->temperature);
+    // c * gamma / (b - gamma), with b and c both scaled by 100
+    *dewPoint = (int32_t) divideRounded(MAGNUS_C * 100 * gamma, (int64_t) MAGNUS_B * (1 << 24) - 100 * gamma);
+    return SAPHBME280_DERIVED_NO_ERROR;
+}
+
+int32_t saphBme280_derived_absoluteHumidity(const saphBmeMeasurements_t* measurements, uint32_t* absoluteHumidity) {
+    if (measurements == 0 || absoluteHumidity == 0) {
+        return SAPHBME280_DERIVED_NULL_POINTER_ERROR;
+    }
+    // Saturation vapour pressure relative to 6.112 hPa, e^(magnus term) in Q30
+    int64_t magnusTerm = getMagnusTermQ24(measurements->temperature);
+    uint64_t saturation = exp2Q30((int32_t) ((magnusTerm * LOG2_E_Q30) >> 30));
+    uint64_t vapour = (saturation * measurements->humidity) >> 10;
+    uint64_t temperatureCentiKelvin = (uint64_t) (ZERO_CELSIUS_IN_CENTI_KELVIN + measurements->temperature);
+    uint64_t result = vapour * ABSOLUTE_HUMIDITY_FACTOR / (temperatureCentiKelvin * 10);
+    *absoluteHumidity = (uint32_t) ((result + (1u << 29)) >> 30);
+    return SAPHBME280_DERIVED_NO_ERROR;
+}
+
+int32_t saphBme280_derived_altitude(const saphBmeMeasurements_t* measurements, uint32_t seaLevelPressure,
+                                    int32_t* altitude) {
+    if (measurements == 0 || altitude == 0) {
+        return SAPHBME280_DERIVED_NULL_POINTER_ERROR;
+    }
+    if (measurements->pressure == 0 || seaLevelPressure == 0) {
+        return SAPHBME280_DERIVED_OUT_OF_RANGE_ERROR;
+    }
+    // (p / p0)^(1 / 5.255) as 2^(log2(p / p0) / 5.255)
+    int64_t log2Ratio = (int64_t) log2Q24(measurements->pressure) - log2Q24(seaLevelPressure);
+    uint64_t ratio = exp2Q30((int32_t) ((log2Ratio * INVERSE_BAROMETRIC_EXPONENT_Q30) >> 30));
+    int64_t height = (int64_t) BAROMETRIC_HEIGHT_CM * ((int64_t) (1 << 30) - (int64_t) ratio);
+    *altitude = (int32_t) ((height + (1 << 29)) >> 30);
+    return SAPHBME280_DERIVED_NO_ERROR;
+}
+
+int32_t saphBme280_derived_seaLevelPressure(const saphBmeMeasurements_t* measurements, int32_t altitude,
+                                            uint32_t* seaLevelPressure) {
+    if (measurements == 0 || seaLevelPressure == 0) {
+        return SAPHBME280_DERIVED_NULL_POINTER_ERROR;
+    }
+    // p / (1 - h / 44330 m)^5.255 as p * 2^(-5.255 * log2(1 - h / 44330 m))
+    int64_t base = (int64_t) (1 << 30) - divideRounded((int64_t) altitude * (1 << 30), BAROMETRIC_HEIGHT_CM);
+    if (base <= 0) {
+        return SAPHBME280_DERIVED_OUT_OF_RANGE_ERROR;
+    }
+    int64_t log2Base = (int64_t) log2Q24((uint64_t) base) - (30 << 24);
+    uint64_t factor = exp2Q30((int32_t) (-((log2Base * BAROMETRIC_EXPONENT_Q24) >> 24))) >> 6;
+    // Factors beyond 256 would overflow below and are far outside the atmosphere anyway
+    if (factor >= ((uint64_t) 1 << 32)) {
+        return SAPHBME280_DERIVED_OUT_OF_RANGE_ERROR;
+    }
+    uint64_t result = (measurements->pressure * factor + (1u << 23)) >> 24;
+    if (result > UINT32_MAX) {
+        return SAPHBME280_DERIVED_OUT_OF_RANGE_ERROR;
+    }
+    *seaLevelPressure = (uint32_t) result;
+    return SAPHBME280_DERIVED_NO_ERROR;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+/* *
+ * log2 of a positive integer in Q24. The normalised mantissa picks a table entry, the small rest e relative to
+ * that entry goes through ln(1 + e) = e - e^2 / 2 + e^3 / 3, which is exact to 2^-26 for e < 1 / 64.
+ * */
+static int32_t log2Q24(uint64_t value) {
+    int32_t exponent = 63;
+    for (uint8_t shift = 32; shift > 0; shift >>= 1) {
+        if ((value >> (64 - shift)) == 0) {
+            value <<= shift;
+            exponent -= shift;
+        }
+    }
+    uint32_t mantissa = (uint32_t) (value >> 32);
+    uint32_t index = (mantissa >> (31 - TABLE_BITS)) & ((1u << TABLE_BITS) - 1);
+    uint32_t rest = mantissa & ((1u << (31 - TABLE_BITS)) - 1);
+    int64_t relative = (int64_t) (((uint64_t) rest * reciprocalTable[index]) >> 31);
+    int64_t relativeSquared = (relative * relative) >> 31;
+    int64_t relativeCubed = (relativeSquared * relative) >> 31;
+    int64_t logRest = relative - relativeSquared / 2 + relativeCubed / 3;
+    int64_t log2Rest = (logRest * LOG2_E_Q30) >> 30;
+    return exponent * (1 << 24) + (int32_t) ((log2Table[index] + log2Rest + 64) >> 7);
+}
+
+/* *
+ * 2^x for x in Q24, result in Q30. The fraction splits into a table entry and a rest d < 1 / 64,
+ * 2^d = 1 + t + t^2 / 2 + t^3 / 6 with t = d ln 2 is exact to 2^-30.
+ * Saturates at 2^33 and underflows to 0 below 2^-30.
+ * */
+static uint64_t exp2Q30(int32_t exponent) {
+    int32_t integer = exponent >> 24;
+    uint32_t fraction = (uint32_t) exponent & ((1u << 24) - 1);
+    uint32_t index = fraction >> (24 - TABLE_BITS);
+    uint64_t rest = fraction & ((1u << (24 - TABLE_BITS)) - 1);
+    uint64_t scaledRest = ((rest << 7) * LN2_Q31) >> 31;
+    uint64_t scaledRestSquared = (scaledRest * scaledRest) >> 31;
+    uint64_t scaledRestCubed = (scaledRestSquared * scaledRest) >> 31;
+    uint64_t power = (1ull << 31) + scaledRest + scaledRestSquared / 2 + scaledRestCubed / 6;
+    uint64_t mantissa = (exp2Table[index] * power) >> 31;
+    int32_t shift = integer - 1;
+    if (shift >= 0) {
+        return shift > 31 ? UINT64_MAX : mantissa << shift;
+    }
+    if (-shift >= 40) {
+        return 0;
+    }
+    return (mantissa + (1ull << (-shift - 1))) >> -shift;
+}
+
+// b * T / (c + T) of the Magnus formula, natural log scale in Q24
+static int64_t getMagnusTermQ24(int32_t temperature) {
+    return divideRounded((int64_t) temperature * MAGNUS_B * (1 << 24), 100 * ((int64_t) MAGNUS_C + temperature));
+}
+
+static int64_t divideRounded(int64_t dividend, int64_t divisor) {
+    if ((dividend >= 0) == (divisor >= 0)) {
+        return (dividend + divisor / 2) / divisor;
+    }
+    return (dividend - divisor / 2) / divisor;
+}
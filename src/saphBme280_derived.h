@@ -0,0 +1,38 @@
+#ifndef SAPHBME280_DERIVED_H
+#define SAPHBME280_DERIVED_H
+
+#include <stdint.h>
+
+#include "saphBme280.h"
+
+#define SAPHBME280_DERIVED_NO_ERROR 0
+#define SAPHBME280_DERIVED_NULL_POINTER_ERROR -20
+#define SAPHBME280_DERIVED_OUT_OF_RANGE_ERROR -45
+
+// 1013.25 hPa in the Q24.8 Pa of saphBmeMeasurements_t
+#define SAPHBME280_DERIVED_STANDARD_SEA_LEVEL_PRESSURE (101325u * 256u)
+
+/* *
+ * Quantities derived from a compensated measurement without floating point.
+ * log2 and exp2 come from 64 entry tables refined by a short polynomial. Errors against the same formulas
+ * in double precision, over -40 to 85 degC, 1 to 100 %RH and 300 to 1100 hPa:
+ * dew point +-0.01 degC, absolute humidity +-0.01 g/m^3, altitude +-1 cm,
+ * sea level pressure +-0.05 Pa for altitudes up to 9 km.
+ * The formulas themselves (Magnus, international barometric formula) are of course less accurate than that.
+ * */
+
+// Magnus formula with Sonntag's coefficients over water, in 0.01 degC
+int32_t saphBme280_derived_dewPoint(const saphBmeMeasurements_t* measurements, int32_t* dewPoint);
+
+// Water vapour density in 0.01 g/m^3
+int32_t saphBme280_derived_absoluteHumidity(const saphBmeMeasurements_t* measurements, uint32_t* absoluteHumidity);
+
+// Height above the level of seaLevelPressure (Q24.8 Pa) in cm, international barometric formula
+int32_t saphBme280_derived_altitude(const saphBmeMeasurements_t* measurements, uint32_t seaLevelPressure,
+                                    int32_t* altitude);
+
+// Pressure reduced from altitude (cm) to sea level in Q24.8 Pa, the inverse of saphBme280_derived_altitude
+int32_t saphBme280_derived_seaLevelPressure(const saphBmeMeasurements_t* measurements, int32_t altitude,
+                                            uint32_t* seaLevelPressure);
+
+#endif // SAPHBME280_DERIVED_H
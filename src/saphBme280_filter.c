@@ -0,0 +1,207 @@
+#include "saphBme280_filter.h"
+
+#include <string.h>
+
+#define AMOUNT_CHANNELS 3
+#define CHANNEL_PRESSURE 0
+#define CHANNEL_TEMPERATURE 1
+#define CHANNEL_HUMIDITY 2
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static void initKind(saphBme280_filter_t* filter, uint8_t kind, uint8_t length, uint8_t order);
+
+static int32_t pushMovingAverage(saphBme280_filter_t* filter, int32_t* values);
+
+static int32_t pushCic(saphBme280_filter_t* filter, int32_t* values);
+
+static int32_t pushIir(saphBme280_filter_t* filter, int32_t* values);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t saphBme280_filter_initMovingAverage(saphBme280_filter_t* filter, uint8_t length) {
+    if (filter == 0) {
+        return SAPHBME280_FILTER_NULL_POINTER_ERROR;
+    }
+    if (length == 0 || length > SAPHBME280_FILTER_MAX_LENGTH) {
+        return SAPHBME280_FILTER_INVALID_CONFIG_ERROR;
+    }
+    initKind(filter, SAPHBME280_FILTER_KIND_MOVING_AVERAGE, length, 0);
+    return SAPHBME280_FILTER_NO_ERROR;
+}
+
+/* *
+ * Integrator/comb decimator with a differential delay of one, outputs one sample per decimation inputs.
+ * Order one is a block average, higher orders suppress aliasing better at the cost of a longer settling time.
+ * */
+int32_t saphBme280_filter_initCic(saphBme280_filter_t* filter, uint8_t decimation, uint8_t order) {
+    if (filter == 0) {
+        return SAPHBME280_FILTER_NULL_POINTER_ERROR;
+    }
+    if (decimation == 0 || decimation > SAPHBME280_FILTER_MAX_LENGTH || order == 0 ||
+        order > SAPHBME280_FILTER_MAX_CIC_ORDER) {
+        return SAPHBME280_FILTER_INVALID_CONFIG_ERROR;
+    }
+    initKind(filter, SAPHBME280_FILTER_KIND_CIC, decimation, order);
+    return SAPHBME280_FILTER_NO_ERROR;
+}
+
+// Same response as the sensor's filter, datasheet chapter 3.4.4, but with fraction bits in the state
+int32_t saphBme280_filter_initIir(saphBme280_filter_t* filter, uint8_t iirFilterCoefficient) {
+    if (filter == 0) {
+        return SAPHBME280_FILTER_NULL_POINTER_ERROR;
+    }
+    if (iirFilterCoefficient > SAPHBME280_IIR_FILTER_COEFFICIENT_16) {
+        return SAPHBME280_FILTER_INVALID_CONFIG_ERROR;
+    }
+    initKind(filter, SAPHBME280_FILTER_KIND_IIR, 1, iirFilterCoefficient);
+    return SAPHBME280_FILTER_NO_ERROR;
+}
+
+// Drops the history but keeps the configuration
+void saphBme280_filter_reset(saphBme280_filter_t* filter) {
+    if (filter == 0) {
+        return;
+    }
+    filter->position = 0;
+    filter->fill = 0;
+    memset(filter->channels, 0, sizeof(filter->channels));
+}
+
+int32_t saphBme280_filter_push(saphBme280_filter_t* filter, const saphBmeRawMeasurements_t* input,
+                               saphBmeRawMeasurements_t* output) {
+    if (filter == 0 || input == 0 || output == 0) {
+        return SAPHBME280_FILTER_NULL_POINTER_ERROR;
+    }
+    int32_t values[AMOUNT_CHANNELS];
+    values[CHANNEL_PRESSURE] = input->pressure;
+    values[CHANNEL_TEMPERATURE] = input->temperature;
+    values[CHANNEL_HUMIDITY] = input->humidity;
+    int32_t outcome;
+    switch (filter->kind) {
+        case SAPHBME280_FILTER_KIND_MOVING_AVERAGE:
+            outcome = pushMovingAverage(filter, values);
+            break;
+        case SAPHBME280_FILTER_KIND_CIC:
+            outcome = pushCic(filter, values);
+            break;
+        case SAPHBME280_FILTER_KIND_IIR:
+            outcome = pushIir(filter, values);
+            break;
+        default:
+            outcome = SAPHBME280_FILTER_OUTPUT_READY;
+            break;
+    }
+    if (outcome == SAPHBME280_FILTER_OUTPUT_READY) {
+        output->pressure = values[CHANNEL_PRESSURE];
+        output->temperature = values[CHANNEL_TEMPERATURE];
+        output->humidity = values[CHANNEL_HUMIDITY];
+    }
+    return outcome;
+}
+
+// Reads one raw sample through the filter, result is only written if the filter produced an output
+int32_t saphBme280_filter_getMeasurements(saphBmeDevice_t* device, saphBme280_filter_t* filter,
+                                          saphBmeMeasurements_t* result) {
+    if (device == 0 || filter == 0 || result == 0) {
+        return SAPHBME280_FILTER_NULL_POINTER_ERROR;
+    }
+    saphBmeRawMeasurements_t rawValues = {0, 0, 0};
+    int32_t errorCode = saphBme280_internal_getRawMeasurement(device, &rawValues);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    saphBmeRawMeasurements_t filteredValues = {0, 0, 0};
+    int32_t outcome = saphBme280_filter_push(filter, &rawValues, &filteredValues);
+    if (outcome == SAPHBME280_FILTER_OUTPUT_READY) {
+        *result = saphBme280_internal_compensateMeasurements(device, &filteredValues);
+    }
+    return outcome;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static void initKind(saphBme280_filter_t* filter, uint8_t kind, uint8_t length, uint8_t order) {
+    filter->kind = kind;
+    filter->length = length;
+    filter->order = order;
+    filter->cicGain = 1;
+    if (kind == SAPHBME280_FILTER_KIND_CIC) {
+        for (uint8_t i = 0; i < order; ++i) {
+            filter->cicGain *= length;
+        }
+    }
+    saphBme280_filter_reset(filter);
+}
+
+// Running sum over a ring buffer, averages over what is there until the window is full
+static int32_t pushMovingAverage(saphBme280_filter_t* filter, int32_t* values) {
+    if (filter->fill < filter->length) {
+        filter->fill++;
+    }
+    for (uint8_t i = 0; i < AMOUNT_CHANNELS; ++i) {
+        saphBme280_filterChannel_t* channel = &(filter->channels[i]);
+        channel->sum += values[i] - channel->history[filter->position];
+        channel->history[filter->position] = values[i];
+        values[i] = (channel->sum + filter->fill / 2) / filter->fill;
+    }
+    filter->position++;
+    if (filter->position >= filter->length) {
+        filter->position = 0;
+    }
+    return SAPHBME280_FILTER_OUTPUT_READY;
+}
+
+// The first order - 1 decimated outputs are still settling and get dropped
+static int32_t pushCic(saphBme280_filter_t* filter, int32_t* values) {
+    filter->position++;
+    bool decimate = filter->position >= filter->length;
+    for (uint8_t i = 0; i < AMOUNT_CHANNELS; ++i) {
+        saphBme280_filterChannel_t* channel = &(filter->channels[i]);
+        uint32_t accumulator = (uint32_t) values[i];
+        for (uint8_t stage = 0; stage < filter->order; ++stage) {
+            channel->integrators[stage] += accumulator;
+            accumulator = channel->integrators[stage];
+        }
+        if (!decimate) {
+            continue;
+        }
+        for (uint8_t stage = 0; stage < filter->order; ++stage) {
+            uint32_t delayed = channel->combDelays[stage];
+            channel->combDelays[stage] = accumulator;
+            accumulator -= delayed;
+        }
+        values[i] = (int32_t) ((accumulator + filter->cicGain / 2) / filter->cicGain);
+    }
+    if (!decimate) {
+        return SAPHBME280_FILTER_NO_OUTPUT;
+    }
+    filter->position = 0;
+    if (filter->fill < filter->order) {
+        filter->fill++;
+    }
+    return filter->fill >= filter->order ? SAPHBME280_FILTER_OUTPUT_READY : SAPHBME280_FILTER_NO_OUTPUT;
+}
+
+// Starts from the first sample instead of zero, otherwise the output would need many samples to rise
+static int32_t pushIir(saphBme280_filter_t* filter, int32_t* values) {
+    for (uint8_t i = 0; i < AMOUNT_CHANNELS; ++i) {
+        saphBme280_filterChannel_t* channel = &(filter->channels[i]);
+        int32_t scaled = values[i] << SAPHBME280_FILTER_IIR_FRACTION_BITS;
+        if (filter->fill == 0) {
+            channel->iirState = scaled;
+        } else {
+            channel->iirState += (scaled - channel->iirState) >> filter->order;
+        }
+        values[i] = (channel->iirState + (1 << (SAPHBME280_FILTER_IIR_FRACTION_BITS - 1)))
+                >> SAPHBME280_FILTER_IIR_FRACTION_BITS;
+    }
+    filter->fill = 1;
+    return SAPHBME280_FILTER_OUTPUT_READY;
+}
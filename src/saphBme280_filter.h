@@ -0,0 +1,68 @@
+#ifndef SAPHBME280_FILTER_H
+#define SAPHBME280_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+
+#define SAPHBME280_FILTER_NO_ERROR 0
+#define SAPHBME280_FILTER_NULL_POINTER_ERROR -20
+#define SAPHBME280_FILTER_INVALID_CONFIG_ERROR -43
+
+// Positive results of saphBme280_filter_push and saphBme280_filter_getMeasurements
+#define SAPHBME280_FILTER_NO_OUTPUT 0
+#define SAPHBME280_FILTER_OUTPUT_READY 1
+
+#define SAPHBME280_FILTER_KIND_NONE 0
+#define SAPHBME280_FILTER_KIND_MOVING_AVERAGE 1
+#define SAPHBME280_FILTER_KIND_CIC 2
+#define SAPHBME280_FILTER_KIND_IIR 3
+
+// Matches the x16 of the sensor's own oversampling
+#define SAPHBME280_FILTER_MAX_LENGTH 16
+#define SAPHBME280_FILTER_MAX_CIC_ORDER 3
+// Fraction bits the IIR keeps in its state so small steps do not get lost to truncation
+#define SAPHBME280_FILTER_IIR_FRACTION_BITS 8
+
+typedef struct saphBme280_filterChannel_t {
+    int32_t history[SAPHBME280_FILTER_MAX_LENGTH];
+    int32_t sum;
+    // CIC stages run modulo 2^32, the comb outputs are exact as long as the result fits
+    uint32_t integrators[SAPHBME280_FILTER_MAX_CIC_ORDER];
+    uint32_t combDelays[SAPHBME280_FILTER_MAX_CIC_ORDER];
+    int32_t iirState;
+} saphBme280_filterChannel_t;
+
+/* *
+ * Filter stage on raw ADC values, outputs stay in the raw 20/16 bit scale so they can be compensated as usual.
+ * One channel each for pressure, temperature and humidity.
+ * */
+typedef struct saphBme280_filter_t {
+    uint8_t kind;
+    // Window of the moving average, decimation factor of the CIC
+    uint8_t length;
+    // Stages of the CIC, shift of the IIR
+    uint8_t order;
+    uint8_t position;
+    uint8_t fill;
+    uint32_t cicGain;
+    saphBme280_filterChannel_t channels[3];
+} saphBme280_filter_t;
+
+int32_t saphBme280_filter_initMovingAverage(saphBme280_filter_t* filter, uint8_t length);
+
+int32_t saphBme280_filter_initCic(saphBme280_filter_t* filter, uint8_t decimation, uint8_t order);
+
+int32_t saphBme280_filter_initIir(saphBme280_filter_t* filter, uint8_t iirFilterCoefficient);
+
+void saphBme280_filter_reset(saphBme280_filter_t* filter);
+
+int32_t saphBme280_filter_push(saphBme280_filter_t* filter, const saphBmeRawMeasurements_t* input,
+                               saphBmeRawMeasurements_t* output);
+
+int32_t saphBme280_filter_getMeasurements(saphBmeDevice_t* device, saphBme280_filter_t* filter,
+                                          saphBmeMeasurements_t* result);
+
+#endif // SAPHBME280_FILTER_H
@@ -17,6 +17,8 @@ static uint32_t getMeasurement20BitFromBuffer(const uint8_t* buffer);
 
 static uint32_t getMeasurement16itFromBuffer(const uint8_t* buffer);
 
+static bool isAtResetValues(const uint8_t* burst, bool hasHumidity);
+
 static int32_t readTrimmingValues(saphBmeDevice_t* device, uint8_t* buffer);
 
 static inline void setTemperatureTrimmingValues(saphBmeDevice_t* device, const uint8_t* buffer);
@@ -44,14 +46,18 @@ int32_t saphBme280_internal_writeToRegister(saphBmeDevice_t* device, uint8_t* bu
 }
 
 
+// The pointer write and the read share one hold of the bus lock, another core could move the pointer otherwise
 int32_t saphBme280_internal_readFromRegister(saphBmeDevice_t* device, uint8_t regAddress, uint8_t* readingBuffer,
                                              uint32_t readAmount) {
     int32_t commResult = 0;
+    i2c_handler_lock();
     if ((commResult = saphBme280_internal_writeToRegister(device, &regAddress, 1)) != SAPH_BME280_NO_ERROR) {
+        i2c_handler_unlock();
         return commResult;
     }
 
     commResult = i2c_handler_read(device->address, readingBuffer, readAmount);
+    i2c_handler_unlock();
     if (commResult != readAmount) {
         return saphBme280_internal_getErrorCode(commResult, false);
     }
@@ -62,6 +68,7 @@ int32_t saphBme280_internal_readFromRegister(saphBmeDevice_t* device, uint8_t re
 #define BURST_READ_TRIM_FIRST 25
 #define BURST_READ_TRIM_SECOND 1
 #define BURST_READ_TRIM_THIRD 7
+#define BURST_READ_TRIM_PRESSURE_ONLY 24
 
 int32_t saphBme280_internal_readTrimmingValues(saphBmeDevice_t* device) {
     uint8_t buffer[BURST_READ_TRIM_FIRST + BURST_READ_TRIM_SECOND + BURST_READ_TRIM_THIRD];
@@ -71,25 +78,34 @@ int32_t saphBme280_internal_readTrimmingValues(saphBmeDevice_t* device) {
     }
     setTemperatureTrimmingValues(device, buffer);
     setPressureTrimmingValues(device, buffer);
-    setHumidityTrimmingValues(device, buffer);
+    if (saphBme280_hasHumidity(device)) {
+        setHumidityTrimmingValues(device, buffer);
+    }
 
     return SAPH_BME280_NO_ERROR;
 }
 
-#define MEASUREMENT_DATA_AMOUNT 8
 #define REG_PRESSURE_START_ADDR 0xF7
+// 0x80 0x00 0x00 in the pressure and temperature registers and 0x80 0x00 in humidity, also what skipped ones read as
+#define RAW_20BIT_RESET_VALUE 0x80000
+#define RAW_HUMIDITY_RESET_VALUE 0x8000
 
 int32_t saphBme280_internal_getRawMeasurement(saphBmeDevice_t* device, saphBmeRawMeasurements_t* result) {
-    uint8_t receiveBuffer[MEASUREMENT_DATA_AMOUNT];
+    uint8_t receiveBuffer[SAPHBME280_BURST_SIZE];
+    bool hasHumidity = saphBme280_hasHumidity(device);
+    uint32_t readAmount = saphBme280_internal_getBurstSize(device);
     int32_t commResult = saphBme280_internal_readFromRegister(device, REG_PRESSURE_START_ADDR, (uint8_t*) receiveBuffer,
-                                                              MEASUREMENT_DATA_AMOUNT);
+                                                              readAmount);
     if (commResult != SAPH_BME280_NO_ERROR) {
         return commResult;
     }
 
     result->pressure = getMeasurement20BitFromBuffer(receiveBuffer);
     result->temperature = getMeasurement20BitFromBuffer(receiveBuffer + 3);
-    result->humidity = getMeasurement16itFromBuffer(receiveBuffer + 6);
+    result->humidity = hasHumidity ? getMeasurement16itFromBuffer(receiveBuffer + 6) : 0;
+    if (isAtResetValues(receiveBuffer, hasHumidity)) {
+        return SAPH_BME280_NO_MEASUREMENT_ERROR;
+    }
     return SAPH_BME280_NO_ERROR;
 }
 
@@ -99,10 +115,59 @@ saphBme280_internal_compensateMeasurements(saphBmeDevice_t* device, saphBmeRawMe
     tempResults_t temps = compensateTemperature(device, rawMeasurements->temperature);
     result.temperature = temps.temperature;
     result.pressure = compensatePressure(device, rawMeasurements->pressure, temps.fineTemperature);
-    result.humidity = compensateHumidity(device, rawMeasurements->humidity, temps.fineTemperature);
+    result.humidity = 0;
+    if (saphBme280_hasHumidity(device)) {
+        result.humidity = compensateHumidity(device, rawMeasurements->humidity, temps.fineTemperature);
+    }
     return result;
 }
 
+uint32_t saphBme280_internal_getBurstSize(saphBmeDevice_t* device) {
+    return saphBme280_hasHumidity(device) ? SAPHBME280_BURST_SIZE : SAPHBME280_BURST_SIZE_NO_HUMIDITY;
+}
+
+/* *
+ * Reads the data registers into buffer as they come off the bus, getBurstSize bytes, nothing is decoded.
+ * The buffer holds the burst even when the sensor reports no measurement, it is the caller's to discard.
+ * */
+int32_t saphBme280_internal_readRawBurst(saphBmeDevice_t* device, uint8_t* buffer) {
+    int32_t commResult = saphBme280_internal_readFromRegister(device, REG_PRESSURE_START_ADDR, buffer,
+                                                              saphBme280_internal_getBurstSize(device));
+    if (commResult != SAPH_BME280_NO_ERROR) {
+        return commResult;
+    }
+    if (isAtResetValues(buffer, saphBme280_hasHumidity(device))) {
+        return SAPH_BME280_NO_MEASUREMENT_ERROR;
+    }
+    return SAPH_BME280_NO_ERROR;
+}
+
+/* *
+ * Compensates amount bursts lying back to back into one array per quantity, with no structs in between.
+ * A null array skips that quantity and its math, the temperature is computed either way since the others need it.
+ * Without humidity on the sensor the humidity array is filled with 0.
+ * */
+void saphBme280_internal_compensateBursts(saphBmeDevice_t* device, const uint8_t* bursts, uint32_t amount,
+                                          int32_t* temperature, uint32_t* pressure, uint32_t* humidity) {
+    bool hasHumidity = saphBme280_hasHumidity(device);
+    uint32_t burstSize = saphBme280_internal_getBurstSize(device);
+    for (uint32_t i = 0; i < amount; ++i) {
+        const uint8_t* burst = bursts + i * burstSize;
+        tempResults_t temps = compensateTemperature(device, (int32_t) getMeasurement20BitFromBuffer(burst + 3));
+        if (temperature != 0) {
+            temperature[i] = temps.temperature;
+        }
+        if (pressure != 0) {
+            pressure[i] = compensatePressure(device, (int32_t) getMeasurement20BitFromBuffer(burst),
+                                             temps.fineTemperature);
+        }
+        if (humidity != 0) {
+            humidity[i] = hasHumidity ? compensateHumidity(device, (int32_t) getMeasurement16itFromBuffer(burst + 6),
+                                                           temps.fineTemperature) : 0;
+        }
+    }
+}
+
 int32_t saphBme280_internal_getErrorCode(int32_t commResult, bool wasWriting) {
     if (wasWriting) {
         if (commResult >= 0) {
@@ -132,11 +197,25 @@ static uint32_t getMeasurement16itFromBuffer(const uint8_t* buffer) {
     return (buffer[0] << 8) + (buffer[1]);
 }
 
+/* *
+ * A sensor reset between trigger and read leaves all data registers at their reset value. One of them alone is no
+ * proof, e.g. a raw temperature of 0x80000 is about 26.5 degC and a possible reading at x1 oversampling.
+ * */
+static bool isAtResetValues(const uint8_t* burst, bool hasHumidity) {
+    return getMeasurement20BitFromBuffer(burst) == RAW_20BIT_RESET_VALUE &&
+           getMeasurement20BitFromBuffer(burst + 3) == RAW_20BIT_RESET_VALUE &&
+           (!hasHumidity || getMeasurement16itFromBuffer(burst + 6) == RAW_HUMIDITY_RESET_VALUE);
+}
+
 
 static int32_t readTrimmingValues(saphBmeDevice_t* device, uint8_t* buffer) {
     uint8_t startingAddressFirst = 0x88;
     uint8_t startingAddressSecond = 0xA1;
     uint8_t startingAddressThird = 0xE1;
+    if (!saphBme280_hasHumidity(device)) {
+        // 0xA0 only pads the BME280 layout up to dig_H1, a BMP280 is done after dig_P9
+        return saphBme280_internal_readFromRegister(device, startingAddressFirst, buffer, BURST_READ_TRIM_PRESSURE_ONLY);
+    }
     int32_t errorCode = saphBme280_internal_readFromRegister(device, startingAddressFirst, buffer,
                                                              BURST_READ_TRIM_FIRST);
     if (errorCode != SAPH_BME280_NO_ERROR) {
@@ -181,7 +260,7 @@ static uint32_t compensatePressure(saphBmeDevice_t* device, int32_t rawPressure,
     }
     pressure = 1048576 - rawPressure;
     pressure = (((pressure << 31) - value2) * 3125) / value1;
-    value1 = (((int64_t) trims->dig_P9) * (pressure >> 13) * (pressure > 13)) >> 25;
+    value1 = (((int64_t) trims->dig_P9) * (pressure >> 13) * (pressure >> 13)) >> 25;
     value2 = (((int64_t) trims->dig_P8) * pressure) >> 19;
     pressure = ((pressure + value1 + value2) >> 8) + (((int64_t) trims->dig_P7) << 4);
     uint32_t result = (uint32_t) pressure;
@@ -194,11 +273,13 @@ static uint32_t compensateHumidity(saphBmeDevice_t* device, int32_t rawHumidity,
     variable = (fineTemperature - ((int32_t) 76800));
     variable =
             ((((rawHumidity << 14) - (((int32_t) trims->dig_H4) << 20) -
-               (((int32_t) trims->dig_H5) * variable)) + ((int32_t) 16348)) >> 15) *
-            (((((((variable * ((int32_t) trims->dig_H6) >> 10) * (variable * ((int32_t) trims->dig_H3)) >> 11) +
-                 ((int32_t) 32768)) >> 10) + ((int32_t) 2097152)) * ((int32_t) trims->dig_H2) + 8192) >> 14);
+               (((int32_t) trims->dig_H5) * variable)) + ((int32_t) 16384)) >> 15) *
+            (((((((variable * ((int32_t) trims->dig_H6)) >> 10) *
+                 (((variable * ((int32_t) trims->dig_H3)) >> 11) + ((int32_t) 32768))) >> 10) +
+               ((int32_t) 2097152)) * ((int32_t) trims->dig_H2) + 8192) >> 14);
     variable = (variable - (((((variable >> 15) * (variable >> 15)) >> 7) * ((int32_t) trims->dig_H1)) >> 4));
     variable = (variable < 0 ? 0 : variable);
+    variable = (variable > 419430400 ? 419430400 : variable);
     return (uint32_t) (variable >> 12);
 }
 
@@ -4,6 +4,11 @@
 #include <stdbool.h>
 #include "saphBme280.h"
 
+// Data registers from 0xF7 on as one burst, pressure, temperature and humidity as the sensor sends them
+#define SAPHBME280_BURST_SIZE 8
+// The BMP280 has no humidity registers
+#define SAPHBME280_BURST_SIZE_NO_HUMIDITY 6
+
 typedef struct saphBmeRawMeasurements_t {
     int32_t pressure;
     int32_t temperature;
@@ -24,4 +29,11 @@ int32_t saphBme280_internal_getRawMeasurement(saphBmeDevice_t* device, saphBmeRa
 saphBmeMeasurements_t
 saphBme280_internal_compensateMeasurements(saphBmeDevice_t* device, saphBmeRawMeasurements_t* rawMeasurements);
 
+uint32_t saphBme280_internal_getBurstSize(saphBmeDevice_t* device);
+
+int32_t saphBme280_internal_readRawBurst(saphBmeDevice_t* device, uint8_t* buffer);
+
+void saphBme280_internal_compensateBursts(saphBmeDevice_t* device, const uint8_t* bursts, uint32_t amount,
+                                          int32_t* temperature, uint32_t* pressure, uint32_t* humidity);
+
 #endif // SAPHBME280_INTERNAL_H
@@ -0,0 +1,87 @@
+#include "saphBme280_report.h"
+
+#include <string.h>
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static bool isBeyond(int64_t value, int64_t reference, uint32_t deadband);
+
+static bool hasMoved(const saphBme280_reportConfig_t* config, const saphBmeMeasurements_t* measurements,
+                     const saphBmeMeasurements_t* reference);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t saphBme280_report_init(saphBme280_report_t* report, const saphBme280_reportConfig_t* config) {
+    if (report == 0 || config == 0) {
+        return SAPHBME280_REPORT_NULL_POINTER_ERROR;
+    }
+    memset(report, 0, sizeof(saphBme280_report_t));
+    report->config = *config;
+    return SAPHBME280_REPORT_NO_ERROR;
+}
+
+/* *
+ * Returns SAPHBME280_REPORT_EMIT if the sample should be passed on to display, log or USB,
+ * SAPHBME280_REPORT_SUPPRESSED if it is within the deadbands of the last emitted one and the heartbeat has not expired,
+ * or a negative error code. The first sample of a sensor is always emitted.
+ * */
+int32_t saphBme280_report_offer(saphBme280_report_t* report, uint8_t address,
+                                const saphBmeMeasurements_t* measurements, uint32_t nowUs) {
+    if (report == 0 || measurements == 0) {
+        return SAPHBME280_REPORT_NULL_POINTER_ERROR;
+    }
+    saphBme280_reportSensor_t* sensor = saphBme280_report_getSensor(report, address);
+    if (sensor == 0) {
+        if (report->amountSensors >= SAPHBME280_REPORT_MAX_SENSORS) {
+            return SAPHBME280_REPORT_NO_FREE_SLOT_ERROR;
+        }
+        sensor = &(report->sensors[report->amountSensors]);
+        report->amountSensors++;
+        sensor->address = address;
+    }
+    sensor->offered++;
+    bool heartbeatExpired = report->config.heartbeatUs != 0 &&
+                            (uint32_t) (nowUs - sensor->lastEmittedUs) >= report->config.heartbeatUs;
+    if (sensor->hasEmitted && !heartbeatExpired && !hasMoved(&(report->config), measurements, &(sensor->lastEmitted))) {
+        return SAPHBME280_REPORT_SUPPRESSED;
+    }
+    sensor->hasEmitted = true;
+    sensor->lastEmitted = *measurements;
+    sensor->lastEmittedUs = nowUs;
+    sensor->emitted++;
+    return SAPHBME280_REPORT_EMIT;
+}
+
+// Returns 0 if the sensor has not offered a sample yet
+saphBme280_reportSensor_t* saphBme280_report_getSensor(saphBme280_report_t* report, uint8_t address) {
+    if (report == 0) {
+        return 0;
+    }
+    for (uint8_t i = 0; i < report->amountSensors; ++i) {
+        if (report->sensors[i].address == address) {
+            return &(report->sensors[i]);
+        }
+    }
+    return 0;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static bool isBeyond(int64_t value, int64_t reference, uint32_t deadband) {
+    int64_t difference = value > reference ? value - reference : reference - value;
+    return difference > deadband;
+}
+
+// Compared against the last emitted sample, so a slow drift gets reported once it adds up to a deadband
+static bool hasMoved(const saphBme280_reportConfig_t* config, const saphBmeMeasurements_t* measurements,
+                     const saphBmeMeasurements_t* reference) {
+    return isBeyond(measurements->pressure, reference->pressure, config->pressureDeadband) ||
+           isBeyond(measurements->temperature, reference->temperature, config->temperatureDeadband) ||
+           isBeyond(measurements->humidity, reference->humidity, config->humidityDeadband);
+}
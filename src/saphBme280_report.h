@@ -0,0 +1,57 @@
+#ifndef SAPHBME280_REPORT_H
+#define SAPHBME280_REPORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+
+#define SAPHBME280_REPORT_NO_ERROR 0
+#define SAPHBME280_REPORT_NULL_POINTER_ERROR -20
+#define SAPHBME280_REPORT_NO_FREE_SLOT_ERROR -46
+
+// Positive results of saphBme280_report_offer
+#define SAPHBME280_REPORT_SUPPRESSED 0
+#define SAPHBME280_REPORT_EMIT 1
+
+// Same as the sensors discovery can find on one bus
+#define SAPHBME280_REPORT_MAX_SENSORS 2
+
+/* *
+ * Deadbands in the units of saphBmeMeasurements_t, a sample is emitted once a field moved further than this
+ * from the last emitted sample. A heartbeat of 0 turns the heartbeat off.
+ * */
+typedef struct saphBme280_reportConfig_t {
+    uint32_t pressureDeadband;
+    uint32_t temperatureDeadband;
+    uint32_t humidityDeadband;
+    uint32_t heartbeatUs;
+} saphBme280_reportConfig_t;
+
+typedef struct saphBme280_reportSensor_t {
+    uint8_t address;
+    bool hasEmitted;
+    saphBmeMeasurements_t lastEmitted;
+    uint32_t lastEmittedUs;
+    uint32_t offered;
+    uint32_t emitted;
+} saphBme280_reportSensor_t;
+
+/* *
+ * Keeps the last emitted sample per sensor, keyed by its I2C address.
+ * Times are microseconds of a free running 32 bit clock, e.g. time_us_32(), wrap around is handled.
+ * */
+typedef struct saphBme280_report_t {
+    saphBme280_reportConfig_t config;
+    uint8_t amountSensors;
+    saphBme280_reportSensor_t sensors[SAPHBME280_REPORT_MAX_SENSORS];
+} saphBme280_report_t;
+
+int32_t saphBme280_report_init(saphBme280_report_t* report, const saphBme280_reportConfig_t* config);
+
+int32_t saphBme280_report_offer(saphBme280_report_t* report, uint8_t address,
+                                const saphBmeMeasurements_t* measurements, uint32_t nowUs);
+
+saphBme280_reportSensor_t* saphBme280_report_getSensor(saphBme280_report_t* report, uint8_t address);
+
+#endif // SAPHBME280_REPORT_H
@@ -0,0 +1,176 @@
+#include "saphBme280_sampler.h"
+
+#include <string.h>
+
+// Polls during a conversion are spaced a quarter of the shorter phase of the cycle apart
+#define RETRY_INTERVAL_DIVISOR 4
+// Typical and maximum conversion time differ by about 15%, polling starts this fraction early at first
+#define GUARD_DIVISOR 4
+// Each measured period moves the estimate by this fraction of the difference
+#define PERIOD_SMOOTHING 4
+// Measured periods further off than this fraction of the estimate are discarded
+#define PERIOD_TOLERANCE_DIVISOR 4
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static bool isTimeReached(uint32_t nowUs, uint32_t targetUs);
+
+static int32_t checkConversion(saphBme280_sampler_t* sampler, uint32_t nowUs);
+
+static void updateTiming(saphBme280_sampler_t* sampler, uint32_t nowUs);
+
+static void learnPeriod(saphBme280_sampler_t* sampler, uint32_t edgeUs);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+/* *
+ * Expects the device to have just been committed to normal mode with the prepared register values,
+ * the first conversion then finishes about one typical measurement time later.
+ * The period starts out at the datasheet typical and follows the observed conversions from there.
+ * */
+int32_t saphBme280_sampler_init(saphBme280_sampler_t* sampler, saphBmeDevice_t* device, uint32_t nowUs) {
+    if (sampler == 0 || device == 0) {
+        return SAPHBME280_SAMPLER_NULL_POINTER_ERROR;
+    }
+    memset(sampler, 0, sizeof(saphBme280_sampler_t));
+    uint32_t measurementTimeUs = saphBme280_getTypicalMeasurementTimeUs(device);
+    uint32_t standbyTimeUs = saphBme280_getStandbyTimeUs(device);
+    uint32_t shorterPhaseUs = measurementTimeUs < standbyTimeUs ? measurementTimeUs : standbyTimeUs;
+    sampler->device = device;
+    sampler->periodUs = measurementTimeUs + standbyTimeUs;
+    sampler->retryIntervalUs = shorterPhaseUs / RETRY_INTERVAL_DIVISOR;
+    sampler->guardUs = measurementTimeUs / GUARD_DIVISOR;
+    sampler->maxGuardUs = measurementTimeUs / 2;
+    sampler->readyUs = nowUs - standbyTimeUs;
+    sampler->nextPollUs = sampler->readyUs + sampler->periodUs - sampler->guardUs;
+    return SAPHBME280_SAMPLER_NO_ERROR;
+}
+
+/* *
+ * Returns SAPHBME280_SAMPLER_FRESH_SAMPLE with result filled in if a conversion finished since the last fresh sample,
+ * SAPHBME280_SAMPLER_NO_SAMPLE if not, or a negative error code.
+ *
+ * Calls before the next conversion is due cost no bus traffic. Polling starts a guard time before the expected end
+ * of the next conversion, after it has started, so the measuring bit going low marks it as done.
+ * Catching that edge between two close polls keeps the period estimate and the poll timing in phase and lets the
+ * guard shrink, in phase a sample costs two status reads and one burst read.
+ * */
+int32_t saphBme280_sampler_poll(saphBme280_sampler_t* sampler, uint32_t nowUs, saphBmeMeasurements_t* result) {
+    if (sampler == 0 || result == 0) {
+        return SAPHBME280_SAMPLER_NULL_POINTER_ERROR;
+    }
+    int32_t outcome = checkConversion(sampler, nowUs);
+    if (outcome != SAPHBME280_SAMPLER_FRESH_SAMPLE) {
+        return outcome;
+    }
+    int32_t errorCode = saphBme280_getMeasurements(sampler->device, result);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    updateTiming(sampler, nowUs);
+    sampler->freshSamples++;
+    return SAPHBME280_SAMPLER_FRESH_SAMPLE;
+}
+
+/* *
+ * Same as saphBme280_sampler_poll, but a fresh sample goes into ring as its raw burst and is compensated only when
+ * it is taken out with saphBme280_burst_decode or looked at with saphBme280_burst_peek.
+ * The ring has to belong to the sampler's device, a ring of another one is rejected before anything is read.
+ * */
+int32_t saphBme280_sampler_pollRaw(saphBme280_sampler_t* sampler, uint32_t nowUs, saphBme280_burst_ring_t* ring) {
+    if (sampler == 0 || ring == 0) {
+        return SAPHBME280_SAMPLER_NULL_POINTER_ERROR;
+    }
+    if (ring->device != sampler->device) {
+        return SAPHBME280_SAMPLER_INVALID_CONFIG_ERROR;
+    }
+    int32_t outcome = checkConversion(sampler, nowUs);
+    if (outcome != SAPHBME280_SAMPLER_FRESH_SAMPLE) {
+        return outcome;
+    }
+    int32_t errorCode = saphBme280_burst_read(ring);
+    if (errorCode != SAPHBME280_BURST_NO_ERROR) {
+        return errorCode;
+    }
+    updateTiming(sampler, nowUs);
+    sampler->freshSamples++;
+    return SAPHBME280_SAMPLER_FRESH_SAMPLE;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+// SAPHBME280_SAMPLER_FRESH_SAMPLE once the next conversion is done and can be read, nothing is read yet
+static int32_t checkConversion(saphBme280_sampler_t* sampler, uint32_t nowUs) {
+    if (!isTimeReached(nowUs, sampler->nextPollUs)) {
+        sampler->duplicatesAvoided++;
+        return SAPHBME280_SAMPLER_NO_SAMPLE;
+    }
+    uint8_t status = 0;
+    int32_t errorCode = saphBme280_status(sampler->device, &status);
+    sampler->statusReads++;
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    if (status & (SAPHBME280_STATUS_MEASURING | SAPHBME280_STATUS_IM_UPDATE)) {
+        if (sampler->busyPolls < UINT8_MAX) {
+            sampler->busyPolls++;
+        }
+        sampler->lastBusyUs = nowUs;
+        sampler->nextPollUs = nowUs + sampler->retryIntervalUs;
+        sampler->duplicatesAvoided++;
+        return SAPHBME280_SAMPLER_NO_SAMPLE;
+    }
+    return SAPHBME280_SAMPLER_FRESH_SAMPLE;
+}
+
+static bool isTimeReached(uint32_t nowUs, uint32_t targetUs) {
+    return (int32_t) (nowUs - targetUs) >= 0;
+}
+
+/* *
+ * A busy status shortly before this idle one brackets the end of the conversion, more than one busy poll means
+ * polling started earlier than needed. Without a busy poll the conversion ended at some unknown point before now,
+ * so the guard grows until the next end is caught again.
+ * */
+static void updateTiming(saphBme280_sampler_t* sampler, uint32_t nowUs) {
+    bool bracketed = sampler->busyPolls > 0 &&
+                     !isTimeReached(nowUs, sampler->lastBusyUs + 2 * sampler->retryIntervalUs);
+    if (bracketed) {
+        learnPeriod(sampler, nowUs);
+        if (sampler->busyPolls > 1 && sampler->guardUs >= 2 * sampler->retryIntervalUs) {
+            sampler->guardUs -= sampler->retryIntervalUs;
+        }
+    } else {
+        sampler->hasEdge = false;
+        sampler->guardUs += 2 * sampler->retryIntervalUs;
+        if (sampler->guardUs > sampler->maxGuardUs) {
+            sampler->guardUs = sampler->maxGuardUs;
+        }
+    }
+    sampler->busyPolls = 0;
+    sampler->readyUs = nowUs;
+    sampler->nextPollUs = sampler->readyUs + sampler->periodUs - sampler->guardUs;
+}
+
+// Edges further apart than one period are divided by the amount of conversions that went by in between
+static void learnPeriod(saphBme280_sampler_t* sampler, uint32_t edgeUs) {
+    if (sampler->hasEdge) {
+        uint32_t elapsedUs = edgeUs - sampler->lastEdgeUs;
+        uint32_t conversions = (elapsedUs + sampler->periodUs / 2) / sampler->periodUs;
+        if (conversions > 0) {
+            int32_t deviationUs = (int32_t) (elapsedUs / conversions) - (int32_t) sampler->periodUs;
+            int32_t toleranceUs = (int32_t) (sampler->periodUs / PERIOD_TOLERANCE_DIVISOR);
+            if (deviationUs < toleranceUs && deviationUs > -toleranceUs) {
+                sampler->periodUs += deviationUs / PERIOD_SMOOTHING;
+            }
+        }
+    }
+    sampler->lastEdgeUs = edgeUs;
+    sampler->hasEdge = true;
+}
@@ -0,0 +1,47 @@
+#ifndef SAPHBME280_SAMPLER_H
+#define SAPHBME280_SAMPLER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+#include "saphBme280_burst.h"
+
+#define SAPHBME280_SAMPLER_NO_ERROR 0
+#define SAPHBME280_SAMPLER_NULL_POINTER_ERROR -20
+#define SAPHBME280_SAMPLER_INVALID_CONFIG_ERROR -43
+
+// Positive results of saphBme280_sampler_poll
+#define SAPHBME280_SAMPLER_NO_SAMPLE 0
+#define SAPHBME280_SAMPLER_FRESH_SAMPLE 1
+
+/* *
+ * Hands out every normal mode conversion once.
+ * Times are microseconds of a free running 32 bit clock, e.g. time_us_32(), wrap around is handled.
+ * */
+typedef struct saphBme280_sampler_t {
+    saphBmeDevice_t* device;
+    uint32_t periodUs;
+    uint32_t retryIntervalUs;
+    // How long before the expected end of a conversion polling starts
+    uint32_t guardUs;
+    uint32_t maxGuardUs;
+    // Latest point in time the last handed out conversion can have finished
+    uint32_t readyUs;
+    uint32_t nextPollUs;
+    uint32_t lastBusyUs;
+    uint32_t lastEdgeUs;
+    uint8_t busyPolls;
+    bool hasEdge;
+    uint32_t freshSamples;
+    uint32_t duplicatesAvoided;
+    uint32_t statusReads;
+} saphBme280_sampler_t;
+
+int32_t saphBme280_sampler_init(saphBme280_sampler_t* sampler, saphBmeDevice_t* device, uint32_t nowUs);
+
+int32_t saphBme280_sampler_poll(saphBme280_sampler_t* sampler, uint32_t nowUs, saphBmeMeasurements_t* result);
+
+int32_t saphBme280_sampler_pollRaw(saphBme280_sampler_t* sampler, uint32_t nowUs, saphBme280_burst_ring_t* ring);
+
+#endif // SAPHBME280_SAMPLER_H
@@ -0,0 +1,182 @@
+#include "saphBme280_stats.h"
+
+#include <string.h>
+
+#define AMOUNT_CHANNELS 3
+#define CHANNEL_PRESSURE 0
+#define CHANNEL_TEMPERATURE 1
+#define CHANNEL_HUMIDITY 2
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static void accumulate(saphBme280_statsAccumulator_t* accumulator, bool isFirst, int32_t value, int32_t reference);
+
+static void merge(saphBme280_statsAccumulator_t* target, bool targetIsEmpty,
+                  const saphBme280_statsAccumulator_t* source);
+
+static void finishWindow(saphBme280_stats_t* stats, uint8_t index);
+
+static saphBme280_statsChannel_t summarize(const saphBme280_statsAccumulator_t* accumulator, uint32_t count,
+                                           int32_t reference);
+
+static int64_t divideRounded(int64_t dividend, uint32_t divisor);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+void saphBme280_stats_init(saphBme280_stats_t* stats) {
+    if (stats == 0) {
+        return;
+    }
+    memset(stats, 0, sizeof(saphBme280_stats_t));
+}
+
+// Windows have to be added shortest first
+int32_t saphBme280_stats_addWindow(saphBme280_stats_t* stats, uint32_t lengthInSamples) {
+    if (stats == 0) {
+        return SAPHBME280_STATS_NULL_POINTER_ERROR;
+    }
+    if (stats->amountWindows >= SAPHBME280_STATS_MAX_WINDOWS || lengthInSamples == 0) {
+        return SAPHBME280_STATS_INVALID_CONFIG_ERROR;
+    }
+    if (stats->amountWindows > 0) {
+        uint32_t previousLength = stats->windows[stats->amountWindows - 1].length;
+        if (lengthInSamples <= previousLength || lengthInSamples % previousLength != 0) {
+            return SAPHBME280_STATS_INVALID_CONFIG_ERROR;
+        }
+    }
+    saphBme280_statsWindow_t* window = &(stats->windows[stats->amountWindows]);
+    memset(window, 0, sizeof(saphBme280_statsWindow_t));
+    window->length = lengthInSamples;
+    stats->amountWindows++;
+    return SAPHBME280_STATS_NO_ERROR;
+}
+
+/* *
+ * Returns a bit mask of the windows that completed with this sample, their summaries are then available
+ * through saphBme280_stats_getSummary until the window completes again.
+ * */
+int32_t saphBme280_stats_push(saphBme280_stats_t* stats, const saphBmeMeasurements_t* measurements) {
+    if (stats == 0 || measurements == 0) {
+        return SAPHBME280_STATS_NULL_POINTER_ERROR;
+    }
+    if (stats->amountWindows == 0) {
+        return SAPHBME280_STATS_INVALID_CONFIG_ERROR;
+    }
+    int32_t values[AMOUNT_CHANNELS];
+    values[CHANNEL_PRESSURE] = (int32_t) measurements->pressure;
+    values[CHANNEL_TEMPERATURE] = measurements->temperature;
+    values[CHANNEL_HUMIDITY] = (int32_t) measurements->humidity;
+    if (!stats->hasReference) {
+        memcpy(stats->reference, values, sizeof(values));
+        stats->hasReference = true;
+    }
+    saphBme280_statsWindow_t* shortest = &(stats->windows[0]);
+    for (uint8_t i = 0; i < AMOUNT_CHANNELS; ++i) {
+        accumulate(&(shortest->channels[i]), shortest->count == 0, values[i], stats->reference[i]);
+    }
+    shortest->count++;
+
+    int32_t completed = 0;
+    for (uint8_t i = 0; i < stats->amountWindows && stats->windows[i].count >= stats->windows[i].length; ++i) {
+        finishWindow(stats, i);
+        completed |= 1 << i;
+    }
+    return completed;
+}
+
+int32_t saphBme280_stats_getSummary(saphBme280_stats_t* stats, uint8_t window, saphBme280_statsSummary_t* summary) {
+    if (stats == 0 || summary == 0) {
+        return SAPHBME280_STATS_NULL_POINTER_ERROR;
+    }
+    if (window >= stats->amountWindows) {
+        return SAPHBME280_STATS_INVALID_CONFIG_ERROR;
+    }
+    if (!stats->windows[window].hasSummary) {
+        return SAPHBME280_STATS_NO_SUMMARY_ERROR;
+    }
+    *summary = stats->windows[window].summary;
+    return SAPHBME280_STATS_NO_ERROR;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static void accumulate(saphBme280_statsAccumulator_t* accumulator, bool isFirst, int32_t value, int32_t reference) {
+    if (isFirst) {
+        accumulator->min = value;
+        accumulator->max = value;
+    } else if (value < accumulator->min) {
+        accumulator->min = value;
+    } else if (value > accumulator->max) {
+        accumulator->max = value;
+    }
+    int64_t deviation = (int64_t) value - reference;
+    accumulator->sum += deviation;
+    accumulator->sumSquares += (uint64_t) (deviation * deviation);
+}
+
+// Both share the reference of the engine, so merging is plain addition
+static void merge(saphBme280_statsAccumulator_t* target, bool targetIsEmpty,
+                  const saphBme280_statsAccumulator_t* source) {
+    if (targetIsEmpty || source->min < target->min) {
+        target->min = source->min;
+    }
+    if (targetIsEmpty || source->max > target->max) {
+        target->max = source->max;
+    }
+    target->sum += source->sum;
+    target->sumSquares += source->sumSquares;
+}
+
+// Publishes the summary and hands the accumulated values up to the next longer window
+static void finishWindow(saphBme280_stats_t* stats, uint8_t index) {
+    saphBme280_statsWindow_t* window = &(stats->windows[index]);
+    window->summary.count = window->count;
+    window->summary.pressure = summarize(&(window->channels[CHANNEL_PRESSURE]), window->count,
+                                         stats->reference[CHANNEL_PRESSURE]);
+    window->summary.temperature = summarize(&(window->channels[CHANNEL_TEMPERATURE]), window->count,
+                                            stats->reference[CHANNEL_TEMPERATURE]);
+    window->summary.humidity = summarize(&(window->channels[CHANNEL_HUMIDITY]), window->count,
+                                         stats->reference[CHANNEL_HUMIDITY]);
+    window->hasSummary = true;
+
+    if (index + 1 < stats->amountWindows) {
+        saphBme280_statsWindow_t* longer = &(stats->windows[index + 1]);
+        for (uint8_t i = 0; i < AMOUNT_CHANNELS; ++i) {
+            merge(&(longer->channels[i]), longer->count == 0, &(window->channels[i]));
+        }
+        longer->count += window->count;
+    }
+    window->count = 0;
+    memset(window->channels, 0, sizeof(window->channels));
+}
+
+/* *
+ * Population variance as (sumSquares - sum^2 / n) / n, with sum^2 / n split into quotient and remainder
+ * of sum / n so the intermediate products stay within 64 bit.
+ * */
+static saphBme280_statsChannel_t summarize(const saphBme280_statsAccumulator_t* accumulator, uint32_t count,
+                                           int32_t reference) {
+    saphBme280_statsChannel_t channel;
+    channel.min = accumulator->min;
+    channel.max = accumulator->max;
+    channel.mean = (int32_t) (reference + divideRounded(accumulator->sum, count));
+    int64_t quotient = accumulator->sum / count;
+    int64_t remainder = accumulator->sum % count;
+    uint64_t sumSquaredByCount = (uint64_t) (quotient * accumulator->sum + remainder * accumulator->sum / count);
+    uint64_t variance = (accumulator->sumSquares - sumSquaredByCount) / count;
+    channel.variance = variance > UINT32_MAX ? UINT32_MAX : (uint32_t) variance;
+    return channel;
+}
+
+static int64_t divideRounded(int64_t dividend, uint32_t divisor) {
+    if (dividend >= 0) {
+        return (dividend + divisor / 2) / divisor;
+    }
+    return (dividend - divisor / 2) / divisor;
+}
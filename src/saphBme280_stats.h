@@ -0,0 +1,69 @@
+#ifndef SAPHBME280_STATS_H
+#define SAPHBME280_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+
+#define SAPHBME280_STATS_NO_ERROR 0
+#define SAPHBME280_STATS_NULL_POINTER_ERROR -20
+#define SAPHBME280_STATS_INVALID_CONFIG_ERROR -43
+#define SAPHBME280_STATS_NO_SUMMARY_ERROR -44
+
+#define SAPHBME280_STATS_MAX_WINDOWS 4
+
+/* *
+ * Sums of the deviations from a reference sample, exact in 64 bit for windows of up to millions of samples,
+ * so neither the mean nor the variance suffers from cancellation.
+ * */
+typedef struct saphBme280_statsAccumulator_t {
+    int32_t min;
+    int32_t max;
+    int64_t sum;
+    uint64_t sumSquares;
+} saphBme280_statsAccumulator_t;
+
+// Units as in saphBmeMeasurements_t, the variance in those units squared
+typedef struct saphBme280_statsChannel_t {
+    int32_t min;
+    int32_t max;
+    int32_t mean;
+    uint32_t variance;
+} saphBme280_statsChannel_t;
+
+typedef struct saphBme280_statsSummary_t {
+    uint32_t count;
+    saphBme280_statsChannel_t pressure;
+    saphBme280_statsChannel_t temperature;
+    saphBme280_statsChannel_t humidity;
+} saphBme280_statsSummary_t;
+
+typedef struct saphBme280_statsWindow_t {
+    uint32_t length;
+    uint32_t count;
+    saphBme280_statsAccumulator_t channels[3];
+    bool hasSummary;
+    saphBme280_statsSummary_t summary;
+} saphBme280_statsWindow_t;
+
+/* *
+ * Tumbling windows of increasing length, each a multiple of the one before.
+ * Only the shortest window sees every sample, the longer ones merge the completed shorter windows.
+ * */
+typedef struct saphBme280_stats_t {
+    uint8_t amountWindows;
+    bool hasReference;
+    int32_t reference[3];
+    saphBme280_statsWindow_t windows[SAPHBME280_STATS_MAX_WINDOWS];
+} saphBme280_stats_t;
+
+void saphBme280_stats_init(saphBme280_stats_t* stats);
+
+int32_t saphBme280_stats_addWindow(saphBme280_stats_t* stats, uint32_t lengthInSamples);
+
+int32_t saphBme280_stats_push(saphBme280_stats_t* stats, const saphBmeMeasurements_t* measurements);
+
+int32_t saphBme280_stats_getSummary(saphBme280_stats_t* stats, uint8_t window, saphBme280_statsSummary_t* summary);
+
+#endif // SAPHBME280_STATS_H
@@ -0,0 +1,132 @@
+#include "saph_cycleBench.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static void emptyOp(void* context, uint32_t iteration);
+
+static uint32_t timeIteration(saph_cycleBench_t* bench, saph_cycleBench_op_t op, void* context, uint32_t iteration);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t saph_cycleBench_init(saph_cycleBench_t* bench, saph_cycleBench_counter_t readCounter, uint32_t counterMask,
+                             bool countsDown) {
+    if (bench == 0 || readCounter == 0) {
+        return SAPH_CYCLEBENCH_NULL_POINTER_ERROR;
+    }
+    // Only counters of a power of two period wrap cleanly under the mask
+    if (counterMask == 0 || (counterMask & (counterMask + 1)) != 0) {
+        return SAPH_CYCLEBENCH_INVALID_CONFIG_ERROR;
+    }
+    bench->readCounter = readCounter;
+    bench->counterMask = counterMask;
+    bench->countsDown = countsDown;
+    bench->overheadCycles = 0;
+    return SAPH_CYCLEBENCH_NO_ERROR;
+}
+
+// Cycles between two counter readings, correct across one wrap of the counter
+uint32_t saph_cycleBench_elapsed(saph_cycleBench_t* bench, uint32_t start, uint32_t end) {
+    if (bench == 0) {
+        return 0;
+    }
+    uint32_t difference = bench->countsDown ? start - end : end - start;
+    return difference & bench->counterMask;
+}
+
+// The fastest empty iteration becomes the overhead, so no real operation can come out negative
+int32_t saph_cycleBench_calibrate(saph_cycleBench_t* bench, uint32_t iterations) {
+    if (bench == 0) {
+        return SAPH_CYCLEBENCH_NULL_POINTER_ERROR;
+    }
+    if (iterations == 0) {
+        return SAPH_CYCLEBENCH_INVALID_CONFIG_ERROR;
+    }
+    bench->overheadCycles = 0;
+    uint32_t fastest = UINT32_MAX;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        uint32_t cycles = timeIteration(bench, emptyOp, 0, i);
+        if (cycles < fastest) {
+            fastest = cycles;
+        }
+    }
+    bench->overheadCycles = fastest;
+    return SAPH_CYCLEBENCH_NO_ERROR;
+}
+
+int32_t saph_cycleBench_run(saph_cycleBench_t* bench, const char* name, saph_cycleBench_op_t op, void* context,
+                            uint32_t iterations, saph_cycleBench_result_t* result) {
+    if (bench == 0 || name == 0 || op == 0 || result == 0) {
+        return SAPH_CYCLEBENCH_NULL_POINTER_ERROR;
+    }
+    if (iterations == 0) {
+        return SAPH_CYCLEBENCH_INVALID_CONFIG_ERROR;
+    }
+    memset(result, 0, sizeof(saph_cycleBench_result_t));
+    result->name = name;
+    result->minCycles = UINT32_MAX;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        uint32_t cycles = timeIteration(bench, op, context, i);
+        cycles = cycles > bench->overheadCycles ? cycles - bench->overheadCycles : 0;
+        if (cycles < result->minCycles) {
+            result->minCycles = cycles;
+        }
+        if (cycles > result->maxCycles) {
+            result->maxCycles = cycles;
+        }
+        result->totalCycles += cycles;
+    }
+    result->iterations = iterations;
+    return SAPH_CYCLEBENCH_NO_ERROR;
+}
+
+// Rounded to the nearest cycle, 0 for an empty result
+uint32_t saph_cycleBench_getMeanCycles(const saph_cycleBench_result_t* result) {
+    if (result == 0 || result->iterations == 0) {
+        return 0;
+    }
+    return (uint32_t) ((result->totalCycles + result->iterations / 2) / result->iterations);
+}
+
+/* *
+ * One JSON object per line, e.g. {"name":"compensate","iterations":1000,"min":812,"mean":830,"max":1104,"overhead":9}
+ * Lines of several runs can be collected from the serial port and diffed like the host bench output.
+ * Returns the length of the line or a negative error code.
+ * */
+int32_t saph_cycleBench_formatResult(const saph_cycleBench_result_t* result, uint32_t overheadCycles, char* buffer,
+                                     uint32_t bufferSize) {
+    if (result == 0 || result->name == 0 || buffer == 0) {
+        return SAPH_CYCLEBENCH_NULL_POINTER_ERROR;
+    }
+    int written = snprintf(buffer, bufferSize,
+                           "{\"name\":\"%s\",\"iterations\":%lu,\"min\":%lu,\"mean\":%lu,\"max\":%lu,\"overhead\":%lu}",
+                           result->name, (unsigned long) result->iterations, (unsigned long) result->minCycles,
+                           (unsigned long) saph_cycleBench_getMeanCycles(result), (unsigned long) result->maxCycles,
+                           (unsigned long) overheadCycles);
+    if (written < 0 || (uint32_t) written >= bufferSize) {
+        return SAPH_CYCLEBENCH_BUFFER_TOO_SMALL_ERROR;
+    }
+    return written;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static void emptyOp(void* context, uint32_t iteration) {
+    (void) context;
+    (void) iteration;
+}
+
+static uint32_t timeIteration(saph_cycleBench_t* bench, saph_cycleBench_op_t op, void* context, uint32_t iteration) {
+    uint32_t start = bench->readCounter();
+    op(context, iteration);
+    uint32_t end = bench->readCounter();
+    return saph_cycleBench_elapsed(bench, start, end);
+}
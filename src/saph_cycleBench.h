@@ -0,0 +1,54 @@
+#ifndef SAPH_CYCLEBENCH_H
+#define SAPH_CYCLEBENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define SAPH_CYCLEBENCH_NO_ERROR 0
+#define SAPH_CYCLEBENCH_NULL_POINTER_ERROR -20
+#define SAPH_CYCLEBENCH_INVALID_CONFIG_ERROR -43
+#define SAPH_CYCLEBENCH_BUFFER_TOO_SMALL_ERROR -48
+
+// SysTick of the Cortex M0+, 24 bits counting down at the processor clock
+#define SAPH_CYCLEBENCH_SYSTICK_MASK 0x00FFFFFFu
+
+typedef uint32_t (* saph_cycleBench_counter_t)(void);
+
+typedef void (* saph_cycleBench_op_t)(void* context, uint32_t iteration);
+
+/* *
+ * Times operations with a free running cycle counter of counterMask bits. Every iteration is timed on its own,
+ * so a single iteration may take up to one counter period, 134 ms for SysTick at 125 MHz.
+ * The cost of reading the counter and calling the operation is measured by calibrate and taken off every iteration.
+ * */
+typedef struct saph_cycleBench_t {
+    saph_cycleBench_counter_t readCounter;
+    uint32_t counterMask;
+    bool countsDown;
+    uint32_t overheadCycles;
+} saph_cycleBench_t;
+
+typedef struct saph_cycleBench_result_t {
+    const char* name;
+    uint32_t iterations;
+    uint32_t minCycles;
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+} saph_cycleBench_result_t;
+
+int32_t saph_cycleBench_init(saph_cycleBench_t* bench, saph_cycleBench_counter_t readCounter, uint32_t counterMask,
+                             bool countsDown);
+
+uint32_t saph_cycleBench_elapsed(saph_cycleBench_t* bench, uint32_t start, uint32_t end);
+
+int32_t saph_cycleBench_calibrate(saph_cycleBench_t* bench, uint32_t iterations);
+
+int32_t saph_cycleBench_run(saph_cycleBench_t* bench, const char* name, saph_cycleBench_op_t op, void* context,
+                            uint32_t iterations, saph_cycleBench_result_t* result);
+
+uint32_t saph_cycleBench_getMeanCycles(const saph_cycleBench_result_t* result);
+
+int32_t saph_cycleBench_formatResult(const saph_cycleBench_result_t* result, uint32_t overheadCycles, char* buffer,
+                                     uint32_t bufferSize);
+
+#endif // SAPH_CYCLEBENCH_H
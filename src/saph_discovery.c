@@ -0,0 +1,135 @@
+#include "saph_discovery.h"
+#include "saphBme280.h"
+#include "saph_ssd1306.h"
+
+#include <string.h>
+
+typedef struct candidate_t {
+    uint8_t address;
+    bool isDisplay;
+} candidate_t;
+
+// Every address the supported parts can be strapped to, in bus order.
+// SSD1306: SA0 selects 0x3C/0x3D, BME280/BMP280: SDO selects 0x76/0x77
+static const candidate_t candidates[] = {
+        {0x3C, true},
+        {0x3D, true},
+        {0x76, false},
+        {0x77, false},
+};
+
+#define AMOUNT_CANDIDATES (sizeof(candidates) / sizeof(candidates[0]))
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static int32_t probeBme280(saph_discovery_registry_t* registry, uint8_t address);
+
+static int32_t probeSsd1306(saph_discovery_registry_t* registry, uint8_t address);
+
+static uint8_t getKindFromChipId(int32_t chipId);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+void saph_discovery_init(saph_discovery_registry_t* registry) {
+    if (registry == 0) {
+        return;
+    }
+    memset(registry, 0, sizeof(saph_discovery_registry_t));
+}
+
+int32_t saph_discovery_step(saph_discovery_registry_t* registry) {
+    if (registry == 0) {
+        return SAPH_DISCOVERY_NULL_POINTER_ERROR;
+    }
+    if (saph_discovery_isDone(registry)) {
+        return SAPH_DISCOVERY_KIND_NONE;
+    }
+    const candidate_t* candidate = &candidates[registry->nextCandidate];
+    registry->nextCandidate++;
+    if (candidate->isDisplay) {
+        return probeSsd1306(registry, candidate->address);
+    }
+    return probeBme280(registry, candidate->address);
+}
+
+bool saph_discovery_isDone(saph_discovery_registry_t* registry) {
+    return registry == 0 || registry->nextCandidate >= AMOUNT_CANDIDATES;
+}
+
+int32_t saph_discovery_probeAll(saph_discovery_registry_t* registry) {
+    if (registry == 0) {
+        return SAPH_DISCOVERY_NULL_POINTER_ERROR;
+    }
+    while (!saph_discovery_isDone(registry)) {
+        saph_discovery_step(registry);
+    }
+    return registry->amountBme280 + registry->amountSsd1306;
+}
+
+saphBmeDevice_t* saph_discovery_getBme280(saph_discovery_registry_t* registry, uint8_t index) {
+    if (registry == 0 || index >= registry->amountBme280) {
+        return 0;
+    }
+    return &(registry->bme280[index].device);
+}
+
+saph_ssd1306_device_t* saph_discovery_getSsd1306(saph_discovery_registry_t* registry, uint8_t index) {
+    if (registry == 0 || index >= registry->amountSsd1306) {
+        return 0;
+    }
+    return &(registry->ssd1306[index]);
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static int32_t probeBme280(saph_discovery_registry_t* registry, uint8_t address) {
+    if (registry->amountBme280 >= SAPH_DISCOVERY_MAX_BME280) {
+        return SAPH_DISCOVERY_KIND_NONE;
+    }
+    saphBmeDevice_t probeDevice;
+    memset(&probeDevice, 0, sizeof(saphBmeDevice_t));
+    probeDevice.address = address;
+    uint8_t kind = getKindFromChipId(saphBme280_getId(&probeDevice));
+    if (kind == SAPH_DISCOVERY_KIND_NONE) {
+        return SAPH_DISCOVERY_KIND_NONE;
+    }
+    saph_discovery_bme280Entry_t* entry = &(registry->bme280[registry->amountBme280]);
+    if (saphBme280_init(address, &(entry->device)) != SAPH_BME280_NO_ERROR) {
+        return SAPH_DISCOVERY_KIND_NONE;
+    }
+    entry->kind = kind;
+    registry->amountBme280++;
+    return kind;
+}
+
+// The SSD1306 has no id register, so a panel is anything answering a status read on its addresses
+static int32_t probeSsd1306(saph_discovery_registry_t* registry, uint8_t address) {
+    if (registry->amountSsd1306 >= SAPH_DISCOVERY_MAX_SSD1306) {
+        return SAPH_DISCOVERY_KIND_NONE;
+    }
+    saph_ssd1306_device_t* device = &(registry->ssd1306[registry->amountSsd1306]);
+    saph_ssd1306_init(address, device);
+    uint8_t status = 0;
+    if (saph_ssd1306_status(device, &status) != SAPH_SSD1306_NO_ERROR) {
+        return SAPH_DISCOVERY_KIND_NONE;
+    }
+    registry->amountSsd1306++;
+    return SAPH_DISCOVERY_KIND_SSD1306;
+}
+
+static uint8_t getKindFromChipId(int32_t chipId) {
+    switch (chipId) {
+        case SAPH_DISCOVERY_CHIP_ID_BME280:
+            return SAPH_DISCOVERY_KIND_BME280;
+        case SAPH_DISCOVERY_CHIP_ID_BMP280:
+            return SAPH_DISCOVERY_KIND_BMP280;
+        default:
+            return SAPH_DISCOVERY_KIND_NONE;
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef SAPH_DISCOVERY_H
+#define SAPH_DISCOVERY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+#include "saph_ssd1306.h"
+
+#define SAPH_DISCOVERY_NO_ERROR 0
+#define SAPH_DISCOVERY_NULL_POINTER_ERROR -20
+
+#define SAPH_DISCOVERY_KIND_NONE 0
+#define SAPH_DISCOVERY_KIND_BME280 1
+#define SAPH_DISCOVERY_KIND_BMP280 2
+#define SAPH_DISCOVERY_KIND_SSD1306 3
+
+// Chip ids as found in register 0xD0
+#define SAPH_DISCOVERY_CHIP_ID_BME280 0x60
+#define SAPH_DISCOVERY_CHIP_ID_BMP280 0x58
+
+// One slot per address the parts can be strapped to
+#define SAPH_DISCOVERY_MAX_BME280 2
+#define SAPH_DISCOVERY_MAX_SSD1306 2
+
+typedef struct saph_discovery_bme280Entry_t {
+    uint8_t kind;
+    saphBmeDevice_t device;
+} saph_discovery_bme280Entry_t;
+
+typedef struct saph_discovery_registry_t {
+    uint8_t nextCandidate;
+    uint8_t amountBme280;
+    uint8_t amountSsd1306;
+    saph_discovery_bme280Entry_t bme280[SAPH_DISCOVERY_MAX_BME280];
+    saph_ssd1306_device_t ssd1306[SAPH_DISCOVERY_MAX_SSD1306];
+} saph_discovery_registry_t;
+
+void saph_discovery_init(saph_discovery_registry_t* registry);
+
+int32_t saph_discovery_step(saph_discovery_registry_t* registry);
+
+bool saph_discovery_isDone(saph_discovery_registry_t* registry);
+
+int32_t saph_discovery_probeAll(saph_discovery_registry_t* registry);
+
+saphBmeDevice_t* saph_discovery_getBme280(saph_discovery_registry_t* registry, uint8_t index);
+
+saph_ssd1306_device_t* saph_discovery_getSsd1306(saph_discovery_registry_t* registry, uint8_t index);
+
+#endif // SAPH_DISCOVERY_H
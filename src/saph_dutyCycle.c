@@ -0,0 +1,170 @@
+#include "saph_dutyCycle.h"
+
+#include <string.h>
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static bool isTimeReached(uint32_t nowUs, uint32_t targetUs);
+
+static void accountCharge(saph_dutyCycle_t* cycle, uint32_t nowUs);
+
+static int32_t startSample(saph_dutyCycle_t* cycle, uint32_t nowUs);
+
+static int32_t finishSample(saph_dutyCycle_t* cycle, uint32_t nowUs, saphBmeMeasurements_t* result);
+
+static int32_t setDisplayAwake(saph_dutyCycle_t* cycle, bool awake);
+
+static void scheduleWake(saph_dutyCycle_t* cycle);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+/* *
+ * Expects the sensor's oversampling to be prepared already, e.g. with the weather monitoring profile.
+ * The display may be 0, otherwise it is put to sleep right away. The first sample is due immediately.
+ * */
+int32_t saph_dutyCycle_init(saph_dutyCycle_t* cycle, saphBmeDevice_t* sensor, saph_ssd1306_device_t* display,
+                            const saph_dutyCycle_config_t* config, uint32_t nowUs) {
+    if (cycle == 0 || sensor == 0 || config == 0) {
+        return SAPH_DUTYCYCLE_NULL_POINTER_ERROR;
+    }
+    if (config->intervalUs <= saphBme280_getMeasurementTimeUs(sensor) ||
+        config->mcuSleepMode > SAPH_DUTYCYCLE_MCU_DORMANT) {
+        return SAPH_DUTYCYCLE_INVALID_CONFIG_ERROR;
+    }
+    memset(cycle, 0, sizeof(saph_dutyCycle_t));
+    cycle->sensor = sensor;
+    cycle->display = display;
+    cycle->config = *config;
+    cycle->state = SAPH_DUTYCYCLE_STATE_IDLE;
+    cycle->nextSampleUs = nowUs;
+    cycle->nextWakeUs = nowUs;
+    cycle->lastStepUs = nowUs;
+    if (display != 0) {
+        return saph_ssd1306_displaySleep(display, true);
+    }
+    return SAPH_DUTYCYCLE_NO_ERROR;
+}
+
+/* *
+ * Does whatever is due at nowUs and sets nextWakeUs. Returns SAPH_DUTYCYCLE_SAMPLE_READY with result filled in
+ * when a conversion was read, SAPH_DUTYCYCLE_NO_SAMPLE otherwise, or a negative error code.
+ * A failed read drops that sample, the next one is triggered on schedule.
+ * */
+int32_t saph_dutyCycle_step(saph_dutyCycle_t* cycle, uint32_t nowUs, saphBmeMeasurements_t* result) {
+    if (cycle == 0 || result == 0) {
+        return SAPH_DUTYCYCLE_NULL_POINTER_ERROR;
+    }
+    accountCharge(cycle, nowUs);
+    cycle->wakeups++;
+    int32_t errorCode = SAPH_DUTYCYCLE_NO_ERROR;
+    int32_t outcome = SAPH_DUTYCYCLE_NO_SAMPLE;
+    if (cycle->state == SAPH_DUTYCYCLE_STATE_MEASURING && isTimeReached(nowUs, cycle->conversionDoneUs)) {
+        errorCode = finishSample(cycle, nowUs, result);
+        outcome = SAPH_DUTYCYCLE_SAMPLE_READY;
+    }
+    if (errorCode == SAPH_DUTYCYCLE_NO_ERROR && cycle->displayAwake && isTimeReached(nowUs, cycle->displayOffUs)) {
+        errorCode = setDisplayAwake(cycle, false);
+    }
+    if (errorCode == SAPH_DUTYCYCLE_NO_ERROR && cycle->state == SAPH_DUTYCYCLE_STATE_IDLE &&
+        isTimeReached(nowUs, cycle->nextSampleUs)) {
+        errorCode = startSample(cycle, nowUs);
+    }
+    scheduleWake(cycle);
+    return errorCode != SAPH_DUTYCYCLE_NO_ERROR ? errorCode : outcome;
+}
+
+// In nA*us up to the last step
+uint64_t saph_dutyCycle_getTotalCharge(saph_dutyCycle_t* cycle) {
+    if (cycle == 0) {
+        return 0;
+    }
+    return cycle->charge.sensor + cycle->charge.display + cycle->charge.mcu;
+}
+
+// In nA*s, i.e. thousandths of a uA*s, 0 before the first sample
+uint32_t saph_dutyCycle_getChargePerSample(saph_dutyCycle_t* cycle) {
+    if (cycle == 0 || cycle->samples == 0) {
+        return 0;
+    }
+    return (uint32_t) (saph_dutyCycle_getTotalCharge(cycle) / cycle->samples / 1000000u);
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static bool isTimeReached(uint32_t nowUs, uint32_t targetUs) {
+    return (int32_t) (nowUs - targetUs) >= 0;
+}
+
+// Everything was in the state the last step left it in since then, conversions are booked when they start
+static void accountCharge(saph_dutyCycle_t* cycle, uint32_t nowUs) {
+    uint64_t elapsedUs = (uint32_t) (nowUs - cycle->lastStepUs);
+    cycle->lastStepUs = nowUs;
+    cycle->charge.sensor += elapsedUs * SAPHBME280_SLEEP_CURRENT_NA;
+    if (cycle->display != 0) {
+        cycle->charge.display += elapsedUs * (cycle->displayAwake ? SAPH_DUTYCYCLE_DISPLAY_ON_NA
+                                                                  : SAPH_DUTYCYCLE_DISPLAY_SLEEP_NA);
+    }
+    uint64_t mcuSleepNa = cycle->config.mcuSleepMode == SAPH_DUTYCYCLE_MCU_DORMANT ? SAPH_DUTYCYCLE_MCU_DORMANT_NA
+                                                                                   : SAPH_DUTYCYCLE_MCU_SLEEP_NA;
+    cycle->charge.mcu += elapsedUs * mcuSleepNa +
+                         (uint64_t) SAPH_DUTYCYCLE_MCU_ACTIVE_US_PER_WAKE * (SAPH_DUTYCYCLE_MCU_ACTIVE_NA - mcuSleepNa);
+}
+
+// A stalled caller gets the next sample one interval from now instead of a burst of overdue ones
+static int32_t startSample(saph_dutyCycle_t* cycle, uint32_t nowUs) {
+    cycle->nextSampleUs += cycle->config.intervalUs;
+    if (isTimeReached(nowUs, cycle->nextSampleUs)) {
+        cycle->nextSampleUs = nowUs + cycle->config.intervalUs;
+    }
+    int32_t errorCode = saphBme280_triggerForcedMeasurement(cycle->sensor);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    cycle->state = SAPH_DUTYCYCLE_STATE_MEASURING;
+    cycle->conversionDoneUs = nowUs + saphBme280_getMeasurementTimeUs(cycle->sensor);
+    cycle->charge.sensor += saphBme280_getMeasurementCharge(cycle->sensor);
+    return SAPH_DUTYCYCLE_NO_ERROR;
+}
+
+static int32_t finishSample(saph_dutyCycle_t* cycle, uint32_t nowUs, saphBmeMeasurements_t* result) {
+    cycle->state = SAPH_DUTYCYCLE_STATE_IDLE;
+    int32_t errorCode = saphBme280_getMeasurements(cycle->sensor, result);
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        return errorCode;
+    }
+    cycle->samples++;
+    if (cycle->display == 0 || cycle->config.displayOnUs == 0) {
+        return SAPH_DUTYCYCLE_NO_ERROR;
+    }
+    cycle->displayOffUs = nowUs + cycle->config.displayOnUs;
+    return setDisplayAwake(cycle, true);
+}
+
+static int32_t setDisplayAwake(saph_dutyCycle_t* cycle, bool awake) {
+    if (cycle->displayAwake == awake) {
+        return SAPH_DUTYCYCLE_NO_ERROR;
+    }
+    int32_t errorCode = saph_ssd1306_displaySleep(cycle->display, !awake);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    cycle->displayAwake = awake;
+    return SAPH_DUTYCYCLE_NO_ERROR;
+}
+
+static void scheduleWake(saph_dutyCycle_t* cycle) {
+    uint32_t nextWakeUs = cycle->nextSampleUs;
+    if (cycle->state == SAPH_DUTYCYCLE_STATE_MEASURING) {
+        nextWakeUs = cycle->conversionDoneUs;
+    }
+    if (cycle->displayAwake && (int32_t) (cycle->displayOffUs - nextWakeUs) < 0) {
+        nextWakeUs = cycle->displayOffUs;
+    }
+    cycle->nextWakeUs = nextWakeUs;
+}
@@ -0,0 +1,85 @@
+#ifndef SAPH_DUTYCYCLE_H
+#define SAPH_DUTYCYCLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saphBme280.h"
+#include "saph_ssd1306.h"
+
+#define SAPH_DUTYCYCLE_NO_ERROR 0
+#define SAPH_DUTYCYCLE_NULL_POINTER_ERROR -20
+#define SAPH_DUTYCYCLE_INVALID_CONFIG_ERROR -43
+
+// Positive results of saph_dutyCycle_step
+#define SAPH_DUTYCYCLE_NO_SAMPLE 0
+#define SAPH_DUTYCYCLE_SAMPLE_READY 1
+
+#define SAPH_DUTYCYCLE_STATE_IDLE 0
+#define SAPH_DUTYCYCLE_STATE_MEASURING 1
+
+/* *
+ * How the MCU waits for the next wakeup, only picks the current of the energy model. Sleep is what saph_hal_sleepUs
+ * does on the Pico, clocks gated except for the timer. Dormant stops the oscillators as well, which the Pico HAL
+ * doesn't do, so only pick it with a platform that does.
+ * */
+#define SAPH_DUTYCYCLE_MCU_SLEEP 0
+#define SAPH_DUTYCYCLE_MCU_DORMANT 1
+
+/* *
+ * Supply currents of the energy model in nA. RP2040 figures are the rough chip currents of its datasheet
+ * (chapter 2.15), the SSD1306 module figure assumes about half the pixels lit, measure your own board to refine them.
+ * */
+#define SAPH_DUTYCYCLE_MCU_ACTIVE_NA 20000000u
+#define SAPH_DUTYCYCLE_MCU_SLEEP_NA 1500000u
+#define SAPH_DUTYCYCLE_MCU_DORMANT_NA 180000u
+#define SAPH_DUTYCYCLE_DISPLAY_ON_NA 8000000u
+#define SAPH_DUTYCYCLE_DISPLAY_SLEEP_NA 10000u
+// Wake up, I2C transfers at 100 kHz and going back to sleep
+#define SAPH_DUTYCYCLE_MCU_ACTIVE_US_PER_WAKE 2000u
+
+typedef struct saph_dutyCycle_config_t {
+    uint32_t intervalUs;
+    // How long the display stays lit after each sample, 0 keeps it dark
+    uint32_t displayOnUs;
+    uint8_t mcuSleepMode;
+} saph_dutyCycle_config_t;
+
+// Accumulated charge per part in nA*us
+typedef struct saph_dutyCycle_charge_t {
+    uint64_t sensor;
+    uint64_t display;
+    uint64_t mcu;
+} saph_dutyCycle_charge_t;
+
+/* *
+ * Forced measurement every interval with everything asleep in between. The caller sleeps until nextWakeUs
+ * and calls saph_dutyCycle_step again, which keeps all scheduling and the energy accounting testable on the host.
+ * Times are microseconds of a free running 32 bit clock, e.g. time_us_32(), wrap around is handled.
+ * */
+typedef struct saph_dutyCycle_t {
+    saphBmeDevice_t* sensor;
+    saph_ssd1306_device_t* display;
+    saph_dutyCycle_config_t config;
+    uint8_t state;
+    bool displayAwake;
+    uint32_t nextSampleUs;
+    uint32_t conversionDoneUs;
+    uint32_t displayOffUs;
+    uint32_t nextWakeUs;
+    uint32_t lastStepUs;
+    uint32_t samples;
+    uint32_t wakeups;
+    saph_dutyCycle_charge_t charge;
+} saph_dutyCycle_t;
+
+int32_t saph_dutyCycle_init(saph_dutyCycle_t* cycle, saphBmeDevice_t* sensor, saph_ssd1306_device_t* display,
+                            const saph_dutyCycle_config_t* config, uint32_t nowUs);
+
+int32_t saph_dutyCycle_step(saph_dutyCycle_t* cycle, uint32_t nowUs, saphBmeMeasurements_t* result);
+
+uint64_t saph_dutyCycle_getTotalCharge(saph_dutyCycle_t* cycle);
+
+uint32_t saph_dutyCycle_getChargePerSample(saph_dutyCycle_t* cycle);
+
+#endif // SAPH_DUTYCYCLE_H
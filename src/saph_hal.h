@@ -0,0 +1,22 @@
+//
+// Platform layer under the drivers: the bus is i2c_handler.h, time and waiting are here.
+// Each platform links one implementation of both:
+//   Pico SDK     i2c_handler.c                 saph_hal_pico.c
+//   Linux        i2c_handler_linux.c           saph_hal_posix.c
+//   Simulation   test/support/sim_i2c_bus.c    test/support/sim_hal.c
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_SAPH_HAL_H
+#define SAPH_PICO_TEMPERATURE_SAPH_HAL_H
+
+#include <stdint.h>
+
+// Monotonic, wraps after about 71 minutes like time_us_32 of the Pico SDK, so compare differences only
+uint32_t saph_hal_getTimeUs(void);
+
+void saph_hal_delayUs(uint32_t delayUs);
+
+// Waits like saph_hal_delayUs, but lets the platform stop what it doesn't need meanwhile. Made for long idle waits.
+void saph_hal_sleepUs(uint32_t sleepUs);
+
+#endif //SAPH_PICO_TEMPERATURE_SAPH_HAL_H
@@ -0,0 +1,65 @@
+//
+// saph_hal.h on the Pico SDK timer
+//
+
+#include "saph_hal.h"
+
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/scb.h"
+#include "hardware/sync.h"
+#include "hardware/timer.h"
+
+// Hardware alarm that ends saph_hal_sleepUs, the SDK's own sleep_us and alarm pool use alarm 3
+#define SAPH_HAL_SLEEP_ALARM 0
+
+static bool sleepAlarmClaimed = false;
+static volatile bool sleepAlarmFired = false;
+
+static void onSleepAlarm(uint alarmNum);
+
+uint32_t saph_hal_getTimeUs(void) {
+    return time_us_32();
+}
+
+void saph_hal_delayUs(uint32_t delayUs) {
+    sleep_us(delayUs);
+}
+
+/* *
+ * Deep sleep with only the system timer clocked while the core waits in __wfi, the other clocks are gated
+ * by the clock block until the alarm interrupt. Oscillators and PLLs keep running, so nothing needs restarting.
+ * */
+void saph_hal_sleepUs(uint32_t sleepUs) {
+    if (!sleepAlarmClaimed) {
+        hardware_alarm_claim(SAPH_HAL_SLEEP_ALARM);
+        hardware_alarm_set_callback(SAPH_HAL_SLEEP_ALARM, onSleepAlarm);
+        sleepAlarmClaimed = true;
+    }
+    sleepAlarmFired = false;
+    if (hardware_alarm_set_target(SAPH_HAL_SLEEP_ALARM, make_timeout_time_us(sleepUs))) {
+        return;
+    }
+    uint32_t savedSleepEn0 = clocks_hw->sleep_en0;
+    uint32_t savedSleepEn1 = clocks_hw->sleep_en1;
+    clocks_hw->sleep_en0 = 0;
+    clocks_hw->sleep_en1 = CLOCKS_SLEEP_EN1_CLK_SYS_TIMER_BITS;
+    scb_hw->scr |= M0PLUS_SCR_SLEEPDEEP_BITS;
+    // A pending interrupt still ends __wfi with interrupts masked, so the alarm can't slip in between check and sleep.
+    // Other interrupts wake the core as well, it goes back to sleep until the alarm fired.
+    uint32_t interrupts = save_and_disable_interrupts();
+    while (!sleepAlarmFired) {
+        __wfi();
+        restore_interrupts(interrupts);
+        interrupts = save_and_disable_interrupts();
+    }
+    restore_interrupts(interrupts);
+    scb_hw->scr &= ~M0PLUS_SCR_SLEEPDEEP_BITS;
+    clocks_hw->sleep_en0 = savedSleepEn0;
+    clocks_hw->sleep_en1 = savedSleepEn1;
+}
+
+static void onSleepAlarm(uint alarmNum) {
+    (void) alarmNum;
+    sleepAlarmFired = true;
+}
@@ -0,0 +1,29 @@
+//
+// saph_hal.h on POSIX clocks, e.g. a Linux gateway next to i2c_handler_linux.c
+//
+
+// clock_gettime and nanosleep also with -std=c11
+#define _POSIX_C_SOURCE 200809L
+
+#include "saph_hal.h"
+
+#include <errno.h>
+#include <time.h>
+
+uint32_t saph_hal_getTimeUs(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t) ((uint64_t) now.tv_sec * 1000000u + (uint64_t) now.tv_nsec / 1000u);
+}
+
+// A signal only cuts the sleep short, the rest of it is slept afterwards
+void saph_hal_delayUs(uint32_t delayUs) {
+    struct timespec remaining = {(time_t) (delayUs / 1000000u), (long) (delayUs % 1000000u) * 1000};
+    while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) {
+    }
+}
+
+// The kernel idles the CPU in nanosleep already
+void saph_hal_sleepUs(uint32_t sleepUs) {
+    saph_hal_delayUs(sleepUs);
+}
@@ -28,4 +28,151 @@ int32_t saph_ssd1306_displayOn(saph_ssd1306_device_t* device, bool ignoreRam) {
     return errorCode;
 }
 
+#define DISPLAY_SLEEP 0xAE
+#define DISPLAY_WAKE 0xAF
+// The panel is dark while asleep, RAM contents and settings are kept and shown again on wake up
+int32_t saph_ssd1306_displaySleep(saph_ssd1306_device_t* device, bool sleep) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    uint8_t command[1] = {sleep ? DISPLAY_SLEEP : DISPLAY_WAKE};
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, 1);
+}
+
+int32_t saph_ssd1306_status(saph_ssd1306_device_t* device, uint8_t* buffer) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    return saph_ssd1306_internal_readStatus(device, buffer);
+}
+
+#define SET_MULTIPLEX_RATIO 0xA8
+#define SET_COM_PINS_CONFIG 0xDA
+// Multiplex ratio and COM pin wiring of the panel this build is for, the rest of the power on defaults fit all
+int32_t saph_ssd1306_configurePanel(saph_ssd1306_device_t* device) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    uint8_t command[4] = {SET_MULTIPLEX_RATIO, SAPH_SSD1306_MULTIPLEX_RATIO,
+                          SET_COM_PINS_CONFIG, SAPH_SSD1306_COM_PINS_CONFIG};
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, 4);
+}
 
+#define SET_MEMORY_ADDRESSING_MODE 0x20
+#define HORIZONTAL_ADDRESSING 0x00
+#define SET_COLUMN_ADDRESS 0x21
+#define SET_PAGE_ADDRESS 0x22
+/* *
+ * Horizontal addressing inside the window, the pointer wraps from the last byte back to startColumn/startPage.
+ * A window of a single column takes one byte per page and returns to the top after each column.
+ * Columns count from the left edge of the panel, the offset into GDDRAM is added here.
+ * */
+int32_t saph_ssd1306_setAddressWindow(saph_ssd1306_device_t* device, uint8_t startColumn, uint8_t endColumn,
+                                      uint8_t startPage, uint8_t endPage) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    uint8_t command[SAPH_SSD1306_ADDRESS_WINDOW_SIZE];
+    int32_t errorCode = saph_ssd1306_encodeAddressWindow(command, startColumn, endColumn, startPage, endPage);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, SAPH_SSD1306_ADDRESS_WINDOW_SIZE);
+}
+
+// The SAPH_SSD1306_ADDRESS_WINDOW_SIZE command bytes of setAddressWindow, for a transfer that is sent elsewhere
+int32_t saph_ssd1306_encodeAddressWindow(uint8_t* command, uint8_t startColumn, uint8_t endColumn,
+                                         uint8_t startPage, uint8_t endPage) {
+    if (command == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (startColumn > endColumn || endColumn >= SAPH_SSD1306_WIDTH ||
+        startPage > endPage || endPage >= SAPH_SSD1306_PAGES) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    command[0] = SET_MEMORY_ADDRESSING_MODE;
+    command[1] = HORIZONTAL_ADDRESSING;
+    command[2] = SET_COLUMN_ADDRESS;
+    command[3] = (uint8_t) (startColumn + SAPH_SSD1306_COLUMN_OFFSET);
+    command[4] = (uint8_t) (endColumn + SAPH_SSD1306_COLUMN_OFFSET);
+    command[5] = SET_PAGE_ADDRESS;
+    command[6] = startPage;
+    command[7] = endPage;
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+int32_t saph_ssd1306_writeData(saph_ssd1306_device_t* device, const uint8_t* buffer, uint32_t bufferSize) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    return saph_ssd1306_internal_sendData(device, buffer, bufferSize);
+}
+
+#define SCROLL_RIGHT_SETUP 0x26
+#define SCROLL_LEFT_SETUP 0x27
+#define SCROLL_VERTICAL_RIGHT_SETUP 0x29
+#define SCROLL_VERTICAL_LEFT_SETUP 0x2A
+#define SET_VERTICAL_SCROLL_AREA 0xA3
+#define SCROLL_DEACTIVATE 0x2E
+#define SCROLL_ACTIVATE 0x2F
+#define SCROLL_DUMMY_LOW 0x00
+#define SCROLL_DUMMY_HIGH 0xFF
+#define SCROLL_MAX_FRAME_INTERVAL 0x07
+
+static bool isScrollRangeValid(uint8_t direction, uint8_t startPage, uint8_t endPage, uint8_t frameInterval) {
+    return direction <= SAPH_SSD1306_SCROLL_LEFT && startPage <= endPage && endPage < SAPH_SSD1306_PAGES &&
+           frameInterval <= SCROLL_MAX_FRAME_INTERVAL;
+}
+
+/* *
+ * Continuous horizontal scroll of the pages startPage to endPage by one column every frameInterval,
+ * takes effect with saph_ssd1306_scrollActivate. Deactivate scrolling before setting it up again.
+ * */
+int32_t saph_ssd1306_scrollHorizontal(saph_ssd1306_device_t* device, uint8_t direction, uint8_t startPage,
+                                      uint8_t endPage, uint8_t frameInterval) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (!isScrollRangeValid(direction, startPage, endPage, frameInterval)) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    uint8_t command[7] = {direction == SAPH_SSD1306_SCROLL_LEFT ? SCROLL_LEFT_SETUP : SCROLL_RIGHT_SETUP,
+                          SCROLL_DUMMY_LOW, startPage, frameInterval, endPage, SCROLL_DUMMY_LOW, SCROLL_DUMMY_HIGH};
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, 7);
+}
+
+// Like saph_ssd1306_scrollHorizontal, the vertical scroll area additionally moves up by verticalOffset rows per step
+int32_t saph_ssd1306_scrollVerticalHorizontal(saph_ssd1306_device_t* device, uint8_t direction, uint8_t startPage,
+                                              uint8_t endPage, uint8_t frameInterval, uint8_t verticalOffset) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (!isScrollRangeValid(direction, startPage, endPage, frameInterval) ||
+        verticalOffset >= SAPH_SSD1306_HEIGHT) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    uint8_t command[6] = {direction == SAPH_SSD1306_SCROLL_LEFT ? SCROLL_VERTICAL_LEFT_SETUP
+                                                                : SCROLL_VERTICAL_RIGHT_SETUP,
+                          SCROLL_DUMMY_LOW, startPage, frameInterval, endPage, verticalOffset};
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, 6);
+}
+
+// Rows 0 to fixedRows - 1 stay put, the following scrollRows rows take part in vertical scrolling
+int32_t saph_ssd1306_setVerticalScrollArea(saph_ssd1306_device_t* device, uint8_t fixedRows, uint8_t scrollRows) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (fixedRows + scrollRows > SAPH_SSD1306_HEIGHT) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    uint8_t command[3] = {SET_VERTICAL_SCROLL_AREA, fixedRows, scrollRows};
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, 3);
+}
+
+int32_t saph_ssd1306_scrollActivate(saph_ssd1306_device_t* device, bool active) {
+    if (device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    uint8_t command[1] = {active ? SCROLL_ACTIVATE : SCROLL_DEACTIVATE};
+    return saph_ssd1306_internal_sendCtrlCommand(device, command, 1);
+}
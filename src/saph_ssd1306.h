@@ -4,11 +4,30 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include "saph_ssd1306_geometry.h"
+
 #define SAPH_SSD1306_NO_ERROR 0
 #define SAPH_SSD1306_COMM_ERROR_WRITE_AMOUNT -11
 #define SAPH_SSD1306_COMM_ERROR_READ_AMOUNT -12
 #define SAPH_SSD1306_NULL_POINTER_ERROR -20
 #define SAPH_SSD1306_RESERVED_ADDR_ERROR -30
+#define SAPH_SSD1306_INVALID_CONFIG_ERROR -43
+
+// Command bytes of an address window, without the control byte
+#define SAPH_SSD1306_ADDRESS_WINDOW_SIZE 8
+
+#define SAPH_SSD1306_SCROLL_RIGHT 0
+#define SAPH_SSD1306_SCROLL_LEFT 1
+
+// Frames between two scroll steps, in the encoding of the scroll setup commands (datasheet 10.2.1)
+#define SAPH_SSD1306_SCROLL_FRAMES_2 0x07
+#define SAPH_SSD1306_SCROLL_FRAMES_3 0x04
+#define SAPH_SSD1306_SCROLL_FRAMES_4 0x05
+#define SAPH_SSD1306_SCROLL_FRAMES_5 0x00
+#define SAPH_SSD1306_SCROLL_FRAMES_25 0x06
+#define SAPH_SSD1306_SCROLL_FRAMES_64 0x01
+#define SAPH_SSD1306_SCROLL_FRAMES_128 0x02
+#define SAPH_SSD1306_SCROLL_FRAMES_256 0x03
 
 typedef struct saph_ssd1306_device_t {
     uint8_t address;
@@ -20,4 +39,28 @@ int32_t saph_ssd1306_contrast(saph_ssd1306_device_t* device, uint8_t contrastLev
 
 int32_t saph_ssd1306_displayOn(saph_ssd1306_device_t* device, bool ignoreRam);
 
+int32_t saph_ssd1306_displaySleep(saph_ssd1306_device_t* device, bool sleep);
+
+int32_t saph_ssd1306_status(saph_ssd1306_device_t* device, uint8_t* buffer);
+
+int32_t saph_ssd1306_configurePanel(saph_ssd1306_device_t* device);
+
+int32_t saph_ssd1306_setAddressWindow(saph_ssd1306_device_t* device, uint8_t startColumn, uint8_t endColumn,
+                                      uint8_t startPage, uint8_t endPage);
+
+int32_t saph_ssd1306_encodeAddressWindow(uint8_t* command, uint8_t startColumn, uint8_t endColumn,
+                                         uint8_t startPage, uint8_t endPage);
+
+int32_t saph_ssd1306_writeData(saph_ssd1306_device_t* device, const uint8_t* buffer, uint32_t bufferSize);
+
+int32_t saph_ssd1306_scrollHorizontal(saph_ssd1306_device_t* device, uint8_t direction, uint8_t startPage,
+                                      uint8_t endPage, uint8_t frameInterval);
+
+int32_t saph_ssd1306_scrollVerticalHorizontal(saph_ssd1306_device_t* device, uint8_t direction, uint8_t startPage,
+                                              uint8_t endPage, uint8_t frameInterval, uint8_t verticalOffset);
+
+int32_t saph_ssd1306_setVerticalScrollArea(saph_ssd1306_device_t* device, uint8_t fixedRows, uint8_t scrollRows);
+
+int32_t saph_ssd1306_scrollActivate(saph_ssd1306_device_t* device, bool active);
+
 #endif // SAPH_SSD1306_H
@@ -0,0 +1,301 @@
+#include "saph_ssd1306_framebuffer.h"
+#include "saph_ssd1306_internal.h"
+
+#include <string.h>
+
+// Control bytes in front of the queued transfers, the same the internal send functions put there
+#define CONTROL_COMMAND 0x00
+#define CONTROL_DATA 0x40
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static uint8_t* getFront(saph_ssd1306_framebuffer_t* framebuffer);
+
+static uint16_t gatherChunk(saph_ssd1306_framebuffer_t* framebuffer, uint8_t* column, uint8_t* page);
+
+static int32_t finishChunk(saph_ssd1306_framebuffer_t* framebuffer, uint8_t column, uint8_t page, uint16_t amount);
+
+static int32_t flushStepQueued(saph_ssd1306_framebuffer_t* framebuffer);
+
+static int32_t queueTransfer(saph_ssd1306_framebuffer_t* framebuffer);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+/* *
+ * Both frames start dark and the first swap sends the whole frame, which also clears what the panel
+ * had in RAM after power up. Chunks are at least one byte and at most SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK.
+ * */
+int32_t saph_ssd1306_framebuffer_init(saph_ssd1306_framebuffer_t* framebuffer, saph_ssd1306_device_t* device,
+                                      uint16_t chunkSize) {
+    if (framebuffer == 0 || device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (chunkSize == 0 || chunkSize > SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    memset(framebuffer, 0, sizeof(saph_ssd1306_framebuffer_t));
+    framebuffer->device = device;
+    framebuffer->chunkSize = chunkSize;
+    framebuffer->invalidated = true;
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+// Stays the same buffer until the next swap, returns 0 without a framebuffer
+uint8_t* saph_ssd1306_framebuffer_getBack(saph_ssd1306_framebuffer_t* framebuffer) {
+    if (framebuffer == 0) {
+        return 0;
+    }
+    return framebuffer->frames[framebuffer->back];
+}
+
+void saph_ssd1306_framebuffer_clear(saph_ssd1306_framebuffer_t* framebuffer) {
+    if (framebuffer == 0) {
+        return;
+    }
+    memset(framebuffer->frames[framebuffer->back], 0, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+}
+
+// Pixels outside the panel are dropped
+void saph_ssd1306_framebuffer_setPixel(saph_ssd1306_framebuffer_t* framebuffer, uint8_t x, uint8_t y, bool lit) {
+    if (framebuffer == 0 || x >= SAPH_SSD1306_WIDTH || y >= SAPH_SSD1306_HEIGHT) {
+        return;
+    }
+    uint8_t* byte = &(framebuffer->frames[framebuffer->back][(y / 8) * SAPH_SSD1306_WIDTH + x]);
+    uint8_t mask = (uint8_t) (1u << (y % 8));
+    *byte = lit ? (uint8_t) (*byte | mask) : (uint8_t) (*byte & ~mask);
+}
+
+/* *
+ * Returns SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING if the new frame differs from the shown one and has to be flushed,
+ * SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE if nothing changed, or SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR while the last
+ * frame is still being flushed. The new back frame starts as a copy of the new front, so drawing can go on
+ * incrementally. Nothing is sent on the bus here.
+ * */
+int32_t saph_ssd1306_framebuffer_swap(saph_ssd1306_framebuffer_t* framebuffer) {
+    if (framebuffer == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (framebuffer->flushing) {
+        return SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR;
+    }
+    framebuffer->swaps++;
+    uint8_t* back = framebuffer->frames[framebuffer->back];
+    if (framebuffer->invalidated) {
+        framebuffer->invalidated = false;
+        framebuffer->dirty.startColumn = 0;
+        framebuffer->dirty.endColumn = SAPH_SSD1306_WIDTH - 1;
+        framebuffer->dirty.startPage = 0;
+        framebuffer->dirty.endPage = SAPH_SSD1306_PAGES - 1;
+    } else if (!saph_ssd1306_framebuffer_diff(getFront(framebuffer), back, &(framebuffer->dirty))) {
+        return SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE;
+    }
+    framebuffer->back ^= 1u;
+    memcpy(framebuffer->frames[framebuffer->back], back, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    framebuffer->flushing = true;
+    framebuffer->windowSent = false;
+    framebuffer->flushColumn = framebuffer->dirty.startColumn;
+    framebuffer->flushPage = framebuffer->dirty.startPage;
+    return SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+}
+
+/* *
+ * Does one bus transfer of the pending flush, the address window of the dirty region first and then chunks of it.
+ * Returns SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING while there is more to send, SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE
+ * once the panel shows the front frame, or a negative error code. A failed transfer is repeated by the next step.
+ * With an arbiter a step queues the next transfer once the last one is done and sends nothing itself.
+ * */
+int32_t saph_ssd1306_framebuffer_flushStep(saph_ssd1306_framebuffer_t* framebuffer) {
+    if (framebuffer == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (!framebuffer->flushing) {
+        return SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE;
+    }
+    if (framebuffer->arbiter != 0) {
+        return flushStepQueued(framebuffer);
+    }
+    saph_ssd1306_region_t* dirty = &(framebuffer->dirty);
+    if (!framebuffer->windowSent) {
+        int32_t errorCode = saph_ssd1306_setAddressWindow(framebuffer->device, dirty->startColumn, dirty->endColumn,
+                                                          dirty->startPage, dirty->endPage);
+        if (errorCode != SAPH_SSD1306_NO_ERROR) {
+            return errorCode;
+        }
+        framebuffer->windowSent = true;
+        return SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+    }
+    uint8_t column = framebuffer->flushColumn;
+    uint8_t page = framebuffer->flushPage;
+    uint16_t amount = gatherChunk(framebuffer, &column, &page);
+    int32_t errorCode = saph_ssd1306_internal_sendDataInPlace(framebuffer->device, framebuffer->chunkBuffer, amount);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    return finishChunk(framebuffer, column, page, amount);
+}
+
+/* *
+ * Flushes through the arbiter from now on, or directly again with 0. The arbiter has to split writes into chunks
+ * no shorter than an address window, or none at all, as the command of a window cannot be cut apart.
+ * Returns SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR while a flush is under way.
+ * */
+int32_t saph_ssd1306_framebuffer_useArbiter(saph_ssd1306_framebuffer_t* framebuffer, i2c_arbiter_t* arbiter) {
+    if (framebuffer == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (framebuffer->flushing) {
+        return SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR;
+    }
+    if (arbiter != 0 && arbiter->chunkSize > 0 && arbiter->chunkSize < SAPH_SSD1306_ADDRESS_WINDOW_SIZE) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    framebuffer->arbiter = arbiter;
+    framebuffer->request.state = I2C_ARBITER_STATE_IDLE;
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+bool saph_ssd1306_framebuffer_isFlushing(saph_ssd1306_framebuffer_t* framebuffer) {
+    return framebuffer != 0 && framebuffer->flushing;
+}
+
+// E.g. after the panel was reset, the next swap sends the whole frame again
+void saph_ssd1306_framebuffer_invalidate(saph_ssd1306_framebuffer_t* framebuffer) {
+    if (framebuffer == 0) {
+        return;
+    }
+    framebuffer->invalidated = true;
+}
+
+/* *
+ * Bounding box of all bytes that differ, false if both frames are the same.
+ * Rows are compared as a whole first, which skips most of the work for the unchanged pages.
+ * */
+bool saph_ssd1306_framebuffer_diff(const uint8_t* previous, const uint8_t* next, saph_ssd1306_region_t* region) {
+    if (previous == 0 || next == 0 || region == 0) {
+        return false;
+    }
+    bool changed = false;
+    region->startColumn = SAPH_SSD1306_WIDTH - 1;
+    region->endColumn = 0;
+    for (uint8_t page = 0; page < SAPH_SSD1306_PAGES; ++page) {
+        const uint8_t* previousRow = previous + page * SAPH_SSD1306_WIDTH;
+        const uint8_t* nextRow = next + page * SAPH_SSD1306_WIDTH;
+        if (memcmp(previousRow, nextRow, SAPH_SSD1306_WIDTH) == 0) {
+            continue;
+        }
+        uint8_t first = 0;
+        while (previousRow[first] == nextRow[first]) {
+            first++;
+        }
+        uint8_t last = SAPH_SSD1306_WIDTH - 1;
+        while (previousRow[last] == nextRow[last]) {
+            last--;
+        }
+        if (!changed) {
+            region->startPage = page;
+            changed = true;
+        }
+        region->endPage = page;
+        region->startColumn = first < region->startColumn ? first : region->startColumn;
+        region->endColumn = last > region->endColumn ? last : region->endColumn;
+    }
+    return changed;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static uint8_t* getFront(saph_ssd1306_framebuffer_t* framebuffer) {
+    return framebuffer->frames[framebuffer->back ^ 1u];
+}
+
+// Rows of the window lie apart in the frame, so the chunk is gathered row by row behind the control byte
+static uint16_t gatherChunk(saph_ssd1306_framebuffer_t* framebuffer, uint8_t* column, uint8_t* page) {
+    saph_ssd1306_region_t* dirty = &(framebuffer->dirty);
+    uint8_t* chunk = framebuffer->chunkBuffer + 1;
+    const uint8_t* front = getFront(framebuffer);
+    uint16_t amount = 0;
+    while (amount < framebuffer->chunkSize && *page <= dirty->endPage) {
+        uint16_t rowLeft = (uint16_t) (dirty->endColumn - *column + 1);
+        uint16_t take = (uint16_t) (framebuffer->chunkSize - amount);
+        take = take < rowLeft ? take : rowLeft;
+        memcpy(chunk + amount, front + *page * SAPH_SSD1306_WIDTH + *column, take);
+        amount = (uint16_t) (amount + take);
+        *column = (uint8_t) (*column + take - 1);
+        if (*column == dirty->endColumn) {
+            *column = dirty->startColumn;
+            (*page)++;
+        } else {
+            (*column)++;
+        }
+    }
+    return amount;
+}
+
+// column and page are where the flush goes on after the sent chunk
+static int32_t finishChunk(saph_ssd1306_framebuffer_t* framebuffer, uint8_t column, uint8_t page, uint16_t amount) {
+    framebuffer->bytesFlushed += amount;
+    framebuffer->flushColumn = column;
+    framebuffer->flushPage = page;
+    if (page > framebuffer->dirty.endPage) {
+        framebuffer->flushing = false;
+        return SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE;
+    }
+    return SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+}
+
+// The request goes back to idle once its outcome is taken over, a failed transfer is queued again by the next step
+static int32_t flushStepQueued(saph_ssd1306_framebuffer_t* framebuffer) {
+    i2c_arbiter_request_t* request = &(framebuffer->request);
+    if (request->state == I2C_ARBITER_STATE_QUEUED) {
+        return SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+    }
+    if (request->state == I2C_ARBITER_STATE_FAILED) {
+        request->state = I2C_ARBITER_STATE_IDLE;
+        return request->result;
+    }
+    if (request->state == I2C_ARBITER_STATE_DONE) {
+        request->state = I2C_ARBITER_STATE_IDLE;
+        if (!framebuffer->windowSent) {
+            framebuffer->windowSent = true;
+        } else if (finishChunk(framebuffer, framebuffer->queuedColumn, framebuffer->queuedPage,
+                               framebuffer->queuedAmount) == SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE) {
+            return SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE;
+        }
+    }
+    return queueTransfer(framebuffer);
+}
+
+// The window or the next chunk at low priority, the control byte is repeated in front of every piece the arbiter cuts
+static int32_t queueTransfer(saph_ssd1306_framebuffer_t* framebuffer) {
+    saph_ssd1306_region_t* dirty = &(framebuffer->dirty);
+    uint32_t amount;
+    if (!framebuffer->windowSent) {
+        framebuffer->chunkBuffer[0] = CONTROL_COMMAND;
+        int32_t errorCode = saph_ssd1306_encodeAddressWindow(framebuffer->chunkBuffer + 1, dirty->startColumn,
+                                                             dirty->endColumn, dirty->startPage, dirty->endPage);
+        if (errorCode != SAPH_SSD1306_NO_ERROR) {
+            return errorCode;
+        }
+        amount = 1 + SAPH_SSD1306_ADDRESS_WINDOW_SIZE;
+    } else {
+        framebuffer->queuedColumn = framebuffer->flushColumn;
+        framebuffer->queuedPage = framebuffer->flushPage;
+        framebuffer->queuedAmount = gatherChunk(framebuffer, &(framebuffer->queuedColumn),
+                                                &(framebuffer->queuedPage));
+        framebuffer->chunkBuffer[0] = CONTROL_DATA;
+        amount = 1u + framebuffer->queuedAmount;
+    }
+    i2c_arbiter_prepareWrite(&(framebuffer->request), framebuffer->device->address, I2C_ARBITER_PRIORITY_LOW,
+                             framebuffer->chunkBuffer, amount, 1);
+    int32_t errorCode = i2c_arbiter_submit(framebuffer->arbiter, &(framebuffer->request));
+    if (errorCode != I2C_ARBITER_NO_ERROR) {
+        return errorCode;
+    }
+    return SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+}
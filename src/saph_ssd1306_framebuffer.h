@@ -0,0 +1,86 @@
+#ifndef SAPH_SSD1306_FRAMEBUFFER_H
+#define SAPH_SSD1306_FRAMEBUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saph_ssd1306.h"
+#include "i2c_arbiter.h"
+
+#define SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR -47
+
+// Positive results of saph_ssd1306_framebuffer_swap and _flushStep
+#define SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE 0
+#define SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING 1
+
+#define SAPH_SSD1306_FRAMEBUFFER_SIZE (SAPH_SSD1306_PAGES * SAPH_SSD1306_WIDTH)
+// A chunk of 32 bytes keeps one transfer at about 3 ms on a 100 kHz bus
+#define SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK 32
+// Largest chunk, one row of a 128 column panel, the chunk buffer lives in the framebuffer and not on the stack
+#ifndef SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK
+#define SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK 128
+#endif
+
+/* *
+ * Inclusive bounding box of the bytes that differ between two frames, in columns and pages.
+ * */
+typedef struct saph_ssd1306_region_t {
+    uint8_t startColumn;
+    uint8_t endColumn;
+    uint8_t startPage;
+    uint8_t endPage;
+} saph_ssd1306_region_t;
+
+/* *
+ * Two frames in GDDRAM layout, byte page * WIDTH + column holds 8 rows with the least significant bit on top.
+ * Rendering goes into the back frame. A swap compares it with the front frame, which is what the panel shows,
+ * makes it the front frame and starts flushing the changed region. Each flush step sends at most chunkSize bytes
+ * in one bus transfer, so sensor transactions between two steps wait for one chunk at most.
+ * With an arbiter the steps queue their transfer at low priority instead, and the arbiter decides when it goes out.
+ * */
+typedef struct saph_ssd1306_framebuffer_t {
+    saph_ssd1306_device_t* device;
+    uint8_t frames[2][SAPH_SSD1306_FRAMEBUFFER_SIZE];
+    uint8_t back;
+    uint16_t chunkSize;
+    // The next swap sends the whole frame, whatever the panel showed before is unknown
+    bool invalidated;
+    bool flushing;
+    bool windowSent;
+    saph_ssd1306_region_t dirty;
+    uint8_t flushColumn;
+    uint8_t flushPage;
+    uint32_t swaps;
+    uint32_t bytesFlushed;
+    // Control byte followed by the bytes of the chunk being sent
+    uint8_t chunkBuffer[1 + SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK];
+    i2c_arbiter_t* arbiter;
+    i2c_arbiter_request_t request;
+    // Where the flush stands once the queued chunk is sent
+    uint8_t queuedColumn;
+    uint8_t queuedPage;
+    uint16_t queuedAmount;
+} saph_ssd1306_framebuffer_t;
+
+int32_t saph_ssd1306_framebuffer_init(saph_ssd1306_framebuffer_t* framebuffer, saph_ssd1306_device_t* device,
+                                      uint16_t chunkSize);
+
+uint8_t* saph_ssd1306_framebuffer_getBack(saph_ssd1306_framebuffer_t* framebuffer);
+
+void saph_ssd1306_framebuffer_clear(saph_ssd1306_framebuffer_t* framebuffer);
+
+void saph_ssd1306_framebuffer_setPixel(saph_ssd1306_framebuffer_t* framebuffer, uint8_t x, uint8_t y, bool lit);
+
+int32_t saph_ssd1306_framebuffer_swap(saph_ssd1306_framebuffer_t* framebuffer);
+
+int32_t saph_ssd1306_framebuffer_flushStep(saph_ssd1306_framebuffer_t* framebuffer);
+
+int32_t saph_ssd1306_framebuffer_useArbiter(saph_ssd1306_framebuffer_t* framebuffer, i2c_arbiter_t* arbiter);
+
+bool saph_ssd1306_framebuffer_isFlushing(saph_ssd1306_framebuffer_t* framebuffer);
+
+void saph_ssd1306_framebuffer_invalidate(saph_ssd1306_framebuffer_t* framebuffer);
+
+bool saph_ssd1306_framebuffer_diff(const uint8_t* previous, const uint8_t* next, saph_ssd1306_region_t* region);
+
+#endif // SAPH_SSD1306_FRAMEBUFFER_H
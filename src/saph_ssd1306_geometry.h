@@ -0,0 +1,44 @@
+#ifndef SAPH_SSD1306_GEOMETRY_H
+#define SAPH_SSD1306_GEOMETRY_H
+
+/* *
+ * Panel geometry, picked per build with e.g. -DSAPH_SSD1306_GEOMETRY=SAPH_SSD1306_GEOMETRY_128X32.
+ * Everything sized or looped by the panel uses these constants, so a smaller panel gets smaller frames
+ * and no geometry arithmetic at runtime. GDDRAM is always 128x64, smaller panels show a window of it.
+ * */
+#define SAPH_SSD1306_GEOMETRY_128X64 0
+#define SAPH_SSD1306_GEOMETRY_128X32 1
+#define SAPH_SSD1306_GEOMETRY_72X40 2
+
+#ifndef SAPH_SSD1306_GEOMETRY
+#define SAPH_SSD1306_GEOMETRY SAPH_SSD1306_GEOMETRY_128X64
+#endif
+
+#if SAPH_SSD1306_GEOMETRY == SAPH_SSD1306_GEOMETRY_128X64
+// 0.96" panels
+#define SAPH_SSD1306_WIDTH 128
+#define SAPH_SSD1306_PAGES 8
+#define SAPH_SSD1306_COLUMN_OFFSET 0
+#define SAPH_SSD1306_COM_PINS_CONFIG 0x12
+#elif SAPH_SSD1306_GEOMETRY == SAPH_SSD1306_GEOMETRY_128X32
+// 0.91" panels, only every other COM line is wired
+#define SAPH_SSD1306_WIDTH 128
+#define SAPH_SSD1306_PAGES 4
+#define SAPH_SSD1306_COLUMN_OFFSET 0
+#define SAPH_SSD1306_COM_PINS_CONFIG 0x02
+#elif SAPH_SSD1306_GEOMETRY == SAPH_SSD1306_GEOMETRY_72X40
+// 0.42" panels, wired to the GDDRAM columns 28 to 99
+#define SAPH_SSD1306_WIDTH 72
+#define SAPH_SSD1306_PAGES 5
+#define SAPH_SSD1306_COLUMN_OFFSET 28
+#define SAPH_SSD1306_COM_PINS_CONFIG 0x12
+#else
+#error "Unknown SAPH_SSD1306_GEOMETRY"
+#endif
+
+#define SAPH_SSD1306_HEIGHT (SAPH_SSD1306_PAGES * 8)
+#define SAPH_SSD1306_MULTIPLEX_RATIO (SAPH_SSD1306_HEIGHT - 1)
+#define SAPH_SSD1306_RAM_WIDTH 128
+#define SAPH_SSD1306_RAM_PAGES 8
+
+#endif // SAPH_SSD1306_GEOMETRY_H
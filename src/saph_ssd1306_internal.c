@@ -7,9 +7,68 @@ int32_t saph_ssd1306_internal_sendCtrlCommand(saph_ssd1306_device_t* device, uin
     if (device == 0 || buffer == 0) {
         return SAPH_SSD1306_NULL_POINTER_ERROR;
     }
+    // Variable length, the frame grows with bufferSize and the stack report lists it as dynamic
     uint8_t sendingBuffer[bufferSize + 1];
     sendingBuffer[0] = 0x00;
     memcpy(sendingBuffer + 1, buffer, bufferSize);
-    int32_t errorCode = i2c_handler_write(device->address, sendingBuffer, bufferSize + 1);
-    return errorCode;
+    // A blocking write either sends everything and reports the amount, or fails as a whole
+    int32_t commResult = i2c_handler_write(device->address, sendingBuffer, bufferSize + 1);
+    if (commResult < 0) {
+        return commResult;
+    }
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+/* *
+ * Data bytes go to GDDRAM at the address pointer, which advances by one after each byte. Longer writes are split
+ * into transactions of SAPH_SSD1306_DATA_CHUNK bytes, each with its own control byte, the pointer carries on
+ * between them. A failed transaction stops the write, the bytes before it are on the display already.
+ * */
+int32_t saph_ssd1306_internal_sendData(saph_ssd1306_device_t* device, const uint8_t* buffer, uint32_t bufferSize) {
+    if (device == 0 || buffer == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    uint8_t sendingBuffer[1 + SAPH_SSD1306_DATA_CHUNK];
+    sendingBuffer[0] = 0x40;
+    uint32_t sent = 0;
+    do {
+        uint32_t amount = bufferSize - sent < SAPH_SSD1306_DATA_CHUNK ? bufferSize - sent : SAPH_SSD1306_DATA_CHUNK;
+        memcpy(sendingBuffer + 1, buffer + sent, amount);
+        int32_t commResult = i2c_handler_write(device->address, sendingBuffer, amount + 1);
+        if (commResult < 0) {
+            return commResult;
+        }
+        sent += amount;
+    } while (sent < bufferSize);
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+/* *
+ * Like sendData for a buffer that already keeps its first byte free for the control byte, the dataSize data bytes
+ * follow it. Nothing is copied, so large writes need no second buffer on the stack.
+ * */
+int32_t saph_ssd1306_internal_sendDataInPlace(saph_ssd1306_device_t* device, uint8_t* buffer, uint32_t dataSize) {
+    if (device == 0 || buffer == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    buffer[0] = 0x40;
+    int32_t commResult = i2c_handler_write(device->address, buffer, dataSize + 1);
+    if (commResult < 0) {
+        return commResult;
+    }
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+// A plain read without a control byte returns the status register (datasheet 8.1.5.2)
+int32_t saph_ssd1306_internal_readStatus(saph_ssd1306_device_t* device, uint8_t* buffer) {
+    if (device == 0 || buffer == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    int32_t commResult = i2c_handler_read(device->address, buffer, 1);
+    if (commResult < 0) {
+        return commResult;
+    } else if (commResult != 1) {
+        return SAPH_SSD1306_COMM_ERROR_READ_AMOUNT;
+    }
+    return SAPH_SSD1306_NO_ERROR;
 }
@@ -3,6 +3,17 @@
 
 #include "saph_ssd1306.h"
 
+// Data bytes per transaction of sendData, the sending buffer with its control byte lives on the stack
+#ifndef SAPH_SSD1306_DATA_CHUNK
+#define SAPH_SSD1306_DATA_CHUNK 32
+#endif
+
 int32_t saph_ssd1306_internal_sendCtrlCommand(saph_ssd1306_device_t* device, uint8_t* buffer, uint32_t bufferSize);
 
+int32_t saph_ssd1306_internal_sendData(saph_ssd1306_device_t* device, const uint8_t* buffer, uint32_t bufferSize);
+
+int32_t saph_ssd1306_internal_sendDataInPlace(saph_ssd1306_device_t* device, uint8_t* buffer, uint32_t dataSize);
+
+int32_t saph_ssd1306_internal_readStatus(saph_ssd1306_device_t* device, uint8_t* buffer);
+
 #endif // SAPH_SSD1306_INTERNAL_H
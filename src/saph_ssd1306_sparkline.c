@@ -0,0 +1,270 @@
+#include "saph_ssd1306_sparkline.h"
+
+#include <string.h>
+
+#define ROWS_PER_PAGE 8
+
+// ###############################################
+// Helper Function definitions
+// ###############################################
+
+static uint8_t ringIndex(saph_ssd1306_sparkline_t* sparkline, uint8_t age);
+
+static int64_t decodeLevel(saph_ssd1306_sparkline_t* sparkline, uint8_t level);
+
+static bool encodeLevel(saph_ssd1306_sparkline_t* sparkline, int64_t value, uint8_t* level);
+
+static void rescale(saph_ssd1306_sparkline_t* sparkline, int64_t low, int64_t high);
+
+static void findMinMaxLevel(saph_ssd1306_sparkline_t* sparkline);
+
+static uint8_t getRow(saph_ssd1306_sparkline_t* sparkline, uint8_t level);
+
+static uint8_t renderColumnPage(saph_ssd1306_sparkline_t* sparkline, uint8_t column, uint8_t page);
+
+static int32_t drawColumns(saph_ssd1306_sparkline_t* sparkline, uint8_t firstColumn, uint8_t amountColumns);
+
+// ###############################################
+// Implementations
+// ###############################################
+
+int32_t saph_ssd1306_sparkline_init(saph_ssd1306_sparkline_t* sparkline, saph_ssd1306_device_t* device, uint8_t field,
+                                    uint8_t startColumn, uint8_t columns, uint8_t startPage, uint8_t endPage,
+                                    uint32_t minStep) {
+    if (sparkline == 0 || device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (field > SAPH_SSD1306_SPARKLINE_FIELD_HUMIDITY || columns < 2 ||
+        startColumn + columns > SAPH_SSD1306_WIDTH || startPage > endPage || endPage >= SAPH_SSD1306_PAGES ||
+        minStep == 0) {
+        return SAPH_SSD1306_INVALID_CONFIG_ERROR;
+    }
+    memset(sparkline, 0, sizeof(saph_ssd1306_sparkline_t));
+    sparkline->device = device;
+    sparkline->field = field;
+    sparkline->startColumn = startColumn;
+    sparkline->columns = columns;
+    sparkline->startPage = startPage;
+    sparkline->pages = endPage - startPage + 1;
+    sparkline->minStep = minStep;
+    sparkline->scaleStep = minStep;
+    return saph_ssd1306_sparkline_redraw(sparkline);
+}
+
+/* *
+ * Stores the sample and redraws its column and the gap after it, or everything if the scale had to change.
+ * */
+int32_t saph_ssd1306_sparkline_push(saph_ssd1306_sparkline_t* sparkline, int32_t value) {
+    if (sparkline == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (sparkline->amount == 0) {
+        // Centered, so the first samples have room to both sides
+        sparkline->scaleStep = sparkline->minStep;
+        sparkline->scaleBase = (int32_t) ((int64_t) value - (int64_t) (SAPH_SSD1306_SPARKLINE_MAX_LEVEL / 2) *
+                                                             sparkline->minStep);
+    }
+    bool isFull = sparkline->amount == sparkline->columns;
+    uint8_t evicted = sparkline->levels[sparkline->cursor];
+    uint8_t level = 0;
+    bool needsRescale = !encodeLevel(sparkline, value, &level);
+    if (needsRescale) {
+        int64_t low = value;
+        int64_t high = value;
+        if (sparkline->amount > 0) {
+            int64_t oldLow = decodeLevel(sparkline, sparkline->minLevel);
+            int64_t oldHigh = decodeLevel(sparkline, sparkline->maxLevel);
+            low = oldLow < low ? oldLow : low;
+            high = oldHigh > high ? oldHigh : high;
+        }
+        rescale(sparkline, low, high);
+        encodeLevel(sparkline, value, &level);
+    }
+    sparkline->levels[sparkline->cursor] = level;
+    uint8_t column = sparkline->cursor;
+    sparkline->cursor = (uint8_t) ((sparkline->cursor + 1) % sparkline->columns);
+    if (!isFull) {
+        sparkline->amount++;
+    }
+    if (sparkline->amount == 1) {
+        sparkline->minLevel = level;
+        sparkline->maxLevel = level;
+    } else if (isFull && (evicted == sparkline->minLevel || evicted == sparkline->maxLevel)) {
+        findMinMaxLevel(sparkline);
+    } else {
+        sparkline->minLevel = level < sparkline->minLevel ? level : sparkline->minLevel;
+        sparkline->maxLevel = level > sparkline->maxLevel ? level : sparkline->maxLevel;
+    }
+    if (!needsRescale && sparkline->scaleStep > sparkline->minStep &&
+        sparkline->maxLevel - sparkline->minLevel < SAPH_SSD1306_SPARKLINE_SHRINK_LEVELS) {
+        rescale(sparkline, decodeLevel(sparkline, sparkline->minLevel), decodeLevel(sparkline, sparkline->maxLevel));
+        needsRescale = true;
+    }
+    if (needsRescale) {
+        return saph_ssd1306_sparkline_redraw(sparkline);
+    }
+    // The column after the gap loses the segment to its old predecessor
+    uint8_t amountColumns = sparkline->amount == sparkline->columns ? 3 : 2;
+    return drawColumns(sparkline, column, amountColumns > sparkline->columns ? sparkline->columns : amountColumns);
+}
+
+int32_t saph_ssd1306_sparkline_pushMeasurements(saph_ssd1306_sparkline_t* sparkline,
+                                                const saphBmeMeasurements_t* measurements) {
+    if (sparkline == 0 || measurements == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (sparkline->field == SAPH_SSD1306_SPARKLINE_FIELD_PRESSURE) {
+        return saph_ssd1306_sparkline_push(sparkline, (int32_t) measurements->pressure);
+    } else if (sparkline->field == SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE) {
+        return saph_ssd1306_sparkline_push(sparkline, measurements->temperature);
+    }
+    return saph_ssd1306_sparkline_push(sparkline, (int32_t) measurements->humidity);
+}
+
+int32_t saph_ssd1306_sparkline_redraw(saph_ssd1306_sparkline_t* sparkline) {
+    if (sparkline == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    sparkline->fullRedraws++;
+    return drawColumns(sparkline, 0, sparkline->columns);
+}
+
+// Age 0 is the newest sample, values come back at the resolution of the current scale
+int32_t saph_ssd1306_sparkline_getValue(saph_ssd1306_sparkline_t* sparkline, uint8_t age, int32_t* value) {
+    if (sparkline == 0 || value == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    if (age >= sparkline->amount) {
+        return SAPH_SSD1306_SPARKLINE_NO_SAMPLE_ERROR;
+    }
+    *value = (int32_t) decodeLevel(sparkline, sparkline->levels[ringIndex(sparkline, age)]);
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+static uint8_t ringIndex(saph_ssd1306_sparkline_t* sparkline, uint8_t age) {
+    return (uint8_t) ((sparkline->cursor + sparkline->columns - 1 - age) % sparkline->columns);
+}
+
+static int64_t decodeLevel(saph_ssd1306_sparkline_t* sparkline, uint8_t level) {
+    return (int64_t) sparkline->scaleBase + (int64_t) level * sparkline->scaleStep;
+}
+
+// Rounds to the nearest level, false if the value is off the scale
+static bool encodeLevel(saph_ssd1306_sparkline_t* sparkline, int64_t value, uint8_t* level) {
+    int64_t offset = value - sparkline->scaleBase;
+    if (offset < 0) {
+        return false;
+    }
+    uint64_t rounded = ((uint64_t) offset + sparkline->scaleStep / 2) / sparkline->scaleStep;
+    if (rounded > SAPH_SSD1306_SPARKLINE_MAX_LEVEL) {
+        return false;
+    }
+    *level = (uint8_t) rounded;
+    return true;
+}
+
+/* *
+ * The history spans half of the new scale, centered, so it can drift a while before the next rescale.
+ * Levels are decoded with the old scale and encoded with the new one, which costs at most half a step each time.
+ * */
+static void rescale(saph_ssd1306_sparkline_t* sparkline, int64_t low, int64_t high) {
+    int32_t oldBase = sparkline->scaleBase;
+    uint32_t oldStep = sparkline->scaleStep;
+    uint64_t span = (uint64_t) (high - low);
+    uint64_t step = (2 * span + SAPH_SSD1306_SPARKLINE_MAX_LEVEL - 1) / SAPH_SSD1306_SPARKLINE_MAX_LEVEL;
+    sparkline->scaleStep = step > sparkline->minStep ? (uint32_t) step : sparkline->minStep;
+    int64_t center = low + (int64_t) (span / 2);
+    sparkline->scaleBase = (int32_t) (center - (int64_t) (SAPH_SSD1306_SPARKLINE_MAX_LEVEL / 2) *
+                                               sparkline->scaleStep);
+    for (uint8_t i = 0; i < sparkline->amount; ++i) {
+        uint8_t index = ringIndex(sparkline, i);
+        int64_t value = (int64_t) oldBase + (int64_t) sparkline->levels[index] * oldStep;
+        encodeLevel(sparkline, value, &(sparkline->levels[index]));
+    }
+    findMinMaxLevel(sparkline);
+}
+
+static void findMinMaxLevel(saph_ssd1306_sparkline_t* sparkline) {
+    sparkline->minLevel = SAPH_SSD1306_SPARKLINE_MAX_LEVEL;
+    sparkline->maxLevel = 0;
+    for (uint8_t i = 0; i < sparkline->amount; ++i) {
+        uint8_t level = sparkline->levels[ringIndex(sparkline, i)];
+        sparkline->minLevel = level < sparkline->minLevel ? level : sparkline->minLevel;
+        sparkline->maxLevel = level > sparkline->maxLevel ? level : sparkline->maxLevel;
+    }
+}
+
+// Row 0 is the top of the widget, the highest level
+static uint8_t getRow(saph_ssd1306_sparkline_t* sparkline, uint8_t level) {
+    uint16_t lastRow = (uint16_t) (sparkline->pages * ROWS_PER_PAGE - 1);
+    return (uint8_t) (lastRow - (level * lastRow + SAPH_SSD1306_SPARKLINE_MAX_LEVEL / 2) /
+                                SAPH_SSD1306_SPARKLINE_MAX_LEVEL);
+}
+
+/* *
+ * A column holds a vertical segment from the row of the previous sample to its own, which joins neighbouring
+ * samples into a line. Columns without a sample and the gap at the cursor stay dark.
+ * */
+static uint8_t renderColumnPage(saph_ssd1306_sparkline_t* sparkline, uint8_t column, uint8_t page) {
+    bool isFull = sparkline->amount == sparkline->columns;
+    uint8_t previous = (uint8_t) ((column + sparkline->columns - 1) % sparkline->columns);
+    bool hasSample = isFull ? column != sparkline->cursor : column < sparkline->amount;
+    bool hasPrevious = isFull ? previous != sparkline->cursor : column > 0;
+    if (!hasSample) {
+        return 0;
+    }
+    uint8_t top = getRow(sparkline, sparkline->levels[column]);
+    uint8_t bottom = top;
+    if (hasPrevious) {
+        uint8_t previousRow = getRow(sparkline, sparkline->levels[previous]);
+        top = previousRow < top ? previousRow : top;
+        bottom = previousRow > bottom ? previousRow : bottom;
+    }
+    uint8_t pageTop = (uint8_t) (page * ROWS_PER_PAGE);
+    uint8_t pageBottom = (uint8_t) (pageTop + ROWS_PER_PAGE - 1);
+    if (bottom < pageTop || top > pageBottom) {
+        return 0;
+    }
+    uint8_t first = top > pageTop ? top - pageTop : 0;
+    uint8_t last = bottom < pageBottom ? bottom - pageTop : ROWS_PER_PAGE - 1;
+    return (uint8_t) ((0xFFu >> (ROWS_PER_PAGE - 1 - last)) & (0xFFu << first));
+}
+
+/* *
+ * One address window over the columns, the data goes out in transfers of at most a panel row,
+ * which keeps the stack small for a full redraw. A run past the last column continues at the first.
+ * */
+static int32_t drawColumns(saph_ssd1306_sparkline_t* sparkline, uint8_t firstColumn, uint8_t amountColumns) {
+    if (firstColumn + amountColumns > sparkline->columns) {
+        uint8_t tail = (uint8_t) (sparkline->columns - firstColumn);
+        int32_t errorCode = drawColumns(sparkline, firstColumn, tail);
+        if (errorCode != SAPH_SSD1306_NO_ERROR) {
+            return errorCode;
+        }
+        return drawColumns(sparkline, 0, (uint8_t) (amountColumns - tail));
+    }
+    uint8_t screenColumn = (uint8_t) (sparkline->startColumn + firstColumn);
+    int32_t errorCode = saph_ssd1306_setAddressWindow(sparkline->device, screenColumn,
+                                                      (uint8_t) (screenColumn + amountColumns - 1),
+                                                      sparkline->startPage,
+                                                      (uint8_t) (sparkline->startPage + sparkline->pages - 1));
+    uint8_t buffer[SAPH_SSD1306_SPARKLINE_MAX_COLUMNS];
+    uint32_t amountBytes = 0;
+    for (uint8_t page = 0; page < sparkline->pages && errorCode == SAPH_SSD1306_NO_ERROR; ++page) {
+        for (uint8_t i = 0; i < amountColumns; ++i) {
+            buffer[amountBytes++] = renderColumnPage(sparkline, (uint8_t) (firstColumn + i), page);
+            if (amountBytes == sizeof(buffer)) {
+                errorCode = saph_ssd1306_writeData(sparkline->device, buffer, amountBytes);
+                amountBytes = 0;
+            }
+        }
+    }
+    if (errorCode != SAPH_SSD1306_NO_ERROR || amountBytes == 0) {
+        return errorCode;
+    }
+    return saph_ssd1306_writeData(sparkline->device, buffer, amountBytes);
+}
@@ -0,0 +1,59 @@
+#ifndef SAPH_SSD1306_SPARKLINE_H
+#define SAPH_SSD1306_SPARKLINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saph_ssd1306.h"
+#include "saphBme280.h"
+
+#define SAPH_SSD1306_SPARKLINE_NO_SAMPLE_ERROR -44
+
+#define SAPH_SSD1306_SPARKLINE_FIELD_PRESSURE 0
+#define SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE 1
+#define SAPH_SSD1306_SPARKLINE_FIELD_HUMIDITY 2
+
+#define SAPH_SSD1306_SPARKLINE_MAX_COLUMNS SAPH_SSD1306_WIDTH
+#define SAPH_SSD1306_SPARKLINE_MAX_LEVEL 255
+// The scale is narrowed again once the history uses less than this many levels
+#define SAPH_SSD1306_SPARKLINE_SHRINK_LEVELS 64
+
+/* *
+ * History graph of one measurement field in a rectangle of the panel, drawn as a sweep: sample k goes to
+ * column k % columns and the column after it is blanked as a gap, so every sample redraws two or three columns.
+ * Samples are kept as 8 bit levels of a linear scale, level = (value - scaleBase) / scaleStep. The scale widens
+ * when a sample falls outside and narrows when the history shrinks, both requantize the ring and redraw it all.
+ * */
+typedef struct saph_ssd1306_sparkline_t {
+    saph_ssd1306_device_t* device;
+    uint8_t field;
+    uint8_t startColumn;
+    uint8_t columns;
+    uint8_t startPage;
+    uint8_t pages;
+    // Smallest value step per level, the resolution worth showing, e.g. 1 for 0.01 degC
+    uint32_t minStep;
+    int32_t scaleBase;
+    uint32_t scaleStep;
+    uint8_t levels[SAPH_SSD1306_SPARKLINE_MAX_COLUMNS];
+    uint8_t amount;
+    uint8_t cursor;
+    uint8_t minLevel;
+    uint8_t maxLevel;
+    uint32_t fullRedraws;
+} saph_ssd1306_sparkline_t;
+
+int32_t saph_ssd1306_sparkline_init(saph_ssd1306_sparkline_t* sparkline, saph_ssd1306_device_t* device, uint8_t field,
+                                    uint8_t startColumn, uint8_t columns, uint8_t startPage, uint8_t endPage,
+                                    uint32_t minStep);
+
+int32_t saph_ssd1306_sparkline_push(saph_ssd1306_sparkline_t* sparkline, int32_t value);
+
+int32_t saph_ssd1306_sparkline_pushMeasurements(saph_ssd1306_sparkline_t* sparkline,
+                                                const saphBmeMeasurements_t* measurements);
+
+int32_t saph_ssd1306_sparkline_redraw(saph_ssd1306_sparkline_t* sparkline);
+
+int32_t saph_ssd1306_sparkline_getValue(saph_ssd1306_sparkline_t* sparkline, uint8_t age, int32_t* value);
+
+#endif // SAPH_SSD1306_SPARKLINE_H
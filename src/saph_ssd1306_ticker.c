@@ -0,0 +1,82 @@
+#include "saph_ssd1306_ticker.h"
+
+// ###############################################
+// Implementations
+// ###############################################
+
+/* *
+ * Scrolling has to be off while it is set up (datasheet 10.2.1). The address window is narrowed to the entry
+ * column, so every push lands there without sending addresses again.
+ * */
+int32_t saph_ssd1306_ticker_init(saph_ssd1306_ticker_t* ticker, saph_ssd1306_device_t* device, uint8_t direction,
+                                 uint8_t startPage, uint8_t endPage, uint8_t frameInterval) {
+    if (ticker == 0 || device == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    ticker->device = device;
+    ticker->direction = direction;
+    ticker->startPage = startPage;
+    ticker->endPage = endPage;
+    ticker->frameInterval = frameInterval;
+    ticker->steps = 0;
+    int32_t errorCode = saph_ssd1306_scrollActivate(device, false);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    errorCode = saph_ssd1306_scrollHorizontal(device, direction, startPage, endPage, frameInterval);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    uint8_t entryColumn = saph_ssd1306_ticker_getEntryColumn(ticker);
+    errorCode = saph_ssd1306_setAddressWindow(device, entryColumn, entryColumn, startPage, endPage);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    return saph_ssd1306_scrollActivate(device, true);
+}
+
+/* *
+ * column holds one byte per page of the strip, top page first, least significant bit on top.
+ * The scroll is off while the column goes into GDDRAM and is set up again before it restarts (datasheet 10.2.1).
+ * The address window still covers only the entry column, so the pointer is back at its top after every push.
+ * */
+int32_t saph_ssd1306_ticker_push(saph_ssd1306_ticker_t* ticker, const uint8_t* column) {
+    if (ticker == 0 || column == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    int32_t errorCode = saph_ssd1306_scrollActivate(ticker->device, false);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    errorCode = saph_ssd1306_writeData(ticker->device, column, ticker->endPage - ticker->startPage + 1);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    errorCode = saph_ssd1306_scrollHorizontal(ticker->device, ticker->direction, ticker->startPage, ticker->endPage,
+                                              ticker->frameInterval);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    errorCode = saph_ssd1306_scrollActivate(ticker->device, true);
+    if (errorCode != SAPH_SSD1306_NO_ERROR) {
+        return errorCode;
+    }
+    ticker->steps++;
+    return SAPH_SSD1306_NO_ERROR;
+}
+
+// The strip stays as it is, RAM has to be rewritten before anything else is drawn on it
+int32_t saph_ssd1306_ticker_stop(saph_ssd1306_ticker_t* ticker) {
+    if (ticker == 0) {
+        return SAPH_SSD1306_NULL_POINTER_ERROR;
+    }
+    return saph_ssd1306_scrollActivate(ticker->device, false);
+}
+
+// Scrolling left shifts new content in on the right edge and the other way round
+uint8_t saph_ssd1306_ticker_getEntryColumn(saph_ssd1306_ticker_t* ticker) {
+    if (ticker == 0 || ticker->direction == SAPH_SSD1306_SCROLL_RIGHT) {
+        return 0;
+    }
+    return SAPH_SSD1306_WIDTH - 1;
+}
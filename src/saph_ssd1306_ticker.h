@@ -0,0 +1,36 @@
+#ifndef SAPH_SSD1306_TICKER_H
+#define SAPH_SSD1306_TICKER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "saph_ssd1306.h"
+
+/* *
+ * Scrolling strip on the pages startPage to endPage. The SSD1306 moves the strip itself with its continuous
+ * horizontal scroll, each step only the newly exposed column at the entry edge gets written, one byte per page.
+ * GDDRAM must not be written while scrolling (datasheet 10.2.2), so a push stops the scroll, writes the column and
+ * sets the scroll up and starts it again, which adds 12 command bytes to the column.
+ * The caller pushes one column per scroll step, i.e. every frameInterval frames. Nothing ties a push to the chip's
+ * own scroll clock though: a push that comes early or late lets the chip repeat or skip a column, so on a panel the
+ * strip only keeps its exact history as long as the pushes keep pace with the frames.
+ * */
+typedef struct saph_ssd1306_ticker_t {
+    saph_ssd1306_device_t* device;
+    uint8_t direction;
+    uint8_t startPage;
+    uint8_t endPage;
+    uint8_t frameInterval;
+    uint32_t steps;
+} saph_ssd1306_ticker_t;
+
+int32_t saph_ssd1306_ticker_init(saph_ssd1306_ticker_t* ticker, saph_ssd1306_device_t* device, uint8_t direction,
+                                 uint8_t startPage, uint8_t endPage, uint8_t frameInterval);
+
+int32_t saph_ssd1306_ticker_push(saph_ssd1306_ticker_t* ticker, const uint8_t* column);
+
+int32_t saph_ssd1306_ticker_stop(saph_ssd1306_ticker_t* ticker);
+
+uint8_t saph_ssd1306_ticker_getEntryColumn(saph_ssd1306_ticker_t* ticker);
+
+#endif // SAPH_SSD1306_TICKER_H
@@ -1 +0,0 @@
-/home/saphieron/git/private/pico/pico-sdk//src/rp2_common/hardware_i2c/include/hardware/i2c.h
\ No newline at end of file
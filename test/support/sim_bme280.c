@@ -0,0 +1,325 @@
+//
+// Register level model of a BME280 or BMP280, see sim_bme280.h
+//
+
+#include "sim_bme280.h"
+#include "sim_i2c_bus.h"
+
+#include <string.h>
+
+#define REG_TRIM_FIRST_ADDR 0x88
+#define REG_TRIM_H1_ADDR 0xA1
+#define REG_DEVICE_ID_ADDR 0xD0
+#define REG_RESET_ADDR 0xE0
+#define REG_TRIM_H2_ADDR 0xE1
+#define REG_HUMIDITY_CTRL_ADDR 0xF2
+#define REG_STATUS_ADDR 0xF3
+#define REG_MEASURE_CONTROL_ADDR 0xF4
+#define REG_CONFIG_ADDR 0xF5
+#define REG_PRESSURE_START_ADDR 0xF7
+#define REG_HUMIDITY_START_ADDR 0xFD
+
+#define REG_RESET_VALUE 0xB6
+#define STATUS_MEASURING 0x08
+#define MODE_BITS 0x03
+// Value of a data register whose measurement was skipped
+#define SKIPPED_MSB 0x80
+
+// The trimming values of test_saphBme280_internal.c, which leave dig_H6 at 0
+const saphBmeTrimmingValues_t sim_bme280_referenceTrimmingValues = {28417, 26721, 50,
+                                                                    38042, -10559, 3024,
+                                                                    8726, -185, -7,
+                                                                    9900, -10230, 4285,
+                                                                    75, 360, 0,
+                                                                    325, 50, 0};
+
+static int32_t onWrite(void* context, const uint8_t* buffer, uint32_t amount);
+
+static int32_t onRead(void* context, uint8_t* buffer, uint32_t amount);
+
+static void resetControlRegisters(sim_bme280_t* sim);
+
+static void putLittleEndian(uint8_t* target, uint16_t value);
+
+static bool hasHumidity(sim_bme280_t* sim);
+
+static void writeMeasureCtrl(sim_bme280_t* sim, uint8_t value);
+
+static void finishConversion(sim_bme280_t* sim);
+
+static void updateStatus(sim_bme280_t* sim);
+
+static void resetDataRegisters(sim_bme280_t* sim);
+
+static uint8_t takeFault(sim_bme280_t* sim, bool isRead);
+
+static uint8_t drawFault(sim_bme280_t* sim, bool isRead);
+
+static void writeDataRegisters(sim_bme280_t* sim, int32_t pressure, int32_t temperature, int32_t humidity);
+
+void sim_bme280_init(sim_bme280_t* sim, uint8_t chipId) {
+    memset(sim, 0, sizeof(sim_bme280_t));
+    sim->chipId = chipId;
+    sim->registers[REG_DEVICE_ID_ADDR] = chipId;
+    resetControlRegisters(sim);
+    sim_bme280_setTrimmingValues(sim, &sim_bme280_referenceTrimmingValues);
+    resetDataRegisters(sim);
+}
+
+void sim_bme280_setTrimmingValues(sim_bme280_t* sim, const saphBmeTrimmingValues_t* trims) {
+    uint8_t* reg = &(sim->registers[REG_TRIM_FIRST_ADDR]);
+    const uint16_t temperatureAndPressure[] = {trims->dig_T1, trims->dig_T2, trims->dig_T3,
+                                               trims->dig_P1, trims->dig_P2, trims->dig_P3,
+                                               trims->dig_P4, trims->dig_P5, trims->dig_P6,
+                                               trims->dig_P7, trims->dig_P8, trims->dig_P9};
+    for (uint8_t i = 0; i < 12; ++i) {
+        putLittleEndian(reg + 2 * i, temperatureAndPressure[i]);
+    }
+    if (!hasHumidity(sim)) {
+        return;
+    }
+    sim->registers[REG_TRIM_H1_ADDR] = trims->dig_H1;
+    reg = &(sim->registers[REG_TRIM_H2_ADDR]);
+    putLittleEndian(reg, trims->dig_H2);
+    reg[2] = trims->dig_H3;
+    reg[3] = (uint8_t) (trims->dig_H4 >> 4);
+    reg[4] = (uint8_t) ((trims->dig_H4 & 0x0F) | ((trims->dig_H5 & 0x0F) << 4));
+    reg[5] = (uint8_t) (trims->dig_H5 >> 4);
+    reg[6] = (uint8_t) trims->dig_H6;
+}
+
+void sim_bme280_setRawMeasurement(sim_bme280_t* sim, int32_t pressure, int32_t temperature, int32_t humidity) {
+    sim->rawPressure = pressure;
+    sim->rawTemperature = temperature;
+    sim->rawHumidity = humidity;
+    writeDataRegisters(sim, pressure, temperature, humidity);
+}
+
+int32_t sim_bme280_attach(sim_bme280_t* sim, uint8_t address) {
+    return sim_i2c_bus_attach(address, sim, onWrite, onRead);
+}
+
+void sim_bme280_setTiming(sim_bme280_t* sim, uint32_t measurementTimeUs, uint32_t standbyTimeUs) {
+    sim->measurementTimeUs = measurementTimeUs;
+    sim->standbyTimeUs = standbyTimeUs;
+    sim->cyclePositionUs = 0;
+    updateStatus(sim);
+}
+
+/* *
+ * Runs the conversion cycle: a conversion starts with the mode write, normal mode follows it with the standby time
+ * and starts over, forced mode drops back to sleep. The data registers change at the end of each conversion.
+ * */
+void sim_bme280_advanceTime(sim_bme280_t* sim, uint32_t deltaUs) {
+    while (deltaUs > 0 && sim->measurementTimeUs > 0) {
+        uint8_t mode = sim->registers[REG_MEASURE_CONTROL_ADDR] & MODE_BITS;
+        if (mode == 0) {
+            break;
+        }
+        uint32_t cycleEndUs = sim->measurementTimeUs;
+        if (sim->cyclePositionUs >= sim->measurementTimeUs) {
+            cycleEndUs += sim->standbyTimeUs;
+        }
+        uint32_t step = cycleEndUs - sim->cyclePositionUs;
+        if (step > deltaUs) {
+            step = deltaUs;
+        }
+        sim->cyclePositionUs += step;
+        deltaUs -= step;
+        if (sim->cyclePositionUs == sim->measurementTimeUs) {
+            finishConversion(sim);
+            if (mode != MODE_BITS) {
+                sim->registers[REG_MEASURE_CONTROL_ADDR] &= ~MODE_BITS;
+                sim->cyclePositionUs = 0;
+            }
+        } else if (sim->cyclePositionUs == sim->measurementTimeUs + sim->standbyTimeUs) {
+            sim->cyclePositionUs = 0;
+        }
+    }
+    updateStatus(sim);
+}
+
+/* *
+ * Random faults from a xorshift sequence, the same seed gives the same faults for the same traffic.
+ * Scheduled faults take precedence over random ones.
+ * */
+void sim_bme280_setFaultRates(sim_bme280_t* sim, const sim_bme280_faultRates_t* rates, uint32_t seed) {
+    sim->faultRates = *rates;
+    sim->faultRandomState = seed == 0 ? 1 : seed;
+}
+
+// Hits the transaction with the given index, counted from 0 at init. A short read scheduled on a write is lost.
+int32_t sim_bme280_scheduleFault(sim_bme280_t* sim, uint32_t transaction, uint8_t kind) {
+    if (sim->amountScheduledFaults >= SIM_BME280_MAX_SCHEDULED_FAULTS) {
+        return SIM_BME280_FULL_ERROR;
+    }
+    sim->scheduledFaults[sim->amountScheduledFaults].transaction = transaction;
+    sim->scheduledFaults[sim->amountScheduledFaults].kind = kind;
+    sim->amountScheduledFaults++;
+    return SIM_BME280_NO_ERROR;
+}
+
+// Control and data registers back to their reset values and any conversion aborted, the trimming values stay
+void sim_bme280_powerOnReset(sim_bme280_t* sim) {
+    resetControlRegisters(sim);
+    resetDataRegisters(sim);
+    sim->registerPointer = 0;
+    sim->cyclePositionUs = 0;
+    updateStatus(sim);
+}
+
+// ###############################################
+// Helper Functions
+// ###############################################
+
+// Writes are a register address followed by any amount of value/address pairs, no auto increment
+static int32_t onWrite(void* context, const uint8_t* buffer, uint32_t amount) {
+    sim_bme280_t* sim = (sim_bme280_t*) context;
+    if (takeFault(sim, false) == SIM_BME280_FAULT_NACK) {
+        return SIM_I2C_BUS_NACK;
+    }
+    if (amount == 0) {
+        return 0;
+    }
+    sim->registerPointer = buffer[0];
+    for (uint32_t i = 0; i + 1 < amount; i += 2) {
+        uint8_t regAddress = buffer[i];
+        uint8_t value = buffer[i + 1];
+        if (regAddress == REG_RESET_ADDR && value == REG_RESET_VALUE) {
+            resetControlRegisters(sim);
+        } else if (regAddress == REG_HUMIDITY_CTRL_ADDR && !hasHumidity(sim)) {
+            continue;
+        } else if (regAddress == REG_MEASURE_CONTROL_ADDR) {
+            writeMeasureCtrl(sim, value);
+        } else if (regAddress == REG_HUMIDITY_CTRL_ADDR || regAddress == REG_CONFIG_ADDR) {
+            sim->registers[regAddress] = value;
+        }
+    }
+    return (int32_t) amount;
+}
+
+// Reads auto increment the register pointer
+static int32_t onRead(void* context, uint8_t* buffer, uint32_t amount) {
+    sim_bme280_t* sim = (sim_bme280_t*) context;
+    uint8_t fault = takeFault(sim, true);
+    if (fault == SIM_BME280_FAULT_NACK) {
+        return SIM_I2C_BUS_NACK;
+    }
+    if (fault == SIM_BME280_FAULT_SHORT_READ) {
+        amount /= 2;
+    }
+    for (uint32_t i = 0; i < amount; ++i) {
+        buffer[i] = sim->registers[sim->registerPointer++];
+    }
+    return (int32_t) amount;
+}
+
+static void resetControlRegisters(sim_bme280_t* sim) {
+    sim->registers[REG_HUMIDITY_CTRL_ADDR] = 0;
+    sim->registers[REG_MEASURE_CONTROL_ADDR] = 0;
+    sim->registers[REG_CONFIG_ADDR] = 0;
+}
+
+static void putLittleEndian(uint8_t* target, uint16_t value) {
+    target[0] = (uint8_t) value;
+    target[1] = (uint8_t) (value >> 8);
+}
+
+static bool hasHumidity(sim_bme280_t* sim) {
+    return sim->chipId != SAPHBME280_CHIP_ID_BMP280;
+}
+
+// Leaving sleep starts a conversion, changing settings while running keeps the cycle going
+static void writeMeasureCtrl(sim_bme280_t* sim, uint8_t value) {
+    bool wasSleeping = (sim->registers[REG_MEASURE_CONTROL_ADDR] & MODE_BITS) == 0;
+    sim->registers[REG_MEASURE_CONTROL_ADDR] = value;
+    if (wasSleeping || (value & MODE_BITS) == 0) {
+        sim->cyclePositionUs = 0;
+    }
+    updateStatus(sim);
+}
+
+static void finishConversion(sim_bme280_t* sim) {
+    sim->conversions++;
+    int32_t temperature = sim->rawTemperature + (int32_t) sim->conversions * sim->temperatureStep;
+    writeDataRegisters(sim, sim->rawPressure, temperature, sim->rawHumidity);
+}
+
+static void writeDataRegisters(sim_bme280_t* sim, int32_t pressure, int32_t temperature, int32_t humidity) {
+    uint8_t* reg = &(sim->registers[REG_PRESSURE_START_ADDR]);
+    reg[0] = (uint8_t) (pressure >> 12);
+    reg[1] = (uint8_t) (pressure >> 4);
+    reg[2] = (uint8_t) ((pressure & 0x0F) << 4);
+    reg[3] = (uint8_t) (temperature >> 12);
+    reg[4] = (uint8_t) (temperature >> 4);
+    reg[5] = (uint8_t) ((temperature & 0x0F) << 4);
+    if (hasHumidity(sim)) {
+        reg[6] = (uint8_t) (humidity >> 8);
+        reg[7] = (uint8_t) humidity;
+    }
+}
+
+static void updateStatus(sim_bme280_t* sim) {
+    bool running = (sim->registers[REG_MEASURE_CONTROL_ADDR] & MODE_BITS) != 0 && sim->measurementTimeUs > 0;
+    if (running && sim->cyclePositionUs < sim->measurementTimeUs) {
+        sim->registers[REG_STATUS_ADDR] = STATUS_MEASURING;
+    } else {
+        sim->registers[REG_STATUS_ADDR] = 0;
+    }
+}
+
+static void resetDataRegisters(sim_bme280_t* sim) {
+    memset(&(sim->registers[REG_PRESSURE_START_ADDR]), 0, 8);
+    sim->registers[REG_PRESSURE_START_ADDR] = SKIPPED_MSB;
+    sim->registers[REG_PRESSURE_START_ADDR + 3] = SKIPPED_MSB;
+    sim->registers[REG_HUMIDITY_START_ADDR] = SKIPPED_MSB;
+}
+
+// Counts the transaction and carries out a reset right away, the other faults are up to the caller
+static uint8_t takeFault(sim_bme280_t* sim, bool isRead) {
+    uint32_t transaction = sim->transactions++;
+    uint8_t fault = SIM_BME280_FAULT_NONE;
+    bool scheduled = false;
+    for (uint8_t i = 0; i < sim->amountScheduledFaults; ++i) {
+        if (sim->scheduledFaults[i].transaction == transaction) {
+            fault = sim->scheduledFaults[i].kind;
+            sim->scheduledFaults[i] = sim->scheduledFaults[--sim->amountScheduledFaults];
+            scheduled = true;
+            break;
+        }
+    }
+    if (!scheduled) {
+        fault = drawFault(sim, isRead);
+    }
+    if (fault == SIM_BME280_FAULT_SHORT_READ && !isRead) {
+        fault = SIM_BME280_FAULT_NONE;
+    }
+    if (fault == SIM_BME280_FAULT_RESET) {
+        sim_bme280_powerOnReset(sim);
+        sim->resetsBeforeRead += isRead ? 1 : 0;
+    }
+    sim->injectedFaults[fault]++;
+    return fault;
+}
+
+static uint8_t drawFault(sim_bme280_t* sim, bool isRead) {
+    const sim_bme280_faultRates_t* rates = &sim->faultRates;
+    if (rates->nackPpm == 0 && rates->shortReadPpm == 0 && rates->resetPpm == 0) {
+        return SIM_BME280_FAULT_NONE;
+    }
+    uint32_t state = sim->faultRandomState;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    sim->faultRandomState = state;
+    uint32_t draw = state % 1000000u;
+    if (draw < rates->nackPpm) {
+        return SIM_BME280_FAULT_NACK;
+    }
+    draw -= rates->nackPpm;
+    if (draw < rates->shortReadPpm) {
+        return isRead ? SIM_BME280_FAULT_SHORT_READ : SIM_BME280_FAULT_NONE;
+    }
+    draw -= rates->shortReadPpm;
+    return draw < rates->resetPpm ? SIM_BME280_FAULT_RESET : SIM_BME280_FAULT_NONE;
+}
@@ -0,0 +1,84 @@
+//
+// Register level model of a BME280 or BMP280 for host tests, attached to the bus from sim_i2c_bus.h
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_SIM_BME280_H
+#define SAPH_PICO_TEMPERATURE_SIM_BME280_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "saphBme280.h"
+
+#define SIM_BME280_NO_ERROR 0
+#define SIM_BME280_FULL_ERROR -1
+
+// What a transaction to the sensor can suffer, see sim_bme280_setFaultRates and sim_bme280_scheduleFault
+#define SIM_BME280_FAULT_NONE 0
+#define SIM_BME280_FAULT_NACK 1
+// Only half the requested bytes arrive, writes are never cut short
+#define SIM_BME280_FAULT_SHORT_READ 2
+// Power on reset right before the transaction, which then goes through normally, see sim_bme280_powerOnReset
+#define SIM_BME280_FAULT_RESET 3
+#define SIM_BME280_AMOUNT_FAULT_KINDS 4
+#define SIM_BME280_MAX_SCHEDULED_FAULTS 8
+
+// Chances per transaction in parts per million
+typedef struct sim_bme280_faultRates_t {
+    uint32_t nackPpm;
+    uint32_t shortReadPpm;
+    uint32_t resetPpm;
+} sim_bme280_faultRates_t;
+
+typedef struct sim_bme280_fault_t {
+    uint32_t transaction;
+    uint8_t kind;
+} sim_bme280_fault_t;
+
+typedef struct sim_bme280_t {
+    uint8_t chipId;
+    uint8_t registerPointer;
+    uint8_t registers[256];
+    // Conversion timing, disabled while measurementTimeUs is 0 and data only changes through setRawMeasurement
+    uint32_t measurementTimeUs;
+    uint32_t standbyTimeUs;
+    uint32_t cyclePositionUs;
+    uint32_t conversions;
+    // Every finished conversion reports the raw values, temperature raised by temperatureStep per conversion
+    int32_t rawPressure;
+    int32_t rawTemperature;
+    int32_t rawHumidity;
+    int32_t temperatureStep;
+    // Fault injection, transactions counts everything addressed to the sensor since init
+    uint32_t transactions;
+    sim_bme280_faultRates_t faultRates;
+    uint32_t faultRandomState;
+    sim_bme280_fault_t scheduledFaults[SIM_BME280_MAX_SCHEDULED_FAULTS];
+    uint8_t amountScheduledFaults;
+    // Per kind, SIM_BME280_FAULT_NONE counts the clean transactions
+    uint32_t injectedFaults[SIM_BME280_AMOUNT_FAULT_KINDS];
+    // Resets between a register pointer write and its read, the read starts at register 0x00 and nothing tells
+    uint32_t resetsBeforeRead;
+} sim_bme280_t;
+
+// Trimming values of the BME280 the compensation tests were written against
+extern const saphBmeTrimmingValues_t sim_bme280_referenceTrimmingValues;
+
+void sim_bme280_init(sim_bme280_t* sim, uint8_t chipId);
+
+void sim_bme280_setTrimmingValues(sim_bme280_t* sim, const saphBmeTrimmingValues_t* trims);
+
+void sim_bme280_setRawMeasurement(sim_bme280_t* sim, int32_t pressure, int32_t temperature, int32_t humidity);
+
+int32_t sim_bme280_attach(sim_bme280_t* sim, uint8_t address);
+
+void sim_bme280_setTiming(sim_bme280_t* sim, uint32_t measurementTimeUs, uint32_t standbyTimeUs);
+
+void sim_bme280_advanceTime(sim_bme280_t* sim, uint32_t deltaUs);
+
+void sim_bme280_setFaultRates(sim_bme280_t* sim, const sim_bme280_faultRates_t* rates, uint32_t seed);
+
+int32_t sim_bme280_scheduleFault(sim_bme280_t* sim, uint32_t transaction, uint8_t kind);
+
+void sim_bme280_powerOnReset(sim_bme280_t* sim);
+
+#endif //SAPH_PICO_TEMPERATURE_SIM_BME280_H
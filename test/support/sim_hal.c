@@ -0,0 +1,29 @@
+//
+// Simulated backend of saph_hal.h, see sim_hal.h
+//
+
+#include "sim_hal.h"
+
+static sim_hal_delayHandler_t delayHandler = 0;
+static void* delayContext = 0;
+
+void sim_hal_setDelayHandler(sim_hal_delayHandler_t onDelay, void* context) {
+    delayHandler = onDelay;
+    delayContext = context;
+}
+
+uint32_t saph_hal_getTimeUs(void) {
+    return sim_i2c_bus_getTimeUs();
+}
+
+void saph_hal_delayUs(uint32_t delayUs) {
+    sim_i2c_bus_advanceTime(delayUs);
+    if (delayHandler != 0) {
+        delayHandler(delayContext, delayUs);
+    }
+}
+
+// Idle bus time as well, sleeping only changes the current on real hardware
+void saph_hal_sleepUs(uint32_t sleepUs) {
+    saph_hal_delayUs(sleepUs);
+}
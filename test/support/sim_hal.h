@@ -0,0 +1,18 @@
+//
+// saph_hal.h on the simulated bus: the time is the bus time of sim_i2c_bus.h and a delay passes idle bus time.
+// Device models that convert in the background learn about every delay through the delay handler.
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_SIM_HAL_H
+#define SAPH_PICO_TEMPERATURE_SIM_HAL_H
+
+#include <stdint.h>
+#include "saph_hal.h"
+#include "sim_i2c_bus.h"
+
+typedef void (* sim_hal_delayHandler_t)(void* context, uint32_t delayUs);
+
+// Called after the bus time moved on, 0 removes the handler
+void sim_hal_setDelayHandler(sim_hal_delayHandler_t onDelay, void* context);
+
+#endif //SAPH_PICO_TEMPERATURE_SIM_HAL_H
@@ -0,0 +1,198 @@
+//
+// Host side stand-in for i2c_handler.c, see sim_i2c_bus.h
+//
+
+#include "sim_i2c_bus.h"
+
+#include <pthread.h>
+#include <string.h>
+
+typedef struct simDevice_t {
+    uint8_t address;
+    void* context;
+    sim_i2c_bus_writeHandler_t onWrite;
+    sim_i2c_bus_readHandler_t onRead;
+} simDevice_t;
+
+static simDevice_t devices[SIM_I2C_BUS_MAX_DEVICES];
+static uint8_t amountDevices = 0;
+static sim_i2c_bus_stats_t stats;
+static uint8_t currentAddress = 0;
+static uint32_t busTimeUs = 0;
+static sim_i2c_bus_observer_t observer = 0;
+static void* observerContext = 0;
+// One bus on the host, hold times are bus time, only the thread holding the lock touches the depth and the stats
+static pthread_once_t lockOnce = PTHREAD_ONCE_INIT;
+static pthread_mutex_t busLock;
+static uint32_t lockDepth = 0;
+static uint32_t lockedAtUs = 0;
+static i2c_handler_lockStats_t lockStats;
+
+static simDevice_t* findDevice(uint8_t addr);
+
+static void initLock(void);
+
+void sim_i2c_bus_reset(void) {
+    memset(devices, 0, sizeof(devices));
+    amountDevices = 0;
+    busTimeUs = 0;
+    observer = 0;
+    sim_i2c_bus_clearStats();
+    i2c_handler_clearLockStats();
+}
+
+int32_t sim_i2c_bus_attach(uint8_t address, void* context, sim_i2c_bus_writeHandler_t onWrite,
+                           sim_i2c_bus_readHandler_t onRead) {
+    if (amountDevices >= SIM_I2C_BUS_MAX_DEVICES) {
+        return SIM_I2C_BUS_FULL_ERROR;
+    }
+    simDevice_t* device = &devices[amountDevices++];
+    device->address = address;
+    device->context = context;
+    device->onWrite = onWrite;
+    device->onRead = onRead;
+    return SIM_I2C_BUS_NO_ERROR;
+}
+
+sim_i2c_bus_stats_t sim_i2c_bus_getStats(void) {
+    return stats;
+}
+
+void sim_i2c_bus_clearStats(void) {
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint8_t sim_i2c_bus_getCurrentAddress(void) {
+    return currentAddress;
+}
+
+uint32_t sim_i2c_bus_getTimeUs(void) {
+    return busTimeUs;
+}
+
+void sim_i2c_bus_advanceTime(uint32_t deltaUs) {
+    busTimeUs += deltaUs;
+}
+
+void sim_i2c_bus_setObserver(sim_i2c_bus_observer_t onTransaction, void* context) {
+    observer = onTransaction;
+    observerContext = context;
+}
+
+// ###############################################
+// i2c_handler.h implementation
+// ###############################################
+
+uint32_t i2c_handler_initialise(uint32_t baudrate) {
+    return baudrate;
+}
+
+void i2c_handler_disable(void) {
+}
+
+int32_t i2c_handler_selectHwInstance(uint8_t device_num) {
+    return device_num <= 1 ? 0 : -1;
+}
+
+uint32_t i2c_handler_set_baudrate(uint32_t baudrate) {
+    return baudrate;
+}
+
+int32_t i2c_handler_write(uint8_t addr, uint8_t* buffer, uint32_t amount) {
+    i2c_handler_lock();
+    simDevice_t* device = findDevice(addr);
+    int32_t result = SIM_I2C_BUS_NACK;
+    if (device != 0 && device->onWrite != 0) {
+        currentAddress = addr;
+        result = device->onWrite(device->context, buffer, amount);
+        stats.writeTransactions++;
+        if (result > 0) {
+            stats.bytesWritten += result;
+        }
+    }
+    busTimeUs += (1 + (result > 0 ? result : 0)) * SIM_I2C_BUS_BYTE_TIME_US;
+    if (observer != 0) {
+        observer(observerContext, busTimeUs, addr, false, buffer, amount, result);
+    }
+    i2c_handler_unlock();
+    return result;
+}
+
+int32_t i2c_handler_read(uint8_t addr, uint8_t* buffer, uint32_t amount) {
+    i2c_handler_lock();
+    simDevice_t* device = findDevice(addr);
+    int32_t result = SIM_I2C_BUS_NACK;
+    if (device != 0 && device->onRead != 0) {
+        currentAddress = addr;
+        result = device->onRead(device->context, buffer, amount);
+        stats.readTransactions++;
+        if (result > 0) {
+            stats.bytesRead += result;
+        }
+    }
+    busTimeUs += (1 + (result > 0 ? result : 0)) * SIM_I2C_BUS_BYTE_TIME_US;
+    if (observer != 0) {
+        observer(observerContext, busTimeUs, addr, true, buffer, amount, result);
+    }
+    i2c_handler_unlock();
+    return result;
+}
+
+void i2c_handler_lock(void) {
+    pthread_once(&lockOnce, initLock);
+    if (pthread_mutex_trylock(&busLock) != 0) {
+        pthread_mutex_lock(&busLock);
+        lockStats.contended++;
+    }
+    if (lockDepth++ == 0) {
+        lockStats.acquisitions++;
+        lockedAtUs = busTimeUs;
+    }
+}
+
+void i2c_handler_unlock(void) {
+    if (--lockDepth == 0) {
+        uint32_t heldUs = busTimeUs - lockedAtUs;
+        lockStats.totalHoldUs += heldUs;
+        lockStats.maxHoldUs = heldUs > lockStats.maxHoldUs ? heldUs : lockStats.maxHoldUs;
+    }
+    pthread_mutex_unlock(&busLock);
+}
+
+i2c_handler_lockStats_t i2c_handler_getLockStats(void) {
+    i2c_handler_lock();
+    i2c_handler_lockStats_t result = lockStats;
+    i2c_handler_unlock();
+    return result;
+}
+
+void i2c_handler_clearLockStats(void) {
+    i2c_handler_lock();
+    memset(&lockStats, 0, sizeof(lockStats));
+    lockedAtUs = busTimeUs;
+    i2c_handler_unlock();
+}
+
+void i2c_handler_scanForDevices(void) {
+}
+
+static simDevice_t* findDevice(uint8_t addr) {
+    simDevice_t* anyAddress = 0;
+    for (uint8_t i = 0; i < amountDevices; ++i) {
+        if (devices[i].address == addr) {
+            return &devices[i];
+        }
+        if (devices[i].address == SIM_I2C_BUS_ANY_ADDRESS) {
+            anyAddress = &devices[i];
+        }
+    }
+    return anyAddress;
+}
+
+static void initLock(void) {
+    pthread_mutexattr_t attributes;
+    pthread_mutexattr_init(&attributes);
+    pthread_mutexattr_settype(&attributes, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&busLock, &attributes);
+    pthread_mutexattr_destroy(&attributes);
+}
@@ -0,0 +1,60 @@
+//
+// Host side stand-in for i2c_handler.c: routes every transaction to simulated devices and counts the traffic.
+// Tests include this instead of mock_i2c_handler.h when they want the real drivers talking to a device model.
+// The bus lock is a recursive pthread mutex, so threads can stand in for the two cores.
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_SIM_I2C_BUS_H
+#define SAPH_PICO_TEMPERATURE_SIM_I2C_BUS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "i2c_handler.h"
+
+#define SIM_I2C_BUS_MAX_DEVICES 4
+#define SIM_I2C_BUS_NO_ERROR 0
+#define SIM_I2C_BUS_FULL_ERROR -1
+// PICO_ERROR_GENERIC, what the pico sdk reports when nobody acknowledges the address
+#define SIM_I2C_BUS_NACK -1
+// A device attached here gets every transaction no other device acknowledges, e.g. a trace replay
+#define SIM_I2C_BUS_ANY_ADDRESS 0xFF
+// Per byte and per start/address byte at 100 kHz, the clock traces on the host are recorded with
+#define SIM_I2C_BUS_BYTE_TIME_US 90
+
+typedef int32_t (* sim_i2c_bus_writeHandler_t)(void* context, const uint8_t* buffer, uint32_t amount);
+
+typedef int32_t (* sim_i2c_bus_readHandler_t)(void* context, uint8_t* buffer, uint32_t amount);
+
+// Sees every transaction after it happened, with the bus time at its end, e.g. to record a trace
+typedef void (* sim_i2c_bus_observer_t)(void* context, uint32_t timeUs, uint8_t address, bool isRead,
+                                        const uint8_t* buffer, uint32_t amount, int32_t result);
+
+typedef struct sim_i2c_bus_stats_t {
+    uint32_t writeTransactions;
+    uint32_t readTransactions;
+    uint32_t bytesWritten;
+    uint32_t bytesRead;
+} sim_i2c_bus_stats_t;
+
+void sim_i2c_bus_reset(void);
+
+int32_t sim_i2c_bus_attach(uint8_t address, void* context, sim_i2c_bus_writeHandler_t onWrite,
+                           sim_i2c_bus_readHandler_t onRead);
+
+sim_i2c_bus_stats_t sim_i2c_bus_getStats(void);
+
+void sim_i2c_bus_clearStats(void);
+
+// Address of the transaction the handlers are called for
+uint8_t sim_i2c_bus_getCurrentAddress(void);
+
+// Bus time since the last reset, advanced by every transaction
+uint32_t sim_i2c_bus_getTimeUs(void);
+
+// Idle time on the bus, e.g. a delay of sim_hal.c
+void sim_i2c_bus_advanceTime(uint32_t deltaUs);
+
+// 0 removes the observer, sim_i2c_bus_reset does too
+void sim_i2c_bus_setObserver(sim_i2c_bus_observer_t onTransaction, void* context);
+
+#endif //SAPH_PICO_TEMPERATURE_SIM_I2C_BUS_H
@@ -0,0 +1,173 @@
+//
+// GDDRAM level model of an SSD1306, see sim_ssd1306.h
+//
+
+#include "sim_ssd1306.h"
+#include "sim_i2c_bus.h"
+
+#include <string.h>
+
+#define CONTROL_COMMAND 0x00
+#define CONTROL_DATA 0x40
+
+static int32_t onWrite(void* context, const uint8_t* buffer, uint32_t amount);
+
+static int32_t onRead(void* context, uint8_t* buffer, uint32_t amount);
+
+static uint32_t executeCommand(sim_ssd1306_t* sim, const uint8_t* command, uint32_t available);
+
+static void writeData(sim_ssd1306_t* sim, uint8_t value);
+
+void sim_ssd1306_init(sim_ssd1306_t* sim) {
+    memset(sim, 0, sizeof(sim_ssd1306_t));
+    sim->endColumn = SAPH_SSD1306_RAM_WIDTH - 1;
+    sim->endPage = SAPH_SSD1306_RAM_PAGES - 1;
+    sim->verticalScrollRows = SAPH_SSD1306_RAM_PAGES * 8;
+    sim->multiplexRatio = SAPH_SSD1306_RAM_PAGES * 8 - 1;
+    sim->comPinsConfig = 0x12;
+}
+
+int32_t sim_ssd1306_attach(sim_ssd1306_t* sim, uint8_t address) {
+    return sim_i2c_bus_attach(address, sim, onWrite, onRead);
+}
+
+void sim_ssd1306_scrollStep(sim_ssd1306_t* sim) {
+    if (!sim->scrollActive) {
+        return;
+    }
+    for (uint8_t page = sim->scrollStartPage; page <= sim->scrollEndPage; ++page) {
+        uint8_t* row = sim->ram[page];
+        if (sim->scrollLeft) {
+            uint8_t first = row[0];
+            memmove(row, row + 1, SAPH_SSD1306_RAM_WIDTH - 1);
+            row[SAPH_SSD1306_RAM_WIDTH - 1] = first;
+        } else {
+            uint8_t last = row[SAPH_SSD1306_RAM_WIDTH - 1];
+            memmove(row + 1, row, SAPH_SSD1306_RAM_WIDTH - 1);
+            row[0] = last;
+        }
+    }
+}
+
+// ###############################################
+// Bus handlers
+// ###############################################
+
+static int32_t onWrite(void* context, const uint8_t* buffer, uint32_t amount) {
+    sim_ssd1306_t* sim = (sim_ssd1306_t*) context;
+    if (amount == 0) {
+        return 0;
+    }
+    if (buffer[0] == CONTROL_DATA && sim->scrollActive) {
+        sim->ramWritesWhileScrolling++;
+        return (int32_t) amount;
+    }
+    if (buffer[0] == CONTROL_DATA) {
+        for (uint32_t i = 1; i < amount; ++i) {
+            writeData(sim, buffer[i]);
+        }
+        sim->dataBytes += amount - 1;
+        return (int32_t) amount;
+    }
+    uint32_t position = 1;
+    while (position < amount) {
+        position += executeCommand(sim, buffer + position, amount - position);
+        sim->commands++;
+    }
+    return (int32_t) amount;
+}
+
+// Status byte, bit 6 is set while the display is off
+static int32_t onRead(void* context, uint8_t* buffer, uint32_t amount) {
+    sim_ssd1306_t* sim = (sim_ssd1306_t*) context;
+    for (uint32_t i = 0; i < amount; ++i) {
+        buffer[i] = sim->lit ? 0x00 : 0x40;
+    }
+    return (int32_t) amount;
+}
+
+// Returns how many bytes the command took including its parameters
+static uint32_t executeCommand(sim_ssd1306_t* sim, const uint8_t* command, uint32_t available) {
+    switch (command[0]) {
+        case 0xAE:
+        case 0xAF:
+            sim->lit = command[0] == 0xAF;
+            return 1;
+        case 0x2E:
+            sim->scrollActive = false;
+            return 1;
+        case 0x2F:
+            sim->scrollActive = true;
+            return 1;
+        case 0x20:
+            return 2;
+        case 0x81:
+            return 2;
+        case 0xA8:
+            if (available >= 2) {
+                sim->multiplexRatio = command[1];
+            }
+            return 2;
+        case 0xDA:
+            if (available >= 2) {
+                sim->comPinsConfig = command[1];
+            }
+            return 2;
+        case 0x21:
+            if (available >= 3) {
+                sim->startColumn = command[1];
+                sim->endColumn = command[2];
+                sim->column = command[1];
+            }
+            return 3;
+        case 0x22:
+            if (available >= 3) {
+                sim->startPage = command[1];
+                sim->endPage = command[2];
+                sim->page = command[1];
+            }
+            return 3;
+        case 0x26:
+        case 0x27:
+            if (available >= 7) {
+                sim->scrollLeft = command[0] == 0x27;
+                sim->scrollStartPage = command[2];
+                sim->scrollFrameInterval = command[3];
+                sim->scrollEndPage = command[4];
+                sim->scrollVerticalOffset = 0;
+            }
+            return 7;
+        case 0x29:
+        case 0x2A:
+            if (available >= 6) {
+                sim->scrollLeft = command[0] == 0x2A;
+                sim->scrollStartPage = command[2];
+                sim->scrollFrameInterval = command[3];
+                sim->scrollEndPage = command[4];
+                sim->scrollVerticalOffset = command[5];
+            }
+            return 6;
+        case 0xA3:
+            if (available >= 3) {
+                sim->verticalFixedRows = command[1];
+                sim->verticalScrollRows = command[2];
+            }
+            return 3;
+        case 0xA4:
+        case 0xA5:
+            return 1;
+        default:
+            sim->unknownCommands++;
+            return 1;
+    }
+}
+
+static void writeData(sim_ssd1306_t* sim, uint8_t value) {
+    sim->ram[sim->page][sim->column] = value;
+    if (sim->column < sim->endColumn) {
+        sim->column++;
+        return;
+    }
+    sim->column = sim->startColumn;
+    sim->page = sim->page < sim->endPage ? sim->page + 1 : sim->startPage;
+}
@@ -0,0 +1,49 @@
+//
+// GDDRAM level model of an SSD1306 for host tests, attached to the bus from sim_i2c_bus.h
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_SIM_SSD1306_H
+#define SAPH_PICO_TEMPERATURE_SIM_SSD1306_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "saph_ssd1306.h"
+
+// The whole GDDRAM whatever panel is built for, smaller panels show a window of it
+typedef struct sim_ssd1306_t {
+    uint8_t ram[SAPH_SSD1306_RAM_PAGES][SAPH_SSD1306_RAM_WIDTH];
+    bool lit;
+    uint8_t multiplexRatio;
+    uint8_t comPinsConfig;
+    // Horizontal addressing window and pointer, page addressing is not modelled
+    uint8_t startColumn;
+    uint8_t endColumn;
+    uint8_t startPage;
+    uint8_t endPage;
+    uint8_t column;
+    uint8_t page;
+    // Scroll setup as last received, steps only move RAM while active
+    bool scrollActive;
+    bool scrollLeft;
+    uint8_t scrollStartPage;
+    uint8_t scrollEndPage;
+    uint8_t scrollFrameInterval;
+    uint8_t scrollVerticalOffset;
+    uint8_t verticalFixedRows;
+    uint8_t verticalScrollRows;
+    uint32_t commands;
+    uint32_t dataBytes;
+    // GDDRAM writes sent while scrolling is active, forbidden by datasheet 10.2.2, their bytes are dropped
+    uint32_t ramWritesWhileScrolling;
+    // Commands the model does not know, they are acknowledged like the chip does
+    uint32_t unknownCommands;
+} sim_ssd1306_t;
+
+void sim_ssd1306_init(sim_ssd1306_t* sim);
+
+int32_t sim_ssd1306_attach(sim_ssd1306_t* sim, uint8_t address);
+
+// One step of the continuous horizontal scroll, what the chip does every frameInterval frames
+void sim_ssd1306_scrollStep(sim_ssd1306_t* sim);
+
+#endif //SAPH_PICO_TEMPERATURE_SIM_SSD1306_H
@@ -0,0 +1,102 @@
+//
+// Synthetic measurement traces for host tests of everything downstream of the driver
+//
+
+#ifndef SAPH_PICO_TEMPERATURE_TRACE_INDOOR_H
+#define SAPH_PICO_TEMPERATURE_TRACE_INDOOR_H
+
+#include "saphBme280.h"
+
+#define TRACE_INDOOR_INTERVAL_US 1000000u
+#define TRACE_INDOOR_STEADY_SAMPLES 180
+#define TRACE_INDOOR_SAMPLES (sizeof(traceIndoor) / sizeof(traceIndoor[0]))
+
+/* *
+ * Four minutes at 1 Hz of a room at about 21.5 degC, 1013 hPa and 45 %RH, x16 oversampling.
+ * Steady for the first three minutes, then a window opens: the temperature drops by almost 2 degC
+ * and the humidity climbs by about 6 %RH. Noise follows the datasheet figures for the sensor.
+ * */
+static const saphBmeMeasurements_t traceIndoor[] = {
+        {25932839, 2150, 46074}, {25932727, 2150, 46075}, {25932828, 2151, 46106},
+        {25932824, 2150, 46085}, {25932857, 2148, 46093}, {25932660, 2151, 46037},
+        {25932752, 2149, 46089}, {25932826, 2150, 46065}, {25932814, 2151, 46065},
+        {25932824, 2152, 46112}, {25932723, 2150, 46073}, {25932826, 2150, 46088},
+        {25932702, 2150, 46069}, {25932711, 2152, 46089}, {25932657, 2151, 46084},
+        {25932615, 2152, 46075}, {25932704, 2150, 46096}, {25932653, 2150, 46104},
+        {25932836, 2151, 46120}, {25932770, 2151, 46051}, {25932712, 2151, 46073},
+        {25932683, 2149, 46071}, {25932599, 2152, 46048}, {25932864, 2151, 46099},
+        {25932557, 2148, 46094}, {25932663, 2150, 46109}, {25932759, 2152, 46091},
+        {25932867, 2151, 46101}, {25932785, 2151, 46046}, {25932814, 2152, 46099},
+        {25932690, 2149, 46107}, {25932722, 2149, 46112}, {25932858, 2149, 46100},
+        {25932757, 2151, 46103}, {25932818, 2151, 46070}, {25932808, 2151, 46088},
+        {25932799, 2150, 46124}, {25932618, 2151, 46084}, {25932699, 2151, 46123},
+        {25932817, 2150, 46056}, {25932767, 2150, 46116}, {25932743, 2152, 46092},
+        {25932758, 2151, 46084}, {25932756, 2152, 46089}, {25932753, 2152, 46139},
+        {25932675, 2152, 46080}, {25932777, 2151, 46081}, {25932845, 2152, 46025},
+        {25932720, 2150, 46100}, {25932667, 2152, 46106}, {25932658, 2152, 46151},
+        {25932653, 2152, 46088}, {25932689, 2151, 46022}, {25932769, 2151, 46061},
+        {25932763, 2152, 46112}, {25932557, 2153, 46082}, {25932733, 2151, 46118},
+        {25932767, 2148, 46055}, {25932567, 2153, 46096}, {25932668, 2153, 46097},
+        {25932688, 2153, 46090}, {25932756, 2154, 46085}, {25932585, 2155, 46115},
+        {25932681, 2152, 46110}, {25932718, 2152, 46055}, {25932714, 2150, 46069},
+        {25932552, 2151, 46125}, {25932776, 2153, 46070}, {25932573, 2152, 46113},
+        {25932590, 2154, 46133}, {25932643, 2153, 46045}, {25932647, 2154, 46079},
+        {25932684, 2153, 46132}, {25932738, 2151, 46132}, {25932635, 2154, 46076},
+        {25932655, 2153, 46098}, {25932624, 2154, 46038}, {25932500, 2152, 46116},
+        {25932593, 2153, 46095}, {25932644, 2153, 46129}, {25932716, 2152, 46133},
+        {25932583, 2154, 46118}, {25932549, 2150, 46047}, {25932535, 2154, 46096},
+        {25932626, 2152, 46082}, {25932763, 2153, 46098}, {25932701, 2153, 46092},
+        {25932579, 2151, 46124}, {25932574, 2151, 46123}, {25932618, 2154, 46118},
+        {25932525, 2153, 46059}, {25932684, 2152, 46084}, {25932552, 2152, 46060},
+        {25932519, 2153, 46108}, {25932633, 2150, 46083}, {25932661, 2151, 46092},
+        {25932536, 2150, 46106}, {25932661, 2152, 46118}, {25932624, 2154, 46133},
+        {25932632, 2154, 46048}, {25932696, 2154, 46093}, {25932742, 2152, 46056},
+        {25932777, 2154, 46077}, {25932734, 2154, 46098}, {25932656, 2154, 46078},
+        {25932607, 2153, 46122}, {25932568, 2153, 46076}, {25932649, 2153, 46104},
+        {25932514, 2152, 46168}, {25932626, 2155, 46037}, {25932612, 2154, 46144},
+        {25932567, 2154, 46115}, {25932650, 2151, 46111}, {25932670, 2153, 46148},
+        {25932515, 2152, 46110}, {25932534, 2154, 46079}, {25932642, 2156, 46073},
+        {25932691, 2152, 46128}, {25932621, 2156, 46082}, {25932390, 2154, 46085},
+        {25932594, 2154, 46086}, {25932587, 2153, 46114}, {25932566, 2154, 46096},
+        {25932552, 2155, 46084}, {25932546, 2153, 46102}, {25932544, 2154, 46109},
+        {25932445, 2154, 46116}, {25932573, 2155, 46101}, {25932464, 2154, 46058},
+        {25932464, 2154, 46124}, {25932332, 2153, 46080}, {25932502, 2156, 46072},
+        {25932570, 2153, 46119}, {25932642, 2154, 46124}, {25932571, 2154, 46148},
+        {25932602, 2155, 46080}, {25932578, 2154, 46100}, {25932565, 2155, 46130},
+        {25932713, 2154, 46139}, {25932522, 2154, 46173}, {25932580, 2154, 46133},
+        {25932422, 2154, 46113}, {25932596, 2155, 46128}, {25932573, 2154, 46122},
+        {25932509, 2155, 46103}, {25932422, 2155, 46093}, {25932389, 2154, 46098},
+        {25932446, 2152, 46124}, {25932493, 2155, 46104}, {25932635, 2153, 46123},
+        {25932425, 2156, 46105}, {25932551, 2152, 46134}, {25932485, 2152, 46126},
+        {25932346, 2152, 46084}, {25932377, 2154, 46112}, {25932531, 2155, 46129},
+        {25932570, 2156, 46078}, {25932397, 2154, 46084}, {25932477, 2155, 46124},
+        {25932379, 2153, 46111}, {25932448, 2155, 46110}, {25932524, 2154, 46121},
+        {25932417, 2155, 46108}, {25932391, 2152, 46114}, {25932479, 2153, 46116},
+        {25932443, 2153, 46105}, {25932507, 2156, 46112}, {25932447, 2154, 46112},
+        {25932479, 2156, 46096}, {25932425, 2153, 46095}, {25932443, 2154, 46102},
+        {25932490, 2155, 46104}, {25932423, 2158, 46142}, {25932531, 2155, 46055},
+        {25932463, 2154, 46130}, {25932466, 2158, 46147}, {25932512, 2156, 46128},
+        {25932477, 2155, 46088}, {25932357, 2157, 46122}, {25932416, 2158, 46116},
+        {25932473, 2157, 46096}, {25932753, 2147, 46397}, {25932363, 2140, 46708},
+        {25932297, 2132, 46989}, {25932477, 2122, 47264}, {25932531, 2115, 47475},
+        {25932857, 2111, 47697}, {25932471, 2102, 47916}, {25932366, 2094, 48177},
+        {25932218, 2089, 48374}, {25932220, 2085, 48532}, {25932346, 2080, 48716},
+        {25932413, 2075, 48868}, {25932507, 2069, 49074}, {25932295, 2065, 49188},
+        {25932763, 2061, 49375}, {25932113, 2056, 49572}, {25932472, 2052, 49641},
+        {25932541, 2049, 49767}, {25932166, 2043, 49888}, {25932536, 2041, 49987},
+        {25932396, 2040, 50127}, {25932303, 2034, 50231}, {25932540, 2033, 50297},
+        {25932317, 2033, 50418}, {25932298, 2030, 50527}, {25932599, 2025, 50546},
+        {25932222, 2024, 50691}, {25932370, 2021, 50713}, {25932119, 2020, 50799},
+        {25932462, 2015, 50937}, {25932436, 2015, 50949}, {25932228, 2013, 51001},
+        {25932352, 2011, 51054}, {25932384, 2009, 51141}, {25932384, 2007, 51234},
+        {25932415, 2007, 51253}, {25932356, 2007, 51299}, {25932412, 2002, 51332},
+        {25932240, 2001, 51395}, {25932325, 2000, 51430}, {25932224, 2000, 51460},
+        {25932232, 2000, 51524}, {25932835, 1998, 51536}, {25932500, 1996, 51592},
+        {25932300, 1994, 51637}, {25932578, 1996, 51658}, {25932173, 1995, 51725},
+        {25932011, 1993, 51733}, {25932457, 1994, 51739}, {25932363, 1991, 51750},
+        {25932472, 1991, 51786}, {25932291, 1991, 51831}, {25932288, 1988, 51848},
+        {25932595, 1990, 51819}, {25932364, 1989, 51883}, {25932347, 1986, 51898},
+        {25932264, 1988, 51933}, {25932252, 1987, 51923}, {25932526, 1988, 51947},
+};
+
+#endif //SAPH_PICO_TEMPERATURE_TRACE_INDOOR_H
@@ -0,0 +1,316 @@
+#include "unity.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "i2c_arbiter.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_ssd1306.h"
+#include "sim_bme280.h"
+
+/* *
+ * Runs the arbiter against the simulated SSD1306 and BME280 on one bus. The load simulation estimates bus time
+ * from the traffic of each step: 9 clocks per byte including the acknowledge and one address byte per transfer,
+ * 90 us per byte at 100 kHz.
+ * */
+
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define SIM_SENSOR_ADDRESS 0x76
+#define BUS_US_PER_BYTE 90u
+#define CHUNK_SIZE 32
+// Control byte for GDDRAM data and a whole 128x64 frame
+#define FRAME_BYTES (1 + 1024)
+#define SENSOR_DATA_REGISTER 0xF7
+#define SENSOR_DATA_BYTES 8
+
+#define SIMULATION_US 10000000u
+// Not a multiple of the display period, so the reads land on every phase of a frame
+#define SENSOR_PERIOD_US 10007u
+// Five frames a second keep the bus about half busy
+#define DISPLAY_PERIOD_US 200000u
+#define MAX_LATENCIES (SIMULATION_US / SENSOR_PERIOD_US + 1)
+
+typedef struct latencyResult_t {
+    uint32_t p50Us;
+    uint32_t p99Us;
+    uint32_t maxUs;
+} latencyResult_t;
+
+static sim_ssd1306_t simDisplay;
+static sim_bme280_t simSensor;
+static i2c_arbiter_t arbiter;
+static uint8_t frame[FRAME_BYTES];
+static const uint8_t sensorRegister[1] = {SENSOR_DATA_REGISTER};
+static uint8_t sensorData[SENSOR_DATA_BYTES];
+static uint32_t latencies[MAX_LATENCIES];
+
+// A device that takes one byte less than it was sent
+static int32_t helper_writeShort(void* context, const uint8_t* buffer, uint32_t amount) {
+    (void) context;
+    (void) buffer;
+    return (int32_t) amount - 1;
+}
+
+static uint32_t helper_getBusUs(sim_i2c_bus_stats_t before, sim_i2c_bus_stats_t after) {
+    uint32_t transfers = (after.writeTransactions - before.writeTransactions) +
+                         (after.readTransactions - before.readTransactions);
+    uint32_t bytes = (after.bytesWritten - before.bytesWritten) + (after.bytesRead - before.bytesRead);
+    return (transfers + bytes) * BUS_US_PER_BYTE;
+}
+
+static int helper_compareUint32(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*) a;
+    uint32_t right = *(const uint32_t*) b;
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+/* *
+ * Sensor reads every SENSOR_PERIOD_US and, with display load, a whole frame every DISPLAY_PERIOD_US.
+ * The clock advances by the bus time of every step and jumps to the next submission while the bus is idle.
+ * */
+static latencyResult_t helper_simulate(bool withDisplay, uint8_t displayPriority) {
+    i2c_arbiter_request_t sensorRequest;
+    i2c_arbiter_request_t displayRequest;
+    memset(&sensorRequest, 0, sizeof(sensorRequest));
+    memset(&displayRequest, 0, sizeof(displayRequest));
+    uint32_t nowUs = 0;
+    uint32_t nextSensorUs = 0;
+    uint32_t nextDisplayUs = 0;
+    uint32_t sensorSubmittedUs = 0;
+    uint32_t amountLatencies = 0;
+    while (nowUs < SIMULATION_US) {
+        if (nowUs >= nextSensorUs && sensorRequest.state != I2C_ARBITER_STATE_QUEUED) {
+            i2c_arbiter_prepareWriteRead(&sensorRequest, SIM_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH,
+                                         sensorRegister, 1, sensorData, SENSOR_DATA_BYTES);
+            TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_NO_ERROR, i2c_arbiter_submit(&arbiter, &sensorRequest));
+            sensorSubmittedUs = nextSensorUs;
+            nextSensorUs += SENSOR_PERIOD_US;
+            // Latency counts from the oldest read that fell due, later ones it stands in for are skipped
+            while (nextSensorUs <= nowUs) {
+                nextSensorUs += SENSOR_PERIOD_US;
+            }
+        }
+        if (withDisplay && nowUs >= nextDisplayUs && displayRequest.state != I2C_ARBITER_STATE_QUEUED) {
+            i2c_arbiter_prepareWrite(&displayRequest, SIM_DISPLAY_ADDRESS, displayPriority, frame, FRAME_BYTES, 1);
+            TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_NO_ERROR, i2c_arbiter_submit(&arbiter, &displayRequest));
+            while (nextDisplayUs <= nowUs) {
+                nextDisplayUs += DISPLAY_PERIOD_US;
+            }
+        }
+        if (i2c_arbiter_isIdle(&arbiter)) {
+            uint32_t nextUs = nextSensorUs;
+            if (withDisplay && nextDisplayUs < nextUs) {
+                nextUs = nextDisplayUs;
+            }
+            nowUs = nextUs > nowUs ? nextUs : nowUs;
+            continue;
+        }
+        sim_i2c_bus_stats_t before = sim_i2c_bus_getStats();
+        TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_TRANSFERRED, i2c_arbiter_step(&arbiter));
+        nowUs += helper_getBusUs(before, sim_i2c_bus_getStats());
+        if (sensorRequest.state == I2C_ARBITER_STATE_DONE && amountLatencies < MAX_LATENCIES) {
+            latencies[amountLatencies++] = nowUs - sensorSubmittedUs;
+            sensorRequest.state = I2C_ARBITER_STATE_IDLE;
+        }
+    }
+    qsort(latencies, amountLatencies, sizeof(uint32_t), helper_compareUint32);
+    latencyResult_t result = {latencies[amountLatencies / 2], latencies[(amountLatencies * 99) / 100],
+                              latencies[amountLatencies - 1]};
+    return result;
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_attach(&simSensor, SIM_SENSOR_ADDRESS);
+    memset(frame, 0xA5, sizeof(frame));
+    frame[0] = 0x40;
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_NO_ERROR, i2c_arbiter_init(&arbiter, CHUNK_SIZE));
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # i2c_arbiter_init
+// #############################################
+
+void test_i2c_arbiter_init_rejects_chunks_above_maximum(void) {
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_INVALID_CONFIG_ERROR, i2c_arbiter_init(&arbiter, I2C_ARBITER_MAX_CHUNK + 1));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, i2c_arbiter_init(0, CHUNK_SIZE));
+}
+
+// #############################################
+// # i2c_arbiter_submit
+// #############################################
+
+void test_i2c_arbiter_submit_rejects_a_request_that_is_still_queued(void) {
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWrite(&request, SIM_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, frame, 2, 1);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_NO_ERROR, i2c_arbiter_submit(&arbiter, &request));
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_BUSY_ERROR, i2c_arbiter_submit(&arbiter, &request));
+}
+
+void test_i2c_arbiter_submit_rejects_inconsistent_requests(void) {
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWrite(&request, SIM_DISPLAY_ADDRESS, 2, frame, 2, 1);
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_INVALID_CONFIG_ERROR, i2c_arbiter_submit(&arbiter, &request));
+    i2c_arbiter_prepareWrite(&request, SIM_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, frame, 2, 3);
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_INVALID_CONFIG_ERROR, i2c_arbiter_submit(&arbiter, &request));
+    i2c_arbiter_prepareWriteRead(&request, SIM_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH, sensorRegister, 1, 0, 8);
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_INVALID_CONFIG_ERROR, i2c_arbiter_submit(&arbiter, &request));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, i2c_arbiter_submit(&arbiter, 0));
+}
+
+// #############################################
+// # i2c_arbiter_step
+// #############################################
+
+void test_i2c_arbiter_step_without_requests_is_idle(void) {
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_IDLE, i2c_arbiter_step(&arbiter));
+    TEST_ASSERT_TRUE(i2c_arbiter_isIdle(&arbiter));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, i2c_arbiter_step(0));
+}
+
+void test_i2c_arbiter_step_reads_register_burst_in_one_step(void) {
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWriteRead(&request, SIM_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH, sensorRegister, 1,
+                                 sensorData, SENSOR_DATA_BYTES);
+    i2c_arbiter_submit(&arbiter, &request);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_TRANSFERRED, i2c_arbiter_step(&arbiter));
+
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_DONE, request.state);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&(simSensor.registers[SENSOR_DATA_REGISTER]), sensorData, SENSOR_DATA_BYTES);
+}
+
+void test_i2c_arbiter_step_splits_low_priority_write_and_repeats_prefix(void) {
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWrite(&request, SIM_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, frame, FRAME_BYTES, 1);
+    i2c_arbiter_submit(&arbiter, &request);
+
+    uint32_t steps = 0;
+    while (i2c_arbiter_step(&arbiter) == I2C_ARBITER_TRANSFERRED) {
+        steps++;
+    }
+
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32((FRAME_BYTES - 1) / CHUNK_SIZE, steps);
+    TEST_ASSERT_EQUAL_UINT32(FRAME_BYTES - 1 + steps, stats.bytesWritten);
+    // Every chunk arrived as GDDRAM data
+    TEST_ASSERT_EQUAL_UINT32(FRAME_BYTES - 1, simDisplay.dataBytes);
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_DONE, request.state);
+}
+
+void test_i2c_arbiter_step_lets_high_priority_in_between_chunks(void) {
+    i2c_arbiter_request_t displayRequest;
+    i2c_arbiter_request_t sensorRequest;
+    i2c_arbiter_prepareWrite(&displayRequest, SIM_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, frame, FRAME_BYTES, 1);
+    i2c_arbiter_prepareWriteRead(&sensorRequest, SIM_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH, sensorRegister, 1,
+                                 sensorData, SENSOR_DATA_BYTES);
+    i2c_arbiter_submit(&arbiter, &displayRequest);
+    i2c_arbiter_step(&arbiter);
+
+    i2c_arbiter_submit(&arbiter, &sensorRequest);
+    i2c_arbiter_step(&arbiter);
+
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_DONE, sensorRequest.state);
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_QUEUED, displayRequest.state);
+    TEST_ASSERT_EQUAL_UINT32(CHUNK_SIZE, simDisplay.dataBytes);
+}
+
+void test_i2c_arbiter_step_keeps_order_within_a_priority(void) {
+    i2c_arbiter_request_t first;
+    i2c_arbiter_request_t second;
+    uint8_t firstData[2] = {0x40, 0x11};
+    uint8_t secondData[2] = {0x40, 0x22};
+    i2c_arbiter_prepareWrite(&first, SIM_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, firstData, 2, 1);
+    i2c_arbiter_prepareWrite(&second, SIM_DISPLAY_ADDRESS, I2C_ARBITER_PRIORITY_LOW, secondData, 2, 1);
+    i2c_arbiter_submit(&arbiter, &first);
+    i2c_arbiter_submit(&arbiter, &second);
+
+    i2c_arbiter_step(&arbiter);
+    i2c_arbiter_step(&arbiter);
+
+    TEST_ASSERT_EQUAL_UINT8(0x11, simDisplay.ram[0][0]);
+    TEST_ASSERT_EQUAL_UINT8(0x22, simDisplay.ram[0][1]);
+}
+
+void test_i2c_arbiter_step_fails_request_of_absent_device(void) {
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWriteRead(&request, 0x77, I2C_ARBITER_PRIORITY_HIGH, sensorRegister, 1, sensorData, 1);
+    i2c_arbiter_submit(&arbiter, &request);
+
+    TEST_ASSERT_EQUAL_INT32(SIM_I2C_BUS_NACK, i2c_arbiter_step(&arbiter));
+
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_FAILED, request.state);
+    TEST_ASSERT_EQUAL_INT32(SIM_I2C_BUS_NACK, request.result);
+    TEST_ASSERT_TRUE(i2c_arbiter_isIdle(&arbiter));
+}
+
+void test_i2c_arbiter_step_fails_read_that_came_back_short(void) {
+    i2c_arbiter_request_t request;
+    i2c_arbiter_prepareWriteRead(&request, SIM_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH, sensorRegister, 1,
+                                 sensorData, SENSOR_DATA_BYTES);
+    i2c_arbiter_submit(&arbiter, &request);
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions + 1, SIM_BME280_FAULT_SHORT_READ);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_COMM_ERROR_READ_AMOUNT, i2c_arbiter_step(&arbiter));
+
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_FAILED, request.state);
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_COMM_ERROR_READ_AMOUNT, request.result);
+}
+
+void test_i2c_arbiter_step_fails_short_writes_whole_or_chunked(void) {
+    uint8_t shortAddress = 0x3D;
+    sim_i2c_bus_attach(shortAddress, 0, helper_writeShort, 0);
+    i2c_arbiter_request_t whole;
+    i2c_arbiter_request_t chunked;
+    i2c_arbiter_prepareWrite(&whole, shortAddress, I2C_ARBITER_PRIORITY_HIGH, frame, 2, 1);
+    i2c_arbiter_prepareWrite(&chunked, shortAddress, I2C_ARBITER_PRIORITY_LOW, frame, FRAME_BYTES, 1);
+    i2c_arbiter_submit(&arbiter, &whole);
+    i2c_arbiter_submit(&arbiter, &chunked);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_COMM_ERROR_WRITE_AMOUNT, i2c_arbiter_step(&arbiter));
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_COMM_ERROR_WRITE_AMOUNT, i2c_arbiter_step(&arbiter));
+
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_FAILED, whole.state);
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_FAILED, chunked.state);
+    TEST_ASSERT_EQUAL_INT32(I2C_ARBITER_COMM_ERROR_WRITE_AMOUNT, chunked.result);
+    TEST_ASSERT_TRUE(i2c_arbiter_isIdle(&arbiter));
+}
+
+// #############################################
+// # Sensor read latency under display load
+// #############################################
+
+// Two register bytes plus eight data bytes and two addresses, about 1 ms
+void test_i2c_arbiter_latency_without_display_load_is_the_read_itself(void) {
+    latencyResult_t result = helper_simulate(false, I2C_ARBITER_PRIORITY_LOW);
+
+    TEST_ASSERT_EQUAL_UINT32(11 * BUS_US_PER_BYTE, result.p50Us);
+    TEST_ASSERT_EQUAL_UINT32(11 * BUS_US_PER_BYTE, result.p99Us);
+}
+
+// At most one chunk of 33 bytes plus its address ahead of the read
+void test_i2c_arbiter_latency_with_display_load_is_bounded_by_one_chunk(void) {
+    latencyResult_t result = helper_simulate(true, I2C_ARBITER_PRIORITY_LOW);
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32((11 + 2 + CHUNK_SIZE) * BUS_US_PER_BYTE, result.maxUs);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(result.maxUs, result.p99Us);
+}
+
+// Whole frames in plain order make a read wait for up to a full frame of about 92 ms
+void test_i2c_arbiter_latency_with_display_load_in_plain_order_and_whole_frames(void) {
+    i2c_arbiter_init(&arbiter, 0);
+
+    latencyResult_t result = helper_simulate(true, I2C_ARBITER_PRIORITY_HIGH);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(50000, result.p99Us);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32((11 + 1 + FRAME_BYTES) * BUS_US_PER_BYTE, result.maxUs);
+}
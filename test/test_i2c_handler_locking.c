@@ -0,0 +1,187 @@
+#include "unity.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+#include "sim_ssd1306.h"
+
+/* *
+ * Threads stand in for the two cores: two of them read the same BME280, one through its data registers and one
+ * through its chip id, while a third keeps filling the SSD1306 on the same bus. Without the bus lock around the
+ * register pointer write and its read, a pointer written by one thread gets read by the other.
+ * The threads start together and give up the CPU after every transaction, so they interleave as much as they can.
+ * */
+
+#define SIM_SENSOR_ADDRESS 0x76
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define REG_CHIP_ID 0xD0
+#define ITERATIONS 5000
+#define FRAMES 200
+#define FRAME_SIZE (SAPH_SSD1306_PAGES * SAPH_SSD1306_WIDTH)
+#define BUS_US_PER_BYTE 90u
+
+typedef struct readerResult_t {
+    saphBmeDevice_t device;
+    uint32_t failures;
+    uint32_t wrongValues;
+} readerResult_t;
+
+static sim_bme280_t simSensor;
+static sim_ssd1306_t simDisplay;
+static saph_ssd1306_device_t display;
+static saphBmeMeasurements_t expected;
+static readerResult_t measurementReader;
+static readerResult_t idReader;
+static uint32_t displayFailures;
+static uint32_t clearedAtUs;
+static uint8_t frame[FRAME_SIZE];
+static pthread_barrier_t startLine;
+
+static void helper_yieldAfterTransaction(void* context, uint32_t timeUs, uint8_t address, bool isRead,
+                                         const uint8_t* buffer, uint32_t amount, int32_t result) {
+    sched_yield();
+}
+
+static void* helper_readMeasurements(void* context) {
+    readerResult_t* reader = (readerResult_t*) context;
+    pthread_barrier_wait(&startLine);
+    for (uint32_t i = 0; i < ITERATIONS; ++i) {
+        saphBmeMeasurements_t result;
+        if (saphBme280_getMeasurements(&reader->device, &result) != NO_ERROR) {
+            reader->failures++;
+        } else if (result.temperature != expected.temperature || result.pressure != expected.pressure ||
+                   result.humidity != expected.humidity) {
+            reader->wrongValues++;
+        }
+    }
+    return 0;
+}
+
+static void* helper_readChipId(void* context) {
+    readerResult_t* reader = (readerResult_t*) context;
+    pthread_barrier_wait(&startLine);
+    for (uint32_t i = 0; i < ITERATIONS; ++i) {
+        uint8_t chipId = 0;
+        if (saphBme280_internal_readFromRegister(&reader->device, REG_CHIP_ID, &chipId, 1) != NO_ERROR) {
+            reader->failures++;
+        } else if (chipId != CHIP_ID_BME280) {
+            reader->wrongValues++;
+        }
+    }
+    return 0;
+}
+
+// Every frame differs from the one before, the last one has to be what the panel shows
+static void* helper_fillDisplay(void* context) {
+    (void) context;
+    pthread_barrier_wait(&startLine);
+    for (uint32_t i = 0; i < FRAMES; ++i) {
+        for (uint32_t j = 0; j < FRAME_SIZE; ++j) {
+            frame[j] = (uint8_t) (i + j * 7);
+        }
+        if (saph_ssd1306_setAddressWindow(&display, 0, SAPH_SSD1306_WIDTH - 1, 0, SAPH_SSD1306_PAGES - 1) != 0 ||
+            saph_ssd1306_writeData(&display, frame, sizeof(frame)) != 0) {
+            displayFailures++;
+        }
+    }
+    return 0;
+}
+
+static void helper_runThreads(void) {
+    pthread_t threads[3];
+    pthread_barrier_init(&startLine, 0, 3);
+    sim_i2c_bus_setObserver(helper_yieldAfterTransaction, 0);
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[0], 0, helper_readMeasurements, &measurementReader));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[1], 0, helper_readChipId, &idReader));
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&threads[2], 0, helper_fillDisplay, 0));
+    for (uint32_t i = 0; i < 3; ++i) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_join(threads[i], 0));
+    }
+    sim_i2c_bus_setObserver(0, 0);
+    pthread_barrier_destroy(&startLine);
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_attach(&simSensor, SIM_SENSOR_ADDRESS);
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+
+    memset(&measurementReader, 0, sizeof(readerResult_t));
+    memset(&idReader, 0, sizeof(readerResult_t));
+    displayFailures = 0;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_init(SIM_SENSOR_ADDRESS, &measurementReader.device));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_init(SIM_SENSOR_ADDRESS, &idReader.device));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_triggerForcedMeasurement(&measurementReader.device));
+    sim_bme280_advanceTime(&simSensor, saphBme280_getMeasurementTimeUs(&measurementReader.device));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&measurementReader.device, &expected));
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+
+    sim_i2c_bus_clearStats();
+    i2c_handler_clearLockStats();
+    clearedAtUs = sim_i2c_bus_getTimeUs();
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # Concurrent drivers
+// #############################################
+
+void test_i2c_handler_locking_readersNeverSeeTheOtherThreadsRegisterPointer(void) {
+    helper_runThreads();
+    TEST_ASSERT_EQUAL_UINT32(0, measurementReader.failures);
+    TEST_ASSERT_EQUAL_UINT32(0, measurementReader.wrongValues);
+    TEST_ASSERT_EQUAL_UINT32(0, idReader.failures);
+    TEST_ASSERT_EQUAL_UINT32(0, idReader.wrongValues);
+}
+
+void test_i2c_handler_locking_noTransactionIsLostOrTorn(void) {
+    helper_runThreads();
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(2 * ITERATIONS, stats.readTransactions);
+    TEST_ASSERT_EQUAL_UINT32(ITERATIONS * (MEASUREMENT_SIZE + 1), stats.bytesRead);
+    TEST_ASSERT_EQUAL_UINT32(0, displayFailures);
+    TEST_ASSERT_EQUAL_UINT32(0, simDisplay.unknownCommands);
+    for (uint8_t page = 0; page < SAPH_SSD1306_PAGES; ++page) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frame + page * SAPH_SSD1306_WIDTH, simDisplay.ram[page], SAPH_SSD1306_WIDTH);
+    }
+}
+
+void test_i2c_handler_locking_statsAccountForEveryHold(void) {
+    helper_runThreads();
+    i2c_handler_lockStats_t lockStats = i2c_handler_getLockStats();
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    // Every hold starts with a write, a register read holds on through its pointer write. One more for the getter
+    TEST_ASSERT_EQUAL_UINT32(stats.writeTransactions + 1, lockStats.acquisitions);
+    // All bus time passes under the lock
+    TEST_ASSERT_EQUAL_UINT64(sim_i2c_bus_getTimeUs() - clearedAtUs, lockStats.totalHoldUs);
+    // A measurement holds the bus for the pointer write and the whole burst read
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32((2 + 1 + MEASUREMENT_SIZE + 1) * BUS_US_PER_BYTE, lockStats.maxHoldUs);
+}
+
+void test_i2c_handler_locking_clearingStartsTheCountersOver(void) {
+    i2c_handler_lock();
+    i2c_handler_lock();
+    i2c_handler_unlock();
+    i2c_handler_unlock();
+    i2c_handler_lockStats_t lockStats = i2c_handler_getLockStats();
+    TEST_ASSERT_EQUAL_UINT32(2, lockStats.acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(0, lockStats.contended);
+
+    i2c_handler_clearLockStats();
+    lockStats = i2c_handler_getLockStats();
+    TEST_ASSERT_EQUAL_UINT32(1, lockStats.acquisitions);
+    TEST_ASSERT_EQUAL_UINT64(0, lockStats.totalHoldUs);
+}
@@ -0,0 +1,305 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "i2c_trace.h"
+
+#define NO_ERROR 0
+#define NULL_POINTER_ERROR -20
+#define INVALID_CONFIG_ERROR -43
+#define BUFFER_TOO_SMALL_ERROR -48
+#define PARSE_ERROR -49
+#define NACK -1
+
+#define SENSOR_ADDRESS 0x76
+#define DISPLAY_ADDRESS 0x3C
+#define MEASUREMENT_REGISTER 0xF7
+#define MEASUREMENT_SIZE 8
+
+static uint8_t traceBuffer[1024];
+static i2c_trace_t trace;
+static i2c_trace_cursor_t cursor;
+static i2c_trace_record_t record;
+
+static const uint8_t measurementRegister[1] = {MEASUREMENT_REGISTER};
+static const uint8_t measurement[MEASUREMENT_SIZE] = {0x51, 0x83, 0xA0, 0x7F, 0xB0, 0x00, 0x6D, 0x5F};
+
+// One register pointer write and the burst read of the measurement, what saphBme280_getMeasurements puts on the bus
+static void helper_recordMeasurementRead(uint32_t timeUs) {
+    i2c_trace_record(&trace, timeUs, SENSOR_ADDRESS, false, measurementRegister, 1, 1);
+    i2c_trace_record(&trace, timeUs + 180, SENSOR_ADDRESS, true, measurement, MEASUREMENT_SIZE, MEASUREMENT_SIZE);
+}
+
+static uint32_t helper_countRecords(void) {
+    uint32_t amount = 0;
+    i2c_trace_first(&trace, &cursor);
+    while (i2c_trace_next(&trace, &cursor, &record) == I2C_TRACE_RECORD) {
+        amount++;
+    }
+    return amount;
+}
+
+static char dumpedLines[4][I2C_TRACE_MAX_LINE];
+static uint32_t amountDumpedLines;
+
+static void helper_collectLine(void* context, const char* line) {
+    TEST_ASSERT_EQUAL_PTR(&trace, context);
+    TEST_ASSERT_LESS_THAN_UINT32(4, amountDumpedLines);
+    strcpy(dumpedLines[amountDumpedLines++], line);
+}
+
+void setUp(void) {
+    memset(traceBuffer, 0, sizeof(traceBuffer));
+    i2c_trace_init(&trace, traceBuffer, sizeof(traceBuffer));
+    amountDumpedLines = 0;
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # i2c_trace_init
+// #############################################
+
+void test_i2c_trace_init_returnsErrorIfTraceOrBufferIsNull(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, i2c_trace_init((i2c_trace_t*) 0, traceBuffer, sizeof(traceBuffer)));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, i2c_trace_init(&trace, (uint8_t*) 0, sizeof(traceBuffer)));
+}
+
+void test_i2c_trace_init_rejectsBufferSmallerThanTheLargestRecord(void) {
+    int32_t errorCode = i2c_trace_init(&trace, traceBuffer, I2C_TRACE_MAX_RECORD_SIZE - 1);
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, errorCode);
+}
+
+void test_i2c_trace_init_startsEmpty(void) {
+    TEST_ASSERT_EQUAL_UINT32(0, trace.amountRecords);
+    TEST_ASSERT_EQUAL_UINT32(0, helper_countRecords());
+}
+
+// #############################################
+// # i2c_trace_record and i2c_trace_next
+// #############################################
+
+void test_i2c_trace_record_returnsErrorIfDataIsNull(void) {
+    int32_t errorCode = i2c_trace_record(&trace, 0, SENSOR_ADDRESS, false, (uint8_t*) 0, 1, 1);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+void test_i2c_trace_record_readsBackWhatWasRecorded(void) {
+    helper_recordMeasurementRead(1200);
+    i2c_trace_first(&trace, &cursor);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_TRACE_RECORD, i2c_trace_next(&trace, &cursor, &record));
+    TEST_ASSERT_EQUAL_UINT32(1200, record.timeUs);
+    TEST_ASSERT_EQUAL_HEX8(SENSOR_ADDRESS, record.address);
+    TEST_ASSERT_FALSE(record.isRead);
+    TEST_ASSERT_EQUAL_INT32(1, record.result);
+    TEST_ASSERT_EQUAL_UINT16(1, record.length);
+    TEST_ASSERT_EQUAL_HEX8(MEASUREMENT_REGISTER, record.data[0]);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_TRACE_RECORD, i2c_trace_next(&trace, &cursor, &record));
+    TEST_ASSERT_EQUAL_UINT32(1380, record.timeUs);
+    TEST_ASSERT_TRUE(record.isRead);
+    TEST_ASSERT_EQUAL_INT32(MEASUREMENT_SIZE, record.result);
+    TEST_ASSERT_EQUAL_UINT16(MEASUREMENT_SIZE, record.length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(measurement, record.data, MEASUREMENT_SIZE);
+
+    TEST_ASSERT_EQUAL_INT32(I2C_TRACE_END, i2c_trace_next(&trace, &cursor, &record));
+}
+
+void test_i2c_trace_record_measurementReadTakesNineteenBytes(void) {
+    helper_recordMeasurementRead(1200);
+    // Header, delta, result, length and register for the write, the same four plus eight bytes for the read
+    TEST_ASSERT_EQUAL_UINT32(5 + 4 + MEASUREMENT_SIZE + 1, trace.used);
+}
+
+void test_i2c_trace_record_keepsNoDataOfAFailedRead(void) {
+    uint8_t garbage[4] = {0xDE, 0xAD, 0xBE, 0xEF};
+    i2c_trace_record(&trace, 10, SENSOR_ADDRESS, true, garbage, sizeof(garbage), NACK);
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    TEST_ASSERT_EQUAL_INT32(NACK, record.result);
+    TEST_ASSERT_EQUAL_UINT16(0, record.length);
+}
+
+void test_i2c_trace_record_clipsLongTransfersToTheirFirstBytes(void) {
+    uint8_t frame[I2C_TRACE_MAX_DATA + 100];
+    for (uint32_t i = 0; i < sizeof(frame); ++i) {
+        frame[i] = (uint8_t) i;
+    }
+    i2c_trace_record(&trace, 0, DISPLAY_ADDRESS, false, frame, sizeof(frame), (int32_t) sizeof(frame));
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    TEST_ASSERT_EQUAL_INT32(sizeof(frame), record.result);
+    TEST_ASSERT_EQUAL_UINT16(I2C_TRACE_MAX_DATA, record.length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(frame, record.data, I2C_TRACE_MAX_DATA);
+}
+
+void test_i2c_trace_record_evictsTheOldestRecordsWhenFull(void) {
+    for (uint32_t i = 0; i < 200; ++i) {
+        helper_recordMeasurementRead(i * 1000000u);
+    }
+    TEST_ASSERT_EQUAL_UINT32(400, trace.recorded);
+    TEST_ASSERT_EQUAL_UINT32(400, trace.amountRecords + trace.evicted);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(sizeof(traceBuffer), trace.used);
+    TEST_ASSERT_EQUAL_UINT32(trace.amountRecords, helper_countRecords());
+
+    // The newest record survives whole, times stay exact across evictions and the wrap of the buffer
+    i2c_trace_first(&trace, &cursor);
+    for (uint32_t i = 0; i < trace.amountRecords; ++i) {
+        i2c_trace_next(&trace, &cursor, &record);
+    }
+    TEST_ASSERT_EQUAL_UINT32(199 * 1000000u + 180, record.timeUs);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(measurement, record.data, MEASUREMENT_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(record.timeUs, trace.newestTimeUs);
+}
+
+void test_i2c_trace_record_oldestTimeFollowsEvictions(void) {
+    for (uint32_t i = 0; i < 200; ++i) {
+        helper_recordMeasurementRead(i * 1000u);
+    }
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    uint32_t firstKept = trace.evicted;
+    uint32_t expectedUs = (firstKept / 2) * 1000u + (firstKept % 2 == 0 ? 0 : 180);
+    TEST_ASSERT_EQUAL_UINT32(expectedUs, record.timeUs);
+}
+
+void test_i2c_trace_clear_dropsAllRecords(void) {
+    helper_recordMeasurementRead(0);
+    i2c_trace_clear(&trace);
+    TEST_ASSERT_EQUAL_UINT32(0, helper_countRecords());
+    helper_recordMeasurementRead(5000);
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    TEST_ASSERT_EQUAL_UINT32(5000, record.timeUs);
+}
+
+// #############################################
+// # i2c_trace_formatRecord and i2c_trace_parseLine
+// #############################################
+
+void test_i2c_trace_formatRecord_writesOneLinePerRecord(void) {
+    char line[I2C_TRACE_MAX_LINE];
+    helper_recordMeasurementRead(1200);
+    i2c_trace_first(&trace, &cursor);
+
+    i2c_trace_next(&trace, &cursor, &record);
+    TEST_ASSERT_EQUAL_INT32(14, i2c_trace_formatRecord(&record, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_STRING("1200 76 W 1 F7", line);
+
+    i2c_trace_next(&trace, &cursor, &record);
+    i2c_trace_formatRecord(&record, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("1380 76 R 8 5183A07FB0006D5F", line);
+}
+
+void test_i2c_trace_formatRecord_marksMissingDataAndErrors(void) {
+    char line[I2C_TRACE_MAX_LINE];
+    i2c_trace_record(&trace, 7, DISPLAY_ADDRESS, true, measurement, 1, NACK);
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    i2c_trace_formatRecord(&record, line, sizeof(line));
+    TEST_ASSERT_EQUAL_STRING("7 3C R -1 -", line);
+}
+
+void test_i2c_trace_formatRecord_returnsErrorIfLineIsTooShort(void) {
+    char line[16];
+    helper_recordMeasurementRead(1200);
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    i2c_trace_next(&trace, &cursor, &record);
+    TEST_ASSERT_EQUAL_INT32(BUFFER_TOO_SMALL_ERROR, i2c_trace_formatRecord(&record, line, sizeof(line)));
+}
+
+void test_i2c_trace_parseLine_readsBackAFormattedRecord(void) {
+    char line[I2C_TRACE_MAX_LINE];
+    i2c_trace_record_t parsed;
+    helper_recordMeasurementRead(4000000000u);
+    i2c_trace_first(&trace, &cursor);
+    i2c_trace_next(&trace, &cursor, &record);
+    i2c_trace_next(&trace, &cursor, &record);
+    i2c_trace_formatRecord(&record, line, sizeof(line));
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, i2c_trace_parseLine(line, &parsed));
+    TEST_ASSERT_EQUAL_UINT32(record.timeUs, parsed.timeUs);
+    TEST_ASSERT_EQUAL_HEX8(record.address, parsed.address);
+    TEST_ASSERT_EQUAL(record.isRead, parsed.isRead);
+    TEST_ASSERT_EQUAL_INT32(record.result, parsed.result);
+    TEST_ASSERT_EQUAL_UINT16(record.length, parsed.length);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(record.data, parsed.data, record.length);
+}
+
+void test_i2c_trace_parseLine_readsLowerCaseAndNoData(void) {
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, i2c_trace_parseLine("90 3c W -1 -", &record));
+    TEST_ASSERT_EQUAL_HEX8(DISPLAY_ADDRESS, record.address);
+    TEST_ASSERT_EQUAL_INT32(NACK, record.result);
+    TEST_ASSERT_EQUAL_UINT16(0, record.length);
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, i2c_trace_parseLine("90 3c W 2 00af", &record));
+    TEST_ASSERT_EQUAL_UINT16(2, record.length);
+    TEST_ASSERT_EQUAL_HEX8(0xAF, record.data[1]);
+}
+
+void test_i2c_trace_parseLine_rejectsMalformedLines(void) {
+    TEST_ASSERT_EQUAL_INT32(PARSE_ERROR, i2c_trace_parseLine("", &record));
+    TEST_ASSERT_EQUAL_INT32(PARSE_ERROR, i2c_trace_parseLine("90 3C X 1 F7", &record));
+    TEST_ASSERT_EQUAL_INT32(PARSE_ERROR, i2c_trace_parseLine("90 80 W 1 F7", &record));
+    TEST_ASSERT_EQUAL_INT32(PARSE_ERROR, i2c_trace_parseLine("90 3C W 1 F", &record));
+}
+
+// #############################################
+// # i2c_trace_dump
+// #############################################
+
+void test_i2c_trace_dump_emitsOldestRecordFirst(void) {
+    helper_recordMeasurementRead(1200);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, i2c_trace_dump(&trace, helper_collectLine, &trace));
+    TEST_ASSERT_EQUAL_UINT32(2, amountDumpedLines);
+    TEST_ASSERT_EQUAL_STRING("1200 76 W 1 F7", dumpedLines[0]);
+    TEST_ASSERT_EQUAL_STRING("1380 76 R 8 5183A07FB0006D5F", dumpedLines[1]);
+}
+
+void test_i2c_trace_dump_returnsErrorIfEmitterIsNull(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, i2c_trace_dump(&trace, (i2c_trace_emitLine_t) 0, 0));
+}
+
+// #############################################
+// # i2c_trace_replay
+// #############################################
+
+void test_i2c_trace_replay_returnsRecordedResultsAndData(void) {
+    i2c_trace_replay_t replay;
+    uint8_t buffer[MEASUREMENT_SIZE];
+    helper_recordMeasurementRead(0);
+    i2c_trace_replayInit(&replay, &trace);
+
+    TEST_ASSERT_EQUAL_INT32(1, i2c_trace_replayWrite(&replay, SENSOR_ADDRESS, measurementRegister, 1));
+    TEST_ASSERT_EQUAL_INT32(MEASUREMENT_SIZE, i2c_trace_replayRead(&replay, SENSOR_ADDRESS, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(measurement, buffer, MEASUREMENT_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(0, replay.mismatches);
+    TEST_ASSERT_TRUE(i2c_trace_replayIsDone(&replay));
+}
+
+void test_i2c_trace_replay_countsDifferentWrittenBytes(void) {
+    i2c_trace_replay_t replay;
+    uint8_t otherRegister[1] = {0xF4};
+    helper_recordMeasurementRead(0);
+    i2c_trace_replayInit(&replay, &trace);
+
+    TEST_ASSERT_EQUAL_INT32(1, i2c_trace_replayWrite(&replay, SENSOR_ADDRESS, otherRegister, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, replay.mismatches);
+    TEST_ASSERT_EQUAL_UINT32(0, replay.firstMismatch);
+}
+
+void test_i2c_trace_replay_nacksTransactionsOfAnotherKind(void) {
+    i2c_trace_replay_t replay;
+    uint8_t buffer[MEASUREMENT_SIZE];
+    helper_recordMeasurementRead(0);
+    i2c_trace_replayInit(&replay, &trace);
+
+    i2c_trace_replayWrite(&replay, SENSOR_ADDRESS, measurementRegister, 1);
+    TEST_ASSERT_EQUAL_INT32(NACK, i2c_trace_replayWrite(&replay, SENSOR_ADDRESS, measurementRegister, 1));
+    TEST_ASSERT_EQUAL_INT32(NACK, i2c_trace_replayRead(&replay, SENSOR_ADDRESS, buffer, sizeof(buffer)));
+    TEST_ASSERT_EQUAL_UINT32(2, replay.mismatches);
+    TEST_ASSERT_EQUAL_UINT32(1, replay.firstMismatch);
+    TEST_ASSERT_EQUAL_UINT32(3, replay.replayed);
+}
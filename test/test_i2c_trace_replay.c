@@ -0,0 +1,146 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "i2c_trace.h"
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+#include "sim_ssd1306.h"
+
+/* *
+ * Records the drivers talking to the simulated devices, takes the trace through its text form and plays it back
+ * with no device attached, the way a trace dumped on the board is replayed on the host.
+ * */
+
+#define NO_ERROR 0
+#define CHIP_ID_BME280 0x60
+#define SIM_SENSOR_ADDRESS 0x76
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define FRAME_SIZE (SAPH_SSD1306_PAGES * SAPH_SSD1306_WIDTH)
+
+typedef struct session_t {
+    int32_t errorCodes[8];
+    saphBmeMeasurements_t measurements;
+} session_t;
+
+static uint8_t recordingBuffer[8192];
+static uint8_t replayBuffer[8192];
+static i2c_trace_t recording;
+static i2c_trace_t replayTrace;
+static i2c_trace_replay_t replay;
+static sim_bme280_t simSensor;
+static sim_ssd1306_t simDisplay;
+static saphBmeDevice_t sensor;
+static saph_ssd1306_device_t display;
+static uint8_t frame[FRAME_SIZE];
+
+static void helper_recordTransaction(void* context, uint32_t timeUs, uint8_t address, bool isRead,
+                                     const uint8_t* buffer, uint32_t amount, int32_t result) {
+    i2c_trace_record((i2c_trace_t*) context, timeUs, address, isRead, buffer, amount, result);
+}
+
+static int32_t helper_replayWrite(void* context, const uint8_t* buffer, uint32_t amount) {
+    return i2c_trace_replayWrite((i2c_trace_replay_t*) context, sim_i2c_bus_getCurrentAddress(), buffer, amount);
+}
+
+static int32_t helper_replayRead(void* context, uint8_t* buffer, uint32_t amount) {
+    return i2c_trace_replayRead((i2c_trace_replay_t*) context, sim_i2c_bus_getCurrentAddress(), buffer, amount);
+}
+
+// Every dumped line goes straight back into the trace that is replayed
+static void helper_parseLine(void* context, const char* line) {
+    i2c_trace_record_t record;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, i2c_trace_parseLine(line, &record));
+    i2c_trace_record((i2c_trace_t*) context, record.timeUs, record.address, record.isRead, record.data,
+                     record.length, record.result);
+}
+
+static void helper_runSession(session_t* session, bool withTrigger) {
+    memset(session, 0, sizeof(session_t));
+    session->errorCodes[0] = saphBme280_init(SIM_SENSOR_ADDRESS, &sensor);
+    session->errorCodes[1] = withTrigger ? saphBme280_triggerForcedMeasurement(&sensor) : NO_ERROR;
+    session->errorCodes[2] = saphBme280_getMeasurements(&sensor, &session->measurements);
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+    session->errorCodes[3] = saph_ssd1306_configurePanel(&display);
+    session->errorCodes[4] = saph_ssd1306_displayOn(&display, false);
+    session->errorCodes[5] = saph_ssd1306_setAddressWindow(&display, 0, SAPH_SSD1306_WIDTH - 1, 0,
+                                                           SAPH_SSD1306_PAGES - 1);
+    session->errorCodes[6] = saph_ssd1306_writeData(&display, frame, sizeof(frame));
+    session->errorCodes[7] = saph_ssd1306_displaySleep(&display, true);
+}
+
+static void helper_recordSession(session_t* session) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_attach(&simSensor, SIM_SENSOR_ADDRESS);
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+    sim_i2c_bus_setObserver(helper_recordTransaction, &recording);
+    helper_runSession(session, true);
+    sim_i2c_bus_setObserver(0, 0);
+}
+
+static void helper_attachReplay(void) {
+    i2c_trace_dump(&recording, helper_parseLine, &replayTrace);
+    sim_i2c_bus_reset();
+    i2c_trace_replayInit(&replay, &replayTrace);
+    sim_i2c_bus_attach(SIM_I2C_BUS_ANY_ADDRESS, &replay, helper_replayWrite, helper_replayRead);
+}
+
+void setUp(void) {
+    i2c_trace_init(&recording, recordingBuffer, sizeof(recordingBuffer));
+    i2c_trace_init(&replayTrace, replayBuffer, sizeof(replayBuffer));
+    for (uint32_t i = 0; i < sizeof(frame); ++i) {
+        frame[i] = (uint8_t) (i * 7);
+    }
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # Record and replay
+// #############################################
+
+void test_i2c_trace_replay_recordsEveryTransactionOfTheSession(void) {
+    session_t recorded;
+    helper_recordSession(&recorded);
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, recording.evicted);
+    TEST_ASSERT_EQUAL_UINT32(stats.writeTransactions + stats.readTransactions, recording.amountRecords);
+    TEST_ASSERT_EQUAL_UINT32(sim_i2c_bus_getTimeUs(), recording.newestTimeUs);
+}
+
+void test_i2c_trace_replay_reproducesTheSessionWithoutDevices(void) {
+    session_t recorded;
+    session_t replayed;
+    helper_recordSession(&recorded);
+    helper_attachReplay();
+
+    helper_runSession(&replayed, true);
+    TEST_ASSERT_EQUAL_INT32_ARRAY(recorded.errorCodes, replayed.errorCodes, 8);
+    TEST_ASSERT_EQUAL_INT32(recorded.measurements.temperature, replayed.measurements.temperature);
+    TEST_ASSERT_EQUAL_UINT32(recorded.measurements.pressure, replayed.measurements.pressure);
+    TEST_ASSERT_EQUAL_UINT32(recorded.measurements.humidity, replayed.measurements.humidity);
+    TEST_ASSERT_EQUAL_UINT32(0, replay.mismatches);
+    TEST_ASSERT_TRUE(i2c_trace_replayIsDone(&replay));
+}
+
+void test_i2c_trace_replay_pointsAtTheFirstTransactionThatChanged(void) {
+    session_t recorded;
+    session_t replayed;
+    helper_recordSession(&recorded);
+    // The init and the measurement are the only reads, each after its register pointer write
+    uint32_t initTransactions = 2 * (sim_i2c_bus_getStats().readTransactions - 1);
+    helper_attachReplay();
+
+    helper_runSession(&replayed, false);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, replay.mismatches);
+    // The trigger was the transaction right after the init
+    TEST_ASSERT_EQUAL_UINT32(initTransactions, replay.firstMismatch);
+}
@@ -1,6 +1,8 @@
 #include "saphBme280.h"
 #include "unity.h"
 
+#include <string.h>
+
 #include "test_saphBme280_test_definitions.h"
 #include "mock_i2c_handler.h"
 #include "mock_saphBme280_internal.h"
@@ -20,10 +22,19 @@ static saphBmeDevice_t helper_createBmeDevice(void) {
 // # Test group _init
 // #############################################
 
+static uint8_t chipIdResponse;
+
+static void helper_expectChipIdRead(uint8_t chipId) {
+    chipIdResponse = chipId;
+    saphBme280_internal_readFromRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    saphBme280_internal_readFromRegister_ReturnThruPtr_readingBuffer(&chipIdResponse);
+}
+
 void test_saphBme280_init_initialisesAPassedDevicePointer(void) {
     // Might add some more config settings to it
     uint8_t deviceAddr = 0xFF;
     saphBmeDevice_t actualDevice;
+    helper_expectChipIdRead(CHIP_ID_BME280);
     saphBme280_internal_readTrimmingValues_ExpectAndReturn(&actualDevice, NO_ERROR);
 
     int32_t errorCode = saphBme280_init(deviceAddr, &actualDevice);
@@ -31,6 +42,59 @@ void test_saphBme280_init_initialisesAPassedDevicePointer(void) {
     TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
 }
 
+void test_saphBme280_init_startsWithoutCommittedStateOrVerification(void) {
+    saphBmeDevice_t actualDevice;
+    memset(&actualDevice, 0xA5, sizeof(actualDevice));
+    helper_expectChipIdRead(CHIP_ID_BME280);
+    saphBme280_internal_readTrimmingValues_ExpectAndReturn(&actualDevice, NO_ERROR);
+
+    int32_t errorCode = saphBme280_init(0x76, &actualDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_FALSE(actualDevice.verifyCommits);
+    TEST_ASSERT_EQUAL_UINT8(0, actualDevice.committedValid);
+    TEST_ASSERT_EQUAL_UINT8(0, actualDevice.committedCtrlHumidity);
+    TEST_ASSERT_EQUAL_UINT8(0, actualDevice.committedMeasureCtrl);
+    TEST_ASSERT_EQUAL_UINT8(0, actualDevice.committedConfig);
+}
+
+void test_saphBme280_init_storesChipIdOfBme280(void) {
+    saphBmeDevice_t actualDevice;
+    helper_expectChipIdRead(CHIP_ID_BME280);
+    saphBme280_internal_readTrimmingValues_ExpectAnyArgsAndReturn(NO_ERROR);
+
+    int32_t errorCode = saphBme280_init(0x76, &actualDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT8(CHIP_ID_BME280, actualDevice.chipId);
+    TEST_ASSERT_TRUE(saphBme280_hasHumidity(&actualDevice));
+}
+
+void test_saphBme280_init_detectsBmp280WithoutHumidity(void) {
+    saphBmeDevice_t actualDevice;
+    helper_expectChipIdRead(CHIP_ID_BMP280);
+    saphBme280_internal_readTrimmingValues_ExpectAnyArgsAndReturn(NO_ERROR);
+
+    int32_t errorCode = saphBme280_init(0x76, &actualDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT8(CHIP_ID_BMP280, actualDevice.chipId);
+    TEST_ASSERT_FALSE(saphBme280_hasHumidity(&actualDevice));
+}
+
+void test_saphBme280_init_returnsErrorOnUnknownChipId(void) {
+    saphBmeDevice_t actualDevice;
+    helper_expectChipIdRead(0x55);
+
+    int32_t errorCode = saphBme280_init(0x76, &actualDevice);
+    TEST_ASSERT_EQUAL_INT32(UNKNOWN_CHIP_ERROR, errorCode);
+}
+
+void test_saphBme280_init_returnsErrorOnFailedChipIdRead(void) {
+    saphBmeDevice_t actualDevice;
+    saphBme280_internal_readFromRegister_ExpectAnyArgsAndReturn(ERROR_PLATFORM_GENERIC);
+
+    int32_t errorCode = saphBme280_init(0x76, &actualDevice);
+    TEST_ASSERT_EQUAL_INT32(ERROR_PLATFORM_GENERIC, errorCode);
+}
+
 void test_saphBme280_init_returnsErrorIfDeviceIsNull(void) {
     uint8_t deviceAddr = 0xFF;
     int32_t expectedErrorCode = NULL_POINTER_ERROR;
@@ -54,6 +118,7 @@ void test_saphBme280_init_returnsErrorOnFailedWriteAmount(void) {
     saphBmeDevice_t testDevice;
     uint8_t deviceAddr = 0xFF;
     int32_t expectedError = WRITE_ERROR;
+    helper_expectChipIdRead(CHIP_ID_BME280);
     saphBme280_internal_readTrimmingValues_ExpectAnyArgsAndReturn(expectedError);
     int32_t errorCode = saphBme280_init(deviceAddr, &testDevice);
     TEST_ASSERT_EQUAL_INT32(expectedError, errorCode);
@@ -63,6 +128,7 @@ void test_saphBme280_init_returnsErrorOnFailedReadAmount(void) {
     saphBmeDevice_t fakeDevice;
     uint8_t deviceAddr = 0xFF;
     int32_t expectedError = READ_ERROR;
+    helper_expectChipIdRead(CHIP_ID_BME280);
     saphBme280_internal_readTrimmingValues_ExpectAnyArgsAndReturn(expectedError);
     int32_t errorCode = saphBme280_init(deviceAddr, &fakeDevice);
     TEST_ASSERT_EQUAL_INT32(expectedError, errorCode);
@@ -72,6 +138,7 @@ void test_saphBme280_init_returnsErrorOnGenericPlatformError(void) {
     saphBmeDevice_t fakeDevice;
     uint8_t deviceAddr = 0xFF;
     int32_t expectedError = ERROR_PLATFORM_GENERIC;
+    helper_expectChipIdRead(CHIP_ID_BME280);
     saphBme280_internal_readTrimmingValues_ExpectAnyArgsAndReturn(expectedError);
     int32_t errorCode = saphBme280_init(deviceAddr, &fakeDevice);
     TEST_ASSERT_EQUAL_INT32(expectedError, errorCode);
@@ -432,6 +499,373 @@ void test_saphBme280_commitCtrlHumidity_returnsI2cErrorCodeIfGenericHardwareErro
     TEST_ASSERT_EQUAL_INT32(expectedError, errorCode);
 }
 
+void test_saphBme280_commitCtrlHumidity_skipsWriteOnBmp280(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    saphBme280_prepareCtrlHumidityReg(&fakeDevice, TEST_OVERSAMPLING_x8);
+    int32_t errorCode = saphBme280_commitCtrlHumidity(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _prepareProfile
+// #############################################
+
+static void helper_assertPreparedRegisters(saphBmeDevice_t* device, uint8_t tempOversampling,
+                                           uint8_t pressureOversampling, uint8_t humidityOversampling,
+                                           uint8_t sensorMode, uint8_t standbyTime, uint8_t iirFilterCoefficient) {
+    TEST_ASSERT_EQUAL_UINT8(humidityOversampling, device->registerCtrlHumidity);
+    TEST_ASSERT_EQUAL_UINT8(tempOversampling << 5 | pressureOversampling << 2 | sensorMode,
+                            device->registerMeasureCtrl);
+    TEST_ASSERT_EQUAL_UINT8(standbyTime << 5 | iirFilterCoefficient << 2, device->registerConfig);
+}
+
+void test_saphBme280_prepareProfile_weatherMonitoring(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    int32_t errorCode = saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    helper_assertPreparedRegisters(&fakeDevice, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_x1,
+                                   SENSOR_MODE_SLEEP, STANDBY_TIME_MS_0_5, IIR_FILTER_COEFFICIENT_OFF);
+}
+
+void test_saphBme280_prepareProfile_humiditySensingSkipsPressure(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    int32_t errorCode = saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_HUMIDITY_SENSING);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    helper_assertPreparedRegisters(&fakeDevice, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_SKIP, TEST_OVERSAMPLING_x1,
+                                   SENSOR_MODE_SLEEP, STANDBY_TIME_MS_0_5, IIR_FILTER_COEFFICIENT_OFF);
+}
+
+void test_saphBme280_prepareProfile_indoorNavigation(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    int32_t errorCode = saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    helper_assertPreparedRegisters(&fakeDevice, TEST_OVERSAMPLING_x2, TEST_OVERSAMPLING_x16, TEST_OVERSAMPLING_x1,
+                                   SENSOR_MODE_NORMAL, STANDBY_TIME_MS_0_5, IIR_FILTER_COEFFICIENT_16);
+}
+
+void test_saphBme280_prepareProfile_gamingSkipsHumidity(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    int32_t errorCode = saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_GAMING);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    helper_assertPreparedRegisters(&fakeDevice, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_x4, TEST_OVERSAMPLING_SKIP,
+                                   SENSOR_MODE_NORMAL, STANDBY_TIME_MS_0_5, IIR_FILTER_COEFFICIENT_16);
+}
+
+void test_saphBme280_prepareProfile_returnsErrorOnUnknownProfile(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    int32_t errorCode = saphBme280_prepareProfile(&fakeDevice, 4);
+    TEST_ASSERT_EQUAL_INT32(UNKNOWN_PROFILE_ERROR, errorCode);
+}
+
+void test_saphBme280_prepareProfile_returnsErrorIfDeviceIsNull(void) {
+    int32_t errorCode = saphBme280_prepareProfile((saphBmeDevice_t*) 0, SAPHBME280_PROFILE_GAMING);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _commitAllRegs
+// #############################################
+
+void test_saphBme280_commitAllRegs_writesAllRegistersInOneTransaction(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    uint8_t measureCtrl = fakeDevice.registerMeasureCtrl;
+    // Sleep first, ctrl_hum before ctrl_meas, ctrl_meas with the new mode last
+    uint8_t expectedBuffer[] = {0xF4, measureCtrl & 0xFC,
+                                0xF2, fakeDevice.registerCtrlHumidity,
+                                0xF5, fakeDevice.registerConfig,
+                                0xF4, measureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 8, 8, NO_ERROR);
+    int32_t errorCode = saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitAllRegs_leavesOutCtrlHumidityOnBmp280(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    uint8_t expectedBuffer[] = {0xF4, fakeDevice.registerMeasureCtrl,
+                                0xF5, fakeDevice.registerConfig,
+                                0xF4, fakeDevice.registerMeasureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 6, 6, NO_ERROR);
+    int32_t errorCode = saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitAllRegs_returnsErrorOnWrongAmountWritten(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(WRITE_ERROR);
+    int32_t errorCode = saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(WRITE_ERROR, errorCode);
+}
+
+void test_saphBme280_commitAllRegs_remembersCommittedValues(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_UINT8(fakeDevice.registerCtrlHumidity, fakeDevice.committedCtrlHumidity);
+    TEST_ASSERT_EQUAL_UINT8(fakeDevice.registerMeasureCtrl, fakeDevice.committedMeasureCtrl);
+    TEST_ASSERT_EQUAL_UINT8(fakeDevice.registerConfig, fakeDevice.committedConfig);
+}
+
+// #############################################
+// # Test group _commitChangedRegs
+// #############################################
+
+static saphBmeDevice_t helper_createCommittedBmeDevice(uint8_t profile) {
+    saphBmeDevice_t bmeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&bmeDevice, profile);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    saphBme280_commitAllRegs(&bmeDevice);
+    return bmeDevice;
+}
+
+void test_saphBme280_commitChangedRegs_writesEverythingWhileSensorContentIsUnknown(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    uint8_t measureCtrl = fakeDevice.registerMeasureCtrl;
+    uint8_t expectedBuffer[] = {0xF4, measureCtrl & 0xFC,
+                                0xF2, fakeDevice.registerCtrlHumidity,
+                                0xF5, fakeDevice.registerConfig,
+                                0xF4, measureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 8, 8, NO_ERROR);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_skipsWriteIfNothingChanged(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_writesOnlyMeasureCtrlIfOnlyItChanged(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_prepareMeasureCtrlReg(&fakeDevice, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_x1, SENSOR_MODE_FORCED);
+    uint8_t expectedBuffer[] = {0xF4, fakeDevice.registerMeasureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 2, 2, NO_ERROR);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_writesUnchangedForcedModeForEveryCommit(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_prepareMeasureCtrlReg(&fakeDevice, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_x1, SENSOR_MODE_FORCED);
+    uint8_t expectedBuffer[] = {0xF4, fakeDevice.registerMeasureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 2, 2, NO_ERROR);
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 2, 2, NO_ERROR);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_commitChangedRegs(&fakeDevice));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_commitChangedRegs(&fakeDevice));
+}
+
+void test_saphBme280_commitChangedRegs_latchesChangedCtrlHumidityWithMeasureCtrl(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_prepareCtrlHumidityReg(&fakeDevice, TEST_OVERSAMPLING_x4);
+    uint8_t expectedBuffer[] = {0xF2, TEST_OVERSAMPLING_x4,
+                                0xF4, fakeDevice.registerMeasureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 4, 4, NO_ERROR);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_sleepsBeforeConfigChangeInNormalMode(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    saphBme280_prepareConfigReg(&fakeDevice, STANDBY_TIME_MS_62_5, IIR_FILTER_COEFFICIENT_16);
+    uint8_t measureCtrl = fakeDevice.registerMeasureCtrl;
+    uint8_t expectedBuffer[] = {0xF4, measureCtrl & 0xFC,
+                                0xF5, fakeDevice.registerConfig,
+                                0xF4, measureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 6, 6, NO_ERROR);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_writesOnlyConfigWhileAsleep(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_prepareConfigReg(&fakeDevice, STANDBY_TIME_MS_62_5, IIR_FILTER_COEFFICIENT_2);
+    uint8_t expectedBuffer[] = {0xF5, fakeDevice.registerConfig,
+                                0xF4, fakeDevice.registerMeasureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 4, 4, NO_ERROR);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_rewritesEverythingAfterFailedWrite(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(WRITE_ERROR);
+    int32_t errorCode = saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(WRITE_ERROR, errorCode);
+
+    uint8_t expectedBuffer[] = {0xF4, fakeDevice.registerMeasureCtrl,
+                                0xF2, fakeDevice.registerCtrlHumidity,
+                                0xF5, fakeDevice.registerConfig,
+                                0xF4, fakeDevice.registerMeasureCtrl};
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 8, 8, NO_ERROR);
+    errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_skipsWriteAfterResetForResetValues(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    saphBme280_resetDevice(&fakeDevice);
+    saphBme280_prepareCtrlHumidityReg(&fakeDevice, TEST_OVERSAMPLING_SKIP);
+    saphBme280_prepareConfigReg(&fakeDevice, STANDBY_TIME_MS_0_5, IIR_FILTER_COEFFICIENT_OFF);
+    saphBme280_prepareMeasureCtrlReg(&fakeDevice, TEST_OVERSAMPLING_SKIP, TEST_OVERSAMPLING_SKIP, SENSOR_MODE_SLEEP);
+    int32_t errorCode = saphBme280_commitChangedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_commitChangedRegs_returnsErrorIfDeviceIsNull(void) {
+    int32_t errorCode = saphBme280_commitChangedRegs((saphBmeDevice_t*) 0);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _triggerForcedMeasurement
+// #############################################
+
+void test_saphBme280_triggerForcedMeasurement_writesForcedModeEveryTime(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_WEATHER_MONITORING);
+    static uint8_t expectedBuffer[2];
+    expectedBuffer[0] = 0xF4;
+    expectedBuffer[1] = fakeDevice.registerMeasureCtrl | SENSOR_MODE_FORCED;
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 2, 2, NO_ERROR);
+    saphBme280_internal_writeToRegister_ExpectWithArrayAndReturn(&fakeDevice, 1, expectedBuffer, 2, 2, NO_ERROR);
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_triggerForcedMeasurement(&fakeDevice));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_triggerForcedMeasurement(&fakeDevice));
+}
+
+void test_saphBme280_triggerForcedMeasurement_returnsErrorOnFailedWrite(void) {
+    saphBmeDevice_t fakeDevice = helper_createCommittedBmeDevice(SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(WRITE_ERROR);
+
+    TEST_ASSERT_EQUAL_INT32(WRITE_ERROR, saphBme280_triggerForcedMeasurement(&fakeDevice));
+}
+
+void test_saphBme280_triggerForcedMeasurement_returnsErrorIfDeviceIsNull(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_triggerForcedMeasurement((saphBmeDevice_t*) 0));
+}
+
+// #############################################
+// # Test group _verifyCommittedRegs
+// #############################################
+
+// Readback of 0xF2 to 0xF5, CMock keeps the pointer so it has to outlive the call
+static uint8_t verifyReadback[4];
+
+static void helper_expectVerifyReadback(saphBmeDevice_t* device, uint8_t ctrlHumidity, uint8_t measureCtrl,
+                                        uint8_t config) {
+    verifyReadback[0] = ctrlHumidity;
+    verifyReadback[1] = 0;
+    verifyReadback[2] = measureCtrl;
+    verifyReadback[3] = config;
+    saphBme280_internal_readFromRegister_ExpectAndReturn(device, 0xF2, 0, 4, NO_ERROR);
+    saphBme280_internal_readFromRegister_IgnoreArg_readingBuffer();
+    saphBme280_internal_readFromRegister_ReturnArrayThruPtr_readingBuffer(verifyReadback, 4);
+}
+
+void test_saphBme280_verifyCommittedRegs_acceptsMatchingReadbackAfterCommit(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_setVerifyCommits(&fakeDevice, true);
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    helper_expectVerifyReadback(&fakeDevice, fakeDevice.registerCtrlHumidity, fakeDevice.registerMeasureCtrl,
+                                fakeDevice.registerConfig);
+    int32_t errorCode = saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_verifyCommittedRegs_reportsMismatchAndForgetsCommittedValues(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_setVerifyCommits(&fakeDevice, true);
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    helper_expectVerifyReadback(&fakeDevice, fakeDevice.registerCtrlHumidity, fakeDevice.registerMeasureCtrl, 0x00);
+    int32_t errorCode = saphBme280_commitAllRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(VERIFY_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT8(0, fakeDevice.committedValid);
+}
+
+void test_saphBme280_verifyCommittedRegs_ignoresModeBitsAfterForcedMeasurement(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_setVerifyCommits(&fakeDevice, true);
+    saphBme280_prepareMeasureCtrlReg(&fakeDevice, TEST_OVERSAMPLING_x1, TEST_OVERSAMPLING_x1, SENSOR_MODE_FORCED);
+    saphBme280_internal_writeToRegister_ExpectAnyArgsAndReturn(NO_ERROR);
+    uint8_t measureCtrlBackAsleep = fakeDevice.registerMeasureCtrl & 0xFC;
+    helper_expectVerifyReadback(&fakeDevice, 0, measureCtrlBackAsleep, 0);
+    int32_t errorCode = saphBme280_commitMeasureCtrlReg(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saphBme280_verifyCommittedRegs_returnsReadError(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_internal_readFromRegister_ExpectAnyArgsAndReturn(READ_ERROR);
+    int32_t errorCode = saphBme280_verifyCommittedRegs(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(READ_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _getMeasurementTimeUs
+// #############################################
+
+void test_saphBme280_getMeasurementTimeUs_addsUpDatasheetMaximum(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    TEST_ASSERT_EQUAL_UINT32(9300, saphBme280_getMeasurementTimeUs(&fakeDevice));
+    TEST_ASSERT_EQUAL_UINT32(8000, saphBme280_getTypicalMeasurementTimeUs(&fakeDevice));
+}
+
+void test_saphBme280_getMeasurementTimeUs_leavesOutSkippedMeasurements(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    // 1.25 + 2 * 2.3 + 16 * 2.3 + 0.575 + 1 * 2.3 + 0.575
+    TEST_ASSERT_EQUAL_UINT32(46100, saphBme280_getMeasurementTimeUs(&fakeDevice));
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    TEST_ASSERT_EQUAL_UINT32(43225, saphBme280_getMeasurementTimeUs(&fakeDevice));
+}
+
+// Weather monitoring at one sample per minute averages 0.16 uA, datasheet chapter 3.5.1
+void test_saphBme280_getMeasurementCharge_matchesDatasheetAverageCurrent(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    // 3 ms at 350 uA, 2.5 ms at 714 uA and 2.5 ms at 340 uA
+    TEST_ASSERT_EQUAL_UINT64(3685000000ull, saphBme280_getMeasurementCharge(&fakeDevice));
+    uint64_t averageCurrentNa = saphBme280_getMeasurementCharge(&fakeDevice) / 60000000ull + SAPHBME280_SLEEP_CURRENT_NA;
+    TEST_ASSERT_UINT32_WITHIN(5, 160, (uint32_t) averageCurrentNa);
+}
+
+void test_saphBme280_getMeasurementCharge_leavesOutHumidityOnBmp280(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareProfile(&fakeDevice, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    TEST_ASSERT_EQUAL_UINT64(2835000000ull, saphBme280_getMeasurementCharge(&fakeDevice));
+}
+
+// #############################################
+// # Test group _getStandbyTimeUs
+// #############################################
+
+void test_saphBme280_getStandbyTimeUs_followsPreparedConfig(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    saphBme280_prepareConfigReg(&fakeDevice, STANDBY_TIME_MS_62_5, IIR_FILTER_COEFFICIENT_OFF);
+    TEST_ASSERT_EQUAL_UINT32(62500, saphBme280_getStandbyTimeUs(&fakeDevice));
+    saphBme280_prepareConfigReg(&fakeDevice, STANDBY_TIME_MS_20_0, IIR_FILTER_COEFFICIENT_OFF);
+    TEST_ASSERT_EQUAL_UINT32(20000, saphBme280_getStandbyTimeUs(&fakeDevice));
+}
+
+void test_saphBme280_getStandbyTimeUs_usesLongStandbyTimesOfBmp280(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    saphBme280_prepareConfigReg(&fakeDevice, STANDBY_TIME_MS_20_0, IIR_FILTER_COEFFICIENT_OFF);
+    TEST_ASSERT_EQUAL_UINT32(4000000, saphBme280_getStandbyTimeUs(&fakeDevice));
+}
+
 // #############################################
 // # Test group _getstatus
 // #############################################
@@ -0,0 +1,243 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "saphBme280_burst.h"
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+/* *
+ * Bursts read from the simulated sensor into a ring of raw bytes and decoded in bulk. Every decoded sample has to
+ * match what saphBme280_getMeasurements makes of the same registers.
+ * */
+
+#define SIM_ADDRESS 0x76
+#define NACK -1
+#define OUT_OF_RANGE_ERROR -45
+#define BUFFER_TOO_SMALL_ERROR -48
+// Seven bursts of a BME280 and a free slot
+#define RING_BUFFER_SIZE (8 * MEASUREMENT_SIZE)
+#define RING_CAPACITY 7
+
+static sim_bme280_t simSensor;
+static saphBmeDevice_t device;
+static saphBme280_burst_ring_t ring;
+static uint8_t ringBuffer[RING_BUFFER_SIZE];
+static int32_t temperatures[16];
+static uint32_t pressures[16];
+static uint32_t humidities[16];
+static saphBme280_burst_columns_t columns = {temperatures, pressures, humidities};
+
+static void helper_attachSensor(uint8_t chipId) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, chipId);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_attach(&simSensor, SIM_ADDRESS);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_init(SIM_ADDRESS, &device));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_initRing(&ring, &device, ringBuffer, sizeof(ringBuffer)));
+}
+
+// Sample i has raw values a little apart from the others, so an order mixup shows
+static void helper_setSample(uint32_t i) {
+    sim_bme280_setRawMeasurement(&simSensor, 283413 + (int32_t) i * 101, 523407 + (int32_t) i * 211,
+                                 27999 + (int32_t) i * 37);
+}
+
+static saphBmeMeasurements_t helper_expectedSample(uint32_t i) {
+    helper_setSample(i);
+    saphBmeMeasurements_t expected;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&device, &expected));
+    return expected;
+}
+
+static void helper_readSamples(uint32_t first, uint32_t amount) {
+    for (uint32_t i = first; i < first + amount; ++i) {
+        helper_setSample(i);
+        TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_read(&ring));
+    }
+}
+
+static void helper_assertDecoded(uint32_t firstSample, uint32_t amount) {
+    for (uint32_t i = 0; i < amount; ++i) {
+        saphBmeMeasurements_t expected = helper_expectedSample(firstSample + i);
+        TEST_ASSERT_EQUAL_INT32(expected.temperature, temperatures[i]);
+        TEST_ASSERT_EQUAL_UINT32(expected.pressure, pressures[i]);
+        TEST_ASSERT_EQUAL_UINT32(expected.humidity, humidities[i]);
+    }
+}
+
+void setUp(void) {
+    memset(ringBuffer, 0, sizeof(ringBuffer));
+    memset(temperatures, 0, sizeof(temperatures));
+    memset(pressures, 0, sizeof(pressures));
+    memset(humidities, 0, sizeof(humidities));
+    helper_attachSensor(CHIP_ID_BME280);
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # Ring setup
+// #############################################
+
+void test_saphBme280_burst_initRingRejectsNullPointers(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_initRing(0, &device, ringBuffer, sizeof(ringBuffer)));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_initRing(&ring, 0, ringBuffer, sizeof(ringBuffer)));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_initRing(&ring, &device, 0, sizeof(ringBuffer)));
+}
+
+void test_saphBme280_burst_initRingNeedsRoomForABurstAndTheFreeSlot(void) {
+    TEST_ASSERT_EQUAL_INT32(BUFFER_TOO_SMALL_ERROR,
+                            saphBme280_burst_initRing(&ring, &device, ringBuffer, 2 * MEASUREMENT_SIZE - 1));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_initRing(&ring, &device, ringBuffer, 2 * MEASUREMENT_SIZE));
+    TEST_ASSERT_EQUAL_UINT32(1, saphBme280_burst_getCapacity(&ring));
+}
+
+void test_saphBme280_burst_slotsFollowTheChip(void) {
+    TEST_ASSERT_EQUAL_UINT32(RING_CAPACITY, saphBme280_burst_getCapacity(&ring));
+    helper_attachSensor(CHIP_ID_BMP280);
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_SIZE_NO_HUMIDITY, ring.burstSize);
+    TEST_ASSERT_EQUAL_UINT32(RING_BUFFER_SIZE / MEASUREMENT_SIZE_NO_HUMIDITY - 1, saphBme280_burst_getCapacity(&ring));
+}
+
+// #############################################
+// # Reading
+// #############################################
+
+void test_saphBme280_burst_readStoresTheRegistersAsSent(void) {
+    sim_i2c_bus_clearStats();
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_read(&ring));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(&simSensor.registers[0xF7], ringBuffer, MEASUREMENT_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(1, ring.amount);
+
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.writeTransactions);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.readTransactions);
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_SIZE, stats.bytesRead);
+}
+
+void test_saphBme280_burst_failedReadStoresNothing(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions, SIM_BME280_FAULT_NACK);
+    TEST_ASSERT_EQUAL_INT32(NACK, saphBme280_burst_read(&ring));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.amount);
+}
+
+void test_saphBme280_burst_registersAtResetValueAreNoMeasurement(void) {
+    sim_bme280_powerOnReset(&simSensor);
+    TEST_ASSERT_EQUAL_INT32(NO_MEASUREMENT_ERROR, saphBme280_burst_read(&ring));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.amount);
+}
+
+void test_saphBme280_burst_temperatureAtTheResetValueAloneIsStored(void) {
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 0x80000, 27999);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_read(&ring));
+    saphBmeMeasurements_t expected;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&device, &expected));
+    TEST_ASSERT_EQUAL_INT32(1, saphBme280_burst_decode(&ring, &columns, 16));
+    TEST_ASSERT_EQUAL_INT32(expected.temperature, temperatures[0]);
+}
+
+void test_saphBme280_burst_fullRingGivesUpTheOldest(void) {
+    helper_readSamples(0, RING_CAPACITY + 2);
+    TEST_ASSERT_EQUAL_UINT32(RING_CAPACITY, ring.amount);
+    TEST_ASSERT_EQUAL_UINT32(2, ring.overwritten);
+
+    TEST_ASSERT_EQUAL_INT32(RING_CAPACITY, saphBme280_burst_decode(&ring, &columns, 16));
+    helper_assertDecoded(2, RING_CAPACITY);
+}
+
+void test_saphBme280_burst_failedReadIntoAFullRingKeepsEverySample(void) {
+    helper_readSamples(0, RING_CAPACITY);
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions + 1, SIM_BME280_FAULT_SHORT_READ);
+    TEST_ASSERT_EQUAL_INT32(READ_ERROR, saphBme280_burst_read(&ring));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.overwritten);
+
+    TEST_ASSERT_EQUAL_INT32(RING_CAPACITY, saphBme280_burst_decode(&ring, &columns, 16));
+    helper_assertDecoded(0, RING_CAPACITY);
+}
+
+// #############################################
+// # Decoding
+// #############################################
+
+void test_saphBme280_burst_decodeMatchesGetMeasurements(void) {
+    helper_readSamples(0, 5);
+    TEST_ASSERT_EQUAL_INT32(5, saphBme280_burst_decode(&ring, &columns, 16));
+    TEST_ASSERT_EQUAL_UINT32(0, ring.amount);
+    helper_assertDecoded(0, 5);
+}
+
+void test_saphBme280_burst_decodeTakesNoMoreThanAsked(void) {
+    helper_readSamples(0, 5);
+    TEST_ASSERT_EQUAL_INT32(3, saphBme280_burst_decode(&ring, &columns, 3));
+    TEST_ASSERT_EQUAL_UINT32(2, ring.amount);
+    TEST_ASSERT_EQUAL_INT32(2, saphBme280_burst_decode(&ring, &columns, 16));
+    helper_assertDecoded(3, 2);
+}
+
+void test_saphBme280_burst_decodeAcrossTheEndOfTheBuffer(void) {
+    helper_readSamples(0, 6);
+    saphBme280_burst_decode(&ring, &columns, 6);
+    helper_readSamples(6, 5);
+    TEST_ASSERT_EQUAL_INT32(5, saphBme280_burst_decode(&ring, &columns, 16));
+    helper_assertDecoded(6, 5);
+}
+
+void test_saphBme280_burst_nullColumnsAreSkipped(void) {
+    helper_readSamples(0, 2);
+    saphBme280_burst_columns_t temperatureOnly = {temperatures, 0, 0};
+    TEST_ASSERT_EQUAL_INT32(2, saphBme280_burst_decode(&ring, &temperatureOnly, 16));
+    TEST_ASSERT_EQUAL_INT32(helper_expectedSample(1).temperature, temperatures[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, pressures[1]);
+    TEST_ASSERT_EQUAL_UINT32(0, humidities[1]);
+}
+
+void test_saphBme280_burst_bmp280DecodesWithoutHumidity(void) {
+    helper_attachSensor(CHIP_ID_BMP280);
+    memset(humidities, 0xFF, sizeof(humidities));
+    helper_readSamples(0, 3);
+    TEST_ASSERT_EQUAL_INT32(3, saphBme280_burst_decode(&ring, &columns, 16));
+    helper_assertDecoded(0, 3);
+    TEST_ASSERT_EQUAL_UINT32(0, humidities[2]);
+}
+
+// #############################################
+// # On demand
+// #############################################
+
+void test_saphBme280_burst_peekCompensatesWithoutTakingTheSampleOut(void) {
+    helper_readSamples(0, 3);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_peek(&ring, 1, &result));
+    saphBmeMeasurements_t expected = helper_expectedSample(1);
+    TEST_ASSERT_EQUAL_INT32(expected.temperature, result.temperature);
+    TEST_ASSERT_EQUAL_UINT32(expected.pressure, result.pressure);
+    TEST_ASSERT_EQUAL_UINT32(expected.humidity, result.humidity);
+    TEST_ASSERT_EQUAL_UINT32(3, ring.amount);
+}
+
+void test_saphBme280_burst_peekCountsFromTheOldestAcrossTheEndOfTheBuffer(void) {
+    helper_readSamples(0, RING_CAPACITY + 3);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_peek(&ring, RING_CAPACITY - 1, &result));
+    TEST_ASSERT_EQUAL_INT32(helper_expectedSample(RING_CAPACITY + 2).temperature, result.temperature);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_peek(&ring, 0, &result));
+    TEST_ASSERT_EQUAL_INT32(helper_expectedSample(3).temperature, result.temperature);
+}
+
+void test_saphBme280_burst_peekBeyondTheStoredSamplesIsOutOfRange(void) {
+    helper_readSamples(0, 2);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(OUT_OF_RANGE_ERROR, saphBme280_burst_peek(&ring, 2, &result));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_peek(&ring, 0, 0));
+}
+
+void test_saphBme280_burst_decodeRejectsNullPointers(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_decode(0, &columns, 16));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_decode(&ring, 0, 16));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_burst_read(0));
+}
@@ -0,0 +1,247 @@
+#include <math.h>
+#include "unity.h"
+
+#include "saphBme280_derived.h"
+#include "test_saphBme280_test_definitions.h"
+
+#define OUT_OF_RANGE_ERROR -45
+
+#define STANDARD_PRESSURE (101325 * 256)
+#define HUMIDITY_PERCENT(percent) ((percent) * 1024)
+
+static saphBmeMeasurements_t measurements;
+
+// #############################################
+// # Double precision references
+// #############################################
+
+static double helper_magnusTerm(double temperature) {
+    return 17.62 * temperature / (243.12 + temperature);
+}
+
+static double helper_referenceDewPoint(const saphBmeMeasurements_t* values) {
+    double gamma = log(values->humidity / 1024.0 / 100.0) + helper_magnusTerm(values->temperature / 100.0);
+    return 243.12 * gamma / (17.62 - gamma) * 100;
+}
+
+static double helper_referenceAbsoluteHumidity(const saphBmeMeasurements_t* values) {
+    double temperature = values->temperature / 100.0;
+    return 6.112 * exp(helper_magnusTerm(temperature)) * values->humidity / 1024.0 * 2.1674 /
+           (273.15 + temperature) * 100;
+}
+
+static double helper_referenceAltitude(uint32_t pressure, uint32_t seaLevelPressure) {
+    return 44330 * (1 - pow((double) pressure / seaLevelPressure, 1 / 5.255)) * 100;
+}
+
+static double helper_referenceSeaLevelPressure(uint32_t pressure, int32_t altitude) {
+    return pressure / pow(1 - altitude / 4433000.0, 5.255);
+}
+
+void setUp(void) {
+    measurements.pressure = STANDARD_PRESSURE;
+    measurements.temperature = 2000;
+    measurements.humidity = HUMIDITY_PERCENT(50);
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saphBme280_derived_dewPoint
+// #############################################
+
+void test_saphBme280_derived_dewPoint_at_room_conditions(void) {
+    int32_t dewPoint = 0;
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_derived_dewPoint(&measurements, &dewPoint));
+
+    TEST_ASSERT_EQUAL_INT32(926, dewPoint);
+}
+
+void test_saphBme280_derived_dewPoint_equals_temperature_when_saturated(void) {
+    int32_t dewPoint = 0;
+    measurements.temperature = 2500;
+    measurements.humidity = HUMIDITY_PERCENT(100);
+
+    saphBme280_derived_dewPoint(&measurements, &dewPoint);
+
+    TEST_ASSERT_EQUAL_INT32(2500, dewPoint);
+}
+
+void test_saphBme280_derived_dewPoint_below_freezing(void) {
+    int32_t dewPoint = 0;
+    measurements.temperature = -1000;
+    measurements.humidity = HUMIDITY_PERCENT(80);
+
+    saphBme280_derived_dewPoint(&measurements, &dewPoint);
+
+    TEST_ASSERT_EQUAL_INT32(-1280, dewPoint);
+}
+
+void test_saphBme280_derived_dewPoint_without_humidity_returns_out_of_range(void) {
+    int32_t dewPoint = 0;
+    measurements.humidity = 0;
+
+    TEST_ASSERT_EQUAL_INT32(OUT_OF_RANGE_ERROR, saphBme280_derived_dewPoint(&measurements, &dewPoint));
+}
+
+void test_saphBme280_derived_dewPoint_matches_double_reference_over_sensor_range(void) {
+    double maxError = 0;
+    for (int32_t temperature = -4000; temperature <= 8500; temperature += 37) {
+        for (uint32_t humidity = HUMIDITY_PERCENT(1); humidity <= HUMIDITY_PERCENT(100); humidity += 997) {
+            measurements.temperature = temperature;
+            measurements.humidity = humidity;
+            int32_t dewPoint = 0;
+            saphBme280_derived_dewPoint(&measurements, &dewPoint);
+            double error = fabs(dewPoint - helper_referenceDewPoint(&measurements));
+            maxError = error > maxError ? error : maxError;
+        }
+    }
+    TEST_ASSERT_TRUE(maxError <= 1.0);
+}
+
+// #############################################
+// # saphBme280_derived_absoluteHumidity
+// #############################################
+
+void test_saphBme280_derived_absoluteHumidity_at_room_conditions(void) {
+    uint32_t absoluteHumidity = 0;
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_derived_absoluteHumidity(&measurements, &absoluteHumidity));
+
+    TEST_ASSERT_EQUAL_UINT32(862, absoluteHumidity);
+}
+
+void test_saphBme280_derived_absoluteHumidity_is_zero_without_humidity(void) {
+    uint32_t absoluteHumidity = 1;
+    measurements.humidity = 0;
+
+    saphBme280_derived_absoluteHumidity(&measurements, &absoluteHumidity);
+
+    TEST_ASSERT_EQUAL_UINT32(0, absoluteHumidity);
+}
+
+void test_saphBme280_derived_absoluteHumidity_matches_double_reference_over_sensor_range(void) {
+    double maxError = 0;
+    for (int32_t temperature = -4000; temperature <= 8500; temperature += 37) {
+        for (uint32_t humidity = 0; humidity <= HUMIDITY_PERCENT(100); humidity += 997) {
+            measurements.temperature = temperature;
+            measurements.humidity = humidity;
+            uint32_t absoluteHumidity = 0;
+            saphBme280_derived_absoluteHumidity(&measurements, &absoluteHumidity);
+            double error = fabs(absoluteHumidity - helper_referenceAbsoluteHumidity(&measurements));
+            maxError = error > maxError ? error : maxError;
+        }
+    }
+    TEST_ASSERT_TRUE(maxError <= 1.0);
+}
+
+// #############################################
+// # saphBme280_derived_altitude
+// #############################################
+
+void test_saphBme280_derived_altitude_is_zero_at_sea_level_pressure(void) {
+    int32_t altitude = 1;
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, &altitude));
+
+    TEST_ASSERT_EQUAL_INT32(0, altitude);
+}
+
+void test_saphBme280_derived_altitude_of_standard_atmosphere_at_1000m(void) {
+    int32_t altitude = 0;
+    measurements.pressure = 89874 * 256;
+
+    saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, &altitude);
+
+    TEST_ASSERT_INT32_WITHIN(100, 100000, altitude);
+}
+
+void test_saphBme280_derived_altitude_below_sea_level_is_negative(void) {
+    int32_t altitude = 0;
+    measurements.pressure = 106000 * 256;
+
+    saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, &altitude);
+
+    TEST_ASSERT_LESS_THAN_INT32(0, altitude);
+}
+
+void test_saphBme280_derived_altitude_with_zero_pressure_returns_out_of_range(void) {
+    int32_t altitude = 0;
+
+    TEST_ASSERT_EQUAL_INT32(OUT_OF_RANGE_ERROR, saphBme280_derived_altitude(&measurements, 0, &altitude));
+    measurements.pressure = 0;
+    TEST_ASSERT_EQUAL_INT32(OUT_OF_RANGE_ERROR,
+                            saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, &altitude));
+}
+
+void test_saphBme280_derived_altitude_matches_double_reference_over_sensor_range(void) {
+    double maxError = 0;
+    for (uint32_t pressure = 30000 * 256; pressure <= 110000 * 256; pressure += 8659) {
+        measurements.pressure = pressure;
+        int32_t altitude = 0;
+        saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, &altitude);
+        double error = fabs(altitude - helper_referenceAltitude(pressure, STANDARD_PRESSURE));
+        maxError = error > maxError ? error : maxError;
+    }
+    TEST_ASSERT_TRUE(maxError <= 1.0);
+}
+
+// #############################################
+// # saphBme280_derived_seaLevelPressure
+// #############################################
+
+void test_saphBme280_derived_seaLevelPressure_at_sea_level_is_unchanged(void) {
+    uint32_t seaLevelPressure = 0;
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_derived_seaLevelPressure(&measurements, 0, &seaLevelPressure));
+
+    TEST_ASSERT_EQUAL_UINT32(STANDARD_PRESSURE, seaLevelPressure);
+}
+
+void test_saphBme280_derived_seaLevelPressure_reverses_altitude(void) {
+    int32_t altitude = 0;
+    uint32_t seaLevelPressure = 0;
+    measurements.pressure = 95000 * 256;
+
+    saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, &altitude);
+    saphBme280_derived_seaLevelPressure(&measurements, altitude, &seaLevelPressure);
+
+    // One cm of altitude is about 0.12 Pa
+    TEST_ASSERT_UINT32_WITHIN(256 / 4, STANDARD_PRESSURE, seaLevelPressure);
+}
+
+void test_saphBme280_derived_seaLevelPressure_above_the_atmosphere_returns_out_of_range(void) {
+    uint32_t seaLevelPressure = 0;
+
+    TEST_ASSERT_EQUAL_INT32(OUT_OF_RANGE_ERROR,
+                            saphBme280_derived_seaLevelPressure(&measurements, 4433000, &seaLevelPressure));
+}
+
+void test_saphBme280_derived_seaLevelPressure_matches_double_reference_up_to_9km(void) {
+    double maxError = 0;
+    for (uint32_t pressure = 30000 * 256; pressure <= 110000 * 256; pressure += 86591) {
+        measurements.pressure = pressure;
+        for (int32_t altitude = -50000; altitude <= 900000; altitude += 9173) {
+            uint32_t seaLevelPressure = 0;
+            saphBme280_derived_seaLevelPressure(&measurements, altitude, &seaLevelPressure);
+            double error = fabs(seaLevelPressure - helper_referenceSeaLevelPressure(pressure, altitude));
+            maxError = error > maxError ? error : maxError;
+        }
+    }
+    TEST_ASSERT_TRUE(maxError <= 0.05 * 256);
+}
+
+void test_saphBme280_derived_null_pointers_return_error(void) {
+    int32_t signedResult = 0;
+    uint32_t unsignedResult = 0;
+
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_dewPoint(0, &signedResult));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_dewPoint(&measurements, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_absoluteHumidity(0, &unsignedResult));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_absoluteHumidity(&measurements, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_altitude(0, STANDARD_PRESSURE, &signedResult));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_altitude(&measurements, STANDARD_PRESSURE, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_seaLevelPressure(0, 0, &unsignedResult));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_derived_seaLevelPressure(&measurements, 0, 0));
+}
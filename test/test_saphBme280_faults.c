@@ -0,0 +1,188 @@
+#include "unity.h"
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+/* *
+ * Runs the driver against the simulated sensor with faults injected into its transactions, first one fault at
+ * a time to see which error code each one surfaces as, then random faults under the recovery policy below.
+ * */
+
+#define SIM_ADDRESS 0x76
+#define SIM_MEASUREMENT_TIME_US 7600
+#define NACK -1
+
+static sim_bme280_t simSensor;
+static saphBmeDevice_t device;
+static saphBmeMeasurements_t expected;
+static bool needsConfig;
+
+typedef struct soakResult_t {
+    uint32_t samples;
+    uint32_t failedAttempts;
+    uint32_t longestOutage;
+    uint32_t wrongSamples;
+} soakResult_t;
+
+/* *
+ * One forced measurement with commits verified. A verify mismatch or a reset data register means the sensor
+ * lost its configuration, everything else is retried as is.
+ * */
+static int32_t helper_acquire(saphBmeMeasurements_t* result) {
+    int32_t errorCode = SAPH_BME280_NO_ERROR;
+    if (needsConfig) {
+        errorCode = saphBme280_commitAllRegs(&device);
+    } else {
+        errorCode = saphBme280_triggerForcedMeasurement(&device);
+    }
+    if (errorCode != SAPH_BME280_NO_ERROR) {
+        needsConfig = needsConfig || errorCode == VERIFY_ERROR;
+        return errorCode;
+    }
+    needsConfig = false;
+    sim_bme280_advanceTime(&simSensor, saphBme280_getMeasurementTimeUs(&device));
+    errorCode = saphBme280_getMeasurements(&device, result);
+    needsConfig = errorCode == NO_MEASUREMENT_ERROR;
+    return errorCode;
+}
+
+static soakResult_t helper_soak(uint32_t cycles) {
+    soakResult_t soak = {0, 0, 0, 0};
+    uint32_t outage = 0;
+    for (uint32_t i = 0; i < cycles; ++i) {
+        saphBmeMeasurements_t result;
+        if (helper_acquire(&result) != SAPH_BME280_NO_ERROR) {
+            soak.failedAttempts++;
+            outage++;
+            continue;
+        }
+        soak.samples++;
+        soak.longestOutage = outage > soak.longestOutage ? outage : soak.longestOutage;
+        outage = 0;
+        if (result.temperature != expected.temperature || result.pressure != expected.pressure ||
+            result.humidity != expected.humidity) {
+            soak.wrongSamples++;
+        }
+    }
+    return soak;
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_setTiming(&simSensor, SIM_MEASUREMENT_TIME_US, 0);
+    sim_bme280_attach(&simSensor, SIM_ADDRESS);
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_setVerifyCommits(&device, true);
+    needsConfig = true;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, helper_acquire(&expected));
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # Single faults
+// #############################################
+
+void test_saphBme280_faults_nackOfThePointerWriteIsReportedAsIs(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions, SIM_BME280_FAULT_NACK);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NACK, saphBme280_getMeasurements(&device, &result));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&device, &result));
+}
+
+void test_saphBme280_faults_shortReadIsAReadAmountError(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions + 1, SIM_BME280_FAULT_SHORT_READ);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(READ_ERROR, saphBme280_getMeasurements(&device, &result));
+    TEST_ASSERT_EQUAL_UINT32(1, simSensor.injectedFaults[SIM_BME280_FAULT_SHORT_READ]);
+}
+
+void test_saphBme280_faults_shortReadScheduledOnAWriteIsLost(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions, SIM_BME280_FAULT_SHORT_READ);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&device, &result));
+    TEST_ASSERT_EQUAL_UINT32(0, simSensor.injectedFaults[SIM_BME280_FAULT_SHORT_READ]);
+}
+
+void test_saphBme280_faults_resetBeforeTheReadLeavesNoMeasurement(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions, SIM_BME280_FAULT_RESET);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_MEASUREMENT_ERROR, saphBme280_getMeasurements(&device, &result));
+}
+
+void test_saphBme280_faults_resetIsFoundByTheVerifiedTrigger(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions, SIM_BME280_FAULT_RESET);
+    TEST_ASSERT_EQUAL_INT32(VERIFY_ERROR, saphBme280_triggerForcedMeasurement(&device));
+    TEST_ASSERT_EQUAL_UINT8(0, device.committedValid);
+}
+
+void test_saphBme280_faults_resetBetweenPointerWriteAndReadGoesUnnoticed(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions + 1, SIM_BME280_FAULT_RESET);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&device, &result));
+    TEST_ASSERT_NOT_EQUAL_INT32(expected.temperature, result.temperature);
+    TEST_ASSERT_EQUAL_UINT32(1, simSensor.resetsBeforeRead);
+}
+
+// About 22 degC with the reference trimming values, only all data registers at reset mean a lost measurement
+void test_saphBme280_faults_temperatureAtTheResetValueIsARealMeasurement(void) {
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 0x80000, 27999);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, helper_acquire(&result));
+    saphBmeRawMeasurements_t raw = {283413, 0x80000, 27999};
+    saphBmeMeasurements_t compensated = saphBme280_internal_compensateMeasurements(&device, &raw);
+    TEST_ASSERT_EQUAL_INT32(compensated.temperature, result.temperature);
+    TEST_ASSERT_EQUAL_UINT32(compensated.pressure, result.pressure);
+    TEST_ASSERT_INT32_WITHIN(100, 2200, result.temperature);
+}
+
+void test_saphBme280_faults_recoversFromAResetAfterOneFailedAttempt(void) {
+    sim_bme280_scheduleFault(&simSensor, simSensor.transactions, SIM_BME280_FAULT_RESET);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(VERIFY_ERROR, helper_acquire(&result));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, helper_acquire(&result));
+    TEST_ASSERT_EQUAL_UINT32(expected.humidity, result.humidity);
+}
+
+// #############################################
+// # Random faults
+// #############################################
+
+void test_saphBme280_faults_noRatesInjectNothing(void) {
+    soakResult_t soak = helper_soak(1000);
+    TEST_ASSERT_EQUAL_UINT32(1000, soak.samples);
+    TEST_ASSERT_EQUAL_UINT32(simSensor.transactions, simSensor.injectedFaults[SIM_BME280_FAULT_NONE]);
+}
+
+void test_saphBme280_faults_sameSeedInjectsTheSameFaults(void) {
+    sim_bme280_faultRates_t rates = {20000, 20000, 5000};
+    sim_bme280_setFaultRates(&simSensor, &rates, 42);
+    soakResult_t first = helper_soak(2000);
+    uint32_t firstResets = simSensor.injectedFaults[SIM_BME280_FAULT_RESET];
+
+    setUp();
+    sim_bme280_setFaultRates(&simSensor, &rates, 42);
+    soakResult_t second = helper_soak(2000);
+    TEST_ASSERT_EQUAL_UINT32(first.failedAttempts, second.failedAttempts);
+    TEST_ASSERT_EQUAL_UINT32(firstResets, simSensor.injectedFaults[SIM_BME280_FAULT_RESET]);
+}
+
+void test_saphBme280_faults_soakDeliversWrongSamplesOnlyForUndetectableResets(void) {
+    sim_bme280_faultRates_t rates = {10000, 10000, 2000};
+    sim_bme280_setFaultRates(&simSensor, &rates, 7);
+    soakResult_t soak = helper_soak(20000);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, simSensor.injectedFaults[SIM_BME280_FAULT_NACK]);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, simSensor.injectedFaults[SIM_BME280_FAULT_SHORT_READ]);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, simSensor.injectedFaults[SIM_BME280_FAULT_RESET]);
+    // Whatever the driver cannot tell from a measurement, everything else has to be caught
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(simSensor.resetsBeforeRead, soak.wrongSamples);
+    TEST_ASSERT_GREATER_THAN_UINT32(18000, soak.samples);
+    TEST_ASSERT_LESS_THAN_UINT32(8, soak.longestOutage);
+}
@@ -0,0 +1,307 @@
+#include <math.h>
+#include "unity.h"
+
+#include "saphBme280_filter.h"
+#include "mock_saphBme280_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#define INVALID_CONFIG_ERROR -43
+#define NO_OUTPUT 0
+#define OUTPUT_READY 1
+
+static saphBme280_filter_t filter;
+
+static saphBmeRawMeasurements_t helper_raw(int32_t value) {
+    saphBmeRawMeasurements_t raw = {value, value, value};
+    return raw;
+}
+
+// #############################################
+// # Simulated sensor noise
+// #############################################
+
+// x1 leaves the lowest four bits of the 20 bit result empty, datasheet chapter 3.5
+#define X1_RESOLUTION 16
+#define NOISE_SAMPLES 4096
+#define TRUE_PRESSURE_RAW 415148.3
+
+static uint32_t noiseState;
+
+// Sum of four uniform values, close enough to gaussian with a standard deviation of about 1.15 x1 steps
+static double helper_noisyPressure(void) {
+    double sum = 0;
+    for (uint8_t i = 0; i < 4; ++i) {
+        noiseState = noiseState * 1664525u + 1013904223u;
+        sum += (double) (noiseState >> 8) / (double) (1u << 24) - 0.5;
+    }
+    return TRUE_PRESSURE_RAW + sum * 2 * X1_RESOLUTION;
+}
+
+static int32_t helper_sampleAtX1(void) {
+    return ((int32_t) (helper_noisyPressure() + X1_RESOLUTION / 2) / X1_RESOLUTION) * X1_RESOLUTION;
+}
+
+// The sensor averages its oversampled conversions before they are truncated to 20 bit
+static int32_t helper_sampleAtX16(void) {
+    double sum = 0;
+    for (uint8_t i = 0; i < 16; ++i) {
+        sum += helper_noisyPressure();
+    }
+    return (int32_t) (sum / 16 + 0.5);
+}
+
+typedef struct noiseResult_t {
+    double standardDeviation;
+    double meanError;
+} noiseResult_t;
+
+static noiseResult_t helper_evaluate(const int32_t* values, uint32_t amount) {
+    double sum = 0;
+    for (uint32_t i = 0; i < amount; ++i) {
+        sum += values[i];
+    }
+    double mean = sum / amount;
+    double squares = 0;
+    for (uint32_t i = 0; i < amount; ++i) {
+        squares += (values[i] - mean) * (values[i] - mean);
+    }
+    noiseResult_t result = {sqrt(squares / amount), fabs(mean - TRUE_PRESSURE_RAW)};
+    return result;
+}
+
+static int32_t outputs[NOISE_SAMPLES];
+
+static noiseResult_t helper_filterX1Samples(uint32_t inputs) {
+    noiseState = 1;
+    uint32_t amountOutputs = 0;
+    for (uint32_t i = 0; i < inputs; ++i) {
+        saphBmeRawMeasurements_t input = helper_raw(helper_sampleAtX1());
+        saphBmeRawMeasurements_t output;
+        if (saphBme280_filter_push(&filter, &input, &output) == OUTPUT_READY && i >= 64) {
+            outputs[amountOutputs++] = output.pressure;
+        }
+    }
+    return helper_evaluate(outputs, amountOutputs);
+}
+
+static noiseResult_t helper_hardwareX16Samples(uint32_t amount) {
+    noiseState = 1;
+    for (uint32_t i = 0; i < amount; ++i) {
+        outputs[i] = helper_sampleAtX16();
+    }
+    return helper_evaluate(outputs, amount);
+}
+
+// #############################################
+// # Test group _init
+// #############################################
+
+void test_saphBme280_filter_init_rejectsInvalidConfigurations(void) {
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_filter_initMovingAverage(&filter, 0));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_filter_initMovingAverage(&filter, 17));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_filter_initCic(&filter, 4, 0));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_filter_initCic(&filter, 4, 4));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_filter_initCic(&filter, 17, 1));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_filter_initIir(&filter, 5));
+}
+
+void test_saphBme280_filter_init_returnsErrorIfFilterIsNull(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_filter_initMovingAverage((saphBme280_filter_t*) 0, 4));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_filter_initCic((saphBme280_filter_t*) 0, 4, 1));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_filter_initIir((saphBme280_filter_t*) 0, 1));
+}
+
+// #############################################
+// # Test group moving average
+// #############################################
+
+void test_saphBme280_filter_movingAverage_averagesOverFilledPartOfWindow(void) {
+    saphBme280_filter_initMovingAverage(&filter, 4);
+    int32_t inputs[] = {100, 200, 300, 400, 500, 600};
+    int32_t expected[] = {100, 150, 200, 250, 350, 450};
+    for (uint8_t i = 0; i < 6; ++i) {
+        saphBmeRawMeasurements_t input = helper_raw(inputs[i]);
+        saphBmeRawMeasurements_t output;
+        TEST_ASSERT_EQUAL_INT32(OUTPUT_READY, saphBme280_filter_push(&filter, &input, &output));
+        TEST_ASSERT_EQUAL_INT32(expected[i], output.pressure);
+        TEST_ASSERT_EQUAL_INT32(expected[i], output.temperature);
+        TEST_ASSERT_EQUAL_INT32(expected[i], output.humidity);
+    }
+}
+
+void test_saphBme280_filter_movingAverage_roundsToNearest(void) {
+    saphBme280_filter_initMovingAverage(&filter, 2);
+    saphBmeRawMeasurements_t input = helper_raw(10);
+    saphBmeRawMeasurements_t output;
+    saphBme280_filter_push(&filter, &input, &output);
+    input = helper_raw(13);
+    saphBme280_filter_push(&filter, &input, &output);
+    TEST_ASSERT_EQUAL_INT32(12, output.pressure);
+}
+
+// #############################################
+// # Test group CIC
+// #############################################
+
+void test_saphBme280_filter_cic_firstOrderIsDecimatedBlockAverage(void) {
+    saphBme280_filter_initCic(&filter, 4, 1);
+    int32_t inputs[] = {100, 200, 300, 400, 1000, 1000, 1000, 1000};
+    saphBmeRawMeasurements_t output = helper_raw(0);
+    for (uint8_t i = 0; i < 8; ++i) {
+        saphBmeRawMeasurements_t input = helper_raw(inputs[i]);
+        int32_t outcome = saphBme280_filter_push(&filter, &input, &output);
+        TEST_ASSERT_EQUAL_INT32((i % 4 == 3) ? OUTPUT_READY : NO_OUTPUT, outcome);
+        if (i == 3) {
+            TEST_ASSERT_EQUAL_INT32(250, output.pressure);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT32(1000, output.pressure);
+}
+
+void test_saphBme280_filter_cic_dropsOutputsWhileSettling(void) {
+    saphBme280_filter_initCic(&filter, 4, 3);
+    saphBmeRawMeasurements_t input = helper_raw(5000);
+    saphBmeRawMeasurements_t output = helper_raw(0);
+    uint32_t amountOutputs = 0;
+    for (uint8_t i = 0; i < 16; ++i) {
+        if (saphBme280_filter_push(&filter, &input, &output) == OUTPUT_READY) {
+            amountOutputs++;
+            TEST_ASSERT_EQUAL_INT32(5000, output.pressure);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, amountOutputs);
+}
+
+void test_saphBme280_filter_cic_handlesFullScaleInputAtHighestGain(void) {
+    saphBme280_filter_initCic(&filter, 16, 3);
+    saphBmeRawMeasurements_t input = helper_raw(0xFFFFF);
+    saphBmeRawMeasurements_t output = helper_raw(0);
+    for (uint32_t i = 0; i < 16 * 10; ++i) {
+        saphBme280_filter_push(&filter, &input, &output);
+    }
+    TEST_ASSERT_EQUAL_INT32(0xFFFFF, output.pressure);
+}
+
+// #############################################
+// # Test group IIR
+// #############################################
+
+void test_saphBme280_filter_iir_followsSensorFilterStepResponse(void) {
+    saphBme280_filter_initIir(&filter, IIR_FILTER_COEFFICIENT_4);
+    saphBmeRawMeasurements_t input = helper_raw(1000);
+    saphBmeRawMeasurements_t output;
+    saphBme280_filter_push(&filter, &input, &output);
+    TEST_ASSERT_EQUAL_INT32(1000, output.pressure);
+    // (old * 3 + new) / 4
+    input = helper_raw(2000);
+    saphBme280_filter_push(&filter, &input, &output);
+    TEST_ASSERT_EQUAL_INT32(1250, output.pressure);
+    saphBme280_filter_push(&filter, &input, &output);
+    TEST_ASSERT_EQUAL_INT32(1438, output.pressure);
+}
+
+void test_saphBme280_filter_iir_passesThroughWhenOff(void) {
+    saphBme280_filter_initIir(&filter, IIR_FILTER_COEFFICIENT_OFF);
+    saphBmeRawMeasurements_t input = helper_raw(1000);
+    saphBmeRawMeasurements_t output;
+    saphBme280_filter_push(&filter, &input, &output);
+    input = helper_raw(3000);
+    saphBme280_filter_push(&filter, &input, &output);
+    TEST_ASSERT_EQUAL_INT32(3000, output.temperature);
+}
+
+void test_saphBme280_filter_reset_forgetsHistory(void) {
+    saphBme280_filter_initMovingAverage(&filter, 4);
+    saphBmeRawMeasurements_t input = helper_raw(1000);
+    saphBmeRawMeasurements_t output;
+    saphBme280_filter_push(&filter, &input, &output);
+    saphBme280_filter_reset(&filter);
+    input = helper_raw(3000);
+    saphBme280_filter_push(&filter, &input, &output);
+    TEST_ASSERT_EQUAL_INT32(3000, output.pressure);
+    TEST_ASSERT_EQUAL_UINT8(SAPHBME280_FILTER_KIND_MOVING_AVERAGE, filter.kind);
+}
+
+void test_saphBme280_filter_push_returnsErrorIfPointerIsNull(void) {
+    saphBmeRawMeasurements_t input = helper_raw(0);
+    saphBmeRawMeasurements_t output;
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_filter_push((saphBme280_filter_t*) 0, &input, &output));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR,
+                            saphBme280_filter_push(&filter, (saphBmeRawMeasurements_t*) 0, &output));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_filter_push(&filter, &input, (saphBmeRawMeasurements_t*) 0));
+}
+
+// #############################################
+// # Test group _getMeasurements
+// #############################################
+
+void test_saphBme280_filter_getMeasurements_compensatesFilterOutput(void) {
+    saphBmeDevice_t fakeDevice = {0x76};
+    saphBme280_filter_initMovingAverage(&filter, 1);
+    saphBmeRawMeasurements_t raw = {415148, 519888, 27000};
+    saphBmeMeasurements_t compensated = {100653, 2508, 51000};
+    saphBme280_internal_getRawMeasurement_ExpectAnyArgsAndReturn(NO_ERROR);
+    saphBme280_internal_getRawMeasurement_ReturnThruPtr_result(&raw);
+    saphBme280_internal_compensateMeasurements_ExpectAndReturn(&fakeDevice, &raw, compensated);
+
+    saphBmeMeasurements_t result = {0, 0, 0};
+    int32_t outcome = saphBme280_filter_getMeasurements(&fakeDevice, &filter, &result);
+    TEST_ASSERT_EQUAL_INT32(OUTPUT_READY, outcome);
+    TEST_ASSERT_EQUAL_INT32(2508, result.temperature);
+    TEST_ASSERT_EQUAL_UINT32(100653, result.pressure);
+}
+
+void test_saphBme280_filter_getMeasurements_skipsCompensationWithoutOutput(void) {
+    saphBmeDevice_t fakeDevice = {0x76};
+    saphBme280_filter_initCic(&filter, 2, 1);
+    saphBme280_internal_getRawMeasurement_ExpectAnyArgsAndReturn(NO_ERROR);
+    saphBmeMeasurements_t result = {1, 2, 3};
+    int32_t outcome = saphBme280_filter_getMeasurements(&fakeDevice, &filter, &result);
+    TEST_ASSERT_EQUAL_INT32(NO_OUTPUT, outcome);
+    TEST_ASSERT_EQUAL_INT32(2, result.temperature);
+}
+
+void test_saphBme280_filter_getMeasurements_passesReadErrorOn(void) {
+    saphBmeDevice_t fakeDevice = {0x76};
+    saphBme280_filter_initMovingAverage(&filter, 4);
+    saphBme280_internal_getRawMeasurement_ExpectAnyArgsAndReturn(READ_ERROR);
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(READ_ERROR, saphBme280_filter_getMeasurements(&fakeDevice, &filter, &result));
+}
+
+// #############################################
+// # Test group noise against hardware oversampling
+// #############################################
+
+void test_saphBme280_filter_noise_movingAverageOfX1ComesCloseToHardwareX16(void) {
+    noiseResult_t hardware = helper_hardwareX16Samples(NOISE_SAMPLES / 4);
+    noiseResult_t unfiltered;
+    saphBme280_filter_initMovingAverage(&filter, 1);
+    unfiltered = helper_filterX1Samples(NOISE_SAMPLES);
+    saphBme280_filter_initMovingAverage(&filter, 16);
+    noiseResult_t software = helper_filterX1Samples(NOISE_SAMPLES);
+
+    TEST_ASSERT_TRUE(software.standardDeviation * 3 < unfiltered.standardDeviation);
+    TEST_ASSERT_TRUE(software.standardDeviation < hardware.standardDeviation * 2);
+    TEST_ASSERT_TRUE(software.meanError < X1_RESOLUTION / 2);
+}
+
+void test_saphBme280_filter_noise_cicDecimatesToHardwareX16Rate(void) {
+    noiseResult_t hardware = helper_hardwareX16Samples(NOISE_SAMPLES / 16);
+    saphBme280_filter_initCic(&filter, 16, 1);
+    noiseResult_t software = helper_filterX1Samples(NOISE_SAMPLES);
+
+    TEST_ASSERT_TRUE(software.standardDeviation < hardware.standardDeviation * 1.5);
+    TEST_ASSERT_TRUE(software.meanError < X1_RESOLUTION / 2);
+}
+
+void test_saphBme280_filter_noise_iirKeepsResolutionOfHardwareFilter(void) {
+    saphBme280_filter_initMovingAverage(&filter, 1);
+    noiseResult_t unfiltered = helper_filterX1Samples(NOISE_SAMPLES);
+    saphBme280_filter_initIir(&filter, IIR_FILTER_COEFFICIENT_16);
+    noiseResult_t software = helper_filterX1Samples(NOISE_SAMPLES);
+
+    // Equivalent noise bandwidth of the first order IIR with coefficient 16 is 1 / 31
+    TEST_ASSERT_TRUE(software.standardDeviation * 4 < unfiltered.standardDeviation);
+    TEST_ASSERT_TRUE(software.meanError < X1_RESOLUTION / 2);
+}
@@ -6,6 +6,12 @@
 
 #include "mock_i2c_handler.h"
 
+// The bus lock is exercised against the simulated bus, here it would only get in the way of the expectations
+void setUp(void) {
+    i2c_handler_lock_Ignore();
+    i2c_handler_unlock_Ignore();
+}
+
 static saphBmeDevice_t helper_createBmeDevice(void) {
     uint8_t deviceAddr = 0xF7;
     saphBmeDevice_t bmeDevice = {deviceAddr};
@@ -20,10 +26,12 @@ uint8_t trimmingFirstResponse[firstBurstReadAmount];
 uint8_t trimmingSecondResponse[secondBurstReadAmount];
 uint8_t trimmingThirdResponse[thirdBurstReadAmount];
 
+// Static because the mock only keeps the pointer until the call happens
+static uint8_t firstStartAddr = BURST_ADDR_FIRST;
+static uint8_t secondStartAddr = 0xA1;
+static uint8_t thirdStartAddr = 0xE1;
+
 static void helper_prepareI2cBurstRead(saphBmeDevice_t* fakeDevice) {
-    uint8_t firstStartAddr = BURST_ADDR_FIRST;
-    uint8_t secondStartAddr = 0xA1;
-    uint8_t thirdStartAddr = 0xE1;
     for (int i = 0; i < firstBurstReadAmount; ++i) {
         trimmingFirstResponse[i] = i;
     }
@@ -180,6 +188,26 @@ void test_saphBme280_readTrimmingValues_returnsErrorCodeOnFailedThirdRead(void)
     TEST_ASSERT_EQUAL_INT32(READ_ERROR, errorCode);
 }
 
+void test_saphBme280_readTrimmingValues_bmp280ReadsOnlyTemperatureAndPressureBlock(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    for (int i = 0; i < pressureOnlyBurstReadAmount; ++i) {
+        trimmingFirstResponse[i] = i;
+    }
+    i2c_handler_write_ExpectWithArrayAndReturn(fakeDevice.address, &firstStartAddr, 1, 1, 1);
+    i2c_handler_read_ExpectAndReturn(fakeDevice.address, trimmingFirstResponse, pressureOnlyBurstReadAmount,
+                                     pressureOnlyBurstReadAmount);
+    i2c_handler_read_IgnoreArg_buffer();
+    i2c_handler_read_ReturnArrayThruPtr_buffer(trimmingFirstResponse, pressureOnlyBurstReadAmount);
+
+    int32_t errorCode = saphBme280_internal_readTrimmingValues(&fakeDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    helper_checkUnsignedTrimmingValue(trimmingFirstResponse, &(fakeDevice.trimmingValues.dig_T1));
+    helper_checkSignedTrimmingValue(trimmingFirstResponse + 22, &(fakeDevice.trimmingValues.dig_P9));
+    TEST_ASSERT_EQUAL_UINT8(0, fakeDevice.trimmingValues.dig_H1);
+    TEST_ASSERT_EQUAL_INT16(0, fakeDevice.trimmingValues.dig_H2);
+}
+
 // #############################################
 // # Test group _getRawAllMeasurements
 // #############################################
@@ -232,6 +260,50 @@ void test_saphBme280_getRawAllMeasurements_returnsHumidityInItsPointers(void) {
     TEST_ASSERT_EQUAL_INT32(expectedHumidity, result.humidity);
 }
 
+void test_saphBme280_getRawAllMeasurements_bmp280SkipsHumidityBytes(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    uint8_t startingRegister = 0xF7; // the pressure register
+    uint8_t response[] = {0xAC, 0xAB, 0xAA, 0xBC, 0xBB, 0xBA};
+    saphBmeRawMeasurements_t result = {0, 0, 0xFFFF};
+
+    i2c_handler_write_ExpectWithArrayAndReturn(fakeDevice.address, &startingRegister, 1, 1, 1);
+    i2c_handler_read_ExpectAndReturn(fakeDevice.address, response, MEASUREMENT_SIZE_NO_HUMIDITY,
+                                     MEASUREMENT_SIZE_NO_HUMIDITY);
+    i2c_handler_read_IgnoreArg_buffer();
+    i2c_handler_read_ReturnArrayThruPtr_buffer(response, MEASUREMENT_SIZE_NO_HUMIDITY);
+    int32_t errorCode = saphBme280_internal_getRawMeasurement(&fakeDevice, &result);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_INT32((response[0] << 12) + (response[1] << 4) + (response[2] >> 4), result.pressure);
+    TEST_ASSERT_EQUAL_INT32((response[3] << 12) + (response[4] << 4) + (response[5] >> 4), result.temperature);
+    TEST_ASSERT_EQUAL_INT32(0, result.humidity);
+}
+
+void test_saphBme280_getRawAllMeasurements_returnsErrorIfAllRegistersHoldTheirResetValues(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    uint8_t response[] = {0x80, 0x00, 0x00, 0x80, 0x00, 0x00, 0x80, 0x00};
+    saphBmeRawMeasurements_t result = {0, 0, 0};
+
+    i2c_handler_write_ExpectAnyArgsAndReturn(1);
+    i2c_handler_read_ExpectAnyArgsAndReturn(MEASUREMENT_SIZE);
+    i2c_handler_read_ReturnArrayThruPtr_buffer(response, MEASUREMENT_SIZE);
+    int32_t errorCode = saphBme280_internal_getRawMeasurement(&fakeDevice, &result);
+    TEST_ASSERT_EQUAL_INT32(NO_MEASUREMENT_ERROR, errorCode);
+}
+
+// Raw 0x80000 is about 26.5 degC, a reading like any other as long as the other registers moved on
+void test_saphBme280_getRawAllMeasurements_acceptsTemperatureAtTheResetValueAlone(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    uint8_t response[] = {0x51, 0x83, 0xA0, 0x80, 0x00, 0x00, 0x6D, 0x5F};
+    saphBmeRawMeasurements_t result = {0, 0, 0};
+
+    i2c_handler_write_ExpectAnyArgsAndReturn(1);
+    i2c_handler_read_ExpectAnyArgsAndReturn(MEASUREMENT_SIZE);
+    i2c_handler_read_ReturnArrayThruPtr_buffer(response, MEASUREMENT_SIZE);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_internal_getRawMeasurement(&fakeDevice, &result));
+    TEST_ASSERT_EQUAL_INT32(0x80000, result.temperature);
+}
+
 void test_saphBme280_getRawAllMeasurements_returnsErrorCodeForFailedWrite(void) {
     saphBmeDevice_t fakeDevice = helper_createBmeDevice();
     void* nothingness = 0;
@@ -316,7 +388,7 @@ uint32_t helper_calculatePressure(saphBmeDevice_t* fakeDevice, saphBmeRawMeasure
     }
     pressure = 1048576 - rawMeasurements->pressure;
     pressure = (((pressure << 31) - value2) * 3125) / value1;
-    value1 = (((int64_t) trims.dig_P9) * (pressure >> 13) * (pressure > 13)) >> 25;
+    value1 = (((int64_t) trims.dig_P9) * (pressure >> 13) * (pressure >> 13)) >> 25;
     value2 = (((int64_t) trims.dig_P8) * pressure) >> 19;
     pressure = ((pressure + value1 + value2) >> 8) + (((int64_t) trims.dig_P7) << 4);
     uint32_t result = (uint32_t) pressure;
@@ -341,11 +413,13 @@ uint32_t helper_calculateHumidity(saphBmeDevice_t* fakeDevice, saphBmeRawMeasure
     variable = (fineTemperature - ((int32_t) 76800));
     variable =
             ((((rawHumidity << 14) - (((int32_t) trims.dig_H4) << 20) -
-               (((int32_t) trims.dig_H5) * variable)) + ((int32_t) 16348)) >> 15) *
-            (((((((variable * ((int32_t) trims.dig_H6) >> 10) * (variable * ((int32_t) trims.dig_H3)) >> 11) +
-                 ((int32_t) 32768)) >> 10) + ((int32_t) 2097152)) * ((int32_t) trims.dig_H2) + 8192) >> 14);
+               (((int32_t) trims.dig_H5) * variable)) + ((int32_t) 16384)) >> 15) *
+            (((((((variable * ((int32_t) trims.dig_H6)) >> 10) *
+                 (((variable * ((int32_t) trims.dig_H3)) >> 11) + ((int32_t) 32768))) >> 10) +
+               ((int32_t) 2097152)) * ((int32_t) trims.dig_H2) + 8192) >> 14);
     variable = (variable - (((((variable >> 15) * (variable >> 15)) >> 7) * ((int32_t) trims.dig_H1)) >> 4));
     variable = (variable < 0 ? 0 : variable);
+    variable = (variable > 419430400 ? 419430400 : variable);
     return (uint32_t) (variable >> 12);
 }
 
@@ -358,3 +432,35 @@ void test_saphBme280_compensateMeasurements_compensateHumidityReading(void) {
     saphBmeMeasurements_t result = saphBme280_internal_compensateMeasurements(&fakeDevice, &rawMeasurements);
     TEST_ASSERT_EQUAL_UINT32(expectedHumidity, result.humidity);
 }
+
+// 102168.82 Pa, the floating point formula of the datasheet gives 102169.26 Pa for the same input
+void test_saphBme280_compensateMeasurements_pressureAgreesWithTheDatasheetFloatingPointFormula(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    helper_setTrimmingValues(&fakeDevice);
+    saphBmeRawMeasurements_t rawMeasurements = {283413, 523407, 27999};
+
+    saphBmeMeasurements_t result = saphBme280_internal_compensateMeasurements(&fakeDevice, &rawMeasurements);
+    TEST_ASSERT_EQUAL_UINT32(26155218, result.pressure);
+}
+
+void test_saphBme280_compensateMeasurements_humidityStopsAtHundredPercent(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    helper_setTrimmingValues(&fakeDevice);
+    saphBmeRawMeasurements_t rawMeasurements = {283413, 523407, 65535};
+
+    saphBmeMeasurements_t result = saphBme280_internal_compensateMeasurements(&fakeDevice, &rawMeasurements);
+    TEST_ASSERT_EQUAL_UINT32(100 * 1024, result.humidity);
+}
+
+void test_saphBme280_compensateMeasurements_bmp280LeavesHumidityAtZero(void) {
+    saphBmeDevice_t fakeDevice = helper_createBmeDevice();
+    helper_setTrimmingValues(&fakeDevice);
+    fakeDevice.chipId = CHIP_ID_BMP280;
+    saphBmeRawMeasurements_t rawMeasurements = {283413, 523407, 27999};
+    uint32_t expectedPressure = helper_calculatePressure(&fakeDevice, &rawMeasurements);
+
+    saphBmeMeasurements_t result = saphBme280_internal_compensateMeasurements(&fakeDevice, &rawMeasurements);
+    TEST_ASSERT_EQUAL_INT32(2189, result.temperature);
+    TEST_ASSERT_EQUAL_UINT32(expectedPressure, result.pressure);
+    TEST_ASSERT_EQUAL_UINT32(0, result.humidity);
+}
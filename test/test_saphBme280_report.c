@@ -0,0 +1,181 @@
+#include "unity.h"
+
+#include "saphBme280_report.h"
+#include "trace_indoor.h"
+#include "test_saphBme280_test_definitions.h"
+
+#define NO_FREE_SLOT_ERROR -46
+#define SUPPRESSED 0
+#define EMIT 1
+
+#define SENSOR_ADDRESS 0x76
+#define OTHER_SENSOR_ADDRESS 0x77
+#define HEARTBEAT_US 60000000u
+
+static saphBme280_report_t report;
+static saphBme280_reportConfig_t config;
+static saphBmeMeasurements_t measurements;
+
+// 5 Pa, 0.1 degC and 0.5 %RH, about what a display shows
+static void helper_initDisplayDeadbands(void) {
+    config.pressureDeadband = 5 * 256;
+    config.temperatureDeadband = 10;
+    config.humidityDeadband = 512;
+    config.heartbeatUs = HEARTBEAT_US;
+    saphBme280_report_init(&report, &config);
+}
+
+static uint32_t helper_replayTrace(uint32_t from, uint32_t to) {
+    uint32_t emitted = 0;
+    for (uint32_t i = from; i < to; ++i) {
+        if (saphBme280_report_offer(&report, SENSOR_ADDRESS, &traceIndoor[i], i * TRACE_INDOOR_INTERVAL_US) == EMIT) {
+            emitted++;
+        }
+    }
+    return emitted;
+}
+
+void setUp(void) {
+    measurements.pressure = 101325 * 256;
+    measurements.temperature = 2000;
+    measurements.humidity = 40960;
+    helper_initDisplayDeadbands();
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saphBme280_report_offer
+// #############################################
+
+void test_saphBme280_report_offer_emits_first_sample(void) {
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0));
+}
+
+void test_saphBme280_report_offer_suppresses_sample_within_deadbands(void) {
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+    measurements.pressure += 5 * 256;
+    measurements.temperature -= 10;
+    measurements.humidity += 512;
+
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 1000000));
+}
+
+void test_saphBme280_report_offer_emits_when_any_field_leaves_its_deadband(void) {
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+    saphBmeMeasurements_t moved = measurements;
+    moved.temperature -= 11;
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, SENSOR_ADDRESS, &moved, 1000000));
+
+    moved.humidity += 513;
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, SENSOR_ADDRESS, &moved, 2000000));
+
+    moved.pressure -= 5 * 256 + 1;
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, SENSOR_ADDRESS, &moved, 3000000));
+}
+
+void test_saphBme280_report_offer_handles_temperatures_around_zero(void) {
+    measurements.temperature = -5;
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+
+    measurements.temperature = 5;
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 1000000));
+    measurements.temperature = 6;
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 2000000));
+}
+
+void test_saphBme280_report_offer_reports_slow_drift_once_it_adds_up(void) {
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+    int32_t result = SUPPRESSED;
+    uint8_t steps = 0;
+    while (result == SUPPRESSED) {
+        steps++;
+        measurements.temperature += 2;
+        result = saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, steps * 1000000u);
+    }
+    TEST_ASSERT_EQUAL_UINT8(6, steps);
+}
+
+void test_saphBme280_report_offer_emits_on_heartbeat(void) {
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED,
+                            saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, HEARTBEAT_US - 1));
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, HEARTBEAT_US));
+}
+
+void test_saphBme280_report_offer_heartbeat_across_clock_wrap(void) {
+    uint32_t start = UINT32_MAX - 1000;
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, start);
+
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, start + 2000));
+    TEST_ASSERT_EQUAL_INT32(EMIT,
+                            saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, start + HEARTBEAT_US));
+}
+
+void test_saphBme280_report_offer_without_heartbeat_suppresses_forever(void) {
+    config.heartbeatUs = 0;
+    saphBme280_report_init(&report, &config);
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, UINT32_MAX));
+}
+
+void test_saphBme280_report_offer_keeps_sensors_apart(void) {
+    saphBmeMeasurements_t other = measurements;
+    other.temperature += 500;
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+
+    TEST_ASSERT_EQUAL_INT32(EMIT, saphBme280_report_offer(&report, OTHER_SENSOR_ADDRESS, &other, 0));
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED, saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 1000000));
+    TEST_ASSERT_EQUAL_INT32(SUPPRESSED, saphBme280_report_offer(&report, OTHER_SENSOR_ADDRESS, &other, 1000000));
+    TEST_ASSERT_EQUAL_UINT32(2, saphBme280_report_getSensor(&report, SENSOR_ADDRESS)->offered);
+    TEST_ASSERT_EQUAL_UINT32(1, saphBme280_report_getSensor(&report, OTHER_SENSOR_ADDRESS)->emitted);
+}
+
+void test_saphBme280_report_offer_with_too_many_sensors_returns_no_free_slot(void) {
+    saphBme280_report_offer(&report, SENSOR_ADDRESS, &measurements, 0);
+    saphBme280_report_offer(&report, OTHER_SENSOR_ADDRESS, &measurements, 0);
+
+    TEST_ASSERT_EQUAL_INT32(NO_FREE_SLOT_ERROR, saphBme280_report_offer(&report, 0x78, &measurements, 0));
+}
+
+// #############################################
+// # Recorded traces
+// #############################################
+
+void test_saphBme280_report_steady_room_emits_few_samples(void) {
+    uint32_t emitted = helper_replayTrace(0, TRACE_INDOOR_STEADY_SAMPLES);
+
+    // First sample and the heartbeats at one and two minutes, the noise stays within the deadbands
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(TRACE_INDOOR_STEADY_SAMPLES / 20, emitted);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(3, emitted);
+}
+
+void test_saphBme280_report_opened_window_is_followed_closely(void) {
+    helper_replayTrace(0, TRACE_INDOOR_STEADY_SAMPLES);
+    uint32_t emitted = helper_replayTrace(TRACE_INDOOR_STEADY_SAMPLES, TRACE_INDOOR_SAMPLES);
+
+    // Almost 2 degC in one minute, most of it in the first half
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(10, emitted);
+    saphBme280_reportSensor_t* sensor = saphBme280_report_getSensor(&report, SENSOR_ADDRESS);
+    const saphBmeMeasurements_t* last = &traceIndoor[TRACE_INDOOR_SAMPLES - 1];
+    TEST_ASSERT_INT32_WITHIN(10, last->temperature, sensor->lastEmitted.temperature);
+}
+
+void test_saphBme280_report_whole_trace_ratio(void) {
+    uint32_t emitted = helper_replayTrace(0, TRACE_INDOOR_SAMPLES);
+
+    saphBme280_reportSensor_t* sensor = saphBme280_report_getSensor(&report, SENSOR_ADDRESS);
+    TEST_ASSERT_EQUAL_UINT32(TRACE_INDOOR_SAMPLES, sensor->offered);
+    TEST_ASSERT_EQUAL_UINT32(emitted, sensor->emitted);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(TRACE_INDOOR_SAMPLES / 5, emitted);
+}
+
+void test_saphBme280_report_null_pointers_return_error(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_report_init(0, &config));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_report_init(&report, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_report_offer(0, SENSOR_ADDRESS, &measurements, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_report_offer(&report, SENSOR_ADDRESS, 0, 0));
+    TEST_ASSERT_NULL(saphBme280_report_getSensor(&report, SENSOR_ADDRESS));
+}
@@ -0,0 +1,282 @@
+#include "unity.h"
+
+#include "saphBme280_sampler.h"
+#include "saphBme280_burst.h"
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+/* *
+ * Runs the sampler against the simulated sensor in normal mode.
+ * The simulated sensor converts a bit faster than the datasheet typical the sampler starts out with.
+ * */
+
+#define SIM_ADDRESS 0x76
+// x1 on all three is typically 8ms
+#define SIM_MEASUREMENT_TIME_US 7600
+#define SIM_TEMPERATURE_STEP 1000
+// Close to the wrap of the 32 bit microsecond clock
+#define START_TIME_US 0xFFF00000u
+
+static sim_bme280_t simSensor;
+static saphBmeDevice_t device;
+static saphBme280_sampler_t sampler;
+static uint32_t nowUs;
+static saphBme280_burst_ring_t ring;
+// Enough for 2 s of the 62.5 ms standby
+static uint8_t ringBuffer[40 * MEASUREMENT_SIZE];
+
+typedef struct consumerResult_t {
+    uint32_t polls;
+    uint32_t freshSamples;
+    uint32_t duplicates;
+    uint32_t skipped;
+} consumerResult_t;
+
+static void helper_startNormalModeWithTiming(uint8_t standbyTime, uint32_t simMeasurementUs, uint32_t simStandbyUs) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    simSensor.temperatureStep = SIM_TEMPERATURE_STEP;
+    sim_bme280_setTiming(&simSensor, simMeasurementUs, simStandbyUs);
+    sim_bme280_attach(&simSensor, SIM_ADDRESS);
+
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_prepareConfigReg(&device, standbyTime, IIR_FILTER_COEFFICIENT_OFF);
+    saphBme280_prepareMeasureCtrlReg(&device, OVERSAMPLING_x1, OVERSAMPLING_x1, SENSOR_MODE_NORMAL);
+    saphBme280_commitAllRegs(&device);
+
+    nowUs = START_TIME_US;
+    saphBme280_sampler_init(&sampler, &device, nowUs);
+    sim_i2c_bus_clearStats();
+}
+
+static void helper_startNormalMode(uint8_t standbyTime, uint32_t simStandbyUs) {
+    helper_startNormalModeWithTiming(standbyTime, SIM_MEASUREMENT_TIME_US, simStandbyUs);
+}
+
+// Conversions finished in the simulation tell which sample the sampler must have handed out
+static consumerResult_t helper_runConsumer(uint32_t pollIntervalUs, uint32_t durationUs) {
+    consumerResult_t outcome = {0, 0, 0, 0};
+    uint32_t lastConversion = 0;
+    int32_t lastTemperature = INT32_MIN;
+    for (uint32_t elapsed = 0; elapsed < durationUs; elapsed += pollIntervalUs) {
+        sim_bme280_advanceTime(&simSensor, pollIntervalUs);
+        nowUs += pollIntervalUs;
+        saphBmeMeasurements_t result;
+        int32_t outcomeCode = saphBme280_sampler_poll(&sampler, nowUs, &result);
+        TEST_ASSERT_TRUE(outcomeCode >= 0);
+        outcome.polls++;
+        if (outcomeCode != SAPHBME280_SAMPLER_FRESH_SAMPLE) {
+            continue;
+        }
+        outcome.freshSamples++;
+        if (simSensor.conversions == lastConversion || result.temperature <= lastTemperature) {
+            outcome.duplicates++;
+        } else {
+            outcome.skipped += simSensor.conversions - lastConversion - 1;
+        }
+        lastConversion = simSensor.conversions;
+        lastTemperature = result.temperature;
+    }
+    return outcome;
+}
+
+// #############################################
+// # Test group _init
+// #############################################
+
+void test_saphBme280_sampler_init_returnsErrorIfPointerIsNull(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_sampler_init((saphBme280_sampler_t*) 0, &device, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_sampler_init(&sampler, (saphBmeDevice_t*) 0, 0));
+}
+
+void test_saphBme280_sampler_init_derivesPeriodFromPreparedRegisters(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    TEST_ASSERT_EQUAL_UINT32(8000 + 62500, sampler.periodUs);
+    TEST_ASSERT_EQUAL_UINT32(8000 / 4, sampler.retryIntervalUs);
+}
+
+void test_saphBme280_sampler_init_pollsQuicklyIfStandbyIsShort(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_0_5, 500);
+    TEST_ASSERT_EQUAL_UINT32(8000 + 500, sampler.periodUs);
+    TEST_ASSERT_EQUAL_UINT32(500 / 4, sampler.retryIntervalUs);
+}
+
+// #############################################
+// # Test group _poll
+// #############################################
+
+void test_saphBme280_sampler_poll_returnsErrorIfPointerIsNull(void) {
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_sampler_poll((saphBme280_sampler_t*) 0, 0, &result));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR,
+                            saphBme280_sampler_poll(&sampler, 0, (saphBmeMeasurements_t*) 0));
+}
+
+void test_saphBme280_sampler_poll_staysOffTheBusUntilAConversionCanBeDone(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    // Polling starts a quarter of the typical 8ms early
+    consumerResult_t outcome = helper_runConsumer(1000, 5000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.freshSamples);
+    TEST_ASSERT_EQUAL_UINT32(outcome.polls, sampler.duplicatesAvoided);
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.readTransactions + stats.writeTransactions);
+}
+
+void test_saphBme280_sampler_poll_handsOutEveryConversionOnceToFastConsumer(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    consumerResult_t outcome = helper_runConsumer(1000, 2000000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.skipped);
+    TEST_ASSERT_UINT32_WITHIN(1, simSensor.conversions, outcome.freshSamples);
+    TEST_ASSERT_EQUAL_UINT32(outcome.polls - outcome.freshSamples, sampler.duplicatesAvoided);
+}
+
+void test_saphBme280_sampler_poll_needsFewRegisterReadsPerFreshSample(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    consumerResult_t outcome = helper_runConsumer(1000, 2000000);
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    // Every register read is a pointer write followed by the read
+    TEST_ASSERT_EQUAL_UINT32(stats.readTransactions, stats.writeTransactions);
+    TEST_ASSERT_TRUE(stats.readTransactions <= 3 * outcome.freshSamples);
+    // A reader without the status check burst reads on every call
+    TEST_ASSERT_TRUE(outcome.polls > 20 * stats.readTransactions);
+}
+
+void test_saphBme280_sampler_poll_followsShortStandbyWithoutDuplicates(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_0_5, 500);
+    consumerResult_t outcome = helper_runConsumer(250, 500000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.skipped);
+    TEST_ASSERT_UINT32_WITHIN(1, simSensor.conversions, outcome.freshSamples);
+}
+
+void test_saphBme280_sampler_poll_neverRepeatsSamplesForSlowConsumer(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    consumerResult_t outcome = helper_runConsumer(100000, 5000000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.duplicates);
+    TEST_ASSERT_TRUE(2 * outcome.freshSamples >= outcome.polls);
+}
+
+void test_saphBme280_sampler_poll_followsSensorSlowerThanPlanned(void) {
+    // Standby oscillator running 2% slow and conversions at the datasheet maximum
+    helper_startNormalModeWithTiming(STANDBY_TIME_MS_62_5, 9300, 63750);
+    consumerResult_t outcome = helper_runConsumer(1000, 2000000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.skipped);
+}
+
+void test_saphBme280_sampler_poll_followsSensorFasterThanPlanned(void) {
+    helper_startNormalModeWithTiming(STANDBY_TIME_MS_0_5, 7000, 450);
+    consumerResult_t outcome = helper_runConsumer(100, 500000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.skipped);
+}
+
+void test_saphBme280_sampler_poll_recoversAfterConsumerStall(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    helper_runConsumer(1000, 500000);
+    sim_bme280_advanceTime(&simSensor, 1000000);
+    nowUs += 1000000;
+    consumerResult_t outcome = helper_runConsumer(1000, 1000000);
+    TEST_ASSERT_EQUAL_UINT32(0, outcome.duplicates);
+    TEST_ASSERT_TRUE(outcome.freshSamples >= 13);
+}
+
+void test_saphBme280_sampler_poll_passesStatusReadErrorOn(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    sim_i2c_bus_reset();
+    saphBmeMeasurements_t result;
+    int32_t errorCode = saphBme280_sampler_poll(&sampler, nowUs + 70000, &result);
+    TEST_ASSERT_TRUE(errorCode < 0);
+}
+
+// #############################################
+// # Test group _pollRaw
+// #############################################
+
+static uint32_t helper_runRawConsumer(uint32_t pollIntervalUs, uint32_t durationUs) {
+    uint32_t freshSamples = 0;
+    for (uint32_t elapsed = 0; elapsed < durationUs; elapsed += pollIntervalUs) {
+        sim_bme280_advanceTime(&simSensor, pollIntervalUs);
+        nowUs += pollIntervalUs;
+        int32_t outcomeCode = saphBme280_sampler_pollRaw(&sampler, nowUs, &ring);
+        TEST_ASSERT_TRUE(outcomeCode >= 0);
+        freshSamples += outcomeCode == SAPHBME280_SAMPLER_FRESH_SAMPLE ? 1 : 0;
+    }
+    return freshSamples;
+}
+
+void test_saphBme280_sampler_pollRaw_returnsErrorIfPointerIsNull(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_sampler_pollRaw((saphBme280_sampler_t*) 0, 0, &ring));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR,
+                            saphBme280_sampler_pollRaw(&sampler, 0, (saphBme280_burst_ring_t*) 0));
+}
+
+void test_saphBme280_sampler_pollRaw_rejectsARingOfAnotherDevice(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    saphBmeDevice_t otherDevice = device;
+    saphBme280_burst_initRing(&ring, &otherDevice, ringBuffer, sizeof(ringBuffer));
+    sim_bme280_advanceTime(&simSensor, 100000);
+
+    int32_t errorCode = saphBme280_sampler_pollRaw(&sampler, nowUs + 100000, &ring);
+
+    TEST_ASSERT_EQUAL_INT32(SAPHBME280_SAMPLER_INVALID_CONFIG_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.amount);
+    TEST_ASSERT_EQUAL_UINT32(0, sim_i2c_bus_getStats().readTransactions);
+}
+
+void test_saphBme280_sampler_pollRaw_storesEveryConversionOnce(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    saphBme280_burst_initRing(&ring, &device, ringBuffer, sizeof(ringBuffer));
+    uint32_t freshSamples = helper_runRawConsumer(1000, 2000000);
+    TEST_ASSERT_UINT32_WITHIN(1, simSensor.conversions, freshSamples);
+    TEST_ASSERT_EQUAL_UINT32(freshSamples, ring.amount);
+
+    int32_t temperatures[40];
+    saphBme280_burst_columns_t columns = {temperatures, 0, 0};
+    TEST_ASSERT_EQUAL_INT32((int32_t) freshSamples, saphBme280_burst_decode(&ring, &columns, 40));
+    for (uint32_t i = 1; i < freshSamples; ++i) {
+        TEST_ASSERT_TRUE(temperatures[i] > temperatures[i - 1]);
+    }
+}
+
+void test_saphBme280_sampler_pollRaw_costsTheSameBusTrafficAsPoll(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    helper_runConsumer(1000, 2000000);
+    sim_i2c_bus_stats_t compensated = sim_i2c_bus_getStats();
+
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    saphBme280_burst_initRing(&ring, &device, ringBuffer, sizeof(ringBuffer));
+    helper_runRawConsumer(1000, 2000000);
+    sim_i2c_bus_stats_t raw = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(compensated.readTransactions, raw.readTransactions);
+    TEST_ASSERT_EQUAL_UINT32(compensated.bytesRead, raw.bytesRead);
+}
+
+void test_saphBme280_sampler_pollRaw_peekedSamplesMatchTheDecodedOnes(void) {
+    helper_startNormalMode(STANDBY_TIME_MS_62_5, 62500);
+    saphBme280_burst_initRing(&ring, &device, ringBuffer, sizeof(ringBuffer));
+    uint32_t freshSamples = helper_runRawConsumer(1000, 500000);
+    saphBmeMeasurements_t peeked[8];
+    for (uint32_t i = 0; i < freshSamples; ++i) {
+        TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_burst_peek(&ring, i, &peeked[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT32(freshSamples, ring.amount);
+
+    int32_t temperatures[8];
+    uint32_t pressures[8];
+    uint32_t humidities[8];
+    saphBme280_burst_columns_t columns = {temperatures, pressures, humidities};
+    saphBme280_burst_decode(&ring, &columns, 8);
+    for (uint32_t i = 0; i < freshSamples; ++i) {
+        TEST_ASSERT_EQUAL_INT32(temperatures[i], peeked[i].temperature);
+        TEST_ASSERT_EQUAL_UINT32(pressures[i], peeked[i].pressure);
+        TEST_ASSERT_EQUAL_UINT32(humidities[i], peeked[i].humidity);
+    }
+}
@@ -0,0 +1,252 @@
+#include "unity.h"
+
+#include "saphBme280_stats.h"
+#include "test_saphBme280_test_definitions.h"
+
+#define INVALID_CONFIG_ERROR -43
+#define NO_SUMMARY_ERROR -44
+
+#define SAMPLES_PER_MINUTE 60
+#define SAMPLES_PER_HOUR 3600
+
+static saphBme280_stats_t stats;
+
+static saphBmeMeasurements_t helper_measurement(uint32_t pressure, int32_t temperature, uint32_t humidity) {
+    saphBmeMeasurements_t measurements = {pressure, temperature, humidity};
+    return measurements;
+}
+
+static int32_t helper_pushTemperatures(const int32_t* temperatures, uint32_t amount) {
+    int32_t completed = 0;
+    for (uint32_t i = 0; i < amount; ++i) {
+        saphBmeMeasurements_t measurements = helper_measurement(100000, temperatures[i], 40000);
+        completed = saphBme280_stats_push(&stats, &measurements);
+    }
+    return completed;
+}
+
+static uint32_t randomState;
+
+static saphBmeMeasurements_t helper_randomMeasurement(void) {
+    randomState = randomState * 1664525u + 1013904223u;
+    uint32_t random = randomState >> 8;
+    return helper_measurement(95000 + random % 10000, -1500 + (int32_t) (random % 4000), 20000 + random % 60000);
+}
+
+static void helper_assertChannelsEqual(const saphBme280_statsChannel_t* expected,
+                                       const saphBme280_statsChannel_t* actual) {
+    TEST_ASSERT_EQUAL_INT32(expected->min, actual->min);
+    TEST_ASSERT_EQUAL_INT32(expected->max, actual->max);
+    TEST_ASSERT_EQUAL_INT32(expected->mean, actual->mean);
+    TEST_ASSERT_EQUAL_UINT32(expected->variance, actual->variance);
+}
+
+void setUp(void) {
+    saphBme280_stats_init(&stats);
+    randomState = 1;
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saphBme280_stats_addWindow
+// #############################################
+
+void test_saphBme280_stats_addWindow_accepts_windows_that_are_multiples_of_the_previous(void) {
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_addWindow(&stats, SAMPLES_PER_MINUTE));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_addWindow(&stats, SAMPLES_PER_HOUR));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_addWindow(&stats, SAMPLES_PER_HOUR * 24));
+    TEST_ASSERT_EQUAL_UINT8(3, stats.amountWindows);
+}
+
+void test_saphBme280_stats_addWindow_rejects_invalid_lengths(void) {
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_addWindow(&stats, 0));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_addWindow(&stats, 60));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_addWindow(&stats, 90));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_addWindow(&stats, 60));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_addWindow(&stats, 30));
+    TEST_ASSERT_EQUAL_UINT8(1, stats.amountWindows);
+}
+
+void test_saphBme280_stats_addWindow_rejects_more_than_max_windows(void) {
+    uint32_t length = 2;
+    for (uint8_t i = 0; i < SAPHBME280_STATS_MAX_WINDOWS; ++i) {
+        TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_addWindow(&stats, length));
+        length *= 2;
+    }
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_addWindow(&stats, length));
+}
+
+// #############################################
+// # saphBme280_stats_push
+// #############################################
+
+void test_saphBme280_stats_push_without_windows_returns_invalid_config(void) {
+    saphBmeMeasurements_t measurements = helper_measurement(100000, 2000, 40000);
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_push(&stats, &measurements));
+}
+
+void test_saphBme280_stats_push_computes_min_max_mean_and_variance(void) {
+    const int32_t temperatures[] = {2000, 2100, 1900, 2400};
+    saphBme280_stats_addWindow(&stats, 4);
+
+    TEST_ASSERT_EQUAL_INT32(1, helper_pushTemperatures(temperatures, 4));
+
+    saphBme280_statsSummary_t summary;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_getSummary(&stats, 0, &summary));
+    TEST_ASSERT_EQUAL_UINT32(4, summary.count);
+    TEST_ASSERT_EQUAL_INT32(1900, summary.temperature.min);
+    TEST_ASSERT_EQUAL_INT32(2400, summary.temperature.max);
+    TEST_ASSERT_EQUAL_INT32(2100, summary.temperature.mean);
+    TEST_ASSERT_EQUAL_UINT32(35000, summary.temperature.variance);
+    TEST_ASSERT_EQUAL_INT32(100000, summary.pressure.mean);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.pressure.variance);
+    TEST_ASSERT_EQUAL_INT32(40000, summary.humidity.min);
+    TEST_ASSERT_EQUAL_INT32(40000, summary.humidity.max);
+}
+
+void test_saphBme280_stats_push_handles_negative_temperatures(void) {
+    const int32_t temperatures[] = {-500, -700, -600};
+    saphBme280_stats_addWindow(&stats, 3);
+
+    helper_pushTemperatures(temperatures, 3);
+
+    saphBme280_statsSummary_t summary;
+    saphBme280_stats_getSummary(&stats, 0, &summary);
+    TEST_ASSERT_EQUAL_INT32(-700, summary.temperature.min);
+    TEST_ASSERT_EQUAL_INT32(-500, summary.temperature.max);
+    TEST_ASSERT_EQUAL_INT32(-600, summary.temperature.mean);
+    TEST_ASSERT_EQUAL_UINT32(6666, summary.temperature.variance);
+}
+
+void test_saphBme280_stats_push_rounds_mean_to_nearest(void) {
+    const int32_t temperatures[] = {10, 11, -10, -11};
+    saphBme280_stats_addWindow(&stats, 2);
+    saphBme280_statsSummary_t summary;
+
+    helper_pushTemperatures(temperatures, 2);
+    saphBme280_stats_getSummary(&stats, 0, &summary);
+    TEST_ASSERT_EQUAL_INT32(11, summary.temperature.mean);
+
+    helper_pushTemperatures(&temperatures[2], 2);
+    saphBme280_stats_getSummary(&stats, 0, &summary);
+    TEST_ASSERT_EQUAL_INT32(-11, summary.temperature.mean);
+}
+
+void test_saphBme280_stats_push_returns_mask_of_completed_windows(void) {
+    saphBme280_stats_addWindow(&stats, 2);
+    saphBme280_stats_addWindow(&stats, 6);
+    const int32_t expected[] = {0, 1, 0, 1, 0, 3, 0, 1};
+    saphBmeMeasurements_t measurements = helper_measurement(100000, 2000, 40000);
+
+    for (uint8_t i = 0; i < 8; ++i) {
+        TEST_ASSERT_EQUAL_INT32(expected[i], saphBme280_stats_push(&stats, &measurements));
+    }
+}
+
+void test_saphBme280_stats_push_starts_each_window_afresh(void) {
+    const int32_t temperatures[] = {1000, 3000, 2000, 2000};
+    saphBme280_stats_addWindow(&stats, 2);
+    saphBme280_statsSummary_t summary;
+
+    helper_pushTemperatures(temperatures, 4);
+
+    saphBme280_stats_getSummary(&stats, 0, &summary);
+    TEST_ASSERT_EQUAL_INT32(2000, summary.temperature.min);
+    TEST_ASSERT_EQUAL_INT32(2000, summary.temperature.max);
+    TEST_ASSERT_EQUAL_UINT32(0, summary.temperature.variance);
+}
+
+void test_saphBme280_stats_push_cascaded_hour_matches_direct_hour(void) {
+    saphBme280_stats_t direct;
+    saphBme280_stats_init(&direct);
+    saphBme280_stats_addWindow(&direct, SAMPLES_PER_HOUR);
+    saphBme280_stats_addWindow(&stats, SAMPLES_PER_MINUTE);
+    saphBme280_stats_addWindow(&stats, SAMPLES_PER_HOUR);
+
+    for (uint32_t i = 0; i < SAMPLES_PER_HOUR; ++i) {
+        saphBmeMeasurements_t measurements = helper_randomMeasurement();
+        saphBme280_stats_push(&direct, &measurements);
+        saphBme280_stats_push(&stats, &measurements);
+    }
+
+    saphBme280_statsSummary_t expected;
+    saphBme280_statsSummary_t actual;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_getSummary(&direct, 0, &expected));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_getSummary(&stats, 1, &actual));
+    TEST_ASSERT_EQUAL_UINT32(SAMPLES_PER_HOUR, actual.count);
+    helper_assertChannelsEqual(&expected.pressure, &actual.pressure);
+    helper_assertChannelsEqual(&expected.temperature, &actual.temperature);
+    helper_assertChannelsEqual(&expected.humidity, &actual.humidity);
+}
+
+// A day at 1 Hz with pressure swinging 5000 Pa around the reference, the squares alone exceed 32 bit
+void test_saphBme280_stats_push_stays_exact_over_a_day(void) {
+    saphBme280_stats_addWindow(&stats, SAMPLES_PER_HOUR);
+    saphBme280_stats_addWindow(&stats, SAMPLES_PER_HOUR * 24);
+
+    for (uint32_t i = 0; i < SAMPLES_PER_HOUR * 24; ++i) {
+        saphBmeMeasurements_t measurements = helper_measurement(i % 2 ? 105000 : 95000, 2000, 40000);
+        saphBme280_stats_push(&stats, &measurements);
+    }
+
+    saphBme280_statsSummary_t summary;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_stats_getSummary(&stats, 1, &summary));
+    TEST_ASSERT_EQUAL_INT32(100000, summary.pressure.mean);
+    TEST_ASSERT_EQUAL_UINT32(25000000, summary.pressure.variance);
+}
+
+void test_saphBme280_stats_push_summaries_cut_upstream_bytes_by_orders_of_magnitude(void) {
+    saphBme280_stats_addWindow(&stats, SAMPLES_PER_MINUTE);
+    saphBme280_stats_addWindow(&stats, SAMPLES_PER_HOUR);
+    uint32_t rawBytes = 0;
+    uint32_t minuteSummaries = 0;
+    uint32_t hourSummaries = 0;
+
+    for (uint32_t i = 0; i < SAMPLES_PER_HOUR; ++i) {
+        saphBmeMeasurements_t measurements = helper_randomMeasurement();
+        int32_t completed = saphBme280_stats_push(&stats, &measurements);
+        rawBytes += sizeof(saphBmeMeasurements_t);
+        minuteSummaries += (completed & 1) ? 1 : 0;
+        hourSummaries += (completed & 2) ? 1 : 0;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(60, minuteSummaries);
+    TEST_ASSERT_EQUAL_UINT32(1, hourSummaries);
+    uint32_t hourBytes = hourSummaries * sizeof(saphBme280_statsSummary_t);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(100, rawBytes / hourBytes);
+    uint32_t minuteBytes = minuteSummaries * sizeof(saphBme280_statsSummary_t);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(10, rawBytes / minuteBytes);
+}
+
+// #############################################
+// # saphBme280_stats_getSummary
+// #############################################
+
+void test_saphBme280_stats_getSummary_before_first_completion_returns_no_summary(void) {
+    saphBme280_stats_addWindow(&stats, 2);
+    saphBmeMeasurements_t measurements = helper_measurement(100000, 2000, 40000);
+    saphBme280_stats_push(&stats, &measurements);
+    saphBme280_statsSummary_t summary;
+
+    TEST_ASSERT_EQUAL_INT32(NO_SUMMARY_ERROR, saphBme280_stats_getSummary(&stats, 0, &summary));
+}
+
+void test_saphBme280_stats_getSummary_unknown_window_returns_invalid_config(void) {
+    saphBme280_stats_addWindow(&stats, 2);
+    saphBme280_statsSummary_t summary;
+
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saphBme280_stats_getSummary(&stats, 1, &summary));
+}
+
+void test_saphBme280_stats_null_pointers_return_error(void) {
+    saphBmeMeasurements_t measurements = helper_measurement(100000, 2000, 40000);
+    saphBme280_statsSummary_t summary;
+    saphBme280_stats_addWindow(&stats, 2);
+
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_stats_addWindow(0, 2));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_stats_push(0, &measurements));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_stats_push(&stats, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_stats_getSummary(0, 0, &summary));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saphBme280_stats_getSummary(&stats, 0, 0));
+}
@@ -11,10 +11,18 @@
 #define ERROR_PLATFORM_GENERIC -2
 #define NULL_POINTER_ERROR -20
 #define ADDRESS_RESERVED_ERROR -30
+#define UNKNOWN_CHIP_ERROR -40
+#define UNKNOWN_PROFILE_ERROR -41
+#define VERIFY_ERROR -42
+#define NO_MEASUREMENT_ERROR -44
+
+#define CHIP_ID_BME280 0x60
+#define CHIP_ID_BMP280 0x58
 
 #define LOWEST_THREE_BITS 7
 
 #define MEASUREMENT_SIZE 8
+#define MEASUREMENT_SIZE_NO_HUMIDITY 6
 
 #define TEST_OVERSAMPLING_SKIP 0x00
 #define TEST_OVERSAMPLING_x1 0x01
@@ -45,6 +53,7 @@
 #define firstBurstReadAmount 25
 #define secondBurstReadAmount 1
 #define thirdBurstReadAmount 7
+#define pressureOnlyBurstReadAmount 24
 #define BURST_ADDR_FIRST 0x88
 
 #define LOWER_FOUR_BITS 0x0F
@@ -0,0 +1,207 @@
+#include "unity.h"
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+/* *
+ * Runs the real driver against the simulated sensor for both chip variants sharing the register map.
+ * */
+
+#define SIM_ADDRESS 0x76
+
+static sim_bme280_t simSensor;
+static saphBmeDevice_t device;
+
+static void helper_attachSensor(uint8_t chipId) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, chipId);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_attach(&simSensor, SIM_ADDRESS);
+}
+
+static void helper_assertTemperatureAndPressureTrims(saphBmeTrimmingValues_t* actual) {
+    const saphBmeTrimmingValues_t* expected = &sim_bme280_referenceTrimmingValues;
+    TEST_ASSERT_EQUAL_UINT16(expected->dig_T1, actual->dig_T1);
+    TEST_ASSERT_EQUAL_INT16(expected->dig_T2, actual->dig_T2);
+    TEST_ASSERT_EQUAL_INT16(expected->dig_T3, actual->dig_T3);
+    TEST_ASSERT_EQUAL_UINT16(expected->dig_P1, actual->dig_P1);
+    TEST_ASSERT_EQUAL_INT16(expected->dig_P2, actual->dig_P2);
+    TEST_ASSERT_EQUAL_INT16(expected->dig_P5, actual->dig_P5);
+    TEST_ASSERT_EQUAL_INT16(expected->dig_P9, actual->dig_P9);
+}
+
+// #############################################
+// # Test group BME280
+// #############################################
+
+void test_saphBme280_variants_bme280InitReadsAllTrimmingValues(void) {
+    helper_attachSensor(CHIP_ID_BME280);
+    int32_t errorCode = saphBme280_init(SIM_ADDRESS, &device);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_TRUE(saphBme280_hasHumidity(&device));
+    helper_assertTemperatureAndPressureTrims(&device.trimmingValues);
+    TEST_ASSERT_EQUAL_UINT8(sim_bme280_referenceTrimmingValues.dig_H1, device.trimmingValues.dig_H1);
+    TEST_ASSERT_EQUAL_INT16(sim_bme280_referenceTrimmingValues.dig_H2, device.trimmingValues.dig_H2);
+    TEST_ASSERT_EQUAL_INT16(sim_bme280_referenceTrimmingValues.dig_H4, device.trimmingValues.dig_H4);
+    TEST_ASSERT_EQUAL_INT16(sim_bme280_referenceTrimmingValues.dig_H5, device.trimmingValues.dig_H5);
+
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.readTransactions);
+    TEST_ASSERT_EQUAL_UINT32(1 + firstBurstReadAmount + secondBurstReadAmount + thirdBurstReadAmount,
+                             stats.bytesRead);
+}
+
+void test_saphBme280_variants_bme280MeasuresAllThreeQuantities(void) {
+    helper_attachSensor(CHIP_ID_BME280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    sim_i2c_bus_clearStats();
+
+    saphBmeMeasurements_t result = {0, 0, 0};
+    int32_t errorCode = saphBme280_getMeasurements(&device, &result);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_INT32(2189, result.temperature);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, result.humidity);
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_SIZE, sim_i2c_bus_getStats().bytesRead);
+}
+
+// #############################################
+// # Test group BMP280
+// #############################################
+
+void test_saphBme280_variants_bmp280InitSkipsHumidityTrimming(void) {
+    helper_attachSensor(CHIP_ID_BMP280);
+    int32_t errorCode = saphBme280_init(SIM_ADDRESS, &device);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_FALSE(saphBme280_hasHumidity(&device));
+    helper_assertTemperatureAndPressureTrims(&device.trimmingValues);
+
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.readTransactions);
+    TEST_ASSERT_EQUAL_UINT32(1 + pressureOnlyBurstReadAmount, stats.bytesRead);
+}
+
+void test_saphBme280_variants_bmp280ReadsShorterBurstAndReportsNoHumidity(void) {
+    helper_attachSensor(CHIP_ID_BMP280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    sim_i2c_bus_clearStats();
+
+    saphBmeMeasurements_t result = {0, 0, 0xFFFF};
+    int32_t errorCode = saphBme280_getMeasurements(&device, &result);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_INT32(2189, result.temperature);
+    TEST_ASSERT_EQUAL_UINT32(0, result.humidity);
+    TEST_ASSERT_EQUAL_UINT32(MEASUREMENT_SIZE_NO_HUMIDITY, sim_i2c_bus_getStats().bytesRead);
+}
+
+void test_saphBme280_variants_bmp280AndBme280AgreeOnPressure(void) {
+    saphBmeMeasurements_t bmeResult;
+    saphBmeMeasurements_t bmpResult;
+    helper_attachSensor(CHIP_ID_BME280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_getMeasurements(&device, &bmeResult);
+
+    helper_attachSensor(CHIP_ID_BMP280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_getMeasurements(&device, &bmpResult);
+    TEST_ASSERT_EQUAL_UINT32(bmeResult.pressure, bmpResult.pressure);
+}
+
+void test_saphBme280_variants_bmp280NeverWritesCtrlHumidity(void) {
+    helper_attachSensor(CHIP_ID_BMP280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    sim_i2c_bus_clearStats();
+
+    saphBme280_prepareCtrlHumidityReg(&device, OVERSAMPLING_x4);
+    int32_t errorCode = saphBme280_commitCtrlHumidity(&device);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT32(0, sim_i2c_bus_getStats().writeTransactions);
+}
+
+void test_saphBme280_variants_unknownChipIsRejected(void) {
+    helper_attachSensor(0x55);
+    int32_t errorCode = saphBme280_init(SIM_ADDRESS, &device);
+    TEST_ASSERT_EQUAL_INT32(UNKNOWN_CHIP_ERROR, errorCode);
+}
+
+void test_saphBme280_variants_missingSensorReportsPlatformError(void) {
+    helper_attachSensor(CHIP_ID_BME280);
+    int32_t errorCode = saphBme280_init(SIM_ADDRESS + 1, &device);
+    TEST_ASSERT_TRUE(errorCode < 0);
+}
+
+// #############################################
+// # Test group _commitAllRegs
+// #############################################
+
+void test_saphBme280_variants_commitAllRegsConfiguresSensorInOneWrite(void) {
+    helper_attachSensor(CHIP_ID_BME280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    sim_i2c_bus_clearStats();
+
+    int32_t errorCode = saphBme280_commitAllRegs(&device);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT32(1, sim_i2c_bus_getStats().writeTransactions);
+    TEST_ASSERT_EQUAL_UINT8(device.registerCtrlHumidity, simSensor.registers[0xF2]);
+    TEST_ASSERT_EQUAL_UINT8(device.registerMeasureCtrl, simSensor.registers[0xF4]);
+    TEST_ASSERT_EQUAL_UINT8(device.registerConfig, simSensor.registers[0xF5]);
+}
+
+// #############################################
+// # Test group _commitChangedRegs
+// #############################################
+
+#define AMOUNT_RECONFIGURATIONS 50
+
+static uint32_t helper_countWritesForRepeatedProfile(int32_t (*commit)(saphBmeDevice_t*)) {
+    helper_attachSensor(CHIP_ID_BME280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    sim_i2c_bus_clearStats();
+    for (uint32_t i = 0; i < AMOUNT_RECONFIGURATIONS; i++) {
+        saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+        commit(&device);
+    }
+    return sim_i2c_bus_getStats().writeTransactions;
+}
+
+void test_saphBme280_variants_commitChangedRegsAvoidsRepeatedWrites(void) {
+    uint32_t writesCommitAll = helper_countWritesForRepeatedProfile(saphBme280_commitAllRegs);
+    uint32_t writesCommitChanged = helper_countWritesForRepeatedProfile(saphBme280_commitChangedRegs);
+    TEST_ASSERT_EQUAL_UINT32(AMOUNT_RECONFIGURATIONS, writesCommitAll);
+    TEST_ASSERT_EQUAL_UINT32(1, writesCommitChanged);
+    TEST_ASSERT_EQUAL_UINT32(AMOUNT_RECONFIGURATIONS - 1, writesCommitAll - writesCommitChanged);
+    TEST_ASSERT_EQUAL_UINT8(device.registerMeasureCtrl, simSensor.registers[0xF4]);
+    TEST_ASSERT_EQUAL_UINT8(device.registerConfig, simSensor.registers[0xF5]);
+}
+
+void test_saphBme280_variants_commitChangedRegsSendsFewerBytesForSingleChange(void) {
+    helper_attachSensor(CHIP_ID_BME280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_commitAllRegs(&device);
+    sim_i2c_bus_clearStats();
+
+    saphBme280_prepareCtrlHumidityReg(&device, OVERSAMPLING_x4);
+    int32_t errorCode = saphBme280_commitChangedRegs(&device);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT32(4, sim_i2c_bus_getStats().bytesWritten);
+    TEST_ASSERT_EQUAL_UINT8(OVERSAMPLING_x4, simSensor.registers[0xF2]);
+}
+
+void test_saphBme280_variants_verifiedCommitDetectsLostConfiguration(void) {
+    helper_attachSensor(CHIP_ID_BME280);
+    saphBme280_init(SIM_ADDRESS, &device);
+    saphBme280_setVerifyCommits(&device, true);
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_INDOOR_NAVIGATION);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_commitChangedRegs(&device));
+
+    // Brown-out of the sensor alone, the driver still believes its registers are in place
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    TEST_ASSERT_EQUAL_INT32(VERIFY_ERROR, saphBme280_verifyCommittedRegs(&device));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_commitChangedRegs(&device));
+    TEST_ASSERT_EQUAL_UINT8(device.registerConfig, simSensor.registers[0xF5]);
+}
@@ -0,0 +1,184 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "saph_cycleBench.h"
+#include "test_saphBme280_test_definitions.h"
+
+#define INVALID_CONFIG_ERROR -43
+#define BUFFER_TOO_SMALL_ERROR -48
+
+// What a counter read plus the call of an empty operation costs on the fake
+#define FAKE_READ_CYCLES 7
+
+/* *
+ * Fake SysTick: counts down within 24 bits, every read costs FAKE_READ_CYCLES
+ * and an operation costs what opCycles says for its iteration.
+ * */
+static uint32_t fakeCounter;
+static uint32_t readJitter[4];
+static uint32_t reads;
+static uint32_t opCycles[8];
+
+static saph_cycleBench_t bench;
+static saph_cycleBench_result_t result;
+
+static uint32_t fake_readCounter(void) {
+    uint32_t value = fakeCounter;
+    fakeCounter = (fakeCounter - FAKE_READ_CYCLES - readJitter[reads % 4]) & SAPH_CYCLEBENCH_SYSTICK_MASK;
+    reads++;
+    return value;
+}
+
+static void fake_op(void* context, uint32_t iteration) {
+    uint32_t* calls = (uint32_t*) context;
+    (*calls)++;
+    fakeCounter = (fakeCounter - opCycles[iteration % 8]) & SAPH_CYCLEBENCH_SYSTICK_MASK;
+}
+
+void setUp(void) {
+    fakeCounter = 0x00123456;
+    reads = 0;
+    memset(readJitter, 0, sizeof(readJitter));
+    memset(opCycles, 0, sizeof(opCycles));
+    memset(&result, 0, sizeof(result));
+    saph_cycleBench_init(&bench, fake_readCounter, SAPH_CYCLEBENCH_SYSTICK_MASK, true);
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saph_cycleBench_init
+// #############################################
+
+void test_saph_cycleBench_init_rejects_masks_that_are_no_counter_period(void) {
+    saph_cycleBench_t other;
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saph_cycleBench_init(&other, fake_readCounter, 0, true));
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saph_cycleBench_init(&other, fake_readCounter, 0x00FFFFFE, true));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_cycleBench_init(&other, fake_readCounter, UINT32_MAX, false));
+}
+
+void test_saph_cycleBench_init_returns_error_on_null_pointers(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_init(0, fake_readCounter, 0xFF, true));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_init(&bench, 0, 0xFF, true));
+}
+
+// #############################################
+// # saph_cycleBench_elapsed
+// #############################################
+
+void test_saph_cycleBench_elapsed_handles_the_wrap_of_a_down_counter(void) {
+    TEST_ASSERT_EQUAL_UINT32(100, saph_cycleBench_elapsed(&bench, 0x00000500, 0x0000049C));
+    TEST_ASSERT_EQUAL_UINT32(0x15, saph_cycleBench_elapsed(&bench, 0x00000005, 0x00FFFFF0));
+}
+
+void test_saph_cycleBench_elapsed_handles_the_wrap_of_an_up_counter(void) {
+    saph_cycleBench_init(&bench, fake_readCounter, UINT32_MAX, false);
+
+    TEST_ASSERT_EQUAL_UINT32(100, saph_cycleBench_elapsed(&bench, 1000, 1100));
+    TEST_ASSERT_EQUAL_UINT32(0x20, saph_cycleBench_elapsed(&bench, 0xFFFFFFF0, 0x00000010));
+}
+
+// #############################################
+// # saph_cycleBench_calibrate
+// #############################################
+
+void test_saph_cycleBench_calibrate_takes_the_fastest_empty_iteration(void) {
+    // Only the first read of an iteration lies between the two counter values
+    readJitter[0] = 4;
+    readJitter[1] = 9;
+    readJitter[2] = 2;
+    readJitter[3] = 9;
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_cycleBench_calibrate(&bench, 16));
+
+    TEST_ASSERT_EQUAL_UINT32(FAKE_READ_CYCLES + 2, bench.overheadCycles);
+}
+
+void test_saph_cycleBench_calibrate_rejects_zero_iterations(void) {
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saph_cycleBench_calibrate(&bench, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_calibrate(0, 1));
+}
+
+// #############################################
+// # saph_cycleBench_run
+// #############################################
+
+void test_saph_cycleBench_run_reports_min_max_and_mean_without_the_overhead(void) {
+    uint32_t costs[8] = {100, 120, 100, 300, 100, 100, 110, 100};
+    memcpy(opCycles, costs, sizeof(opCycles));
+    uint32_t calls = 0;
+    saph_cycleBench_calibrate(&bench, 4);
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_cycleBench_run(&bench, "op", fake_op, &calls, 16, &result));
+
+    TEST_ASSERT_EQUAL_UINT32(16, calls);
+    TEST_ASSERT_EQUAL_UINT32(16, result.iterations);
+    TEST_ASSERT_EQUAL_UINT32(100, result.minCycles);
+    TEST_ASSERT_EQUAL_UINT32(300, result.maxCycles);
+    TEST_ASSERT_EQUAL_UINT64(2 * 1030, result.totalCycles);
+    TEST_ASSERT_EQUAL_UINT32(129, saph_cycleBench_getMeanCycles(&result));
+    TEST_ASSERT_EQUAL_STRING("op", result.name);
+}
+
+void test_saph_cycleBench_run_times_iterations_across_the_counter_wrap(void) {
+    opCycles[0] = 0x00400000;
+    fakeCounter = 0x00100000;
+    uint32_t calls = 0;
+    saph_cycleBench_calibrate(&bench, 1);
+
+    saph_cycleBench_run(&bench, "long", fake_op, &calls, 8, &result);
+
+    TEST_ASSERT_EQUAL_UINT32(0x00400000, result.maxCycles);
+    TEST_ASSERT_EQUAL_UINT32(0, result.minCycles);
+}
+
+void test_saph_cycleBench_run_never_goes_below_zero_cycles(void) {
+    readJitter[0] = 3;
+    readJitter[1] = 3;
+    readJitter[2] = 3;
+    readJitter[3] = 3;
+    saph_cycleBench_calibrate(&bench, 4);
+    readJitter[0] = 0;
+    readJitter[1] = 0;
+    readJitter[2] = 0;
+    readJitter[3] = 0;
+    uint32_t calls = 0;
+
+    saph_cycleBench_run(&bench, "faster than empty", fake_op, &calls, 4, &result);
+
+    TEST_ASSERT_EQUAL_UINT32(0, result.maxCycles);
+    TEST_ASSERT_EQUAL_UINT64(0, result.totalCycles);
+}
+
+void test_saph_cycleBench_run_rejects_zero_iterations_and_null_pointers(void) {
+    uint32_t calls = 0;
+    TEST_ASSERT_EQUAL_INT32(INVALID_CONFIG_ERROR, saph_cycleBench_run(&bench, "op", fake_op, &calls, 0, &result));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_run(&bench, 0, fake_op, &calls, 1, &result));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_run(&bench, "op", 0, &calls, 1, &result));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_run(&bench, "op", fake_op, &calls, 1, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, calls);
+}
+
+// #############################################
+// # saph_cycleBench_formatResult
+// #############################################
+
+void test_saph_cycleBench_formatResult_writes_one_json_line(void) {
+    saph_cycleBench_result_t formatted = {"compensate", 1000, 812, 1104, 830000};
+    char line[128];
+
+    int32_t length = saph_cycleBench_formatResult(&formatted, 9, line, sizeof(line));
+
+    TEST_ASSERT_EQUAL_STRING(
+            "{\"name\":\"compensate\",\"iterations\":1000,\"min\":812,\"mean\":830,\"max\":1104,\"overhead\":9}", line);
+    TEST_ASSERT_EQUAL_INT32(strlen(line), length);
+}
+
+void test_saph_cycleBench_formatResult_reports_a_buffer_that_is_too_small(void) {
+    saph_cycleBench_result_t formatted = {"compensate", 1000, 812, 1104, 830000};
+    char line[32];
+
+    TEST_ASSERT_EQUAL_INT32(BUFFER_TOO_SMALL_ERROR, saph_cycleBench_formatResult(&formatted, 9, line, sizeof(line)));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_cycleBench_formatResult(0, 9, line, sizeof(line)));
+}
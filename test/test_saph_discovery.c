@@ -0,0 +1,174 @@
+#include <string.h>
+#include "unity.h"
+
+#include "saph_discovery.h"
+#include "mock_saphBme280.h"
+#include "mock_saph_ssd1306.h"
+
+#define NO_ERROR 0
+#define READ_ERROR -12
+#define ERROR_PLATFORM_GENERIC -2
+#define NULL_POINTER_ERROR -20
+
+#define KIND_NONE 0
+#define KIND_BME280 1
+#define KIND_BMP280 2
+#define KIND_SSD1306 3
+
+#define DISPLAY_ADDR_FIRST 0x3C
+#define DISPLAY_ADDR_SECOND 0x3D
+#define SENSOR_ADDR_FIRST 0x76
+#define SENSOR_ADDR_SECOND 0x77
+
+static saph_discovery_registry_t registry;
+
+void setUp(void) {
+    saph_discovery_init(&registry);
+}
+
+static void helper_expectNoDisplayAt(uint8_t address, uint8_t slot) {
+    saph_ssd1306_init_Expect(address, &registry.ssd1306[slot]);
+    saph_ssd1306_status_ExpectAnyArgsAndReturn(ERROR_PLATFORM_GENERIC);
+}
+
+static void helper_expectDisplayAt(uint8_t address, uint8_t slot) {
+    saph_ssd1306_init_Expect(address, &registry.ssd1306[slot]);
+    saph_ssd1306_status_ExpectAnyArgsAndReturn(NO_ERROR);
+}
+
+// CMock only keeps the pointer, so every probed address needs its own expected device
+static saphBmeDevice_t expectedProbeDevices[2];
+
+static void helper_expectSensorIdAt(uint8_t address, int32_t idOrError) {
+    saphBmeDevice_t* probeDevice = &expectedProbeDevices[address - SENSOR_ADDR_FIRST];
+    memset(probeDevice, 0, sizeof(saphBmeDevice_t));
+    probeDevice->address = address;
+    saphBme280_getId_ExpectAndReturn(probeDevice, idOrError);
+}
+
+static void helper_skipDisplayCandidates(void) {
+    helper_expectNoDisplayAt(DISPLAY_ADDR_FIRST, 0);
+    helper_expectNoDisplayAt(DISPLAY_ADDR_SECOND, 0);
+    saph_discovery_step(&registry);
+    saph_discovery_step(&registry);
+}
+
+// #############################################
+// # Test group _init
+// #############################################
+
+void test_saph_discovery_init_startsWithAnEmptyRegistry(void) {
+    registry.amountBme280 = 2;
+    registry.nextCandidate = 3;
+    saph_discovery_init(&registry);
+    TEST_ASSERT_EQUAL_UINT8(0, registry.amountBme280);
+    TEST_ASSERT_EQUAL_UINT8(0, registry.amountSsd1306);
+    TEST_ASSERT_FALSE(saph_discovery_isDone(&registry));
+}
+
+// #############################################
+// # Test group _step
+// #############################################
+
+void test_saph_discovery_step_returnsErrorIfRegistryIsNull(void) {
+    int32_t errorCode = saph_discovery_step((saph_discovery_registry_t*) 0);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+void test_saph_discovery_step_bindsDisplayAnsweringStatusRead(void) {
+    helper_expectDisplayAt(DISPLAY_ADDR_FIRST, 0);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_SSD1306, kind);
+    TEST_ASSERT_EQUAL_UINT8(1, registry.amountSsd1306);
+    TEST_ASSERT_EQUAL_PTR(&registry.ssd1306[0], saph_discovery_getSsd1306(&registry, 0));
+}
+
+void test_saph_discovery_step_skipsSilentDisplayAddress(void) {
+    helper_expectNoDisplayAt(DISPLAY_ADDR_FIRST, 0);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_NONE, kind);
+    TEST_ASSERT_EQUAL_UINT8(0, registry.amountSsd1306);
+    TEST_ASSERT_NULL(saph_discovery_getSsd1306(&registry, 0));
+}
+
+void test_saph_discovery_step_bindsBme280ById(void) {
+    helper_skipDisplayCandidates();
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, 0x60);
+    saphBme280_init_ExpectAndReturn(SENSOR_ADDR_FIRST, &registry.bme280[0].device, NO_ERROR);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_BME280, kind);
+    TEST_ASSERT_EQUAL_UINT8(1, registry.amountBme280);
+    TEST_ASSERT_EQUAL_UINT8(KIND_BME280, registry.bme280[0].kind);
+    TEST_ASSERT_EQUAL_PTR(&registry.bme280[0].device, saph_discovery_getBme280(&registry, 0));
+}
+
+void test_saph_discovery_step_bindsBmp280ById(void) {
+    helper_skipDisplayCandidates();
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, 0x58);
+    saphBme280_init_ExpectAndReturn(SENSOR_ADDR_FIRST, &registry.bme280[0].device, NO_ERROR);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_BMP280, kind);
+    TEST_ASSERT_EQUAL_UINT8(KIND_BMP280, registry.bme280[0].kind);
+}
+
+void test_saph_discovery_step_ignoresUnknownChipId(void) {
+    helper_skipDisplayCandidates();
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, 0x55);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_NONE, kind);
+    TEST_ASSERT_EQUAL_UINT8(0, registry.amountBme280);
+}
+
+void test_saph_discovery_step_ignoresSensorAddressWithoutResponse(void) {
+    helper_skipDisplayCandidates();
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, ERROR_PLATFORM_GENERIC);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_NONE, kind);
+    TEST_ASSERT_EQUAL_UINT8(0, registry.amountBme280);
+}
+
+void test_saph_discovery_step_doesNotRegisterSensorIfInitFails(void) {
+    helper_skipDisplayCandidates();
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, 0x60);
+    saphBme280_init_ExpectAnyArgsAndReturn(READ_ERROR);
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_NONE, kind);
+    TEST_ASSERT_EQUAL_UINT8(0, registry.amountBme280);
+    TEST_ASSERT_NULL(saph_discovery_getBme280(&registry, 0));
+}
+
+// #############################################
+// # Test group _probeAll
+// #############################################
+
+void test_saph_discovery_probeAll_bindsMixedHardwareInBusOrder(void) {
+    helper_expectNoDisplayAt(DISPLAY_ADDR_FIRST, 0);
+    helper_expectDisplayAt(DISPLAY_ADDR_SECOND, 0);
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, 0x58);
+    saphBme280_init_ExpectAndReturn(SENSOR_ADDR_FIRST, &registry.bme280[0].device, NO_ERROR);
+    helper_expectSensorIdAt(SENSOR_ADDR_SECOND, 0x60);
+    saphBme280_init_ExpectAndReturn(SENSOR_ADDR_SECOND, &registry.bme280[1].device, NO_ERROR);
+
+    int32_t amountBound = saph_discovery_probeAll(&registry);
+    TEST_ASSERT_EQUAL_INT32(3, amountBound);
+    TEST_ASSERT_TRUE(saph_discovery_isDone(&registry));
+    TEST_ASSERT_EQUAL_UINT8(KIND_BMP280, registry.bme280[0].kind);
+    TEST_ASSERT_EQUAL_UINT8(KIND_BME280, registry.bme280[1].kind);
+    TEST_ASSERT_EQUAL_UINT8(1, registry.amountSsd1306);
+}
+
+void test_saph_discovery_step_doesNothingOnceDone(void) {
+    helper_expectNoDisplayAt(DISPLAY_ADDR_FIRST, 0);
+    helper_expectNoDisplayAt(DISPLAY_ADDR_SECOND, 0);
+    helper_expectSensorIdAt(SENSOR_ADDR_FIRST, ERROR_PLATFORM_GENERIC);
+    helper_expectSensorIdAt(SENSOR_ADDR_SECOND, ERROR_PLATFORM_GENERIC);
+    saph_discovery_probeAll(&registry);
+
+    int32_t kind = saph_discovery_step(&registry);
+    TEST_ASSERT_EQUAL_INT32(KIND_NONE, kind);
+}
+
+void test_saph_discovery_probeAll_returnsErrorIfRegistryIsNull(void) {
+    int32_t errorCode = saph_discovery_probeAll((saph_discovery_registry_t*) 0);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
@@ -0,0 +1,244 @@
+#include "unity.h"
+
+#include "saph_dutyCycle.h"
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+/* *
+ * Runs the duty cycle against the simulated sensor and a display that only remembers whether it is lit,
+ * with a simulated clock that jumps straight to each requested wakeup.
+ * */
+
+#define SIM_SENSOR_ADDRESS 0x76
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define SIM_MEASUREMENT_TIME_US 7600
+#define ONE_MINUTE_US 60000000u
+#define ONE_HOUR_US 3600000000u
+#define DISPLAY_ON_US 5000000u
+// Close to the wrap of the 32 bit microsecond clock
+#define START_TIME_US 0xFFF00000u
+
+typedef struct simDisplay_t {
+    bool lit;
+    uint32_t commands;
+} simDisplay_t;
+
+static sim_bme280_t simSensor;
+static simDisplay_t simDisplay;
+static saphBmeDevice_t sensor;
+static saph_ssd1306_device_t display;
+static saph_dutyCycle_t cycle;
+static saph_dutyCycle_config_t config;
+static uint32_t nowUs;
+
+// Control byte followed by the command, 0xAE and 0xAF switch the panel
+static int32_t helper_onDisplayWrite(void* context, const uint8_t* buffer, uint32_t amount) {
+    simDisplay_t* sim = (simDisplay_t*) context;
+    sim->commands++;
+    if (amount == 2 && (buffer[1] == 0xAE || buffer[1] == 0xAF)) {
+        sim->lit = buffer[1] == 0xAF;
+    }
+    return (int32_t) amount;
+}
+
+static int32_t helper_onDisplayRead(void* context, uint8_t* buffer, uint32_t amount) {
+    (void) context;
+    buffer[0] = 0;
+    return (int32_t) amount;
+}
+
+static void helper_start(uint32_t intervalUs, uint32_t displayOnUs, uint8_t mcuSleepMode) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    simSensor.temperatureStep = 1000;
+    sim_bme280_setTiming(&simSensor, SIM_MEASUREMENT_TIME_US, 0);
+    sim_bme280_attach(&simSensor, SIM_SENSOR_ADDRESS);
+    simDisplay.lit = true;
+    simDisplay.commands = 0;
+    sim_i2c_bus_attach(SIM_DISPLAY_ADDRESS, &simDisplay, helper_onDisplayWrite, helper_onDisplayRead);
+
+    saphBme280_init(SIM_SENSOR_ADDRESS, &sensor);
+    saphBme280_prepareProfile(&sensor, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    saphBme280_commitAllRegs(&sensor);
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+
+    config.intervalUs = intervalUs;
+    config.displayOnUs = displayOnUs;
+    config.mcuSleepMode = mcuSleepMode;
+    nowUs = START_TIME_US;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_dutyCycle_init(&cycle, &sensor, &display, &config, nowUs));
+}
+
+static void helper_sleepUntil(uint32_t wakeUs) {
+    sim_bme280_advanceTime(&simSensor, wakeUs - nowUs);
+    nowUs = wakeUs;
+}
+
+// Sleeps until each requested wakeup like the firmware would, returns the amount of samples.
+// Counts from the start since an hour is longer than the signed half of the 32 bit clock
+static uint32_t helper_run(uint32_t durationUs) {
+    uint32_t startUs = nowUs;
+    uint32_t samples = 0;
+    while ((uint32_t) (cycle.nextWakeUs - startUs) < durationUs) {
+        helper_sleepUntil(cycle.nextWakeUs);
+        saphBmeMeasurements_t result;
+        int32_t outcome = saph_dutyCycle_step(&cycle, nowUs, &result);
+        TEST_ASSERT_TRUE(outcome >= 0);
+        samples += outcome == SAPH_DUTYCYCLE_SAMPLE_READY ? 1 : 0;
+    }
+    return samples;
+}
+
+static uint8_t helper_getSimMode(void) {
+    return simSensor.registers[0xF4] & 0x03;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// #############################################
+// # saph_dutyCycle_init
+// #############################################
+
+void test_saph_dutyCycle_init_puts_display_to_sleep(void) {
+    helper_start(ONE_MINUTE_US, DISPLAY_ON_US, SAPH_DUTYCYCLE_MCU_DORMANT);
+
+    TEST_ASSERT_FALSE(simDisplay.lit);
+    TEST_ASSERT_EQUAL_UINT32(nowUs, cycle.nextWakeUs);
+}
+
+void test_saph_dutyCycle_init_rejects_interval_shorter_than_a_conversion(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_SLEEP);
+    config.intervalUs = saphBme280_getMeasurementTimeUs(&sensor);
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_DUTYCYCLE_INVALID_CONFIG_ERROR,
+                            saph_dutyCycle_init(&cycle, &sensor, &display, &config, nowUs));
+}
+
+// #############################################
+// # saph_dutyCycle_step
+// #############################################
+
+void test_saph_dutyCycle_step_triggers_forced_measurement_and_wakes_when_done(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_SLEEP);
+    saphBmeMeasurements_t result;
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_DUTYCYCLE_NO_SAMPLE, saph_dutyCycle_step(&cycle, nowUs, &result));
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_MODE_FORCED, helper_getSimMode());
+    TEST_ASSERT_EQUAL_UINT32(nowUs + saphBme280_getMeasurementTimeUs(&sensor), cycle.nextWakeUs);
+
+    helper_sleepUntil(cycle.nextWakeUs);
+    TEST_ASSERT_EQUAL_INT32(SAPH_DUTYCYCLE_SAMPLE_READY, saph_dutyCycle_step(&cycle, nowUs, &result));
+    TEST_ASSERT_EQUAL_UINT32(1, simSensor.conversions);
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_MODE_SLEEP, helper_getSimMode());
+}
+
+void test_saph_dutyCycle_step_samples_once_per_interval_and_sleeps_in_between(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_DORMANT);
+
+    uint32_t samples = helper_run(ONE_HOUR_US);
+
+    TEST_ASSERT_EQUAL_UINT32(60, samples);
+    TEST_ASSERT_EQUAL_UINT32(60, simSensor.conversions);
+    // One wakeup to trigger and one to read each sample
+    TEST_ASSERT_EQUAL_UINT32(120, cycle.wakeups);
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_MODE_SLEEP, helper_getSimMode());
+}
+
+void test_saph_dutyCycle_step_hands_out_fresh_conversions(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_SLEEP);
+    saphBmeMeasurements_t first;
+    saphBmeMeasurements_t second;
+
+    saph_dutyCycle_step(&cycle, nowUs, &first);
+    helper_sleepUntil(cycle.nextWakeUs);
+    saph_dutyCycle_step(&cycle, nowUs, &first);
+    helper_sleepUntil(cycle.nextWakeUs);
+    saph_dutyCycle_step(&cycle, nowUs, &second);
+    helper_sleepUntil(cycle.nextWakeUs);
+    saph_dutyCycle_step(&cycle, nowUs, &second);
+
+    TEST_ASSERT_GREATER_THAN_INT32(first.temperature, second.temperature);
+}
+
+void test_saph_dutyCycle_step_lights_display_after_sample_and_blanks_it_when_idle(void) {
+    helper_start(ONE_MINUTE_US, DISPLAY_ON_US, SAPH_DUTYCYCLE_MCU_DORMANT);
+    saphBmeMeasurements_t result;
+    saph_dutyCycle_step(&cycle, nowUs, &result);
+    helper_sleepUntil(cycle.nextWakeUs);
+
+    saph_dutyCycle_step(&cycle, nowUs, &result);
+    TEST_ASSERT_TRUE(simDisplay.lit);
+    TEST_ASSERT_EQUAL_UINT32(nowUs + DISPLAY_ON_US, cycle.nextWakeUs);
+
+    helper_sleepUntil(cycle.nextWakeUs);
+    TEST_ASSERT_EQUAL_INT32(SAPH_DUTYCYCLE_NO_SAMPLE, saph_dutyCycle_step(&cycle, nowUs, &result));
+    TEST_ASSERT_FALSE(simDisplay.lit);
+}
+
+void test_saph_dutyCycle_step_after_stall_does_not_catch_up_missed_samples(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_SLEEP);
+    saphBmeMeasurements_t result;
+    saph_dutyCycle_step(&cycle, nowUs, &result);
+    helper_sleepUntil(cycle.nextWakeUs);
+    saph_dutyCycle_step(&cycle, nowUs, &result);
+
+    helper_sleepUntil(nowUs + 5 * ONE_MINUTE_US);
+    saph_dutyCycle_step(&cycle, nowUs, &result);
+
+    TEST_ASSERT_EQUAL_UINT8(SAPH_DUTYCYCLE_STATE_MEASURING, cycle.state);
+    TEST_ASSERT_EQUAL_UINT32(nowUs + ONE_MINUTE_US, cycle.nextSampleUs);
+}
+
+void test_saph_dutyCycle_step_returns_error_if_null(void) {
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(SAPH_DUTYCYCLE_NULL_POINTER_ERROR, saph_dutyCycle_step(0, 0, &result));
+    TEST_ASSERT_EQUAL_INT32(SAPH_DUTYCYCLE_NULL_POINTER_ERROR, saph_dutyCycle_step(&cycle, 0, 0));
+}
+
+// #############################################
+// # Energy accounting
+// #############################################
+
+// Datasheet chapter 3.5.1 gives 0.16 uA for weather monitoring at one sample per minute
+void test_saph_dutyCycle_sensor_charge_matches_datasheet_average(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_DORMANT);
+
+    helper_run(ONE_HOUR_US);
+
+    uint32_t averageSensorCurrentNa = (uint32_t) (cycle.charge.sensor / (nowUs - START_TIME_US));
+    TEST_ASSERT_UINT32_WITHIN(5, 160, averageSensorCurrentNa);
+}
+
+void test_saph_dutyCycle_charge_per_sample_is_dominated_by_the_sleeping_mcu(void) {
+    helper_start(ONE_MINUTE_US, 0, SAPH_DUTYCYCLE_MCU_DORMANT);
+
+    helper_run(ONE_HOUR_US);
+
+    // About 60 s at 180 uA and 10 uA for the dark display plus two 2 ms wakeups at 20 mA,
+    // booked up to the read of the last sample, so 59 of the 60 intervals end up spread over 60 samples
+    uint32_t chargePerSample = saph_dutyCycle_getChargePerSample(&cycle);
+    TEST_ASSERT_UINT32_WITHIN(50000, 11300000, chargePerSample);
+    TEST_ASSERT_GREATER_THAN_UINT64(cycle.charge.sensor * 1000, cycle.charge.mcu);
+}
+
+void test_saph_dutyCycle_uses_a_fraction_of_the_always_on_loop(void) {
+    helper_start(ONE_MINUTE_US, DISPLAY_ON_US, SAPH_DUTYCYCLE_MCU_DORMANT);
+
+    helper_run(ONE_HOUR_US);
+
+    // Normal mode with 1 s standby, the display lit and the MCU awake in sleep_ms
+    saphBme280_prepareMeasureCtrlReg(&sensor, OVERSAMPLING_x1, OVERSAMPLING_x1, SENSOR_MODE_NORMAL);
+    uint64_t alwaysOnPerMinute = 60 * saphBme280_getMeasurementCharge(&sensor) +
+                                 (uint64_t) ONE_MINUTE_US * (SAPH_DUTYCYCLE_DISPLAY_ON_NA + SAPH_DUTYCYCLE_MCU_ACTIVE_NA);
+    uint64_t dutyCycledPerMinute = (uint64_t) saph_dutyCycle_getChargePerSample(&cycle) * 1000000u;
+    TEST_ASSERT_GREATER_THAN_UINT64(dutyCycledPerMinute * 20, alwaysOnPerMinute);
+}
@@ -0,0 +1,99 @@
+#include "unity.h"
+
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "test_saphBme280_test_definitions.h"
+
+#include "sim_hal.h"
+#include "sim_i2c_bus.h"
+#include "sim_bme280.h"
+
+/* *
+ * The simulated backend of saph_hal.h: delays pass bus time and let the sensor model convert, so code that waits
+ * through the HAL runs against the simulated BME280 the way it does against the real one.
+ * */
+
+#define SIM_ADDRESS 0x76
+#define SIM_MEASUREMENT_TIME_US 7600
+
+static sim_bme280_t simSensor;
+static saphBmeDevice_t device;
+static uint32_t delayedUs;
+
+static void helper_advanceSensor(void* context, uint32_t delayUs) {
+    delayedUs += delayUs;
+    sim_bme280_advanceTime((sim_bme280_t*) context, delayUs);
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_bme280_init(&simSensor, CHIP_ID_BME280);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_setTiming(&simSensor, SIM_MEASUREMENT_TIME_US, 0);
+    sim_bme280_attach(&simSensor, SIM_ADDRESS);
+    sim_hal_setDelayHandler(helper_advanceSensor, &simSensor);
+    delayedUs = 0;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_init(SIM_ADDRESS, &device));
+    saphBme280_prepareProfile(&device, SAPHBME280_PROFILE_WEATHER_MONITORING);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_commitAllRegs(&device));
+}
+
+void tearDown(void) {
+    sim_hal_setDelayHandler(0, 0);
+}
+
+// #############################################
+// # saph_hal_getTimeUs, saph_hal_delayUs and saph_hal_sleepUs
+// #############################################
+
+void test_saph_hal_sim_timeIsTheBusTime(void) {
+    uint8_t chipId = 0;
+    uint32_t startUs = saph_hal_getTimeUs();
+    saphBme280_internal_readFromRegister(&device, 0xD0, &chipId, 1);
+    TEST_ASSERT_EQUAL_UINT32(sim_i2c_bus_getTimeUs(), saph_hal_getTimeUs());
+    TEST_ASSERT_GREATER_THAN_UINT32(startUs, saph_hal_getTimeUs());
+}
+
+void test_saph_hal_sim_delayPassesIdleBusTime(void) {
+    uint32_t startUs = saph_hal_getTimeUs();
+    sim_i2c_bus_stats_t before = sim_i2c_bus_getStats();
+    saph_hal_delayUs(1000);
+    TEST_ASSERT_EQUAL_UINT32(startUs + 1000, saph_hal_getTimeUs());
+    TEST_ASSERT_EQUAL_UINT32(1000, delayedUs);
+    TEST_ASSERT_EQUAL_UINT32(before.writeTransactions, sim_i2c_bus_getStats().writeTransactions);
+}
+
+void test_saph_hal_sim_delayWithoutHandlerOnlyMovesTheTime(void) {
+    sim_hal_setDelayHandler(0, 0);
+    uint32_t startUs = saph_hal_getTimeUs();
+    saph_hal_delayUs(250);
+    TEST_ASSERT_EQUAL_UINT32(startUs + 250, saph_hal_getTimeUs());
+    TEST_ASSERT_EQUAL_UINT32(0, delayedUs);
+}
+
+void test_saph_hal_sim_sleepPassesIdleBusTimeLikeADelay(void) {
+    uint32_t startUs = saph_hal_getTimeUs();
+    saph_hal_sleepUs(1500);
+    TEST_ASSERT_EQUAL_UINT32(startUs + 1500, saph_hal_getTimeUs());
+    TEST_ASSERT_EQUAL_UINT32(1500, delayedUs);
+}
+
+// #############################################
+// # Forced measurement waited for through the HAL
+// #############################################
+
+void test_saph_hal_sim_forcedMeasurementIsThereAfterTheMeasurementTime(void) {
+    saphBmeMeasurements_t result;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_triggerForcedMeasurement(&device));
+    saph_hal_delayUs(saphBme280_getMeasurementTimeUs(&device));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&device, &result));
+    TEST_ASSERT_EQUAL_UINT32(1, simSensor.conversions);
+}
+
+void test_saph_hal_sim_forcedMeasurementFinishesOnlyAfterTheWholeMeasurementTime(void) {
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_triggerForcedMeasurement(&device));
+    saph_hal_delayUs(SIM_MEASUREMENT_TIME_US / 2);
+    TEST_ASSERT_EQUAL_UINT32(0, simSensor.conversions);
+    saph_hal_delayUs(SIM_MEASUREMENT_TIME_US / 2);
+    TEST_ASSERT_EQUAL_UINT32(1, simSensor.conversions);
+}
@@ -52,6 +52,35 @@ void test_saph_ssd1306_contrast_returnsErrorOnFailedWrite(void) {
     TEST_ASSERT_EQUAL_INT32(WRITE_ERROR, errorCode);
 }
 
+// #############################################
+// # Test group _status
+// #############################################
+
+void test_saph_ssd1306_status_returnsStatusByteThroughPointer(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t status = 0;
+    saph_ssd1306_internal_readStatus_ExpectAndReturn(&testDevice, &status, NO_ERROR);
+    uint8_t response = 0x43;
+    saph_ssd1306_internal_readStatus_ReturnThruPtr_buffer(&response);
+    int32_t errorCode = saph_ssd1306_status(&testDevice, &status);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT8(response, status);
+}
+
+void test_saph_ssd1306_status_returnsErrorOnDeviceNullPointer(void) {
+    uint8_t status = 0;
+    int32_t errorCode = saph_ssd1306_status((saph_ssd1306_device_t*) 0, &status);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_status_returnsErrorOnFailedRead(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t status = 0;
+    saph_ssd1306_internal_readStatus_ExpectAnyArgsAndReturn(READ_ERROR);
+    int32_t errorCode = saph_ssd1306_status(&testDevice, &status);
+    TEST_ASSERT_EQUAL_INT32(READ_ERROR, errorCode);
+}
+
 // #############################################
 // # Test group _displayOn
 // #############################################
@@ -90,6 +119,191 @@ void test_saph_ssd1306_displayOn_returnsErrorOnFailedWrite(void) {
 }
 
 // #############################################
-// # Test group _displayOn
+// # Test group _displaySleep
+// #############################################
+
+void test_saph_ssd1306_displaySleep_turnsPanelOff(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0xAE};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 1, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_displaySleep(&testDevice, true);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_displaySleep_wakesPanelUp(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0xAF};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 1, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_displaySleep(&testDevice, false);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_displaySleep_returnsErrorOnDeviceNullPointer(void) {
+    int32_t errorCode = saph_ssd1306_displaySleep(0, true);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _configurePanel
+// #############################################
+
+void test_saph_ssd1306_configurePanel_setsMultiplexRatioAndComPinsOfTheBuild(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0xA8, SAPH_SSD1306_HEIGHT - 1, 0xDA, SAPH_SSD1306_COM_PINS_CONFIG};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 4, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_configurePanel(&testDevice);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_configurePanel_returnsErrorOnDeviceNullPointer(void) {
+    int32_t errorCode = saph_ssd1306_configurePanel(0);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _setAddressWindow
+// #############################################
+
+void test_saph_ssd1306_setAddressWindow_setsHorizontalModeColumnsAndPages(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0x20, 0x00, 0x21, 127, 127, 0x22, 2, 5};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 8, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_setAddressWindow(&testDevice, 127, 127, 2, 5);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_setAddressWindow_rejectsWindowOutsideDisplay(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_setAddressWindow(&testDevice, 0, 128, 0, 7));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_setAddressWindow(&testDevice, 0, 127, 0, 8));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_setAddressWindow(&testDevice, 5, 4, 0, 7));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_setAddressWindow(&testDevice, 0, 127, 3, 2));
+}
+
+void test_saph_ssd1306_encodeAddressWindow_writesTheCommandOfSetAddressWindow(void) {
+    uint8_t command[SAPH_SSD1306_ADDRESS_WINDOW_SIZE];
+    uint8_t expectedBuffer[] = {0x20, 0x00, 0x21, 10, 20, 0x22, 1, 3};
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_encodeAddressWindow(command, 10, 20, 1, 3));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expectedBuffer, command, SAPH_SSD1306_ADDRESS_WINDOW_SIZE);
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_encodeAddressWindow(command, 0, 128, 0, 7));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_encodeAddressWindow(0, 0, 127, 0, 7));
+}
+
+void test_saph_ssd1306_setAddressWindow_returnsErrorOnDeviceNullPointer(void) {
+    int32_t errorCode = saph_ssd1306_setAddressWindow(0, 0, 127, 0, 7);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
 // #############################################
+// # Test group _writeData
+// #############################################
+
+void test_saph_ssd1306_writeData_passesBytesOnAsData(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t data[] = {0x01, 0x80, 0xFF};
+    saph_ssd1306_internal_sendData_ExpectAndReturn(&testDevice, data, 3, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_writeData(&testDevice, data, 3);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_writeData_returnsErrorOnFailedWrite(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t data[] = {0x01};
+    saph_ssd1306_internal_sendData_ExpectAnyArgsAndReturn(WRITE_ERROR);
+    int32_t errorCode = saph_ssd1306_writeData(&testDevice, data, 1);
+    TEST_ASSERT_EQUAL_INT32(WRITE_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _scrollHorizontal
+// #############################################
+
+void test_saph_ssd1306_scrollHorizontal_setsUpRightScroll(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0x26, 0x00, 0, SAPH_SSD1306_SCROLL_FRAMES_2, 7, 0x00, 0xFF};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 7, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_scrollHorizontal(&testDevice, SAPH_SSD1306_SCROLL_RIGHT, 0, 7,
+                                                      SAPH_SSD1306_SCROLL_FRAMES_2);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_scrollHorizontal_setsUpLeftScroll(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0x27, 0x00, 4, SAPH_SSD1306_SCROLL_FRAMES_25, 6, 0x00, 0xFF};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 7, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_scrollHorizontal(&testDevice, SAPH_SSD1306_SCROLL_LEFT, 4, 6,
+                                                      SAPH_SSD1306_SCROLL_FRAMES_25);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_scrollHorizontal_rejectsInvalidPagesAndInterval(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_scrollHorizontal(&testDevice, SAPH_SSD1306_SCROLL_LEFT, 5, 4, 0));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_scrollHorizontal(&testDevice, SAPH_SSD1306_SCROLL_LEFT, 0, 8, 0));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_scrollHorizontal(&testDevice, SAPH_SSD1306_SCROLL_LEFT, 0, 7, 8));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_scrollHorizontal(&testDevice, 2, 0, 7, 0));
+}
+
+void test_saph_ssd1306_scrollHorizontal_returnsErrorOnDeviceNullPointer(void) {
+    int32_t errorCode = saph_ssd1306_scrollHorizontal(0, SAPH_SSD1306_SCROLL_LEFT, 0, 7, 0);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _scrollVerticalHorizontal
+// #############################################
+
+void test_saph_ssd1306_scrollVerticalHorizontal_setsUpScrollWithOffset(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0x2A, 0x00, 0, SAPH_SSD1306_SCROLL_FRAMES_5, 7, 1};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 6, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_scrollVerticalHorizontal(&testDevice, SAPH_SSD1306_SCROLL_LEFT, 0, 7,
+                                                              SAPH_SSD1306_SCROLL_FRAMES_5, 1);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_scrollVerticalHorizontal_rejectsOffsetBeyondHeight(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    int32_t errorCode = saph_ssd1306_scrollVerticalHorizontal(&testDevice, SAPH_SSD1306_SCROLL_RIGHT, 0, 7, 0, 64);
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, errorCode);
+}
 
+// #############################################
+// # Test group _setVerticalScrollArea
+// #############################################
+
+void test_saph_ssd1306_setVerticalScrollArea_sendsFixedAndScrollingRows(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedBuffer[] = {0xA3, 16, 48};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedBuffer, 3, NO_ERROR);
+    int32_t errorCode = saph_ssd1306_setVerticalScrollArea(&testDevice, 16, 48);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_setVerticalScrollArea_rejectsAreaBeyondHeight(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    int32_t errorCode = saph_ssd1306_setVerticalScrollArea(&testDevice, 16, 49);
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _scrollActivate
+// #############################################
+
+void test_saph_ssd1306_scrollActivate_startsAndStopsScrolling(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t expectedStart[] = {0x2F};
+    uint8_t expectedStop[] = {0x2E};
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedStart, 1, NO_ERROR);
+    saph_ssd1306_internal_sendCtrlCommand_ExpectAndReturn(&testDevice, expectedStop, 1, NO_ERROR);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_scrollActivate(&testDevice, true));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_scrollActivate(&testDevice, false));
+}
+
+void test_saph_ssd1306_scrollActivate_returnsErrorOnDeviceNullPointer(void) {
+    int32_t errorCode = saph_ssd1306_scrollActivate(0, true);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
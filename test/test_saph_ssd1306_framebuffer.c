@@ -0,0 +1,407 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "saph_ssd1306_framebuffer.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "i2c_arbiter.h"
+#include "saphBme280.h"
+#include "saphBme280_internal.h"
+#include "test_saph_ssd1306_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_ssd1306.h"
+#include "sim_bme280.h"
+
+/* *
+ * Flushes into the simulated SSD1306 with the simulated BME280 on the same bus.
+ * Bus time is estimated from the traffic: 9 clocks per byte including the acknowledge and one address byte
+ * per transfer, 90 us per byte at 100 kHz.
+ * */
+
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define SIM_SENSOR_ADDRESS 0x76
+#define SIM_SENSOR_CHIP_ID 0x60
+#define BUS_US_PER_BYTE 90u
+// Address window command with its control byte
+#define WINDOW_BYTES 9
+
+static sim_ssd1306_t simDisplay;
+static sim_bme280_t simSensor;
+static saph_ssd1306_device_t display;
+static saphBmeDevice_t sensor;
+static saph_ssd1306_framebuffer_t framebuffer;
+static i2c_arbiter_t arbiter;
+
+static uint32_t helper_getBusUs(sim_i2c_bus_stats_t before, sim_i2c_bus_stats_t after) {
+    uint32_t transfers = (after.writeTransactions - before.writeTransactions) +
+                         (after.readTransactions - before.readTransactions);
+    uint32_t bytes = (after.bytesWritten - before.bytesWritten) + (after.bytesRead - before.bytesRead);
+    return (transfers + bytes) * BUS_US_PER_BYTE;
+}
+
+// Flushes to the end, returns the amount of steps
+static uint32_t helper_flush(void) {
+    uint32_t steps = 0;
+    int32_t outcome = SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+    while (outcome == SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING) {
+        outcome = saph_ssd1306_framebuffer_flushStep(&framebuffer);
+        TEST_ASSERT_TRUE(outcome >= 0);
+        steps++;
+    }
+    return steps;
+}
+
+static void helper_assertPanelShows(const uint8_t* frame) {
+    for (uint8_t page = 0; page < SAPH_SSD1306_PAGES; ++page) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(frame + page * SAPH_SSD1306_WIDTH, simDisplay.ram[page], SAPH_SSD1306_WIDTH);
+    }
+}
+
+// A line of text worth of changes, one page high
+static void helper_drawBlock(uint8_t x, uint8_t page, uint8_t width) {
+    uint8_t* back = saph_ssd1306_framebuffer_getBack(&framebuffer);
+    memset(back + page * SAPH_SSD1306_WIDTH + x, 0x5A, width);
+}
+
+// Sensor read the way the acquisition loop does it, returns its bus time
+static uint32_t helper_readSensor(void) {
+    sim_i2c_bus_stats_t before = sim_i2c_bus_getStats();
+    saphBmeMeasurements_t measurements;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saphBme280_getMeasurements(&sensor, &measurements));
+    return helper_getBusUs(before, sim_i2c_bus_getStats());
+}
+
+// Flush steps with a sensor read after each, returns the longest a read waited including its own transfer
+static uint32_t helper_flushInterleaved(void) {
+    uint32_t worstLatencyUs = 0;
+    int32_t outcome = SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING;
+    while (outcome == SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING) {
+        sim_i2c_bus_stats_t before = sim_i2c_bus_getStats();
+        outcome = saph_ssd1306_framebuffer_flushStep(&framebuffer);
+        uint32_t latencyUs = helper_getBusUs(before, sim_i2c_bus_getStats()) + helper_readSensor();
+        worstLatencyUs = latencyUs > worstLatencyUs ? latencyUs : worstLatencyUs;
+    }
+    return worstLatencyUs;
+}
+
+// Flush steps and arbiter steps in turn, the way the main loop runs them, returns the amount of arbiter transfers
+static uint32_t helper_flushQueued(void) {
+    uint32_t transfers = 0;
+    while (saph_ssd1306_framebuffer_isFlushing(&framebuffer)) {
+        TEST_ASSERT_TRUE(saph_ssd1306_framebuffer_flushStep(&framebuffer) >= 0);
+        if (i2c_arbiter_step(&arbiter) == I2C_ARBITER_TRANSFERRED) {
+            transfers++;
+        }
+    }
+    return transfers;
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+    sim_bme280_init(&simSensor, SIM_SENSOR_CHIP_ID);
+    sim_bme280_setRawMeasurement(&simSensor, 283413, 523407, 27999);
+    sim_bme280_attach(&simSensor, SIM_SENSOR_ADDRESS);
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+    saphBme280_init(SIM_SENSOR_ADDRESS, &sensor);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_framebuffer_init(&framebuffer, &display,
+                                                                    SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK));
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saph_ssd1306_framebuffer_init
+// #############################################
+
+void test_saph_ssd1306_framebuffer_init_rejects_chunks_outside_one_frame(void) {
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, saph_ssd1306_framebuffer_init(&framebuffer, &display, 0));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_framebuffer_init(&framebuffer, &display, SAPH_SSD1306_FRAMEBUFFER_SIZE + 1));
+}
+
+void test_saph_ssd1306_framebuffer_init_rejects_chunks_above_the_chunk_buffer(void) {
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_framebuffer_init(&framebuffer, &display,
+                                                          SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK + 1));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_framebuffer_init(&framebuffer, &display,
+                                                                    SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK));
+}
+
+void test_saph_ssd1306_framebuffer_init_returns_error_if_null(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_framebuffer_init(0, &display, 32));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_framebuffer_init(&framebuffer, 0, 32));
+}
+
+// #############################################
+// # saph_ssd1306_framebuffer_setPixel
+// #############################################
+
+void test_saph_ssd1306_framebuffer_setPixel_uses_gddram_layout(void) {
+    saph_ssd1306_framebuffer_setPixel(&framebuffer, 5, 0, true);
+    saph_ssd1306_framebuffer_setPixel(&framebuffer, 5, 11, true);
+    saph_ssd1306_framebuffer_setPixel(&framebuffer, 200, 11, true);
+    saph_ssd1306_framebuffer_setPixel(&framebuffer, 5, SAPH_SSD1306_HEIGHT, true);
+
+    uint8_t* back = saph_ssd1306_framebuffer_getBack(&framebuffer);
+    TEST_ASSERT_EQUAL_UINT8(0x01, back[5]);
+    TEST_ASSERT_EQUAL_UINT8(0x08, back[SAPH_SSD1306_WIDTH + 5]);
+    saph_ssd1306_framebuffer_setPixel(&framebuffer, 5, 0, false);
+    TEST_ASSERT_EQUAL_UINT8(0x00, back[5]);
+}
+
+// #############################################
+// # saph_ssd1306_framebuffer_diff
+// #############################################
+
+void test_saph_ssd1306_framebuffer_diff_finds_bounding_box_of_changes(void) {
+    static uint8_t previous[SAPH_SSD1306_FRAMEBUFFER_SIZE];
+    static uint8_t next[SAPH_SSD1306_FRAMEBUFFER_SIZE];
+    memset(previous, 0, sizeof(previous));
+    memcpy(next, previous, sizeof(next));
+    next[2 * SAPH_SSD1306_WIDTH + 40] = 1;
+    next[5 * SAPH_SSD1306_WIDTH + 10] = 1;
+    saph_ssd1306_region_t region;
+
+    TEST_ASSERT_TRUE(saph_ssd1306_framebuffer_diff(previous, next, &region));
+    TEST_ASSERT_EQUAL_UINT8(10, region.startColumn);
+    TEST_ASSERT_EQUAL_UINT8(40, region.endColumn);
+    TEST_ASSERT_EQUAL_UINT8(2, region.startPage);
+    TEST_ASSERT_EQUAL_UINT8(5, region.endPage);
+    TEST_ASSERT_FALSE(saph_ssd1306_framebuffer_diff(previous, previous, &region));
+}
+
+// #############################################
+// # saph_ssd1306_framebuffer_swap
+// #############################################
+
+void test_saph_ssd1306_framebuffer_swap_first_frame_is_sent_whole(void) {
+    memset(simDisplay.ram, 0xFF, sizeof(simDisplay.ram));
+    helper_drawBlock(0, 0, 8);
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING, saph_ssd1306_framebuffer_swap(&framebuffer));
+    uint32_t steps = helper_flush();
+
+    TEST_ASSERT_EQUAL_UINT32(1 + SAPH_SSD1306_FRAMEBUFFER_SIZE / SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK, steps);
+    helper_assertPanelShows(saph_ssd1306_framebuffer_getBack(&framebuffer));
+}
+
+void test_saph_ssd1306_framebuffer_swap_sends_only_the_dirty_region(void) {
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+    helper_drawBlock(30, 3, 20);
+    sim_i2c_bus_clearStats();
+
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+
+    TEST_ASSERT_EQUAL_UINT32(WINDOW_BYTES + 1 + 20, sim_i2c_bus_getStats().bytesWritten);
+    helper_assertPanelShows(saph_ssd1306_framebuffer_getBack(&framebuffer));
+}
+
+void test_saph_ssd1306_framebuffer_swap_without_changes_sends_nothing(void) {
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+    sim_i2c_bus_clearStats();
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE, saph_ssd1306_framebuffer_swap(&framebuffer));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_DONE, saph_ssd1306_framebuffer_flushStep(&framebuffer));
+    TEST_ASSERT_EQUAL_UINT32(0, sim_i2c_bus_getStats().writeTransactions);
+}
+
+void test_saph_ssd1306_framebuffer_swap_while_flushing_is_busy(void) {
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    saph_ssd1306_framebuffer_flushStep(&framebuffer);
+
+    TEST_ASSERT_TRUE(saph_ssd1306_framebuffer_isFlushing(&framebuffer));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR, saph_ssd1306_framebuffer_swap(&framebuffer));
+}
+
+void test_saph_ssd1306_framebuffer_swap_lets_drawing_go_on_during_the_flush(void) {
+    helper_drawBlock(0, 0, 16);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    static uint8_t shown[SAPH_SSD1306_FRAMEBUFFER_SIZE];
+    memcpy(shown, saph_ssd1306_framebuffer_getBack(&framebuffer), sizeof(shown));
+
+    // The back frame starts as the shown one, drawing into it does not touch the flush
+    saph_ssd1306_framebuffer_flushStep(&framebuffer);
+    helper_drawBlock(0, 7, 128);
+    helper_flush();
+    helper_assertPanelShows(shown);
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING, saph_ssd1306_framebuffer_swap(&framebuffer));
+    helper_flush();
+    helper_assertPanelShows(saph_ssd1306_framebuffer_getBack(&framebuffer));
+    TEST_ASSERT_EQUAL_UINT8(0x5A, simDisplay.ram[0][3]);
+}
+
+void test_saph_ssd1306_framebuffer_swap_returns_error_if_null(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_framebuffer_swap(0));
+}
+
+// #############################################
+// # saph_ssd1306_framebuffer_flushStep
+// #############################################
+
+void test_saph_ssd1306_framebuffer_flushStep_keeps_every_transfer_within_a_chunk(void) {
+    helper_drawBlock(0, 0, 128);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+
+    uint32_t largestTransfer = 0;
+    while (saph_ssd1306_framebuffer_isFlushing(&framebuffer)) {
+        sim_i2c_bus_stats_t before = sim_i2c_bus_getStats();
+        saph_ssd1306_framebuffer_flushStep(&framebuffer);
+        uint32_t bytes = sim_i2c_bus_getStats().bytesWritten - before.bytesWritten;
+        largestTransfer = bytes > largestTransfer ? bytes : largestTransfer;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(1 + SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK, largestTransfer);
+}
+
+void test_saph_ssd1306_framebuffer_flushStep_wraps_chunks_over_rows_of_a_narrow_region(void) {
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+    for (uint8_t page = 1; page < 7; ++page) {
+        helper_drawBlock(100, page, 11);
+    }
+
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    uint32_t steps = helper_flush();
+
+    // Window plus 66 bytes in chunks of 32
+    TEST_ASSERT_EQUAL_UINT32(4, steps);
+    helper_assertPanelShows(saph_ssd1306_framebuffer_getBack(&framebuffer));
+}
+
+void test_saph_ssd1306_framebuffer_flushStep_returns_error_if_null(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_framebuffer_flushStep(0));
+}
+
+// #############################################
+// # saph_ssd1306_framebuffer_useArbiter
+// #############################################
+
+void test_saph_ssd1306_framebuffer_useArbiter_flushes_the_frame_through_the_arbiter(void) {
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter));
+    memset(saph_ssd1306_framebuffer_getBack(&framebuffer), 0x3C, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    sim_i2c_bus_clearStats();
+
+    uint32_t transfers = helper_flushQueued();
+
+    helper_assertPanelShows(saph_ssd1306_framebuffer_getBack(&framebuffer));
+    // The window, then the frame in arbiter chunks, each with its own control byte
+    uint32_t chunks = SAPH_SSD1306_FRAMEBUFFER_SIZE / SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK;
+    TEST_ASSERT_EQUAL_UINT32(1 + chunks, transfers);
+    TEST_ASSERT_EQUAL_UINT32(WINDOW_BYTES + chunks + SAPH_SSD1306_FRAMEBUFFER_SIZE,
+                             sim_i2c_bus_getStats().bytesWritten);
+    TEST_ASSERT_EQUAL_UINT32(SAPH_SSD1306_FRAMEBUFFER_SIZE, framebuffer.bytesFlushed);
+}
+
+void test_saph_ssd1306_framebuffer_useArbiter_flush_steps_only_queue(void) {
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    sim_i2c_bus_clearStats();
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING, saph_ssd1306_framebuffer_flushStep(&framebuffer));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING, saph_ssd1306_framebuffer_flushStep(&framebuffer));
+
+    TEST_ASSERT_EQUAL_UINT32(0, sim_i2c_bus_getStats().writeTransactions);
+    TEST_ASSERT_FALSE(i2c_arbiter_isIdle(&arbiter));
+}
+
+// A read queued at high priority goes out before the rest of the frame, after the piece already on the bus
+void test_saph_ssd1306_framebuffer_useArbiter_sensor_reads_overtake_the_flush(void) {
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter);
+    memset(saph_ssd1306_framebuffer_getBack(&framebuffer), 0x81, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    for (uint8_t i = 0; i < 4; ++i) {
+        saph_ssd1306_framebuffer_flushStep(&framebuffer);
+        i2c_arbiter_step(&arbiter);
+    }
+    const uint8_t sensorRegister[1] = {0xF7};
+    uint8_t sensorData[8];
+    i2c_arbiter_request_t sensorRequest;
+    i2c_arbiter_prepareWriteRead(&sensorRequest, SIM_SENSOR_ADDRESS, I2C_ARBITER_PRIORITY_HIGH, sensorRegister, 1,
+                                 sensorData, 8);
+    i2c_arbiter_submit(&arbiter, &sensorRequest);
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING, saph_ssd1306_framebuffer_flushStep(&framebuffer));
+    i2c_arbiter_step(&arbiter);
+
+    TEST_ASSERT_EQUAL_UINT8(I2C_ARBITER_STATE_DONE, sensorRequest.state);
+    TEST_ASSERT_TRUE(saph_ssd1306_framebuffer_isFlushing(&framebuffer));
+    helper_flushQueued();
+    helper_assertPanelShows(saph_ssd1306_framebuffer_getBack(&framebuffer));
+}
+
+void test_saph_ssd1306_framebuffer_useArbiter_reports_a_failed_transfer_and_queues_it_again(void) {
+    saph_ssd1306_device_t absentDisplay;
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS + 1, &absentDisplay);
+    saph_ssd1306_framebuffer_init(&framebuffer, &absentDisplay, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+
+    saph_ssd1306_framebuffer_flushStep(&framebuffer);
+    i2c_arbiter_step(&arbiter);
+
+    TEST_ASSERT_EQUAL_INT32(SIM_I2C_BUS_NACK, saph_ssd1306_framebuffer_flushStep(&framebuffer));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING, saph_ssd1306_framebuffer_flushStep(&framebuffer));
+    TEST_ASSERT_FALSE(i2c_arbiter_isIdle(&arbiter));
+    TEST_ASSERT_FALSE(framebuffer.windowSent);
+}
+
+void test_saph_ssd1306_framebuffer_useArbiter_rejects_changes_during_a_flush(void) {
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_FRAMEBUFFER_BUSY_ERROR,
+                            saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter));
+}
+
+// The arbiter would cut the address window command apart
+void test_saph_ssd1306_framebuffer_useArbiter_rejects_arbiter_chunks_shorter_than_a_window(void) {
+    i2c_arbiter_init(&arbiter, SAPH_SSD1306_ADDRESS_WINDOW_SIZE - 1);
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_framebuffer_useArbiter(&framebuffer, &arbiter));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_framebuffer_useArbiter(0, &arbiter));
+}
+
+// #############################################
+// # Bus sharing
+// #############################################
+
+// Without chunks a read waits for the whole frame, 1025 bytes or about 92 ms
+void test_saph_ssd1306_framebuffer_sensor_reads_wait_for_one_chunk_at_most(void) {
+    memset(saph_ssd1306_framebuffer_getBack(&framebuffer), 0x81, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+
+    uint32_t worstLatencyUs = helper_flushInterleaved();
+
+    uint32_t readUs = helper_readSensor();
+    TEST_ASSERT_EQUAL_UINT32((2 + SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK) * BUS_US_PER_BYTE + readUs, worstLatencyUs);
+    TEST_ASSERT_LESS_THAN_UINT32(5000, worstLatencyUs);
+}
+
+// A changing value of a few characters updates more than 20 times a second next to a 1 Hz sensor
+void test_saph_ssd1306_framebuffer_small_updates_keep_a_high_frame_rate(void) {
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+    sim_i2c_bus_stats_t before = sim_i2c_bus_getStats();
+
+    for (uint8_t frame = 1; frame <= 50; ++frame) {
+        helper_drawBlock(64, 2, 30);
+        saph_ssd1306_framebuffer_getBack(&framebuffer)[2 * SAPH_SSD1306_WIDTH + 64] = frame;
+        saph_ssd1306_framebuffer_swap(&framebuffer);
+        helper_flush();
+    }
+
+    uint32_t usPerFrame = helper_getBusUs(before, sim_i2c_bus_getStats()) / 50;
+    TEST_ASSERT_LESS_THAN_UINT32(1000000 / 20, usPerFrame);
+}
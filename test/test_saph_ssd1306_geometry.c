@@ -0,0 +1,185 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "saph_ssd1306_framebuffer.h"
+#include "saph_ssd1306_ticker.h"
+#include "saph_ssd1306_sparkline.h"
+#include "i2c_arbiter.h"
+#include "test_saph_ssd1306_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_ssd1306.h"
+
+/* *
+ * Written against the geometry constants, so it holds for every panel. The default build checks the 128x64 panel,
+ * the build system compiles it once more per geometry with SAPH_SSD1306_GEOMETRY set.
+ * */
+
+#define SIM_DISPLAY_ADDRESS 0x3C
+// Marks GDDRAM the panel does not show
+#define OUTSIDE_PATTERN 0xAA
+
+#if SAPH_SSD1306_GEOMETRY == SAPH_SSD1306_GEOMETRY_128X64
+#define EXPECTED_MULTIPLEX_RATIO 63
+#define EXPECTED_COM_PINS 0x12
+#define EXPECTED_FRAME_BYTES 1024
+#elif SAPH_SSD1306_GEOMETRY == SAPH_SSD1306_GEOMETRY_128X32
+#define EXPECTED_MULTIPLEX_RATIO 31
+#define EXPECTED_COM_PINS 0x02
+#define EXPECTED_FRAME_BYTES 512
+#elif SAPH_SSD1306_GEOMETRY == SAPH_SSD1306_GEOMETRY_72X40
+#define EXPECTED_MULTIPLEX_RATIO 39
+#define EXPECTED_COM_PINS 0x12
+#define EXPECTED_FRAME_BYTES 360
+#endif
+
+static sim_ssd1306_t simDisplay;
+static saph_ssd1306_device_t display;
+static saph_ssd1306_framebuffer_t framebuffer;
+
+static bool helper_isShown(uint8_t ramColumn, uint8_t page) {
+    return ramColumn >= SAPH_SSD1306_COLUMN_OFFSET && ramColumn < SAPH_SSD1306_COLUMN_OFFSET + SAPH_SSD1306_WIDTH &&
+           page < SAPH_SSD1306_PAGES;
+}
+
+// GDDRAM the panel does not show has to keep OUTSIDE_PATTERN
+static void helper_assertOutsideUntouched(void) {
+    for (uint8_t page = 0; page < SAPH_SSD1306_RAM_PAGES; ++page) {
+        for (uint8_t column = 0; column < SAPH_SSD1306_RAM_WIDTH; ++column) {
+            if (!helper_isShown(column, page)) {
+                TEST_ASSERT_EQUAL_HEX8(OUTSIDE_PATTERN, simDisplay.ram[page][column]);
+            }
+        }
+    }
+}
+
+static void helper_flush(void) {
+    while (saph_ssd1306_framebuffer_flushStep(&framebuffer) == SAPH_SSD1306_FRAMEBUFFER_FLUSH_PENDING) {
+    }
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_ssd1306_init(&simDisplay);
+    memset(simDisplay.ram, OUTSIDE_PATTERN, sizeof(simDisplay.ram));
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # Constants
+// #############################################
+
+void test_saph_ssd1306_geometry_frame_holds_exactly_the_panel(void) {
+    TEST_ASSERT_EQUAL_UINT32(EXPECTED_FRAME_BYTES, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    TEST_ASSERT_LESS_THAN_UINT32(2 * EXPECTED_FRAME_BYTES + 1 + SAPH_SSD1306_FRAMEBUFFER_MAX_CHUNK +
+                                 sizeof(i2c_arbiter_request_t) + 64, sizeof(saph_ssd1306_framebuffer_t));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(SAPH_SSD1306_RAM_WIDTH, SAPH_SSD1306_COLUMN_OFFSET + SAPH_SSD1306_WIDTH);
+}
+
+// #############################################
+// # saph_ssd1306_configurePanel
+// #############################################
+
+void test_saph_ssd1306_geometry_configurePanel_sets_multiplex_and_com_pins(void) {
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_configurePanel(&display));
+
+    TEST_ASSERT_EQUAL_UINT8(EXPECTED_MULTIPLEX_RATIO, simDisplay.multiplexRatio);
+    TEST_ASSERT_EQUAL_HEX8(EXPECTED_COM_PINS, simDisplay.comPinsConfig);
+}
+
+// #############################################
+// # saph_ssd1306_setAddressWindow
+// #############################################
+
+void test_saph_ssd1306_geometry_setAddressWindow_shifts_into_the_shown_columns(void) {
+    uint8_t data[2] = {0x11, 0x22};
+
+    saph_ssd1306_setAddressWindow(&display, 0, SAPH_SSD1306_WIDTH - 1, 0, SAPH_SSD1306_PAGES - 1);
+    saph_ssd1306_writeData(&display, data, 2);
+
+    TEST_ASSERT_EQUAL_HEX8(0x11, simDisplay.ram[0][SAPH_SSD1306_COLUMN_OFFSET]);
+    TEST_ASSERT_EQUAL_HEX8(0x22, simDisplay.ram[0][SAPH_SSD1306_COLUMN_OFFSET + 1]);
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_setAddressWindow(&display, 0, SAPH_SSD1306_WIDTH, 0, 0));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_setAddressWindow(&display, 0, 0, 0, SAPH_SSD1306_PAGES));
+}
+
+// #############################################
+// # saph_ssd1306_framebuffer
+// #############################################
+
+void test_saph_ssd1306_geometry_framebuffer_fills_the_panel_and_nothing_else(void) {
+    saph_ssd1306_framebuffer_init(&framebuffer, &display, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    memset(saph_ssd1306_framebuffer_getBack(&framebuffer), 0xFF, SAPH_SSD1306_FRAMEBUFFER_SIZE);
+    sim_i2c_bus_clearStats();
+
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+
+    for (uint8_t page = 0; page < SAPH_SSD1306_PAGES; ++page) {
+        for (uint8_t x = 0; x < SAPH_SSD1306_WIDTH; ++x) {
+            TEST_ASSERT_EQUAL_HEX8(0xFF, simDisplay.ram[page][SAPH_SSD1306_COLUMN_OFFSET + x]);
+        }
+    }
+    helper_assertOutsideUntouched();
+    uint32_t chunks = (EXPECTED_FRAME_BYTES + SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK - 1) /
+                      SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK;
+    TEST_ASSERT_EQUAL_UINT32(9 + chunks + EXPECTED_FRAME_BYTES, sim_i2c_bus_getStats().bytesWritten);
+}
+
+void test_saph_ssd1306_geometry_framebuffer_last_pixel_is_the_bottom_right_corner(void) {
+    saph_ssd1306_framebuffer_init(&framebuffer, &display, SAPH_SSD1306_FRAMEBUFFER_DEFAULT_CHUNK);
+    saph_ssd1306_framebuffer_setPixel(&framebuffer, SAPH_SSD1306_WIDTH - 1, SAPH_SSD1306_HEIGHT - 1, true);
+
+    saph_ssd1306_framebuffer_swap(&framebuffer);
+    helper_flush();
+
+    TEST_ASSERT_EQUAL_HEX8(0x80, simDisplay.ram[SAPH_SSD1306_PAGES - 1][SAPH_SSD1306_COLUMN_OFFSET +
+                                                                        SAPH_SSD1306_WIDTH - 1]);
+}
+
+// #############################################
+// # saph_ssd1306_ticker
+// #############################################
+
+void test_saph_ssd1306_geometry_ticker_enters_at_the_shown_edge(void) {
+    saph_ssd1306_ticker_t ticker;
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, 0, SAPH_SSD1306_PAGES - 1, 0);
+    uint8_t column[SAPH_SSD1306_PAGES];
+    memset(column, 0x3C, sizeof(column));
+
+    saph_ssd1306_ticker_push(&ticker, column);
+
+    TEST_ASSERT_EQUAL_HEX8(0x3C, simDisplay.ram[0][SAPH_SSD1306_COLUMN_OFFSET + SAPH_SSD1306_WIDTH - 1]);
+    for (uint8_t step = 1; step < SAPH_SSD1306_WIDTH; ++step) {
+        sim_ssd1306_scrollStep(&simDisplay);
+    }
+    TEST_ASSERT_EQUAL_HEX8(0x3C, simDisplay.ram[SAPH_SSD1306_PAGES - 1][SAPH_SSD1306_COLUMN_OFFSET]);
+}
+
+// #############################################
+// # saph_ssd1306_sparkline
+// #############################################
+
+void test_saph_ssd1306_geometry_sparkline_over_the_whole_panel_stays_on_it(void) {
+    saph_ssd1306_sparkline_t sparkline;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_sparkline_init(&sparkline, &display,
+                                                                  SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE, 0,
+                                                                  SAPH_SSD1306_WIDTH, 0, SAPH_SSD1306_PAGES - 1, 1));
+
+    for (int32_t i = 0; i < SAPH_SSD1306_WIDTH + 5; ++i) {
+        TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_sparkline_push(&sparkline, 2150 + (i % 40) * 10));
+    }
+
+    helper_assertOutsideUntouched();
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE,
+                                                        1, SAPH_SSD1306_WIDTH, 0, 0, 1));
+}
@@ -2,6 +2,7 @@
 
 #include "saph_ssd1306_internal.h"
 #include "test_saph_ssd1306_test_definitions.h"
+#include <string.h>
 
 #include "mock_i2c_handler.h"
 
@@ -37,6 +38,14 @@ void test_saph_ssd1306_internal_sendCtrlCommand(void) {
     TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
 }
 
+void test_saph_ssd1306_internal_sendCtrlCommand_returnsNoErrorForBytesWritten(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t paramBuffer[] = {0xAF};
+    i2c_handler_write_ExpectAnyArgsAndReturn(2);
+    int32_t errorCode = saph_ssd1306_internal_sendCtrlCommand(&testDevice, paramBuffer, 1);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
 void test_saph_ssd1306_internal_sendCtrlCommand_returnsErrorOnDeviceNullpointer(void) {
     saph_ssd1306_device_t* testDevice = (saph_ssd1306_device_t*) 0;
     uint8_t paramBuffer[] = {0xFA, 0xFB};
@@ -62,3 +71,113 @@ void test_saph_ssd1306_internal_sendCtrlCommand_returnsErrorCodeForFailedWrite(v
     int32_t errorCode = saph_ssd1306_internal_sendCtrlCommand(&testDevice, paramBuffer, bufferSize);
     TEST_ASSERT_EQUAL_INT32(WRITE_ERROR, errorCode);
 }
+
+// #############################################
+// # Test group _sendData
+// #############################################
+
+void test_saph_ssd1306_internal_sendData_prefixesDataControlByte(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t dc_byte = 0x40; // D/C# set, the following bytes go to GDDRAM
+    uint8_t data[] = {0x0F, 0xF0, 0x81};
+    uint8_t expectedData[4] = {dc_byte, data[0], data[1], data[2]};
+    i2c_handler_write_ExpectAndReturn(testDevice.address, expectedData, 4, 4);
+    int32_t errorCode = saph_ssd1306_internal_sendData(&testDevice, data, 3);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_internal_sendData_splitsLongDataIntoChunksWithTheirOwnControlByte(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t data[SAPH_SSD1306_DATA_CHUNK + 3];
+    for (uint32_t i = 0; i < sizeof(data); ++i) {
+        data[i] = (uint8_t) i;
+    }
+    uint8_t expectedFirst[1 + SAPH_SSD1306_DATA_CHUNK];
+    expectedFirst[0] = 0x40;
+    memcpy(expectedFirst + 1, data, SAPH_SSD1306_DATA_CHUNK);
+    uint8_t expectedSecond[4] = {0x40, data[SAPH_SSD1306_DATA_CHUNK], data[SAPH_SSD1306_DATA_CHUNK + 1],
+                                 data[SAPH_SSD1306_DATA_CHUNK + 2]};
+    i2c_handler_write_ExpectAndReturn(testDevice.address, expectedFirst, sizeof(expectedFirst), sizeof(expectedFirst));
+    i2c_handler_write_ExpectAndReturn(testDevice.address, expectedSecond, 4, 4);
+    int32_t errorCode = saph_ssd1306_internal_sendData(&testDevice, data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_internal_sendData_stopsAtTheFirstFailedChunk(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t data[3 * SAPH_SSD1306_DATA_CHUNK] = {0};
+    i2c_handler_write_ExpectAnyArgsAndReturn(1 + SAPH_SSD1306_DATA_CHUNK);
+    i2c_handler_write_ExpectAnyArgsAndReturn(ERROR_PLATFORM_GENERIC);
+    int32_t errorCode = saph_ssd1306_internal_sendData(&testDevice, data, sizeof(data));
+    TEST_ASSERT_EQUAL_INT32(ERROR_PLATFORM_GENERIC, errorCode);
+}
+
+void test_saph_ssd1306_internal_sendData_returnsErrorOnBufferNullpointer(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    int32_t errorCode = saph_ssd1306_internal_sendData(&testDevice, (uint8_t*) 0, 1);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_internal_sendData_returnsPlatformErrorIfNoDeviceAnswers(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t data[] = {0x00};
+    i2c_handler_write_ExpectAnyArgsAndReturn(ERROR_PLATFORM_GENERIC);
+    int32_t errorCode = saph_ssd1306_internal_sendData(&testDevice, data, 1);
+    TEST_ASSERT_EQUAL_INT32(ERROR_PLATFORM_GENERIC, errorCode);
+}
+
+// #############################################
+// # Test group _sendDataInPlace
+// #############################################
+
+void test_saph_ssd1306_internal_sendDataInPlace_setsControlByteInFrontOfTheData(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t buffer[] = {0xEE, 0x0F, 0xF0, 0x81};
+    uint8_t expectedData[4] = {0x40, 0x0F, 0xF0, 0x81};
+    i2c_handler_write_ExpectAndReturn(testDevice.address, expectedData, 4, 4);
+    int32_t errorCode = saph_ssd1306_internal_sendDataInPlace(&testDevice, buffer, 3);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_internal_sendDataInPlace_returnsErrorOnBufferNullpointer(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    int32_t errorCode = saph_ssd1306_internal_sendDataInPlace(&testDevice, (uint8_t*) 0, 1);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+// #############################################
+// # Test group _readStatus
+// #############################################
+
+void test_saph_ssd1306_internal_readStatus_readsSingleByteWithoutControlByte(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t status = 0;
+    uint8_t response = 0x06;
+    i2c_handler_read_ExpectAndReturn(testDevice.address, &status, 1, 1);
+    i2c_handler_read_ReturnThruPtr_buffer(&response);
+    int32_t errorCode = saph_ssd1306_internal_readStatus(&testDevice, &status);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_EQUAL_UINT8(response, status);
+}
+
+void test_saph_ssd1306_internal_readStatus_returnsErrorOnBufferNullpointer(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    int32_t errorCode = saph_ssd1306_internal_readStatus(&testDevice, (uint8_t*) 0);
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_internal_readStatus_returnsErrorOnWrongReadAmount(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t status = 0;
+    i2c_handler_read_ExpectAnyArgsAndReturn(0);
+    int32_t errorCode = saph_ssd1306_internal_readStatus(&testDevice, &status);
+    TEST_ASSERT_EQUAL_INT32(READ_ERROR, errorCode);
+}
+
+void test_saph_ssd1306_internal_readStatus_returnsPlatformErrorIfNoDeviceAnswers(void) {
+    saph_ssd1306_device_t testDevice = helper_createTestDevice();
+    uint8_t status = 0;
+    i2c_handler_read_ExpectAnyArgsAndReturn(ERROR_PLATFORM_GENERIC);
+    int32_t errorCode = saph_ssd1306_internal_readStatus(&testDevice, &status);
+    TEST_ASSERT_EQUAL_INT32(ERROR_PLATFORM_GENERIC, errorCode);
+}
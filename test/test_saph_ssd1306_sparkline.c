@@ -0,0 +1,267 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "saph_ssd1306_sparkline.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "test_saph_ssd1306_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_ssd1306.h"
+#include "trace_indoor.h"
+
+/* *
+ * Draws into the simulated SSD1306 and checks its GDDRAM, the widget covers a 128x32 panel.
+ * */
+
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define PANEL_PAGES 4
+#define PANEL_ROWS (PANEL_PAGES * 8)
+// 0.01 degC per level at the finest scale
+#define TEMPERATURE_MIN_STEP 1
+// Address window command with its control byte
+#define WINDOW_BYTES 9
+
+static sim_ssd1306_t simDisplay;
+static saph_ssd1306_device_t display;
+static saph_ssd1306_sparkline_t sparkline;
+
+static void helper_init(uint8_t columns) {
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_sparkline_init(&sparkline, &display,
+                                                                  SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE, 0, columns,
+                                                                  0, PANEL_PAGES - 1, TEMPERATURE_MIN_STEP));
+}
+
+static void helper_push(int32_t value) {
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_sparkline_push(&sparkline, value));
+}
+
+// Lit rows of a column in the simulated RAM, one bit per row from the top
+static uint32_t helper_getColumnRows(uint8_t column) {
+    uint32_t rows = 0;
+    for (uint8_t page = 0; page < PANEL_PAGES; ++page) {
+        rows |= (uint32_t) simDisplay.ram[page][column] << (8 * page);
+    }
+    return rows;
+}
+
+static uint8_t helper_getTopRow(uint8_t column) {
+    uint32_t rows = helper_getColumnRows(column);
+    uint8_t row = 0;
+    while (row < PANEL_ROWS && (rows & (1u << row)) == 0) {
+        row++;
+    }
+    return row;
+}
+
+static uint32_t helper_getBytesOfPush(int32_t value) {
+    sim_i2c_bus_clearStats();
+    helper_push(value);
+    return sim_i2c_bus_getStats().bytesWritten;
+}
+
+void setUp(void) {
+    sim_i2c_bus_reset();
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saph_ssd1306_sparkline_init
+// #############################################
+
+void test_saph_ssd1306_sparkline_init_clears_its_area(void) {
+    memset(simDisplay.ram, 0xFF, sizeof(simDisplay.ram));
+
+    helper_init(SAPH_SSD1306_WIDTH);
+
+    for (uint8_t x = 0; x < SAPH_SSD1306_WIDTH; ++x) {
+        TEST_ASSERT_EQUAL_UINT32(0, helper_getColumnRows(x));
+        TEST_ASSERT_EQUAL_UINT8(0xFF, simDisplay.ram[PANEL_PAGES][x]);
+    }
+}
+
+void test_saph_ssd1306_sparkline_init_rejects_area_outside_the_panel(void) {
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_PRESSURE,
+                                                        64, 65, 0, 3, 1));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_PRESSURE,
+                                                        0, 128, 2, 1, 1));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_sparkline_init(&sparkline, &display, 3, 0, 128, 0, 3, 1));
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR,
+                            saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_PRESSURE,
+                                                        0, 128, 0, 3, 0));
+}
+
+void test_saph_ssd1306_sparkline_init_returns_error_if_null(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_sparkline_init(0, &display, 0, 0, 128, 0, 3, 1));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_sparkline_init(&sparkline, 0, 0, 0, 128, 0, 3, 1));
+}
+
+// #############################################
+// # saph_ssd1306_sparkline_push
+// #############################################
+
+void test_saph_ssd1306_sparkline_push_first_sample_is_a_dot_in_the_middle(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+
+    helper_push(2150);
+
+    uint32_t rows = helper_getColumnRows(0);
+    TEST_ASSERT_EQUAL_UINT32(1, __builtin_popcount(rows));
+    TEST_ASSERT_UINT8_WITHIN(1, PANEL_ROWS / 2, helper_getTopRow(0));
+}
+
+void test_saph_ssd1306_sparkline_push_joins_samples_into_a_line(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+
+    helper_push(2150);
+    helper_push(2150 + 100);
+
+    // The second column spans from the row of the first sample up to its own
+    uint32_t rows = helper_getColumnRows(1);
+    uint8_t top = helper_getTopRow(1);
+    uint8_t bottom = helper_getTopRow(0);
+    TEST_ASSERT_TRUE(top < bottom);
+    for (uint8_t row = top; row <= bottom; ++row) {
+        TEST_ASSERT_TRUE(rows & (1u << row));
+    }
+}
+
+void test_saph_ssd1306_sparkline_push_redraws_only_its_columns(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+    helper_push(2150);
+
+    // New column and gap while filling up, the column behind the gap joins once the ring is full
+    TEST_ASSERT_EQUAL_UINT32(WINDOW_BYTES + 1 + 2 * PANEL_PAGES, helper_getBytesOfPush(2151));
+    for (uint8_t i = 2; i < SAPH_SSD1306_WIDTH + 10; ++i) {
+        helper_push(2150 + (i % 3));
+    }
+    TEST_ASSERT_EQUAL_UINT32(WINDOW_BYTES + 1 + 3 * PANEL_PAGES, helper_getBytesOfPush(2151));
+    TEST_ASSERT_EQUAL_UINT32(1, sparkline.fullRedraws);
+}
+
+void test_saph_ssd1306_sparkline_push_keeps_a_dark_gap_after_the_newest_sample(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+
+    for (uint32_t i = 0; i < SAPH_SSD1306_WIDTH + 5; ++i) {
+        helper_push(2150);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(5, sparkline.cursor);
+    TEST_ASSERT_NOT_EQUAL(0, helper_getColumnRows(4));
+    TEST_ASSERT_EQUAL_UINT32(0, helper_getColumnRows(5));
+    TEST_ASSERT_NOT_EQUAL(0, helper_getColumnRows(6));
+}
+
+void test_saph_ssd1306_sparkline_push_wraps_its_columns_around_the_area(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+
+    for (uint32_t i = 0; i < SAPH_SSD1306_WIDTH; ++i) {
+        helper_push(2150);
+    }
+
+    // The newest sample sits in the last column and the gap moved to the first one
+    TEST_ASSERT_NOT_EQUAL(0, helper_getColumnRows(SAPH_SSD1306_WIDTH - 1));
+    TEST_ASSERT_EQUAL_UINT32(0, helper_getColumnRows(0));
+}
+
+void test_saph_ssd1306_sparkline_push_widens_the_scale_for_samples_off_it(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+    helper_push(2150);
+    helper_push(2151);
+
+    helper_push(2150 + 1000);
+
+    int32_t newest = 0;
+    int32_t oldest = 0;
+    saph_ssd1306_sparkline_getValue(&sparkline, 0, &newest);
+    saph_ssd1306_sparkline_getValue(&sparkline, 2, &oldest);
+    TEST_ASSERT_EQUAL_UINT32(2, sparkline.fullRedraws);
+    TEST_ASSERT_INT32_WITHIN(sparkline.scaleStep, 3150, newest);
+    TEST_ASSERT_INT32_WITHIN(sparkline.scaleStep, 2150, oldest);
+    // The history takes the middle half of the new scale
+    TEST_ASSERT_UINT8_WITHIN(1, PANEL_ROWS / 4, helper_getTopRow(2));
+}
+
+void test_saph_ssd1306_sparkline_push_narrows_the_scale_once_a_spike_aged_out(void) {
+    helper_init(16);
+    helper_push(2150 + 5000);
+
+    for (uint8_t i = 0; i < 16; ++i) {
+        helper_push(2150 + (i % 2));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(TEMPERATURE_MIN_STEP, sparkline.scaleStep);
+    // Samples from the coarse scale keep its rounding, new ones get the full resolution again
+    helper_push(2153);
+    int32_t newest = 0;
+    saph_ssd1306_sparkline_getValue(&sparkline, 0, &newest);
+    TEST_ASSERT_EQUAL_INT32(2153, newest);
+}
+
+void test_saph_ssd1306_sparkline_push_returns_error_if_null(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_sparkline_push(0, 2150));
+}
+
+// #############################################
+// # saph_ssd1306_sparkline_pushMeasurements
+// #############################################
+
+void test_saph_ssd1306_sparkline_pushMeasurements_takes_the_configured_field(void) {
+    saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_HUMIDITY, 0, 64, 0,
+                                PANEL_PAGES - 1, 10);
+
+    saph_ssd1306_sparkline_pushMeasurements(&sparkline, &traceIndoor[0]);
+
+    int32_t value = 0;
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_sparkline_getValue(&sparkline, 0, &value));
+    TEST_ASSERT_INT32_WITHIN(5, (int32_t) traceIndoor[0].humidity, value);
+}
+
+// A full redraw of the area takes 9 bytes of window and 4 transfers of 129 bytes, an update about 22
+void test_saph_ssd1306_sparkline_pushMeasurements_indoor_trace_flushes_few_bytes_per_update(void) {
+    saph_ssd1306_sparkline_init(&sparkline, &display, SAPH_SSD1306_SPARKLINE_FIELD_TEMPERATURE, 0, SAPH_SSD1306_WIDTH,
+                                0, PANEL_PAGES - 1, TEMPERATURE_MIN_STEP);
+    sim_i2c_bus_clearStats();
+
+    for (uint32_t i = 0; i < TRACE_INDOOR_SAMPLES; ++i) {
+        TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_sparkline_pushMeasurements(&sparkline, &traceIndoor[i]));
+    }
+
+    uint32_t bytesPerUpdate = sim_i2c_bus_getStats().bytesWritten / TRACE_INDOOR_SAMPLES;
+    TEST_ASSERT_LESS_THAN_UINT32(30, bytesPerUpdate);
+    TEST_ASSERT_LESS_THAN_UINT32(8, sparkline.fullRedraws);
+}
+
+// #############################################
+// # saph_ssd1306_sparkline_getValue
+// #############################################
+
+void test_saph_ssd1306_sparkline_getValue_counts_age_from_the_newest(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+    helper_push(2150);
+    helper_push(2160);
+    helper_push(2170);
+
+    int32_t value = 0;
+    saph_ssd1306_sparkline_getValue(&sparkline, 0, &value);
+    TEST_ASSERT_EQUAL_INT32(2170, value);
+    saph_ssd1306_sparkline_getValue(&sparkline, 2, &value);
+    TEST_ASSERT_EQUAL_INT32(2150, value);
+}
+
+void test_saph_ssd1306_sparkline_getValue_without_sample_returns_error(void) {
+    helper_init(SAPH_SSD1306_WIDTH);
+    helper_push(2150);
+    int32_t value = 0;
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_SPARKLINE_NO_SAMPLE_ERROR, saph_ssd1306_sparkline_getValue(&sparkline, 1, &value));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_sparkline_getValue(&sparkline, 0, 0));
+}
@@ -0,0 +1,218 @@
+#include "unity.h"
+
+#include <string.h>
+
+#include "saph_ssd1306_ticker.h"
+#include "saph_ssd1306.h"
+#include "saph_ssd1306_internal.h"
+#include "test_saph_ssd1306_test_definitions.h"
+
+#include "sim_i2c_bus.h"
+#include "sim_ssd1306.h"
+
+/* *
+ * Runs the ticker against the simulated SSD1306, which shifts its RAM on every sim_ssd1306_scrollStep
+ * like the chip does every frameInterval frames, and drops RAM writes that arrive while it scrolls.
+ * */
+
+#define SIM_DISPLAY_ADDRESS 0x3C
+#define STRIP_START_PAGE 4
+#define STRIP_END_PAGE 7
+#define STRIP_PAGES (STRIP_END_PAGE - STRIP_START_PAGE + 1)
+// Deactivate, scroll setup and activate, each with its control byte
+#define SCROLL_RESTART_BYTES (2 + 8 + 2)
+// Control byte plus one byte per page of the strip, with the scroll stopped around it
+#define BYTES_PER_STEP (1 + STRIP_PAGES + SCROLL_RESTART_BYTES)
+// What resending the whole frame costs, all of GDDRAM plus a control byte per data transaction
+#define FRAME_DATA_BYTES (SAPH_SSD1306_PAGES * SAPH_SSD1306_WIDTH)
+#define BYTES_PER_FRAME (FRAME_DATA_BYTES + (FRAME_DATA_BYTES + SAPH_SSD1306_DATA_CHUNK - 1) / SAPH_SSD1306_DATA_CHUNK)
+
+static sim_ssd1306_t simDisplay;
+static saph_ssd1306_device_t display;
+static saph_ssd1306_ticker_t ticker;
+
+static void helper_attach(void) {
+    sim_i2c_bus_reset();
+    sim_ssd1306_init(&simDisplay);
+    sim_ssd1306_attach(&simDisplay, SIM_DISPLAY_ADDRESS);
+    saph_ssd1306_init(SIM_DISPLAY_ADDRESS, &display);
+}
+
+// Column n of the history has every byte set to n, so positions are easy to tell apart
+static void helper_makeColumn(uint32_t n, uint8_t* column) {
+    memset(column, (uint8_t) n, STRIP_PAGES);
+}
+
+// One scroll step of the chip followed by the push the caller does in the same period
+static void helper_step(uint32_t n) {
+    uint8_t column[STRIP_PAGES];
+    helper_makeColumn(n, column);
+    sim_ssd1306_scrollStep(&simDisplay);
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_ticker_push(&ticker, column));
+}
+
+void setUp(void) {
+    helper_attach();
+}
+
+void tearDown(void) {}
+
+// #############################################
+// # saph_ssd1306_ticker_init
+// #############################################
+
+void test_saph_ssd1306_ticker_init_sets_up_and_starts_hardware_scroll(void) {
+    int32_t errorCode = saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE,
+                                                 STRIP_END_PAGE, SAPH_SSD1306_SCROLL_FRAMES_25);
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, errorCode);
+    TEST_ASSERT_TRUE(simDisplay.scrollActive);
+    TEST_ASSERT_TRUE(simDisplay.scrollLeft);
+    TEST_ASSERT_EQUAL_UINT8(STRIP_START_PAGE, simDisplay.scrollStartPage);
+    TEST_ASSERT_EQUAL_UINT8(STRIP_END_PAGE, simDisplay.scrollEndPage);
+    TEST_ASSERT_EQUAL_UINT8(SAPH_SSD1306_SCROLL_FRAMES_25, simDisplay.scrollFrameInterval);
+    TEST_ASSERT_EQUAL_UINT32(0, simDisplay.unknownCommands);
+}
+
+void test_saph_ssd1306_ticker_init_narrows_address_window_to_entry_column(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+
+    TEST_ASSERT_EQUAL_UINT8(SAPH_SSD1306_WIDTH - 1, simDisplay.startColumn);
+    TEST_ASSERT_EQUAL_UINT8(SAPH_SSD1306_WIDTH - 1, simDisplay.endColumn);
+    TEST_ASSERT_EQUAL_UINT8(STRIP_START_PAGE, simDisplay.startPage);
+    TEST_ASSERT_EQUAL_UINT8(STRIP_END_PAGE, simDisplay.endPage);
+}
+
+void test_saph_ssd1306_ticker_init_enters_on_the_left_when_scrolling_right(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_RIGHT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+
+    TEST_ASSERT_EQUAL_UINT8(0, saph_ssd1306_ticker_getEntryColumn(&ticker));
+    TEST_ASSERT_EQUAL_UINT8(0, simDisplay.startColumn);
+    TEST_ASSERT_EQUAL_UINT8(0, simDisplay.endColumn);
+}
+
+void test_saph_ssd1306_ticker_init_rejects_invalid_strip(void) {
+    int32_t errorCode = saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, 5, 4, 0);
+
+    TEST_ASSERT_EQUAL_INT32(SAPH_SSD1306_INVALID_CONFIG_ERROR, errorCode);
+    TEST_ASSERT_FALSE(simDisplay.scrollActive);
+}
+
+void test_saph_ssd1306_ticker_init_returns_error_if_null(void) {
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_ticker_init(0, &display, 0, 0, 7, 0));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_ticker_init(&ticker, 0, 0, 0, 7, 0));
+}
+
+// #############################################
+// # saph_ssd1306_ticker_push
+// #############################################
+
+void test_saph_ssd1306_ticker_push_sends_one_column_per_step(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+    sim_i2c_bus_clearStats();
+
+    for (uint32_t n = 1; n <= 100; ++n) {
+        helper_step(n);
+    }
+
+    sim_i2c_bus_stats_t stats = sim_i2c_bus_getStats();
+    TEST_ASSERT_EQUAL_UINT32(4 * 100, stats.writeTransactions);
+    TEST_ASSERT_EQUAL_UINT32(100 * BYTES_PER_STEP, stats.bytesWritten);
+    TEST_ASSERT_EQUAL_UINT32(100, ticker.steps);
+}
+
+void test_saph_ssd1306_ticker_push_costs_a_fraction_of_a_full_frame(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, 0, SAPH_SSD1306_PAGES - 1, 0);
+    uint8_t column[SAPH_SSD1306_PAGES] = {0};
+    sim_i2c_bus_clearStats();
+    saph_ssd1306_ticker_push(&ticker, column);
+    uint32_t bytesPerStep = sim_i2c_bus_getStats().bytesWritten;
+
+    static uint8_t frame[SAPH_SSD1306_PAGES * SAPH_SSD1306_WIDTH];
+    saph_ssd1306_setAddressWindow(&display, 0, SAPH_SSD1306_WIDTH - 1, 0, SAPH_SSD1306_PAGES - 1);
+    sim_i2c_bus_clearStats();
+    saph_ssd1306_writeData(&display, frame, sizeof(frame));
+    uint32_t bytesPerFrame = sim_i2c_bus_getStats().bytesWritten;
+
+    TEST_ASSERT_EQUAL_UINT32(1 + SAPH_SSD1306_PAGES + SCROLL_RESTART_BYTES, bytesPerStep);
+    TEST_ASSERT_EQUAL_UINT32(BYTES_PER_FRAME, bytesPerFrame);
+    TEST_ASSERT_LESS_THAN_UINT32(bytesPerFrame / 20, bytesPerStep);
+}
+
+void test_saph_ssd1306_ticker_push_keeps_the_latest_history_on_screen(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+
+    uint32_t amountSteps = SAPH_SSD1306_WIDTH + 72;
+    for (uint32_t n = 1; n <= amountSteps; ++n) {
+        helper_step(n);
+    }
+
+    // Oldest visible column on the left, the one pushed last at the entry column
+    for (uint8_t x = 0; x < SAPH_SSD1306_WIDTH; ++x) {
+        uint8_t expected = (uint8_t) (amountSteps - (SAPH_SSD1306_WIDTH - 1) + x);
+        for (uint8_t page = STRIP_START_PAGE; page <= STRIP_END_PAGE; ++page) {
+            TEST_ASSERT_EQUAL_UINT8(expected, simDisplay.ram[page][x]);
+        }
+    }
+}
+
+void test_saph_ssd1306_ticker_push_leaves_pages_outside_the_strip_alone(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+
+    for (uint32_t n = 1; n <= 10; ++n) {
+        helper_step(n);
+    }
+
+    for (uint8_t page = 0; page < STRIP_START_PAGE; ++page) {
+        for (uint8_t x = 0; x < SAPH_SSD1306_WIDTH; ++x) {
+            TEST_ASSERT_EQUAL_UINT8(0, simDisplay.ram[page][x]);
+        }
+    }
+}
+
+void test_saph_ssd1306_ticker_push_writes_ram_only_while_the_scroll_is_stopped(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE,
+                             SAPH_SSD1306_SCROLL_FRAMES_25);
+
+    for (uint32_t n = 1; n <= 10; ++n) {
+        helper_step(n);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(0, simDisplay.ramWritesWhileScrolling);
+    TEST_ASSERT_TRUE(simDisplay.scrollActive);
+    TEST_ASSERT_TRUE(simDisplay.scrollLeft);
+    TEST_ASSERT_EQUAL_UINT8(SAPH_SSD1306_SCROLL_FRAMES_25, simDisplay.scrollFrameInterval);
+    TEST_ASSERT_EQUAL_UINT8(10, simDisplay.ram[STRIP_START_PAGE][SAPH_SSD1306_WIDTH - 1]);
+}
+
+void test_saph_ssd1306_ticker_push_column_written_into_a_running_scroll_is_lost(void) {
+    uint8_t column[STRIP_PAGES];
+    helper_makeColumn(9, column);
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_writeData(&display, column, STRIP_PAGES));
+
+    TEST_ASSERT_EQUAL_UINT32(1, simDisplay.ramWritesWhileScrolling);
+    TEST_ASSERT_EQUAL_UINT8(0, simDisplay.ram[STRIP_START_PAGE][SAPH_SSD1306_WIDTH - 1]);
+}
+
+void test_saph_ssd1306_ticker_push_returns_error_if_null(void) {
+    uint8_t column[STRIP_PAGES] = {0};
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_ticker_push(0, column));
+    TEST_ASSERT_EQUAL_INT32(NULL_POINTER_ERROR, saph_ssd1306_ticker_push(&ticker, 0));
+}
+
+// #############################################
+// # saph_ssd1306_ticker_stop
+// #############################################
+
+void test_saph_ssd1306_ticker_stop_freezes_the_strip(void) {
+    saph_ssd1306_ticker_init(&ticker, &display, SAPH_SSD1306_SCROLL_LEFT, STRIP_START_PAGE, STRIP_END_PAGE, 0);
+    helper_step(1);
+
+    TEST_ASSERT_EQUAL_INT32(NO_ERROR, saph_ssd1306_ticker_stop(&ticker));
+    sim_ssd1306_scrollStep(&simDisplay);
+
+    TEST_ASSERT_FALSE(simDisplay.scrollActive);
+    TEST_ASSERT_EQUAL_UINT8(1, simDisplay.ram[STRIP_START_PAGE][SAPH_SSD1306_WIDTH - 1]);
+}
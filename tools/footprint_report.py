@@ -0,0 +1,188 @@
+#!/usr/bin/env python3
+"""Per module text/data/bss of a firmware image, read from the GNU ld map file.
+
+    python3 tools/footprint_report.py build/saph_pico_temperature.elf.map
+    python3 tools/footprint_report.py build/saph_pico_temperature.elf.map --budget tools/footprint_budget.json
+
+Modules are the sources under src/, everything else is summed per archive, the Pico SDK as one. Linked with
+-Wl,--cref the map also says which files reference a symbol, drivers that reach malloc or printf are listed.
+With a budget the script exits with 1 if a module or the total is over it, or a driver references one of those.
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+
+SRC_DIR = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, "src")
+
+# Output sections by where they end up, everything else that is allocated counts as text
+BSS_SECTIONS = (".bss", ".uninitialized_data", ".tbss")
+DATA_SECTIONS = (".data", ".scratch_x", ".scratch_y", ".tdata", ".ram_vector_table")
+SKIPPED_SECTIONS = (".debug", ".comment", ".ARM.attributes", ".stab", ".heap", ".stack", ".flash_end", "/DISCARD/")
+
+# What a driver with only static storage and no stdio must not reference, also behind the SDK's --wrap
+FORBIDDEN_SYMBOLS = ("malloc", "calloc", "realloc", "free", "printf", "vprintf", "sprintf", "snprintf", "vsnprintf",
+                     "fprintf", "puts", "putchar")
+# The application itself may print, the minimal footprint build compiles it out
+NOT_DRIVERS = ("main",)
+
+INPUT_SECTION = re.compile(r"^ (\S+)(?:\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+))?$")
+WRAPPED_INPUT = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+)$")
+ARCHIVE_MEMBER = re.compile(r"^(.*)\((.*)\)$")
+
+
+def project_modules():
+    return {name[:-2] for name in os.listdir(SRC_DIR) if name.endswith(".c")}
+
+
+def object_stem(path):
+    stem = os.path.basename(path)
+    for suffix in (".obj", ".o", ".c"):
+        if stem.endswith(suffix):
+            stem = stem[:-len(suffix)]
+    return stem
+
+
+def module_of(file, modules):
+    """Name of the project module the input file belongs to, or the group it is summed into."""
+    member = ARCHIVE_MEMBER.match(file)
+    path = member.group(2) if member else file
+    if "pico-sdk" in file or "pico_sdk" in file:
+        return "[pico-sdk]"
+    if object_stem(path) in modules:
+        return object_stem(path)
+    if member:
+        return "[" + object_stem(os.path.basename(member.group(1))) + "]"
+    return "[" + object_stem(path) + "]"
+
+
+def kind_of(output_section):
+    if output_section.startswith(SKIPPED_SECTIONS):
+        return None
+    if output_section.startswith(BSS_SECTIONS):
+        return "bss"
+    if output_section.startswith(DATA_SECTIONS):
+        return "data"
+    return "text"
+
+
+def parse_map(lines, modules):
+    sizes = {}
+    references = {}
+    in_memory_map = False
+    in_cref = False
+    output_section = None
+    pending = None
+    symbol = None
+    for line in lines:
+        line = line.rstrip("\n")
+        if line.startswith("Linker script and memory map"):
+            in_memory_map = True
+            continue
+        if line.startswith("Cross Reference Table"):
+            in_memory_map = False
+            in_cref = True
+            continue
+        if in_cref:
+            symbol = parse_cref_line(line, symbol, references, modules)
+            continue
+        if not in_memory_map:
+            continue
+        if line and not line[0].isspace():
+            output_section = line.split()[0]
+            pending = None
+            continue
+        if pending is not None:
+            wrapped = WRAPPED_INPUT.match(line)
+            if wrapped:
+                add_size(sizes, output_section, wrapped.group(3), int(wrapped.group(2), 16), modules)
+            pending = None
+            continue
+        entry = INPUT_SECTION.match(line)
+        if entry is None or output_section is None or entry.group(1).startswith(("*", "0x")):
+            continue
+        if entry.group(2) is None:
+            pending = entry.group(1)
+        else:
+            add_size(sizes, output_section, entry.group(4), int(entry.group(3), 16), modules)
+    return sizes, references
+
+
+def add_size(sizes, output_section, file, size, modules):
+    kind = kind_of(output_section)
+    if kind is None or size == 0 or file.startswith("linker stubs"):
+        return
+    module = sizes.setdefault(module_of(file.strip(), modules), {"text": 0, "data": 0, "bss": 0})
+    module[kind] += size
+
+
+def parse_cref_line(line, symbol, references, modules):
+    """The first file under a symbol defines it, the ones below it reference it."""
+    if not line.strip() or line.startswith("Symbol"):
+        return symbol
+    if not line[0].isspace():
+        parts = line.split(None, 1)
+        return parts[0] if len(parts) == 2 else None
+    if symbol is not None:
+        name = symbol[len("__wrap_"):] if symbol.startswith("__wrap_") else symbol
+        if name in FORBIDDEN_SYMBOLS:
+            module = module_of(line.strip(), modules)
+            if module in modules and module not in NOT_DRIVERS:
+                references.setdefault(module, set()).add(name)
+    return symbol
+
+
+def check_budget(sizes, budget):
+    violations = []
+    for name, limits in budget.get("modules", {}).items():
+        for kind, limit in limits.items():
+            used = sizes.get(name, {}).get(kind, 0)
+            if used > limit:
+                violations.append("%s %s %d > %d" % (name, kind, used, limit))
+    for kind, limit in budget.get("total", {}).items():
+        used = sum(module[kind] for module in sizes.values())
+        if used > limit:
+            violations.append("total %s %d > %d" % (kind, used, limit))
+    return violations
+
+
+def print_report(sizes, budget):
+    limits = budget.get("modules", {}) if budget else {}
+    print("%-32s %8s %8s %8s  %s" % ("module", "text", "data", "bss", "budget text/data/bss"))
+    for name in sorted(sizes, key=lambda module: (module.startswith("["), module)):
+        module = sizes[name]
+        limit = limits.get(name)
+        limitText = "/".join(str(limit.get(kind, "-")) for kind in ("text", "data", "bss")) if limit else ""
+        print("%-32s %8d %8d %8d  %s" % (name, module["text"], module["data"], module["bss"], limitText))
+    totals = [sum(module[kind] for module in sizes.values()) for kind in ("text", "data", "bss")]
+    print("%-32s %8d %8d %8d" % ("total", totals[0], totals[1], totals[2]))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map", help="map file written by the linker, e.g. with -Wl,-Map")
+    parser.add_argument("--budget", help="JSON with the text/data/bss limits per module and in total")
+    args = parser.parse_args()
+
+    with open(args.map) as file:
+        sizes, references = parse_map(file, project_modules())
+    budget = None
+    if args.budget:
+        with open(args.budget) as file:
+            budget = json.load(file)
+    print_report(sizes, budget)
+
+    problems = []
+    for module in sorted(references):
+        problems.append("%s references %s" % (module, ", ".join(sorted(references[module]))))
+    if budget is not None:
+        problems += check_budget(sizes, budget)
+    for problem in problems:
+        print(problem)
+    return 1 if budget is not None and problems else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,59 @@
+#!/usr/bin/env python3
+"""Stack frame of every driver function, from the .su files gcc writes with -fstack-usage.
+
+    python3 tools/stack_report.py build/bench/CMakeFiles/driver_stack_usage.dir --limit 1024
+
+Frames are listed largest first. A dynamic frame grows with an argument, a variable length array or alloca,
+so its size is only the fixed part. The script exits with 1 if a frame is over the limit, and with
+--fail-on-dynamic also if any frame is dynamic.
+"""
+
+import argparse
+import os
+import sys
+
+
+def read_frames(directory):
+    frames = []
+    for root, _, names in os.walk(directory):
+        for name in sorted(names):
+            if not name.endswith(".su"):
+                continue
+            with open(os.path.join(root, name)) as file:
+                for line in file:
+                    # file:line:column:function <tab> bytes <tab> static, dynamic or dynamic,bounded
+                    location, size, qualifier = line.rstrip("\n").split("\t")
+                    source, row, _, function = location.rsplit(":", 3)
+                    frames.append((int(size), qualifier, "%s:%s" % (os.path.basename(source), row), function))
+    return frames
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("directory", help="directory searched for .su files")
+    parser.add_argument("--limit", type=int, default=1024, help="largest frame in bytes that passes")
+    parser.add_argument("--fail-on-dynamic", action="store_true", help="also fail on frames that are not bounded")
+    args = parser.parse_args()
+
+    frames = read_frames(args.directory)
+    if not frames:
+        print("no .su files in %s, compiled with -fstack-usage?" % args.directory)
+        return 1
+    frames.sort(key=lambda frame: (-frame[0], frame[3]))
+    print("%6s  %-16s %-44s %s" % ("bytes", "kind", "function", "source"))
+    for size, qualifier, source, function in frames:
+        print("%6d  %-16s %-44s %s" % (size, qualifier, function, source))
+
+    failed = False
+    for size, qualifier, source, function in frames:
+        if size > args.limit:
+            print("%s uses %d bytes, more than the limit of %d" % (function, size, args.limit))
+            failed = True
+        if qualifier == "dynamic":
+            print("%s at %s has an unbounded frame, e.g. a variable length array" % (function, source))
+            failed = failed or args.fail_on_dynamic
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())